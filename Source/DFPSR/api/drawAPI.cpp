@@ -23,10 +23,17 @@
 //    distribution.
 
 #include "imageAPI.h"
+#include "drawAPI.h"
 #include "../implementation/math/scalar.h"
 #include "../implementation/image/PackOrder.h"
+#include "../implementation/image/PixelVectors.h"
 #include "../implementation/math/scalar.h"
+#include "../base/threading.h"
+#include "../base/simd.h"
 #include <limits>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
 
 namespace dsr {
 
@@ -153,6 +160,17 @@ void draw_rectangle(const ImageF32& image, const IRect& bound, float color) {
 		}
 	}
 }
+void draw_rectangle(const ImageF16& image, const IRect& bound, float color) {
+	if (image_exists(image)) {
+		uint16_t half = roundToF16(color);
+		// Positive zero has all bits zeroed in half precision too.
+		if (half == 0) {
+			drawSolidRectangleMemset<ImageF16, uint16_t>(image, bound.left(), bound.top(), bound.right(), bound.bottom(), 0);
+		} else {
+			drawSolidRectangleAssign<ImageF16, uint16_t>(image, bound.left(), bound.top(), bound.right(), bound.bottom(), half);
+		}
+	}
+}
 void draw_rectangle(const ImageRgbaU8& image, const IRect& bound, uint32_t packedColor) {
 	if (image_exists(image)) {
 		if (isUniformByte(packedColor)) {
@@ -298,6 +316,11 @@ void draw_line(const ImageF32& image, int32_t x1, int32_t y1, int32_t x2, int32_
 		drawLineSuper<ImageF32, float>(image, x1, y1, x2, y2, color);
 	}
 }
+void draw_line(const ImageF16& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, float color) {
+	if (image_exists(image)) {
+		drawLineSuper<ImageF16, float>(image, x1, y1, x2, y2, color);
+	}
+}
 void draw_line(const ImageRgbaU8& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t packedColor) {
 	if (image_exists(image)) {
 		drawLineSuper<ImageRgbaU8, uint32_t>(image, x1, y1, x2, y2, packedColor);
@@ -384,22 +407,44 @@ struct ImageIntersection {
 	}
 };
 
-#define ITERATE_ROWS(WRITER, READER, OPERATION) \
-{ \
-	uint8_t *targetRow = WRITER.data; \
-	const uint8_t *sourceRow = READER.data; \
-	for (int32_t y = 0; y < READER.height; y++) { \
+// Images with fewer pixels than the threshold are drawn on the calling thread, because starting jobs would take longer than drawing.
+static std::atomic<int64_t> threadingThreshold(65536);
+
+void draw_setThreadingThreshold(int64_t minimumPixelCount) {
+	threadingThreshold = minimumPixelCount;
+}
+
+int64_t draw_getThreadingThreshold() {
+	return threadingThreshold;
+}
+
+// Calls task with non-overlapping intervals of rows covering 0..height - 1.
+//   Uses multiple threads if the region has enough pixels and maxThreadCount is not 1.
+static void splitRows(int32_t width, int32_t height, int32_t maxThreadCount, const TemporaryCallback<void(int32_t startY, int32_t stopY)> &task) {
+	if (maxThreadCount == 1 || width <= 0 || int64_t(width) * int64_t(height) < threadingThreshold) {
+		task(0, height);
+	} else {
+		// Each job gets at least 16384 pixels, so that each job spans many cache lines and threads rarely write to the same cache line.
+		threadedSplit(0, height, task, max(1, 16384 / width), 2, maxThreadCount);
+	}
+}
+
+#define ITERATE_ROWS(WRITER, READER, MAX_THREAD_COUNT, OPERATION) \
+splitRows(READER.width, READER.height, MAX_THREAD_COUNT, [&](int32_t startY, int32_t stopY) { \
+	uint8_t *targetRow = WRITER.data + intptr_t(startY) * WRITER.stride; \
+	const uint8_t *sourceRow = READER.data + intptr_t(startY) * READER.stride; \
+	for (int32_t y = startY; y < stopY; y++) { \
 		OPERATION; \
 		targetRow += WRITER.stride; \
 		sourceRow += READER.stride; \
 	} \
-}
+});
 
-#define ITERATE_PIXELS(WRITER, READER, OPERATION) \
-{ \
-	uint8_t *targetRow = WRITER.data; \
-	const uint8_t *sourceRow = READER.data; \
-	for (int32_t y = 0; y < READER.height; y++) { \
+#define ITERATE_PIXELS(WRITER, READER, MAX_THREAD_COUNT, OPERATION) \
+splitRows(READER.width, READER.height, MAX_THREAD_COUNT, [&](int32_t startY, int32_t stopY) { \
+	uint8_t *targetRow = WRITER.data + intptr_t(startY) * WRITER.stride; \
+	const uint8_t *sourceRow = READER.data + intptr_t(startY) * READER.stride; \
+	for (int32_t y = startY; y < stopY; y++) { \
 		uint8_t *targetPixel = targetRow; \
 		const uint8_t *sourcePixel = sourceRow; \
 		for (int32_t x = 0; x < READER.width; x++) { \
@@ -410,68 +455,72 @@ struct ImageIntersection {
 		targetRow += WRITER.stride; \
 		sourceRow += READER.stride; \
 	} \
-}
+});
 
-#define ITERATE_PIXELS_2(WRITER1, READER1, WRITER2, READER2, OPERATION) \
+#define ITERATE_PIXELS_2(WRITER1, READER1, WRITER2, READER2, MAX_THREAD_COUNT, OPERATION) \
 { \
-	uint8_t *targetRow1 = WRITER1.data; \
-	uint8_t *targetRow2 = WRITER2.data; \
-	const uint8_t *sourceRow1 = READER1.data; \
-	const uint8_t *sourceRow2 = READER2.data; \
 	int32_t minWidth = min(READER1.width, READER2.width); \
 	int32_t minHeight = min(READER1.height, READER2.height); \
-	for (int32_t y = 0; y < minHeight; y++) { \
-		uint8_t *targetPixel1 = targetRow1; \
-		uint8_t *targetPixel2 = targetRow2; \
-		const uint8_t *sourcePixel1 = sourceRow1; \
-		const uint8_t *sourcePixel2 = sourceRow2; \
-		for (int32_t x = 0; x < minWidth; x++) { \
-			{OPERATION;} \
-			targetPixel1 += WRITER1.pixelSize; \
-			targetPixel2 += WRITER2.pixelSize; \
-			sourcePixel1 += READER1.pixelSize; \
-			sourcePixel2 += READER2.pixelSize; \
+	splitRows(minWidth, minHeight, MAX_THREAD_COUNT, [&](int32_t startY, int32_t stopY) { \
+		uint8_t *targetRow1 = WRITER1.data + intptr_t(startY) * WRITER1.stride; \
+		uint8_t *targetRow2 = WRITER2.data + intptr_t(startY) * WRITER2.stride; \
+		const uint8_t *sourceRow1 = READER1.data + intptr_t(startY) * READER1.stride; \
+		const uint8_t *sourceRow2 = READER2.data + intptr_t(startY) * READER2.stride; \
+		for (int32_t y = startY; y < stopY; y++) { \
+			uint8_t *targetPixel1 = targetRow1; \
+			uint8_t *targetPixel2 = targetRow2; \
+			const uint8_t *sourcePixel1 = sourceRow1; \
+			const uint8_t *sourcePixel2 = sourceRow2; \
+			for (int32_t x = 0; x < minWidth; x++) { \
+				{OPERATION;} \
+				targetPixel1 += WRITER1.pixelSize; \
+				targetPixel2 += WRITER2.pixelSize; \
+				sourcePixel1 += READER1.pixelSize; \
+				sourcePixel2 += READER2.pixelSize; \
+			} \
+			targetRow1 += WRITER1.stride; \
+			targetRow2 += WRITER2.stride; \
+			sourceRow1 += READER1.stride; \
+			sourceRow2 += READER2.stride; \
 		} \
-		targetRow1 += WRITER1.stride; \
-		targetRow2 += WRITER2.stride; \
-		sourceRow1 += READER1.stride; \
-		sourceRow2 += READER2.stride; \
-	} \
+	}); \
 }
 
-#define ITERATE_PIXELS_3(WRITER1, READER1, WRITER2, READER2, WRITER3, READER3, OPERATION) \
+#define ITERATE_PIXELS_3(WRITER1, READER1, WRITER2, READER2, WRITER3, READER3, MAX_THREAD_COUNT, OPERATION) \
 { \
-	uint8_t *targetRow1 = WRITER1.data; \
-	uint8_t *targetRow2 = WRITER2.data; \
-	uint8_t *targetRow3 = WRITER3.data; \
-	const uint8_t *sourceRow1 = READER1.data; \
-	const uint8_t *sourceRow2 = READER2.data; \
-	const uint8_t *sourceRow3 = READER3.data; \
 	int32_t minWidth = min(min(READER1.width, READER2.width), READER3.width); \
 	int32_t minHeight = min(min(READER1.height, READER2.height), READER3.height); \
-	for (int32_t y = 0; y < minHeight; y++) { \
-		uint8_t *targetPixel1 = targetRow1; \
-		uint8_t *targetPixel2 = targetRow2; \
-		uint8_t *targetPixel3 = targetRow3; \
-		const uint8_t *sourcePixel1 = sourceRow1; \
-		const uint8_t *sourcePixel2 = sourceRow2; \
-		const uint8_t *sourcePixel3 = sourceRow3; \
-		for (int32_t x = 0; x < minWidth; x++) { \
-			{OPERATION;} \
-			targetPixel1 += WRITER1.pixelSize; \
-			targetPixel2 += WRITER2.pixelSize; \
-			targetPixel3 += WRITER3.pixelSize; \
-			sourcePixel1 += READER1.pixelSize; \
-			sourcePixel2 += READER2.pixelSize; \
-			sourcePixel3 += READER3.pixelSize; \
+	splitRows(minWidth, minHeight, MAX_THREAD_COUNT, [&](int32_t startY, int32_t stopY) { \
+		uint8_t *targetRow1 = WRITER1.data + intptr_t(startY) * WRITER1.stride; \
+		uint8_t *targetRow2 = WRITER2.data + intptr_t(startY) * WRITER2.stride; \
+		uint8_t *targetRow3 = WRITER3.data + intptr_t(startY) * WRITER3.stride; \
+		const uint8_t *sourceRow1 = READER1.data + intptr_t(startY) * READER1.stride; \
+		const uint8_t *sourceRow2 = READER2.data + intptr_t(startY) * READER2.stride; \
+		const uint8_t *sourceRow3 = READER3.data + intptr_t(startY) * READER3.stride; \
+		for (int32_t y = startY; y < stopY; y++) { \
+			uint8_t *targetPixel1 = targetRow1; \
+			uint8_t *targetPixel2 = targetRow2; \
+			uint8_t *targetPixel3 = targetRow3; \
+			const uint8_t *sourcePixel1 = sourceRow1; \
+			const uint8_t *sourcePixel2 = sourceRow2; \
+			const uint8_t *sourcePixel3 = sourceRow3; \
+			for (int32_t x = 0; x < minWidth; x++) { \
+				{OPERATION;} \
+				targetPixel1 += WRITER1.pixelSize; \
+				targetPixel2 += WRITER2.pixelSize; \
+				targetPixel3 += WRITER3.pixelSize; \
+				sourcePixel1 += READER1.pixelSize; \
+				sourcePixel2 += READER2.pixelSize; \
+				sourcePixel3 += READER3.pixelSize; \
+			} \
+			targetRow1 += WRITER1.stride; \
+			targetRow2 += WRITER2.stride; \
+			targetRow3 += WRITER3.stride; \
+			sourceRow1 += READER1.stride; \
+			sourceRow2 += READER2.stride; \
+			sourceRow3 += READER3.stride; \
 		} \
-		targetRow1 += WRITER1.stride; \
-		targetRow2 += WRITER2.stride; \
-		targetRow3 += WRITER3.stride; \
-		sourceRow1 += READER1.stride; \
-		sourceRow2 += READER2.stride; \
-		sourceRow3 += READER3.stride; \
-	} \
+	}); \
 }
 
 inline int32_t saturateFloat(float value) {
@@ -489,58 +538,109 @@ inline int32_t saturateFloat(float value) {
 
 // Copy data from one image region to another of the same size.
 //   Packing order is reinterpreted without conversion.
-static void copyImageData(ImageWriter writer, ImageReader reader) {
+static void copyImageData(ImageWriter writer, ImageReader reader, int32_t maxThreadCount) {
 	assert(writer.width == reader.width && writer.height == reader.height && writer.pixelSize == reader.pixelSize);
-	ITERATE_ROWS(writer, reader, std::memcpy(targetRow, sourceRow, reader.width * reader.pixelSize));
+	ITERATE_ROWS(writer, reader, maxThreadCount, std::memcpy(targetRow, sourceRow, reader.width * reader.pixelSize));
 }
 
-// TODO: Can SIMD be used for specific platforms where vector extract accepts a variable offset?
-static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
+// Moves the channels of one pixel from the source pack order to the target pack order.
+inline void repackPixel(uint8_t *targetPixel, const uint8_t *sourcePixel, const PackOrder &targetPackOrder, const PackOrder &sourcePackOrder) {
+	targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
+	targetPixel[targetPackOrder.greenIndex] = sourcePixel[sourcePackOrder.greenIndex];
+	targetPixel[targetPackOrder.blueIndex]  = sourcePixel[sourcePackOrder.blueIndex];
+	targetPixel[targetPackOrder.alphaIndex] = sourcePixel[sourcePackOrder.alphaIndex];
+}
+
+#if defined(USE_SSSE3) || defined(USE_NEON)
+// Repacks a row of pixels using byte shuffles of whole SIMD vectors.
+//   indices tells which byte of the source to take for each byte of the target, with the same pattern for every pixel.
+//   Vectors are only used while both rows are aligned, so pixels before and after are repacked one at a time.
+static void repackRow(uint8_t *targetPixel, const uint8_t *sourcePixel, int32_t width, const U8xX &indices, const PackOrder &targetPackOrder, const PackOrder &sourcePackOrder) {
+	static const int32_t pixelsPerVector = laneCountX_8Bit / 4;
+	int32_t x = 0;
+	// Sub-images may start anywhere, but both rows will only become aligned at the same time if their misalignments are the same.
+	while (x < width && ((uintptr_t(targetPixel) | uintptr_t(sourcePixel)) & uintptr_t(laneCountX_8Bit - 1)) != 0) {
+		repackPixel(targetPixel, sourcePixel, targetPackOrder, sourcePackOrder);
+		targetPixel += 4;
+		sourcePixel += 4;
+		x++;
+	}
+	if (((uintptr_t(targetPixel) | uintptr_t(sourcePixel)) & uintptr_t(laneCountX_8Bit - 1)) == 0) {
+		while (x + pixelsPerVector <= width) {
+			shuffleBytes(U8xX::readAlignedUnsafe(sourcePixel), indices).writeAlignedUnsafe(targetPixel);
+			targetPixel += laneCountX_8Bit;
+			sourcePixel += laneCountX_8Bit;
+			x += pixelsPerVector;
+		}
+	}
+	while (x < width) {
+		repackPixel(targetPixel, sourcePixel, targetPackOrder, sourcePackOrder);
+		targetPixel += 4;
+		sourcePixel += 4;
+		x++;
+	}
+}
+#endif
+
+static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	PackOrderIndex targetPackOrderIndex = image_getPackOrderIndex(target);
 	PackOrderIndex sourcePackOrderIndex = image_getPackOrderIndex(source);
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
 		if (targetPackOrderIndex == sourcePackOrderIndex) {
 			// No conversion needed
-			copyImageData(intersection.subTarget, intersection.subSource);
+			copyImageData(intersection.subTarget, intersection.subSource, maxThreadCount);
 		} else {
 			PackOrder targetPackOrder = PackOrder::getPackOrder(targetPackOrderIndex);
 			PackOrder sourcePackOrder = PackOrder::getPackOrder(sourcePackOrderIndex);
-			// Read and repack to convert between different color formats
-			// TODO: Pre-compute conversions for each combination of source and target pack order.
-			//       We do not need to store the data in RGBA order, just pack from one format to another.
-			ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
-				targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
-				targetPixel[targetPackOrder.greenIndex] = sourcePixel[sourcePackOrder.greenIndex];
-				targetPixel[targetPackOrder.blueIndex]  = sourcePixel[sourcePackOrder.blueIndex];
-				targetPixel[targetPackOrder.alphaIndex] = sourcePixel[sourcePackOrder.alphaIndex];
-			);
+			#if defined(USE_SSSE3) || defined(USE_NEON)
+				// Pack directly from one format to another by shuffling the bytes within each pixel.
+				ALIGN_BYTES(sizeof(U8xX)) uint8_t indexBytes[laneCountX_8Bit];
+				for (int32_t p = 0; p < laneCountX_8Bit; p += 4) {
+					// Indices select from the same 16-byte half of the vector.
+					int32_t sourcePixel = p & 15;
+					indexBytes[p + targetPackOrder.redIndex]   = sourcePixel + sourcePackOrder.redIndex;
+					indexBytes[p + targetPackOrder.greenIndex] = sourcePixel + sourcePackOrder.greenIndex;
+					indexBytes[p + targetPackOrder.blueIndex]  = sourcePixel + sourcePackOrder.blueIndex;
+					indexBytes[p + targetPackOrder.alphaIndex] = sourcePixel + sourcePackOrder.alphaIndex;
+				}
+				U8xX indices = U8xX::readAlignedUnsafe(indexBytes);
+				int32_t width = intersection.subSource.width;
+				ITERATE_ROWS(intersection.subTarget, intersection.subSource, maxThreadCount,
+					repackRow(targetRow, sourceRow, width, indices, targetPackOrder, sourcePackOrder)
+				);
+			#else
+				// Without byte shuffling instructions, each pixel is repacked by itself.
+				ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
+					repackPixel(targetPixel, sourcePixel, targetPackOrder, sourcePackOrder);
+				);
+			#endif
 		}
 	}
 }
-static void imageImpl_drawCopy(const ImageU8& target, const ImageU8& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageU8& target, const ImageU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		copyImageData(intersection.subTarget, intersection.subSource);
+		copyImageData(intersection.subTarget, intersection.subSource, maxThreadCount);
 	}
 }
-static void imageImpl_drawCopy(const ImageU16& target, const ImageU16& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageU16& target, const ImageU16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		copyImageData(intersection.subTarget, intersection.subSource);
+		copyImageData(intersection.subTarget, intersection.subSource, maxThreadCount);
 	}
 }
-static void imageImpl_drawCopy(const ImageF32& target, const ImageF32& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageF32& target, const ImageF32& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		copyImageData(intersection.subTarget, intersection.subSource);
+		copyImageData(intersection.subTarget, intersection.subSource, maxThreadCount);
 	}
 }
-static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageU8& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			uint8_t luma = *sourcePixel;
 			targetPixel[targetPackOrder.redIndex]   = luma;
 			targetPixel[targetPackOrder.greenIndex] = luma;
@@ -549,11 +649,11 @@ static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageU8& source,
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageU16& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageU16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			int32_t luma = *((const uint16_t*)sourcePixel);
 			if (luma > 255) { luma = 255; }
 			targetPixel[targetPackOrder.redIndex]   = luma;
@@ -563,11 +663,11 @@ static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageU16& source
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageF32& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageF32& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			int32_t luma = saturateFloat(*((const float*)sourcePixel));
 			targetPixel[targetPackOrder.redIndex]   = luma;
 			targetPixel[targetPackOrder.greenIndex] = luma;
@@ -576,36 +676,36 @@ static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageF32& source
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageU8& target, const ImageF32& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageU8& target, const ImageF32& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			*targetPixel = saturateFloat(*((const float*)sourcePixel));
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageU8& target, const ImageU16& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageU8& target, const ImageU16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			int32_t luma = *((const uint16_t*)sourcePixel);
 			if (luma > 255) { luma = 255; }
 			*targetPixel = luma;
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageU16& target, const ImageU8& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageU16& target, const ImageU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			*((uint16_t*)targetPixel) = *sourcePixel;
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageU16& target, const ImageF32& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageU16& target, const ImageF32& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			int32_t luma = *((const float*)sourcePixel);
 			if (luma < 0) { luma = 0; }
 			if (luma > 65535) { luma = 65535; }
@@ -613,18 +713,18 @@ static void imageImpl_drawCopy(const ImageU16& target, const ImageF32& source, i
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageF32& target, const ImageU8& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageF32& target, const ImageU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			*((float*)targetPixel) = (float)(*sourcePixel);
 		);
 	}
 }
-static void imageImpl_drawCopy(const ImageF32& target, const ImageU16& source, int32_t left, int32_t top) {
+static void imageImpl_drawCopy(const ImageF32& target, const ImageU16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			int32_t luma = *((const uint16_t*)sourcePixel);
 			if (luma > 255) { luma = 255; }
 			*((float*)targetPixel) = (float)luma;
@@ -632,42 +732,267 @@ static void imageImpl_drawCopy(const ImageF32& target, const ImageU16& source, i
 	}
 }
 
+// Half precision floats are converted to and from floats one SIMD vector at a time using F16C or NEON.
+//   Rows do not have to be aligned, so the lanes are copied through an aligned array on the stack before loading and after storing.
+#if defined(USE_F16C) || (defined(USE_NEON) && defined(__aarch64__))
+	#define USE_F16_SIMD
+#endif
+static void convertRowFromF16(float *target, const uint16_t *source, int32_t width) {
+	int32_t x = 0;
+	#ifdef USE_F16_SIMD
+		for (; x + laneCountX_16Bit <= width; x += laneCountX_16Bit) {
+			ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint16_t halves[laneCountX_16Bit];
+			ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) float floats[laneCountX_16Bit];
+			std::memcpy(halves, source + x, sizeof(halves));
+			U16xX packed = U16xX::readAlignedUnsafe(halves);
+			lowerFloatFromF16(packed).writeAlignedUnsafe(floats);
+			higherFloatFromF16(packed).writeAlignedUnsafe(floats + laneCountX_32Bit);
+			std::memcpy(target + x, floats, sizeof(floats));
+		}
+	#endif
+	for (; x < width; x++) {
+		target[x] = floatFromF16(source[x]);
+	}
+}
+static void convertRowToF16(uint16_t *target, const float *source, int32_t width) {
+	int32_t x = 0;
+	#ifdef USE_F16_SIMD
+		for (; x + laneCountX_16Bit <= width; x += laneCountX_16Bit) {
+			ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) float floats[laneCountX_16Bit];
+			ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint16_t halves[laneCountX_16Bit];
+			std::memcpy(floats, source + x, sizeof(floats));
+			roundToF16(F32xX::readAlignedUnsafe(floats), F32xX::readAlignedUnsafe(floats + laneCountX_32Bit)).writeAlignedUnsafe(halves);
+			std::memcpy(target + x, halves, sizeof(halves));
+		}
+	#endif
+	for (; x < width; x++) {
+		target[x] = roundToF16(source[x]);
+	}
+}
+static void imageImpl_drawCopy(const ImageF16& target, const ImageF16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		copyImageData(intersection.subTarget, intersection.subSource, maxThreadCount);
+	}
+}
+static void imageImpl_drawCopy(const ImageF16& target, const ImageF32& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		ITERATE_ROWS(intersection.subTarget, intersection.subSource, maxThreadCount,
+			convertRowToF16((uint16_t*)targetRow, (const float*)sourceRow, intersection.subSource.width)
+		);
+	}
+}
+static void imageImpl_drawCopy(const ImageF32& target, const ImageF16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		ITERATE_ROWS(intersection.subTarget, intersection.subSource, maxThreadCount,
+			convertRowFromF16((float*)targetRow, (const uint16_t*)sourceRow, intersection.subSource.width)
+		);
+	}
+}
+static void imageImpl_drawCopy(const ImageF16& target, const ImageU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
+			*((uint16_t*)targetPixel) = roundToF16((float)(*sourcePixel));
+		);
+	}
+}
+static void imageImpl_drawCopy(const ImageU8& target, const ImageF16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
+			*targetPixel = saturateFloat(floatFromF16(*((const uint16_t*)sourcePixel)));
+		);
+	}
+}
+static void imageImpl_drawCopy(const ImageRgbaU8& target, const ImageF16& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		PackOrder targetPackOrder = image_getPackOrder(target);
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
+			int32_t luma = saturateFloat(floatFromF16(*((const uint16_t*)sourcePixel)));
+			targetPixel[targetPackOrder.redIndex]   = luma;
+			targetPixel[targetPackOrder.greenIndex] = luma;
+			targetPixel[targetPackOrder.blueIndex]  = luma;
+			targetPixel[targetPackOrder.alphaIndex] = 255;
+		);
+	}
+}
+
+inline void alphaFilterPixel(uint8_t *targetPixel, const uint8_t *sourcePixel, const PackOrder &targetPackOrder, const PackOrder &sourcePackOrder) {
+	// Optimized for anti-aliasing, where most alpha values are 0 or 255
+	uint32_t sourceRatio = sourcePixel[sourcePackOrder.alphaIndex];
+	if (sourceRatio > 0) {
+		if (sourceRatio == 255) {
+			targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
+			targetPixel[targetPackOrder.greenIndex] = sourcePixel[sourcePackOrder.greenIndex];
+			targetPixel[targetPackOrder.blueIndex]  = sourcePixel[sourcePackOrder.blueIndex];
+			targetPixel[targetPackOrder.alphaIndex] = 255;
+		} else {
+			uint32_t targetRatio = 255 - sourceRatio;
+			targetPixel[targetPackOrder.redIndex]   = normalizedByteMultiplication(targetPixel[targetPackOrder.redIndex], targetRatio) + normalizedByteMultiplication(sourcePixel[sourcePackOrder.redIndex], sourceRatio);
+			targetPixel[targetPackOrder.greenIndex] = normalizedByteMultiplication(targetPixel[targetPackOrder.greenIndex], targetRatio) + normalizedByteMultiplication(sourcePixel[sourcePackOrder.greenIndex], sourceRatio);
+			targetPixel[targetPackOrder.blueIndex]  = normalizedByteMultiplication(targetPixel[targetPackOrder.blueIndex], targetRatio) + normalizedByteMultiplication(sourcePixel[sourcePackOrder.blueIndex], sourceRatio);
+			targetPixel[targetPackOrder.alphaIndex] = normalizedByteMultiplication(targetPixel[targetPackOrder.alphaIndex], targetRatio) + sourceRatio;
+		}
+	}
+}
+
+// Alpha filtering a row of width pixels when source and target have the same pack order.
+//   Bit-exact with alphaFilterPixel, by blending every channel as target * (255 - sourceRatio) + source * sourceRatio.
+//   Source alpha is replaced by 255 before blending, so that target alpha gets sourceRatio added like in alphaFilterPixel.
+static void alphaFilterRow(uint8_t *targetPixel, const uint8_t *sourcePixel, int32_t width, const PackOrder &packOrder) {
+	U32xX transparent = U32xX(0u);
+	U32xX opaque = U32xX(255u);
+	U32xX alphaMask = U32xX(packOrder.alphaMask);
+	int32_t x = 0;
+	for (; x + laneCountX_32Bit <= width; x += laneCountX_32Bit) {
+		U32xX source = readPixels(sourcePixel);
+		U32xX sourceRatio = packOrder_getAlpha(source, packOrder);
+		// Skip blending for whole vectors of fully transparent or fully opaque pixels, which are the most common in sprites and fonts.
+		if (allLanesEqual(sourceRatio, opaque)) {
+			writePixels(targetPixel, source);
+		} else if (!allLanesEqual(sourceRatio, transparent)) {
+			// Repeat the ratio in each byte of the pixel.
+			sourceRatio = sourceRatio | (sourceRatio << 8u);
+			sourceRatio = sourceRatio | (sourceRatio << 16u);
+			U8xX sourceBytes = reinterpret_U8FromU32(source | alphaMask);
+			U8xX targetBytes = reinterpret_U8FromU32(readPixels(targetPixel));
+			U8xX sourceRatios = reinterpret_U8FromU32(sourceRatio);
+			// Inverting the bits of a byte subtracts it from 255.
+			U8xX targetRatios = reinterpret_U8FromU32(~sourceRatio);
+			U16xX lower = normalizedByteMultiplication(lowerToU16(targetBytes), lowerToU16(targetRatios)) + normalizedByteMultiplication(lowerToU16(sourceBytes), lowerToU16(sourceRatios));
+			U16xX upper = normalizedByteMultiplication(higherToU16(targetBytes), higherToU16(targetRatios)) + normalizedByteMultiplication(higherToU16(sourceBytes), higherToU16(sourceRatios));
+			writePixels(targetPixel, reinterpret_U32FromU8(truncateToU8(lower, upper)));
+		}
+		targetPixel += laneCountX_32Bit * 4;
+		sourcePixel += laneCountX_32Bit * 4;
+	}
+	for (; x < width; x++) {
+		alphaFilterPixel(targetPixel, sourcePixel, packOrder, packOrder);
+		targetPixel += 4;
+		sourcePixel += 4;
+	}
+}
 
-static void imageImpl_drawAlphaFilter(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
+static void imageImpl_drawAlphaFilter(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		PackOrder sourcePackOrder = image_getPackOrder(source);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
-		// Read and repack to convert between different color formats
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
-			// Optimized for anti-aliasing, where most alpha values are 0 or 255
-			uint32_t sourceRatio = sourcePixel[sourcePackOrder.alphaIndex];
-			if (sourceRatio > 0) {
-				if (sourceRatio == 255) {
-					targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
-					targetPixel[targetPackOrder.greenIndex] = sourcePixel[sourcePackOrder.greenIndex];
-					targetPixel[targetPackOrder.blueIndex]  = sourcePixel[sourcePackOrder.blueIndex];
-					targetPixel[targetPackOrder.alphaIndex] = 255;
-				} else {
-					uint32_t targetRatio = 255 - sourceRatio;
-					targetPixel[targetPackOrder.redIndex]   = normalizedByteMultiplication(targetPixel[targetPackOrder.redIndex], targetRatio) + normalizedByteMultiplication(sourcePixel[sourcePackOrder.redIndex], sourceRatio);
-					targetPixel[targetPackOrder.greenIndex] = normalizedByteMultiplication(targetPixel[targetPackOrder.greenIndex], targetRatio) + normalizedByteMultiplication(sourcePixel[sourcePackOrder.greenIndex], sourceRatio);
-					targetPixel[targetPackOrder.blueIndex]  = normalizedByteMultiplication(targetPixel[targetPackOrder.blueIndex], targetRatio) + normalizedByteMultiplication(sourcePixel[sourcePackOrder.blueIndex], sourceRatio);
-					targetPixel[targetPackOrder.alphaIndex] = normalizedByteMultiplication(targetPixel[targetPackOrder.alphaIndex], targetRatio) + sourceRatio;
-				}
-			}
-		);
+		if (image_getPackOrderIndex(target) == image_getPackOrderIndex(source)) {
+			ITERATE_ROWS(intersection.subTarget, intersection.subSource, maxThreadCount,
+				alphaFilterRow(targetRow, sourceRow, intersection.subSource.width, targetPackOrder)
+			);
+		} else {
+			// Read and repack to convert between different color formats
+			ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
+				alphaFilterPixel(targetPixel, sourcePixel, targetPackOrder, sourcePackOrder)
+			);
+		}
+	}
+}
+
+// Drawing a premultiplied source pixel over a target pixel, by adding source to target * (255 - source alpha) in every channel including alpha.
+inline void premultipliedAlphaFilterPixel(uint8_t *targetPixel, const uint8_t *sourcePixel, const PackOrder &targetPackOrder, const PackOrder &sourcePackOrder) {
+	uint32_t targetRatio = 255 - sourcePixel[sourcePackOrder.alphaIndex];
+	targetPixel[targetPackOrder.redIndex]   = min(255u, normalizedByteMultiplication(targetPixel[targetPackOrder.redIndex], targetRatio) + sourcePixel[sourcePackOrder.redIndex]);
+	targetPixel[targetPackOrder.greenIndex] = min(255u, normalizedByteMultiplication(targetPixel[targetPackOrder.greenIndex], targetRatio) + sourcePixel[sourcePackOrder.greenIndex]);
+	targetPixel[targetPackOrder.blueIndex]  = min(255u, normalizedByteMultiplication(targetPixel[targetPackOrder.blueIndex], targetRatio) + sourcePixel[sourcePackOrder.blueIndex]);
+	targetPixel[targetPackOrder.alphaIndex] = min(255u, normalizedByteMultiplication(targetPixel[targetPackOrder.alphaIndex], targetRatio) + sourcePixel[sourcePackOrder.alphaIndex]);
+}
+
+// Premultiplied alpha filtering of a row of width pixels when source and target have the same pack order.
+//   Bit-exact with premultipliedAlphaFilterPixel, using one multiplication and one saturated addition per channel.
+static void premultipliedAlphaFilterRow(uint8_t *targetPixel, const uint8_t *sourcePixel, int32_t width, const PackOrder &packOrder) {
+	U32xX transparent = U32xX(0u);
+	U32xX opaque = U32xX(255u);
+	int32_t x = 0;
+	for (; x + laneCountX_32Bit <= width; x += laneCountX_32Bit) {
+		U32xX source = readPixels(sourcePixel);
+		U32xX sourceRatio = packOrder_getAlpha(source, packOrder);
+		// Opaque pixels replace the target, and pixels that are zero in all channels leave the target as it is.
+		if (allLanesEqual(sourceRatio, opaque)) {
+			writePixels(targetPixel, source);
+		} else if (!allLanesEqual(source, transparent)) {
+			sourceRatio = sourceRatio | (sourceRatio << 8u);
+			sourceRatio = sourceRatio | (sourceRatio << 16u);
+			U8xX targetBytes = reinterpret_U8FromU32(readPixels(targetPixel));
+			// Inverting the bits of a byte subtracts it from 255.
+			U8xX targetRatios = reinterpret_U8FromU32(~sourceRatio);
+			U16xX lower = normalizedByteMultiplication(lowerToU16(targetBytes), lowerToU16(targetRatios));
+			U16xX upper = normalizedByteMultiplication(higherToU16(targetBytes), higherToU16(targetRatios));
+			writePixels(targetPixel, reinterpret_U32FromU8(saturatedAddition(truncateToU8(lower, upper), reinterpret_U8FromU32(source))));
+		}
+		targetPixel += laneCountX_32Bit * 4;
+		sourcePixel += laneCountX_32Bit * 4;
+	}
+	for (; x < width; x++) {
+		premultipliedAlphaFilterPixel(targetPixel, sourcePixel, packOrder, packOrder);
+		targetPixel += 4;
+		sourcePixel += 4;
+	}
+}
+
+static void imageImpl_drawPremultipliedAlphaFilter(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t maxThreadCount) {
+	if (ImageIntersection::canCreate(target, source, left, top)) {
+		PackOrder targetPackOrder = image_getPackOrder(target);
+		PackOrder sourcePackOrder = image_getPackOrder(source);
+		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
+		if (image_getPackOrderIndex(target) == image_getPackOrderIndex(source)) {
+			ITERATE_ROWS(intersection.subTarget, intersection.subSource, maxThreadCount,
+				premultipliedAlphaFilterRow(targetRow, sourceRow, intersection.subSource.width, targetPackOrder)
+			);
+		} else {
+			// Read and repack to convert between different color formats
+			ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
+				premultipliedAlphaFilterPixel(targetPixel, sourcePixel, targetPackOrder, sourcePackOrder)
+			);
+		}
 	}
 }
 
-static void imageImpl_drawMaxAlpha(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t sourceAlphaOffset) {
+// Drawing a row of width pixels using draw_maxAlpha without alpha offset when source and target have the same pack order.
+static void maxAlphaRow(uint8_t *targetPixel, const uint8_t *sourcePixel, int32_t width, const PackOrder &packOrder) {
+	U32xX none = U32xX(0u);
+	U32xX all = U32xX(0xFFFFFFFFu);
+	int32_t x = 0;
+	for (; x + laneCountX_32Bit <= width; x += laneCountX_32Bit) {
+		U32xX source = readPixels(sourcePixel);
+		U32xX target = readPixels(targetPixel);
+		// Subtracting source alpha from target alpha wraps around to set the highest bit when the source alpha is higher.
+		U32xX higher = none - ((packOrder_getAlpha(target, packOrder) - packOrder_getAlpha(source, packOrder)) >> 31u);
+		if (allLanesEqual(higher, all)) {
+			writePixels(targetPixel, source);
+		} else if (!allLanesEqual(higher, none)) {
+			writePixels(targetPixel, (source & higher) | (target & ~higher));
+		}
+		targetPixel += laneCountX_32Bit * 4;
+		sourcePixel += laneCountX_32Bit * 4;
+	}
+	for (; x < width; x++) {
+		if (sourcePixel[packOrder.alphaIndex] > targetPixel[packOrder.alphaIndex]) {
+			std::memcpy(targetPixel, sourcePixel, 4);
+		}
+		targetPixel += 4;
+		sourcePixel += 4;
+	}
+}
+
+static void imageImpl_drawMaxAlpha(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t sourceAlphaOffset, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		PackOrder sourcePackOrder = image_getPackOrder(source);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
 		// Read and repack to convert between different color formats
-		if (sourceAlphaOffset == 0) {
-			ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		if (sourceAlphaOffset == 0 && image_getPackOrderIndex(target) == image_getPackOrderIndex(source)) {
+			ITERATE_ROWS(intersection.subTarget, intersection.subSource, maxThreadCount,
+				maxAlphaRow(targetRow, sourceRow, intersection.subSource.width, targetPackOrder)
+			);
+		} else if (sourceAlphaOffset == 0) {
+			ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 				int32_t sourceAlpha = sourcePixel[sourcePackOrder.alphaIndex];
 				if (sourceAlpha > targetPixel[targetPackOrder.alphaIndex]) {
 					targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
@@ -677,7 +1002,7 @@ static void imageImpl_drawMaxAlpha(const ImageRgbaU8& target, const ImageRgbaU8&
 				}
 			);
 		} else {
-			ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+			ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 				int32_t sourceAlpha = sourcePixel[sourcePackOrder.alphaIndex];
 				if (sourceAlpha > 0) {
 					sourceAlpha += sourceAlphaOffset;
@@ -695,13 +1020,13 @@ static void imageImpl_drawMaxAlpha(const ImageRgbaU8& target, const ImageRgbaU8&
 	}
 }
 
-static void imageImpl_drawAlphaClip(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t threshold) {
+static void imageImpl_drawAlphaClip(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t threshold, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		PackOrder sourcePackOrder = image_getPackOrder(source);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
 		// Read and repack to convert between different color formats
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			if (sourcePixel[sourcePackOrder.alphaIndex] > threshold) {
 				targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
 				targetPixel[targetPackOrder.greenIndex] = sourcePixel[sourcePackOrder.greenIndex];
@@ -713,12 +1038,12 @@ static void imageImpl_drawAlphaClip(const ImageRgbaU8& target, const ImageRgbaU8
 }
 
 template <bool FULL_ALPHA>
-void drawSilhouette_template(const ImageRgbaU8& target, const ImageU8& source, const ColorRgbaI32& color, int32_t left, int32_t top) {
+void drawSilhouette_template(const ImageRgbaU8& target, const ImageU8& source, const ColorRgbaI32& color, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(target, source, left, top)) {
 		PackOrder targetPackOrder = image_getPackOrder(target);
 		ImageIntersection intersection = ImageIntersection::create(target, source, left, top);
 		// Read and repack to convert between different color formats
-		ITERATE_PIXELS(intersection.subTarget, intersection.subSource,
+		ITERATE_PIXELS(intersection.subTarget, intersection.subSource, maxThreadCount,
 			uint32_t sourceRatio;
 			if (FULL_ALPHA) {
 				sourceRatio = *sourcePixel;
@@ -742,21 +1067,21 @@ void drawSilhouette_template(const ImageRgbaU8& target, const ImageU8& source, c
 		);
 	}
 }
-static void imageImpl_drawSilhouette(const ImageRgbaU8& target, const ImageU8& source, const ColorRgbaI32& color, int32_t left, int32_t top) {
+static void imageImpl_drawSilhouette(const ImageRgbaU8& target, const ImageU8& source, const ColorRgbaI32& color, int32_t left, int32_t top, int32_t maxThreadCount) {
 	if (color.alpha > 0) {
 		ColorRgbaI32 saturatedColor = color.saturate();
 		if (color.alpha < 255) {
-			drawSilhouette_template<false>(target, source, saturatedColor, left, top);
+			drawSilhouette_template<false>(target, source, saturatedColor, left, top, maxThreadCount);
 		} else {
-			drawSilhouette_template<true>(target, source, saturatedColor, left, top);
+			drawSilhouette_template<true>(target, source, saturatedColor, left, top, maxThreadCount);
 		}
 	}
 }
 
-static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& sourceHeight, int32_t left, int32_t top, int32_t sourceHeightOffset) {
+static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& sourceHeight, int32_t left, int32_t top, int32_t sourceHeightOffset, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(targetHeight, sourceHeight, left, top)) {
 		ImageIntersection intersectionH = ImageIntersection::create(targetHeight, sourceHeight, left, top);
-		ITERATE_PIXELS(intersectionH.subTarget, intersectionH.subSource,
+		ITERATE_PIXELS(intersectionH.subTarget, intersectionH.subSource, maxThreadCount,
 			int32_t newHeight = *((const uint16_t*)sourcePixel);
 			if (newHeight > 0) {
 				newHeight += sourceHeightOffset;
@@ -770,7 +1095,7 @@ static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& s
 	}
 }
 static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
-  int32_t left, int32_t top, int32_t sourceHeightOffset) {
+  int32_t left, int32_t top, int32_t sourceHeightOffset, int32_t maxThreadCount) {
 	assert(image_getWidth(sourceA) == image_getWidth(sourceHeight));
 	assert(image_getHeight(sourceA) == image_getHeight(sourceHeight));
 	if (ImageIntersection::canCreate(targetHeight, sourceHeight, left, top)) {
@@ -778,7 +1103,7 @@ static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& s
 		PackOrder sourceAPackOrder = image_getPackOrder(sourceA);
 		ImageIntersection intersectionH = ImageIntersection::create(targetHeight, sourceHeight, left, top);
 		ImageIntersection intersectionA = ImageIntersection::create(targetA, sourceA, left, top);
-		ITERATE_PIXELS_2(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource,
+		ITERATE_PIXELS_2(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource, maxThreadCount,
 			int32_t newHeight = *((const uint16_t*)sourcePixel1);
 			if (newHeight > 0) {
 				newHeight += sourceHeightOffset;
@@ -796,7 +1121,7 @@ static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& s
 	}
 }
 static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
-  ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, int32_t sourceHeightOffset) {
+  ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, int32_t sourceHeightOffset, int32_t maxThreadCount) {
 	assert(image_getWidth(sourceA) == image_getWidth(sourceHeight));
 	assert(image_getHeight(sourceA) == image_getHeight(sourceHeight));
 	assert(image_getWidth(sourceB) == image_getWidth(sourceHeight));
@@ -809,7 +1134,7 @@ static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& s
 		ImageIntersection intersectionH = ImageIntersection::create(targetHeight, sourceHeight, left, top);
 		ImageIntersection intersectionA = ImageIntersection::create(targetA, sourceA, left, top);
 		ImageIntersection intersectionB = ImageIntersection::create(targetB, sourceB, left, top);
-		ITERATE_PIXELS_3(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource, intersectionB.subTarget, intersectionB.subSource,
+		ITERATE_PIXELS_3(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource, intersectionB.subTarget, intersectionB.subSource, maxThreadCount,
 			int32_t newHeight = *((const uint16_t*)sourcePixel1);
 			if (newHeight > 0) {
 				newHeight += sourceHeightOffset;
@@ -831,10 +1156,10 @@ static void imageImpl_drawHigher(const ImageU16& targetHeight, const ImageU16& s
 	}
 }
 
-static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& sourceHeight, int32_t left, int32_t top, float sourceHeightOffset) {
+static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& sourceHeight, int32_t left, int32_t top, float sourceHeightOffset, int32_t maxThreadCount) {
 	if (ImageIntersection::canCreate(targetHeight, sourceHeight, left, top)) {
 		ImageIntersection intersectionH = ImageIntersection::create(targetHeight, sourceHeight, left, top);
-		ITERATE_PIXELS(intersectionH.subTarget, intersectionH.subSource,
+		ITERATE_PIXELS(intersectionH.subTarget, intersectionH.subSource, maxThreadCount,
 			float newHeight = *((const float*)sourcePixel);
 			if (newHeight > -DSR_FLOAT_INF) {
 				newHeight += sourceHeightOffset;
@@ -846,7 +1171,7 @@ static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& s
 	}
 }
 static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
-  int32_t left, int32_t top, float sourceHeightOffset) {
+  int32_t left, int32_t top, float sourceHeightOffset, int32_t maxThreadCount) {
 	assert(image_getWidth(sourceA) == image_getWidth(sourceHeight));
 	assert(image_getHeight(sourceA) == image_getHeight(sourceHeight));
 	if (ImageIntersection::canCreate(targetHeight, sourceHeight, left, top)) {
@@ -854,7 +1179,7 @@ static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& s
 		PackOrder sourceAPackOrder = image_getPackOrder(sourceA);
 		ImageIntersection intersectionH = ImageIntersection::create(targetHeight, sourceHeight, left, top);
 		ImageIntersection intersectionA = ImageIntersection::create(targetA, sourceA, left, top);
-		ITERATE_PIXELS_2(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource,
+		ITERATE_PIXELS_2(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource, maxThreadCount,
 			float newHeight = *((const float*)sourcePixel1);
 			if (newHeight > -DSR_FLOAT_INF) {
 				newHeight += sourceHeightOffset;
@@ -870,7 +1195,7 @@ static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& s
 	}
 }
 static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
-  ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, float sourceHeightOffset) {
+  ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, float sourceHeightOffset, int32_t maxThreadCount) {
 	assert(image_getWidth(sourceA) == image_getWidth(sourceHeight));
 	assert(image_getHeight(sourceA) == image_getHeight(sourceHeight));
 	assert(image_getWidth(sourceB) == image_getWidth(sourceHeight));
@@ -883,7 +1208,7 @@ static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& s
 		ImageIntersection intersectionH = ImageIntersection::create(targetHeight, sourceHeight, left, top);
 		ImageIntersection intersectionA = ImageIntersection::create(targetA, sourceA, left, top);
 		ImageIntersection intersectionB = ImageIntersection::create(targetB, sourceB, left, top);
-		ITERATE_PIXELS_3(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource, intersectionB.subTarget, intersectionB.subSource,
+		ITERATE_PIXELS_3(intersectionH.subTarget, intersectionH.subSource, intersectionA.subTarget, intersectionA.subSource, intersectionB.subTarget, intersectionB.subSource, maxThreadCount,
 			float newHeight = *((const float*)sourcePixel1);
 			if (newHeight > -DSR_FLOAT_INF) {
 				newHeight += sourceHeightOffset;
@@ -903,10 +1228,16 @@ static void imageImpl_drawHigher(const ImageF32& targetHeight, const ImageF32& s
 	}
 }
 
+
 #define DRAW_COPY_WRAPPER(TARGET_TYPE, SOURCE_TYPE) \
 	void draw_copy(const TARGET_TYPE& target, const SOURCE_TYPE& source, int32_t left, int32_t top) { \
 		if (image_exists(target) && image_exists(source)) { \
-			imageImpl_drawCopy(target, source, left, top); \
+			imageImpl_drawCopy(target, source, left, top, 0); \
+		} \
+	} \
+	void draw_copy_singleThreaded(const TARGET_TYPE& target, const SOURCE_TYPE& source, int32_t left, int32_t top) { \
+		if (image_exists(target) && image_exists(source)) { \
+			imageImpl_drawCopy(target, source, left, top, 1); \
 		} \
 	}
 DRAW_COPY_WRAPPER(ImageU8, ImageU8);
@@ -918,63 +1249,473 @@ DRAW_COPY_WRAPPER(ImageU16, ImageF32);
 DRAW_COPY_WRAPPER(ImageF32, ImageU8);
 DRAW_COPY_WRAPPER(ImageF32, ImageU16);
 DRAW_COPY_WRAPPER(ImageF32, ImageF32);
+DRAW_COPY_WRAPPER(ImageF32, ImageF16);
+DRAW_COPY_WRAPPER(ImageF16, ImageU8);
+DRAW_COPY_WRAPPER(ImageF16, ImageF32);
+DRAW_COPY_WRAPPER(ImageF16, ImageF16);
+DRAW_COPY_WRAPPER(ImageU8, ImageF16);
 DRAW_COPY_WRAPPER(ImageRgbaU8, ImageU8);
 DRAW_COPY_WRAPPER(ImageRgbaU8, ImageU16);
 DRAW_COPY_WRAPPER(ImageRgbaU8, ImageF32);
+DRAW_COPY_WRAPPER(ImageRgbaU8, ImageF16);
 DRAW_COPY_WRAPPER(ImageRgbaU8, ImageRgbaU8);
 
 void draw_alphaFilter(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
 	if (image_exists(target) && image_exists(source)) {
-		imageImpl_drawAlphaFilter(target, source, left, top);
+		if (image_isPremultiplied(source)) {
+			imageImpl_drawPremultipliedAlphaFilter(target, source, left, top, 0);
+		} else {
+			imageImpl_drawAlphaFilter(target, source, left, top, 0);
+		}
+	}
+}
+void draw_alphaFilter_premultiplied(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
+	if (image_exists(target) && image_exists(source)) {
+		imageImpl_drawPremultipliedAlphaFilter(target, source, left, top, 0);
 	}
 }
 void draw_maxAlpha(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t sourceAlphaOffset) {
 	if (image_exists(target) && image_exists(source)) {
-		imageImpl_drawMaxAlpha(target, source, left, top, sourceAlphaOffset);
+		imageImpl_drawMaxAlpha(target, source, left, top, sourceAlphaOffset, 0);
 	}
 }
 void draw_alphaClip(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t threshold) {
 	if (image_exists(target) && image_exists(source)) {
-		imageImpl_drawAlphaClip(target, source, left, top, threshold);
+		imageImpl_drawAlphaClip(target, source, left, top, threshold, 0);
 	}
 }
 void draw_silhouette(const ImageRgbaU8& target, const ImageU8& source, const ColorRgbaI32& color, int32_t left, int32_t top) {
 	if (image_exists(target) && image_exists(source)) {
-		imageImpl_drawSilhouette(target, source, color, left, top);
+		imageImpl_drawSilhouette(target, source, color, left, top, 0);
 	}
 }
 void draw_higher(const ImageU16& targetHeight, const ImageU16& sourceHeight, int32_t left, int32_t top, int32_t sourceHeightOffset) {
 	if (image_exists(targetHeight) && image_exists(sourceHeight)) {
-		imageImpl_drawHigher(targetHeight, sourceHeight, left, top, sourceHeightOffset);
+		imageImpl_drawHigher(targetHeight, sourceHeight, left, top, sourceHeightOffset, 0);
 	}
 }
 void draw_higher(const ImageU16& targetHeight, const ImageU16& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
   int32_t left, int32_t top, int32_t sourceHeightOffset) {
 	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA)) {
-		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, left, top, sourceHeightOffset);
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, left, top, sourceHeightOffset, 0);
 	}
 }
 void draw_higher(const ImageU16& targetHeight, const ImageU16& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
   ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, int32_t sourceHeightOffset) {
 	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA) && image_exists(targetB) && image_exists(sourceB)) {
-		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, targetB, sourceB, left, top, sourceHeightOffset);
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, targetB, sourceB, left, top, sourceHeightOffset, 0);
 	}
 }
 void draw_higher(const ImageF32& targetHeight, const ImageF32& sourceHeight, int32_t left, int32_t top, float sourceHeightOffset) {
 	if (image_exists(targetHeight) && image_exists(sourceHeight)) {
-		imageImpl_drawHigher(targetHeight, sourceHeight, left, top, sourceHeightOffset);
+		imageImpl_drawHigher(targetHeight, sourceHeight, left, top, sourceHeightOffset, 0);
 	}
 }
 void draw_higher(const ImageF32& targetHeight, const ImageF32& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
   int32_t left, int32_t top, float sourceHeightOffset) {
 	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA)) {
-		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, left, top, sourceHeightOffset);
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, left, top, sourceHeightOffset, 0);
 	}
 }
 void draw_higher(const ImageF32& targetHeight, const ImageF32& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
   ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, float sourceHeightOffset) {
 	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA) && image_exists(targetB) && image_exists(sourceB)) {
-		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, targetB, sourceB, left, top, sourceHeightOffset);
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, targetB, sourceB, left, top, sourceHeightOffset, 0);
+	}
+}
+void draw_alphaFilter_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
+	if (image_exists(target) && image_exists(source)) {
+		if (image_isPremultiplied(source)) {
+			imageImpl_drawPremultipliedAlphaFilter(target, source, left, top, 1);
+		} else {
+			imageImpl_drawAlphaFilter(target, source, left, top, 1);
+		}
+	}
+}
+void draw_alphaFilter_premultiplied_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
+	if (image_exists(target) && image_exists(source)) {
+		imageImpl_drawPremultipliedAlphaFilter(target, source, left, top, 1);
+	}
+}
+void draw_maxAlpha_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t sourceAlphaOffset) {
+	if (image_exists(target) && image_exists(source)) {
+		imageImpl_drawMaxAlpha(target, source, left, top, sourceAlphaOffset, 1);
+	}
+}
+void draw_alphaClip_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left, int32_t top, int32_t threshold) {
+	if (image_exists(target) && image_exists(source)) {
+		imageImpl_drawAlphaClip(target, source, left, top, threshold, 1);
+	}
+}
+void draw_silhouette_singleThreaded(const ImageRgbaU8& target, const ImageU8& source, const ColorRgbaI32& color, int32_t left, int32_t top) {
+	if (image_exists(target) && image_exists(source)) {
+		imageImpl_drawSilhouette(target, source, color, left, top, 1);
+	}
+}
+void draw_higher_singleThreaded(const ImageU16& targetHeight, const ImageU16& sourceHeight, int32_t left, int32_t top, int32_t sourceHeightOffset) {
+	if (image_exists(targetHeight) && image_exists(sourceHeight)) {
+		imageImpl_drawHigher(targetHeight, sourceHeight, left, top, sourceHeightOffset, 1);
+	}
+}
+void draw_higher_singleThreaded(const ImageU16& targetHeight, const ImageU16& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+  int32_t left, int32_t top, int32_t sourceHeightOffset) {
+	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA)) {
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, left, top, sourceHeightOffset, 1);
+	}
+}
+void draw_higher_singleThreaded(const ImageU16& targetHeight, const ImageU16& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+  ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, int32_t sourceHeightOffset) {
+	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA) && image_exists(targetB) && image_exists(sourceB)) {
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, targetB, sourceB, left, top, sourceHeightOffset, 1);
+	}
+}
+void draw_higher_singleThreaded(const ImageF32& targetHeight, const ImageF32& sourceHeight, int32_t left, int32_t top, float sourceHeightOffset) {
+	if (image_exists(targetHeight) && image_exists(sourceHeight)) {
+		imageImpl_drawHigher(targetHeight, sourceHeight, left, top, sourceHeightOffset, 1);
+	}
+}
+void draw_higher_singleThreaded(const ImageF32& targetHeight, const ImageF32& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+  int32_t left, int32_t top, float sourceHeightOffset) {
+	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA)) {
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, left, top, sourceHeightOffset, 1);
+	}
+}
+void draw_higher_singleThreaded(const ImageF32& targetHeight, const ImageF32& sourceHeight, ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+  ImageRgbaU8& targetB, const ImageRgbaU8& sourceB, int32_t left, int32_t top, float sourceHeightOffset) {
+	if (image_exists(targetHeight) && image_exists(sourceHeight) && image_exists(targetA) && image_exists(sourceA) && image_exists(targetB) && image_exists(sourceB)) {
+		imageImpl_drawHigher(targetHeight, sourceHeight, targetA, sourceA, targetB, sourceB, left, top, sourceHeightOffset, 1);
+	}
+}
+
+// -------------------------------- Drawing polygons --------------------------------
+
+// Coordinates further away are clamped, so that converting to row and column indices can not overflow.
+static const float maxPolygonCoordinate = 1000000.0f;
+
+// The accumulated coverage within one pixel touched by edges.
+struct CoverageCell {
+	int32_t x, y;
+	// The sum of signed heights from edges passing through the cell, which is added to the winding of all pixels to the right.
+	float cover;
+	// The part of cover that is to the right of the edges within the cell, which is this pixel's own winding.
+	float area;
+	CoverageCell(int32_t x, int32_t y, float cover, float area) : x(x), y(y), cover(cover), area(area) {}
+};
+
+// Accumulates signed coverage from polygon edges in sparse cells, so that pixels between the cells can be filled as spans.
+//   Edges going down add to the winding and edges going up subtract from it, so that any closed contour sums up to zero on each row.
+struct CoverageAccumulator {
+	int32_t width, height;
+	List<CoverageCell> cells;
+	CoverageAccumulator(int32_t width, int32_t height) : width(width), height(height) {}
+	void addCell(int32_t x, int32_t y, float cover, float area) {
+		// Neighboring pieces of the same edge often land in the same cell.
+		if (this->cells.length() > 0) {
+			CoverageCell &lastCell = this->cells.last();
+			if (lastCell.x == x && lastCell.y == y) {
+				lastCell.cover += cover;
+				lastCell.area += area;
+				return;
+			}
+		}
+		this->cells.pushConstruct(x, y, cover, area);
+	}
+	// Pre-condition: 0 <= xA <= width and 0 <= xB <= width
+	// Side-effect: Adds a piece of an edge within row y, going from xA at the top to xB at the bottom, with cover as its signed height.
+	void addRowFragment(int32_t y, float xA, float xB, float cover) {
+		// Which end is on top does not matter within a row, because each column gets cover in proportion to the width inside of it.
+		if (xA > xB) {
+			float swapped = xA; xA = xB; xB = swapped;
+		}
+		int32_t firstColumn = int32_t(xA);
+		if (firstColumn >= this->width) {
+			// Only pixels outside of the image are to the right of the edge.
+			return;
+		}
+		// An edge ending exactly on the left side of a column does not enter it.
+		int32_t lastColumn = max(firstColumn, int32_t(std::ceil(xB)) - 1);
+		if (firstColumn == lastColumn) {
+			float center = (xA + xB) * 0.5f - float(firstColumn);
+			this->addCell(firstColumn, y, cover, cover * (1.0f - center));
+		} else {
+			float coverPerColumn = cover / (xB - xA);
+			for (int32_t column = firstColumn; column <= lastColumn; column++) {
+				float left = max(xA, float(column));
+				float right = min(xB, float(column + 1));
+				float columnCover = (right - left) * coverPerColumn;
+				float center = (left + right) * 0.5f - float(column);
+				this->addCell(column, y, columnCover, columnCover * (1.0f - center));
+			}
+		}
+	}
+	// Side-effect: Adds the edge from (xA, yA) to (xB, yB).
+	void addEdge(float xA, float yA, float xB, float yB) {
+		// NaN is not equal to itself.
+		if (xA != xA || yA != yA || xB != xB || yB != yB) {
+			return;
+		}
+		xA = clamp(-maxPolygonCoordinate, xA, maxPolygonCoordinate);
+		yA = clamp(-maxPolygonCoordinate, yA, maxPolygonCoordinate);
+		xB = clamp(-maxPolygonCoordinate, xB, maxPolygonCoordinate);
+		yB = clamp(-maxPolygonCoordinate, yB, maxPolygonCoordinate);
+		if (yA == yB) {
+			// Horizontal edges do not change the winding.
+			return;
+		}
+		// Split edges crossing the left or right side, so that the parts outside can be clamped to the side without changing the parts inside.
+		//   Anything left of the image only adds its cover to the first column, and anything to the right of the image can be ignored.
+		float sides[2] = {0.0f, float(this->width)};
+		for (int32_t s = 0; s < 2; s++) {
+			float side = sides[s];
+			if ((xA < side && xB > side) || (xA > side && xB < side)) {
+				float ySide = yA + (yB - yA) * ((side - xA) / (xB - xA));
+				this->addEdge(xA, yA, side, ySide);
+				this->addEdge(side, ySide, xB, yB);
+				return;
+			}
+		}
+		xA = clamp(0.0f, xA, float(this->width));
+		xB = clamp(0.0f, xB, float(this->width));
+		float direction = 1.0f;
+		if (yA > yB) {
+			float swapped;
+			swapped = xA; xA = xB; xB = swapped;
+			swapped = yA; yA = yB; yB = swapped;
+			direction = -1.0f;
+		}
+		if (yB <= 0.0f || yA >= float(this->height)) {
+			return;
+		}
+		float slope = (xB - xA) / (yB - yA);
+		int32_t firstRow = int32_t(std::floor(max(yA, 0.0f)));
+		int32_t lastRow = min(int32_t(std::ceil(min(yB, float(this->height)))), this->height) - 1;
+		for (int32_t row = firstRow; row <= lastRow; row++) {
+			float top = max(yA, float(row));
+			float bottom = min(yB, float(row + 1));
+			if (bottom > top) {
+				float xTop = clamp(0.0f, xA + (top - yA) * slope, float(this->width));
+				float xBottom = clamp(0.0f, xA + (bottom - yA) * slope, float(this->width));
+				this->addRowFragment(row, xTop, xBottom, (bottom - top) * direction);
+			}
+		}
+	}
+	// Side-effect: Adds the edges of a closed polygon going through points.
+	void addContour(const List<FVector2D> &points) {
+		intptr_t pointCount = points.length();
+		if (pointCount >= 3) {
+			for (intptr_t p = 0; p < pointCount; p++) {
+				const FVector2D &from = points[p];
+				const FVector2D &to = points[(p + 1) % pointCount];
+				this->addEdge(from.x, from.y, to.x, to.y);
+			}
+		}
+	}
+	// Side-effect: Calls fillSpan(y, left, right, coverage) for each run of pixels from left to right - 1 on row y with the same coverage from 0.0 to 1.0.
+	//   Spans without any coverage are skipped.
+	template <typename F>
+	void sweep(FillRule fillRule, const F &fillSpan) {
+		intptr_t cellCount = this->cells.length();
+		if (cellCount == 0) {
+			return;
+		}
+		// Visit the cells from left to right on each row.
+		List<int32_t> order;
+		order.reserve(cellCount);
+		for (int32_t c = 0; c < cellCount; c++) {
+			order.push(c);
+		}
+		const List<CoverageCell> &cells = this->cells;
+		std::sort(&(order[0]), &(order[0]) + cellCount, [&cells](int32_t left, int32_t right) {
+			return cells[left].y < cells[right].y || (cells[left].y == cells[right].y && cells[left].x < cells[right].x);
+		});
+		intptr_t o = 0;
+		while (o < cellCount) {
+			int32_t y = cells[order[o]].y;
+			float winding = 0.0f;
+			while (o < cellCount && cells[order[o]].y == y) {
+				int32_t x = cells[order[o]].x;
+				float cover = 0.0f;
+				float area = 0.0f;
+				while (o < cellCount && cells[order[o]].y == y && cells[order[o]].x == x) {
+					cover += cells[order[o]].cover;
+					area += cells[order[o]].area;
+					o++;
+				}
+				float pixelCoverage = coverageFromWinding(winding + area, fillRule);
+				if (pixelCoverage > 0.0f) {
+					fillSpan(y, x, x + 1, pixelCoverage);
+				}
+				winding += cover;
+				int32_t nextX = (o < cellCount && cells[order[o]].y == y) ? cells[order[o]].x : this->width;
+				if (nextX > x + 1) {
+					float spanCoverage = coverageFromWinding(winding, fillRule);
+					if (spanCoverage > 0.0f) {
+						fillSpan(y, x + 1, nextX, spanCoverage);
+					}
+				}
+			}
+		}
+	}
+	static float coverageFromWinding(float winding, FillRule fillRule) {
+		float absolute = winding < 0.0f ? -winding : winding;
+		if (fillRule == FillRule::EvenOdd) {
+			// Fold into a triangle wave going from 0 at even windings to 1 at odd windings.
+			absolute = absolute - 2.0f * std::floor(absolute * 0.5f);
+			return absolute > 1.0f ? 2.0f - absolute : absolute;
+		} else {
+			return absolute > 1.0f ? 1.0f : absolute;
+		}
+	}
+};
+
+// Side-effect: Blends ratio / 255 of color into byteCount bytes at target, as target * (255 - ratio) + color * ratio for each byte.
+//   colorPattern is one pixel's bytes in memory order, which is the same byte repeated four times for ImageU8.
+//   Gives the same result as alphaFilterPixel for RgbaU8 pixels when colorPattern has an opaque alpha channel.
+// Pre-condition: target points to the start of a pixel.
+static void blendSpan(uint8_t *target, intptr_t byteCount, uint32_t colorPattern, uint32_t ratio) {
+	const uint8_t *colorBytes = (const uint8_t*)&colorPattern;
+	const intptr_t vectorSize = laneCountX_32Bit * 4;
+	intptr_t b = 0;
+	if (ratio >= 255) {
+		U32xX colors = U32xX(colorPattern);
+		for (; b + vectorSize <= byteCount; b += vectorSize) {
+			writePixels(target + b, colors);
+		}
+		for (; b < byteCount; b++) {
+			target[b] = colorBytes[b & 3];
+		}
+	} else if (ratio > 0) {
+		U8xX sourceBytes = reinterpret_U8FromU32(U32xX(colorPattern));
+		U16xX targetRatios = U16xX(uint16_t(255 - ratio));
+		// The color's part is the same for every pixel.
+		U16xX lowerSource = normalizedByteMultiplication(lowerToU16(sourceBytes), U16xX(uint16_t(ratio)));
+		U16xX upperSource = normalizedByteMultiplication(higherToU16(sourceBytes), U16xX(uint16_t(ratio)));
+		for (; b + vectorSize <= byteCount; b += vectorSize) {
+			U8xX targetBytes = reinterpret_U8FromU32(readPixels(target + b));
+			U16xX lower = normalizedByteMultiplication(lowerToU16(targetBytes), targetRatios) + lowerSource;
+			U16xX upper = normalizedByteMultiplication(higherToU16(targetBytes), targetRatios) + upperSource;
+			writePixels(target + b, reinterpret_U32FromU8(truncateToU8(lower, upper)));
+		}
+		uint32_t sourceParts[4];
+		for (int32_t i = 0; i < 4; i++) {
+			sourceParts[i] = normalizedByteMultiplication(colorBytes[i], ratio);
+		}
+		for (; b < byteCount; b++) {
+			target[b] = normalizedByteMultiplication(target[b], 255 - ratio) + sourceParts[b & 3];
+		}
+	}
+}
+
+// Side-effect: Blends color into image by the coverage in accumulator, multiplied by alpha from 0 to 255.
+static void fillCoverage(const Image &image, CoverageAccumulator &accumulator, FillRule fillRule, uint32_t colorPattern, uint32_t alpha) {
+	uint8_t *data = buffer_dangerous_getUnsafeData(image.impl_buffer) + image.impl_dimensions.getByteStartOffset();
+	int32_t stride = image_getStride(image);
+	int32_t pixelSize = image.impl_dimensions.getPixelSize();
+	float ratioScale = float(alpha);
+	accumulator.sweep(fillRule, [data, stride, pixelSize, colorPattern, ratioScale](int32_t y, int32_t left, int32_t right, float coverage) {
+		blendSpan(data + intptr_t(y) * stride + left * pixelSize, (right - left) * pixelSize, colorPattern, uint32_t(coverage * ratioScale + 0.5f));
+	});
+}
+
+static void fillCoverage(const ImageU8 &image, CoverageAccumulator &accumulator, FillRule fillRule, int32_t color) {
+	uint32_t luma = uint32_t(clamp(0, color, 255));
+	fillCoverage(image, accumulator, fillRule, luma * 0x01010101u, 255);
+}
+
+static void fillCoverage(const ImageRgbaU8 &image, CoverageAccumulator &accumulator, FillRule fillRule, const ColorRgbaI32 &color) {
+	// The alpha channel is blended towards opaque, like when drawing with draw_alphaFilter.
+	uint32_t packedColor = image_saturateAndPack(image, ColorRgbaI32(color.red, color.green, color.blue, 255));
+	fillCoverage(image, accumulator, fillRule, packedColor, uint32_t(clamp(0, color.alpha, 255)));
+}
+
+// Side-effect: Adds the outline of a line through points with thickness, as one contour per segment and one per point for the round joints.
+//   All contours go in the same direction, so that the non-zero fill rule merges them into one shape.
+static void addPolyline(CoverageAccumulator &accumulator, const List<FVector2D>& points, float thickness, bool closed) {
+	intptr_t pointCount = points.length();
+	float radius = thickness * 0.5f;
+	if (pointCount == 0 || !(radius > 0.0f)) {
+		return;
+	}
+	// Enough corners to keep the polygon within a tenth of a pixel from the circle.
+	int32_t cornerCount = 4;
+	if (radius > 0.1f) {
+		cornerCount = clamp(4, int32_t(std::ceil(3.14159265f / std::acos(1.0f - 0.1f / radius))), 256);
+	}
+	List<FVector2D> circle;
+	circle.reserve(cornerCount);
+	for (int32_t c = 0; c < cornerCount; c++) {
+		// Going in negative angles to have the same direction as the segments.
+		float angle = float(c) * -6.28318531f / float(cornerCount);
+		circle.pushConstruct(std::cos(angle) * radius, std::sin(angle) * radius);
+	}
+	for (intptr_t p = 0; p < pointCount; p++) {
+		const FVector2D &center = points[p];
+		for (int32_t c = 0; c < cornerCount; c++) {
+			FVector2D from = center + circle[c];
+			FVector2D to = center + circle[(c + 1) % cornerCount];
+			accumulator.addEdge(from.x, from.y, to.x, to.y);
+		}
+	}
+	intptr_t segmentCount = closed ? pointCount : pointCount - 1;
+	for (intptr_t s = 0; s < segmentCount; s++) {
+		const FVector2D &start = points[s];
+		const FVector2D &end = points[(s + 1) % pointCount];
+		FVector2D direction = end - start;
+		float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+		if (length > 0.0f) {
+			FVector2D offset = FVector2D(-direction.y, direction.x) * (radius / length);
+			FVector2D corners[4] = {start + offset, end + offset, end - offset, start - offset};
+			for (int32_t c = 0; c < 4; c++) {
+				accumulator.addEdge(corners[c].x, corners[c].y, corners[(c + 1) % 4].x, corners[(c + 1) % 4].y);
+			}
+		}
+	}
+}
+
+void draw_polygon(const ImageU8& image, const List<FVector2D>& points, int32_t color, FillRule fillRule) {
+	if (image_exists(image)) {
+		CoverageAccumulator accumulator(image_getWidth(image), image_getHeight(image));
+		accumulator.addContour(points);
+		fillCoverage(image, accumulator, fillRule, color);
+	}
+}
+void draw_polygon(const ImageRgbaU8& image, const List<FVector2D>& points, const ColorRgbaI32& color, FillRule fillRule) {
+	if (image_exists(image)) {
+		CoverageAccumulator accumulator(image_getWidth(image), image_getHeight(image));
+		accumulator.addContour(points);
+		fillCoverage(image, accumulator, fillRule, color);
+	}
+}
+void draw_polygons(const ImageU8& image, const List<List<FVector2D>>& contours, int32_t color, FillRule fillRule) {
+	if (image_exists(image)) {
+		CoverageAccumulator accumulator(image_getWidth(image), image_getHeight(image));
+		for (intptr_t c = 0; c < contours.length(); c++) {
+			accumulator.addContour(contours[c]);
+		}
+		fillCoverage(image, accumulator, fillRule, color);
+	}
+}
+void draw_polygons(const ImageRgbaU8& image, const List<List<FVector2D>>& contours, const ColorRgbaI32& color, FillRule fillRule) {
+	if (image_exists(image)) {
+		CoverageAccumulator accumulator(image_getWidth(image), image_getHeight(image));
+		for (intptr_t c = 0; c < contours.length(); c++) {
+			accumulator.addContour(contours[c]);
+		}
+		fillCoverage(image, accumulator, fillRule, color);
+	}
+}
+void draw_polyline(const ImageU8& image, const List<FVector2D>& points, float thickness, int32_t color, bool closed) {
+	if (image_exists(image)) {
+		CoverageAccumulator accumulator(image_getWidth(image), image_getHeight(image));
+		addPolyline(accumulator, points, thickness, closed);
+		fillCoverage(image, accumulator, FillRule::NonZero, color);
+	}
+}
+void draw_polyline(const ImageRgbaU8& image, const List<FVector2D>& points, float thickness, const ColorRgbaI32& color, bool closed) {
+	if (image_exists(image)) {
+		CoverageAccumulator accumulator(image_getWidth(image), image_getHeight(image));
+		addPolyline(accumulator, points, thickness, closed);
+		fillCoverage(image, accumulator, FillRule::NonZero, color);
 	}
 }
 
@@ -26,6 +26,8 @@
 #define DFPSR_API_DRAW
 
 #include "../implementation/image/Image.h"
+#include "../math/FVector.h"
+#include "../collection/List.h"
 
 namespace dsr {
 
@@ -68,6 +70,7 @@ namespace dsr {
 	void draw_rectangle(const ImageU8& image, const IRect& bound, int32_t color);
 	void draw_rectangle(const ImageU16& image, const IRect& bound, int32_t color);
 	void draw_rectangle(const ImageF32& image, const IRect& bound, float color);
+	void draw_rectangle(const ImageF16& image, const IRect& bound, float color);
 	void draw_rectangle(const ImageRgbaU8& image, const IRect& bound, const ColorRgbaI32& color);
 	// Draw using a color that has been packed in advance with the same pack order using the image_saturateAndPack function.
 	//   This saves time on saturation and packing when drawing many rectangles of the same color.
@@ -77,11 +80,35 @@ namespace dsr {
 	void draw_line(const ImageU8& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t color);
 	void draw_line(const ImageU16& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t color);
 	void draw_line(const ImageF32& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, float color);
+	void draw_line(const ImageF16& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, float color);
 	void draw_line(const ImageRgbaU8& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const ColorRgbaI32& color);
 	// Draw using a color that has been packed in advance with the same pack order using the image_saturateAndPack function.
 	//   This saves time on saturation and packing when drawing many lines of the same color.
 	void draw_line(const ImageRgbaU8& image, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t packedColor);
 
+// Drawing polygons
+	// Polygons are anti-aliased by how much of each pixel's area is covered, so coordinates are given with sub-pixel precision.
+	//   Pixel (x, y) covers the area from x to x + 1 and from y to y + 1, so that IRect(x, y, w, h) as a polygon covers the same pixels as draw_rectangle.
+	//   Only the cells along the edges are accumulated, and the pixels between them are filled as spans of equal coverage.
+	//   ImageU8 moves towards color by the coverage.
+	//   ImageRgbaU8 is alpha filtered with color's alpha multiplied by the coverage, the same way as draw_alphaFilter.
+	// Which parts of overlapping contours are filled.
+	enum class FillRule {
+		NonZero, // Filled where the contours go more times in one direction than the other, so that all contours are merged if they go in the same direction.
+		EvenOdd  // Filled where an odd number of contours overlap, so that inner contours become holes regardless of direction.
+	};
+	// Fill a polygon going through points and back to the first point.
+	void draw_polygon(const ImageU8& image, const List<FVector2D>& points, int32_t color, FillRule fillRule = FillRule::NonZero);
+	void draw_polygon(const ImageRgbaU8& image, const List<FVector2D>& points, const ColorRgbaI32& color, FillRule fillRule = FillRule::NonZero);
+	// Fill multiple polygons as one shape, so that the fill rule can make holes where contours overlap.
+	void draw_polygons(const ImageU8& image, const List<List<FVector2D>>& contours, int32_t color, FillRule fillRule = FillRule::NonZero);
+	void draw_polygons(const ImageRgbaU8& image, const List<List<FVector2D>>& contours, const ColorRgbaI32& color, FillRule fillRule = FillRule::NonZero);
+	// Draw a line of thickness pixels through points, with round joints and ends.
+	//   If closed is true, the last point is also connected to the first point.
+	//   Overlapping parts of the line are only drawn once, so that semi-transparent lines are not darker where they cross.
+	void draw_polyline(const ImageU8& image, const List<FVector2D>& points, float thickness, int32_t color, bool closed = false);
+	void draw_polyline(const ImageRgbaU8& image, const List<FVector2D>& points, float thickness, const ColorRgbaI32& color, bool closed = false);
+
 // Drawing images
 	// Draw an image to another image
 	//   All image types can draw to their own format
@@ -101,10 +128,25 @@ namespace dsr {
 	void draw_copy(const ImageU16& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
 	void draw_copy(const ImageF32& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
 	void draw_copy(const ImageF32& target, const ImageU16& source, int32_t left = 0, int32_t top = 0);
+	// Half precision floats can be drawn to and from F32 and U8, and to RgbaU8 as gray-scale.
+	//   Conversions between F16 and F32 are vectorized, so that F32 can be used for computations while F16 is used for storage.
+	//   Values from F32 are rounded to the nearest half precision float, and values above 65504 become infinity.
+	void draw_copy(const ImageF16& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageF16& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageF32& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageF16& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageU8& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageRgbaU8& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
 	// Draw one RGBA image to another using alpha filtering
 	//   Target alpha does no affect RGB blending, in case that it contains padding for opaque targets
 	//   If you really want to draw to a transparent layer, this method should not be used
+	//   If source is flagged as premultiplied, draw_alphaFilter_premultiplied is used instead
 	void draw_alphaFilter(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0);
+	// Draw one RGBA image with premultiplied alpha to another, by adding source to target * (1 - source alpha) in each channel
+	//   Takes one multiplication and one saturated addition per channel, without multiplying source by its alpha
+	//   Target alpha becomes the coverage of both layers, so transparent layers can be drawn to and then drawn to other images
+	//   A premultiplied target can receive any number of premultiplied layers and still be drawn as premultiplied
+	void draw_alphaFilter_premultiplied(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0);
 	// Draw one RGBA image to another using the alpha channel as height
 	//   sourceAlphaOffset is added to non-zero heights from source alpha
 	//   Writes each source pixel who's alpha value is greater than the target's
@@ -160,6 +202,64 @@ namespace dsr {
 	// Draw a uniform color using a grayscale silhouette as the alpha channel
 	void draw_silhouette(const ImageRgbaU8& target, const ImageU8& silhouette, const ColorRgbaI32& color, int32_t left = 0, int32_t top = 0);
 
+// Multi-threading
+	// Image drawing splits the intersection's rows across multiple threads when it has at least minimumPixelCount pixels.
+	//   The default threshold is 65536 pixels, which is large enough for the drawing to take longer than starting the jobs.
+	//   Setting the threshold to 0 threads all drawing and setting it to a higher value than any image's pixel count threads none.
+	void draw_setThreadingThreshold(int64_t minimumPixelCount);
+	int64_t draw_getThreadingThreshold();
+	// Single-threaded versions of the image drawing functions above, which always draw on the calling thread.
+	//   Use these when already drawing from within a job, so that jobs are not started from other jobs.
+	//   Gives the same result as the multi-threaded versions.
+	void draw_copy_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU8& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU16& target, const ImageU16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF32& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageRgbaU8& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageRgbaU8& target, const ImageU16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageRgbaU8& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU8& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU8& target, const ImageU16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU16& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU16& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF32& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF32& target, const ImageU16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF16& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF16& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF32& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageF16& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageU8& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy_singleThreaded(const ImageRgbaU8& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	void draw_alphaFilter_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_alphaFilter_premultiplied_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_maxAlpha_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0, int32_t sourceAlphaOffset = 0);
+	void draw_alphaClip_singleThreaded(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0, int32_t threshold = 127);
+	void draw_silhouette_singleThreaded(const ImageRgbaU8& target, const ImageU8& silhouette, const ColorRgbaI32& color, int32_t left = 0, int32_t top = 0);
+	void draw_higher_singleThreaded(const ImageU16& targetHeight, const ImageU16& sourceHeight,
+		int32_t left = 0, int32_t top = 0, int32_t sourceHeightOffset = 0
+	);
+	void draw_higher_singleThreaded(const ImageU16& targetHeight, const ImageU16& sourceHeight,
+		ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+		int32_t left = 0, int32_t top = 0, int32_t sourceHeightOffset = 0
+	);
+	void draw_higher_singleThreaded(const ImageU16& targetHeight, const ImageU16& sourceHeight,
+		ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+		ImageRgbaU8& targetB, const ImageRgbaU8& sourceB,
+		int32_t left = 0, int32_t top = 0, int32_t sourceHeightOffset = 0
+	);
+	void draw_higher_singleThreaded(const ImageF32& targetHeight, const ImageF32& sourceHeight,
+		int32_t left = 0, int32_t top = 0, float sourceHeightOffset = 0
+	);
+	void draw_higher_singleThreaded(const ImageF32& targetHeight, const ImageF32& sourceHeight,
+		ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+		int32_t left = 0, int32_t top = 0, float sourceHeightOffset = 0
+	);
+	void draw_higher_singleThreaded(const ImageF32& targetHeight, const ImageF32& sourceHeight,
+		ImageRgbaU8& targetA, const ImageRgbaU8& sourceA,
+		ImageRgbaU8& targetB, const ImageRgbaU8& sourceB,
+		int32_t left = 0, int32_t top = 0, float sourceHeightOffset = 0
+	);
+
 }
 
 #endif
@@ -33,6 +33,8 @@
 	#include <spawn.h>
 	#include <sys/wait.h>
 	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
 	#include <dirent.h>
 	// The environment flags contain information such as username, language, color settings, which system shell and window manager is used...
 	extern char **environ;
@@ -43,6 +45,7 @@
 #endif
 #include <fstream>
 #include <cstdlib>
+#include <mutex>
 #include "bufferAPI.h"
 #include "../base/virtualStack.h"
 
@@ -63,6 +66,8 @@ constexpr const char32_t* getPathSeparator(PathSyntax pathSyntax) {
 	static const CharacterEncoding nativeEncoding = CharacterEncoding::BOM_UTF16LE;
 	#define FILE_ACCESS_FUNCTION _wfopen
 	#define FILE_ACCESS_SELECTION (write ? L"wb" : L"rb")
+	#define FILE_RANDOM_ACCESS_SELECTION (create ? L"w+b" : L"r+b")
+	#define FILE_SEEK_FUNCTION _fseeki64
 	List<String> file_impl_getInputArguments() {
 		// Get a pointer to static memory with the command
 		LPWSTR cmd = GetCommandLineW();
@@ -80,6 +85,8 @@ constexpr const char32_t* getPathSeparator(PathSyntax pathSyntax) {
 	static const CharacterEncoding nativeEncoding = CharacterEncoding::BOM_UTF8;
 	#define FILE_ACCESS_FUNCTION fopen
 	#define FILE_ACCESS_SELECTION (write ? "wb" : "rb")
+	#define FILE_RANDOM_ACCESS_SELECTION (create ? "w+b" : "r+b")
+	#define FILE_SEEK_FUNCTION fseeko
 	List<String> file_impl_getInputArguments() { return List<String>(); }
 #endif
 
@@ -133,6 +140,74 @@ Buffer file_loadBuffer(const ReadableString& filename, bool mustExist) {
 	}
 }
 
+#ifndef USE_MICROSOFT_WINDOWS
+	// The address range returned to munmap when the buffer is freed.
+	struct MappedFile {
+		void *start;
+		uintptr_t size;
+	};
+	// Post-condition: Returns the mapped file as a buffer, or an empty handle if it could not be mapped.
+	static Buffer mapFile(const ReadableString& filename) {
+		uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+		// The heap header is stored in a page of its own in front of the file, so that the file can start at the beginning of a page.
+		if (heap_getHeaderSize() > pageSize || heap_getHeapAlignment() > pageSize) {
+			return Buffer();
+		}
+		Buffer nameBuffer;
+		int fileDescriptor = open(toNativeString(filename, nameBuffer), O_RDONLY);
+		if (fileDescriptor == -1) {
+			return Buffer();
+		}
+		struct stat fileStatus;
+		if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size <= 0) {
+			close(fileDescriptor);
+			return Buffer();
+		}
+		uintptr_t fileSize = fileStatus.st_size;
+		uintptr_t totalSize = pageSize + fileSize;
+		// Reserve the address range with a private page for the header, and then place the file's pages after the header.
+		uint8_t *reserved = (uint8_t*)mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (reserved == MAP_FAILED) {
+			close(fileDescriptor);
+			return Buffer();
+		}
+		uint8_t *data = reserved + pageSize;
+		// MAP_PRIVATE gives copy-on-write pages, so that writing to the buffer never modifies the file.
+		void *mapped = mmap(data, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileDescriptor, 0);
+		// The mapping keeps a reference to the file after closing the file descriptor.
+		close(fileDescriptor);
+		if (mapped == MAP_FAILED) {
+			munmap(reserved, totalSize);
+			return Buffer();
+		}
+		MappedFile *mappedFile = new MappedFile{reserved, totalSize};
+		UnsafeAllocation allocation = heap_adoptExternalMemory(data, fileSize, HeapDestructor([](void *, void *externalResource) {
+			MappedFile *mappedFile = (MappedFile*)externalResource;
+			munmap(mappedFile->start, mappedFile->size);
+			delete mappedFile;
+		}, mappedFile));
+		// Construction from pointer increases the allocation's use count to 1.
+		#ifdef SAFE_POINTER_CHECKS
+			Buffer result(allocation.data, allocation.header->allocationIdentity);
+		#else
+			Buffer result(allocation.data);
+		#endif
+		return result.setName("Memory mapped file");
+	}
+#endif
+
+Buffer file_mapBuffer(const ReadableString& filename, bool mustExist) {
+	#ifndef USE_MICROSOFT_WINDOWS
+		String modifiedFilename = file_optimizePath(filename, LOCAL_PATH_SYNTAX);
+		Buffer result = mapFile(modifiedFilename);
+		if (buffer_exists(result)) {
+			return result;
+		}
+	#endif
+	// Empty files and systems without memory mapping are loaded the normal way.
+	return file_loadBuffer(filename, mustExist);
+}
+
 bool file_saveBuffer(const ReadableString& filename, Buffer buffer, bool mustWork) {
 	String modifiedFilename = file_optimizePath(filename, LOCAL_PATH_SYNTAX);
 	if (!buffer_exists(buffer)) {
@@ -156,6 +231,60 @@ bool file_saveBuffer(const ReadableString& filename, Buffer buffer, bool mustWor
 	return true;
 }
 
+struct RandomAccessFileImpl {
+	FILE *file;
+	// Seeking and reading or writing must be done together without other threads moving the location in between.
+	std::mutex lock;
+	explicit RandomAccessFileImpl(FILE *file) : file(file) {}
+	~RandomAccessFileImpl() {
+		fclose(this->file);
+	}
+};
+
+RandomAccessFile file_openRandomAccess(const ReadableString& filename, bool create, bool mustWork) {
+	String modifiedFilename = file_optimizePath(filename, LOCAL_PATH_SYNTAX);
+	Buffer buffer;
+	FILE *file = FILE_ACCESS_FUNCTION(toNativeString(modifiedFilename, buffer), FILE_RANDOM_ACCESS_SELECTION);
+	if (file == nullptr) {
+		if (mustWork) {
+			throwError(U"Failed to open ", modifiedFilename, U" for random access.\n");
+		}
+		return RandomAccessFile();
+	}
+	return handle_create<RandomAccessFileImpl>(file).setName("Random access file");
+}
+
+bool file_readAt(const RandomAccessFile &file, int64_t byteOffset, SafePointer<uint8_t> target, intptr_t size) {
+	if (file.isNull() || byteOffset < 0) {
+		return false;
+	} else if (size <= 0) {
+		return true;
+	}
+	std::unique_lock<std::mutex> lock(file->lock);
+	if (FILE_SEEK_FUNCTION(file->file, byteOffset, SEEK_SET) != 0) {
+		return false;
+	}
+	size_t readSize = fread((void*)target.getUnsafe(), 1, size, file->file);
+	// Anything after the end of the file is zero.
+	if (intptr_t(readSize) < size) {
+		safeMemorySet(target + intptr_t(readSize), 0, size - intptr_t(readSize));
+	}
+	return true;
+}
+
+bool file_writeAt(const RandomAccessFile &file, int64_t byteOffset, SafePointer<const uint8_t> source, intptr_t size) {
+	if (file.isNull() || byteOffset < 0) {
+		return false;
+	} else if (size <= 0) {
+		return true;
+	}
+	std::unique_lock<std::mutex> lock(file->lock);
+	if (FILE_SEEK_FUNCTION(file->file, byteOffset, SEEK_SET) != 0) {
+		return false;
+	}
+	return fwrite((const void*)source.getUnsafe(), 1, size, file->file) == size_t(size);
+}
+
 const char32_t* file_separator(PathSyntax pathSyntax) {
 	return getPathSeparator(pathSyntax);
 }
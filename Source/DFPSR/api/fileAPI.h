@@ -54,6 +54,17 @@ namespace dsr {
 	//   If mustExist is false, then failure to load will return an empty handle (returning false for buffer_exists).
 	Buffer file_loadBuffer(const ReadableString& filename, bool mustExist = true);
 
+	// Path-syntax: According to the local computer.
+	// Post-condition:
+	//   Returns the same content as file_loadBuffer, but maps the file's pages into memory instead of reading them when supported by the system.
+	//   Mapping takes the same time no matter how large the file is, because pages are only read from the disk when accessed,
+	//   and pages that are not written to are shared with other processes mapping the same file.
+	//   Writing to the buffer only changes the process' own copy of the page, so the file will not be modified.
+	//   On systems without memory mapping, the file is loaded using file_loadBuffer.
+	//   If mustExist is true, then failure to load will throw an exception.
+	//   If mustExist is false, then failure to load will return an empty handle (returning false for buffer_exists).
+	Buffer file_mapBuffer(const ReadableString& filename, bool mustExist = true);
+
 	// Path-syntax: According to the local computer.
 	// Side-effect: Saves buffer to file_optimizePath(filename) as a binary file.
 	// Pre-condition: buffer exists.
@@ -62,6 +73,32 @@ namespace dsr {
 	// Post-condition: Returns true iff the buffer could be saved as a file.
 	bool file_saveBuffer(const ReadableString& filename, Buffer buffer, bool mustWork = true);
 
+	// A reference counted handle to a file that stays open for reading and writing at any byte offset,
+	//   for files that are too large to be loaded into memory at once.
+	//   Reads and writes are protected by a mutex inside of the file, so that multiple threads can share the handle.
+	//   The file is closed when the last handle is released.
+	struct RandomAccessFileImpl;
+	using RandomAccessFile = Handle<RandomAccessFileImpl>;
+
+	// Path-syntax: According to the local computer.
+	// Post-condition:
+	//   Returns a handle to the file at file_optimizePath(filename), opened for both reading and writing.
+	//   If create is true, any existing file is replaced by an empty file.
+	//   If create is false, the file must already exist.
+	//   If mustWork is true, then failure to open will throw an exception.
+	//   If mustWork is false, then failure to open will return an empty handle.
+	RandomAccessFile file_openRandomAccess(const ReadableString& filename, bool create, bool mustWork = true);
+
+	// Side-effect: Reads size bytes starting at byteOffset in file into target.
+	//   Bytes after the end of the file are read as zeroes, so that files can be extended by only writing the parts that are used.
+	// Post-condition: Returns true iff file exists and the location could be reached.
+	bool file_readAt(const RandomAccessFile &file, int64_t byteOffset, SafePointer<uint8_t> target, intptr_t size);
+
+	// Side-effect: Writes size bytes from source to file, starting at byteOffset.
+	//   Writing after the end of the file extends the file, and any skipped bytes are read as zeroes.
+	// Post-condition: Returns true iff all bytes were written.
+	bool file_writeAt(const RandomAccessFile &file, int64_t byteOffset, SafePointer<const uint8_t> source, intptr_t size);
+
 	// Path-syntax: According to the local computer.
 	// Pre-condition: file_getEntryType(path) == EntryType::SymbolicLink
 	// Post-condition: Returns the destination of a symbolic link as an absolute path.
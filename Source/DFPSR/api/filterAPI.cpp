@@ -30,7 +30,11 @@
 #include "imageAPI.h"
 #include "drawAPI.h"
 #include "../implementation/image/PackOrder.h"
+#include "../implementation/image/PixelVectors.h"
+#include "../implementation/render/shader/shaderTypes.h"
 #include "../base/simd.h"
+#include "../base/threading.h"
+#include <cmath>
 
 namespace dsr {
 
@@ -313,6 +317,193 @@ void resizeToTarget(IMAGE_TYPE& target, const IMAGE_TYPE& source, bool interpola
 	}
 }
 
+// Separable resampling using filter kernels that are widened when downscaling, so that every source pixel contributes to the result.
+
+static float getKernelRadius(Sampler sampler) {
+	if (sampler == Sampler::Lanczos) {
+		return 3.0f;
+	} else if (sampler == Sampler::Triangle) {
+		return 1.0f;
+	} else {
+		return 0.5f;
+	}
+}
+
+// Returns the kernel's weight at the distance x from the center, measured in target pixels.
+static float getKernelWeight(Sampler sampler, float x) {
+	if (sampler == Sampler::Lanczos) {
+		if (x == 0.0f) {
+			return 1.0f;
+		} else if (x <= -3.0f || x >= 3.0f) {
+			return 0.0f;
+		} else {
+			float piX = 3.14159265f * x;
+			return 3.0f * sin(piX) * sin(piX * (1.0f / 3.0f)) / (piX * piX);
+		}
+	} else if (sampler == Sampler::Triangle) {
+		return max(0.0f, 1.0f - std::abs(x));
+	} else {
+		// Half open interval, so that exactly one source pixel is selected when upscaling.
+		return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+	}
+}
+
+// Weights for resampling one axis, computed once for each target row or column.
+struct ResampleWeights {
+	// The number of source pixels read for each target pixel, including zero weights at the sides.
+	int32_t tapCount = 0;
+	// tapCount clamped source indices for each target pixel.
+	List<int32_t> sourceIndices;
+	// tapCount normalized weights for each target pixel.
+	List<float> weights;
+	ResampleWeights(Sampler sampler, int32_t sourceSize, int32_t targetSize) {
+		float scale = float(sourceSize) / float(targetSize);
+		// Downscaling stretches the kernel over multiple source pixels, so that it does not skip any pixels.
+		float kernelScale = max(1.0f, scale);
+		float radius = getKernelRadius(sampler) * kernelScale;
+		this->tapCount = int32_t(std::ceil(radius * 2.0f)) + 1;
+		this->sourceIndices.reserve(targetSize * this->tapCount);
+		this->weights.reserve(targetSize * this->tapCount);
+		for (int32_t t = 0; t < targetSize; t++) {
+			// The target pixel's center in source pixel coordinates, where source pixel centers are at whole integers.
+			float center = (float(t) + 0.5f) * scale - 0.5f;
+			int32_t firstIndex = int32_t(std::floor(center - radius));
+			int64_t firstTap = this->weights.length();
+			float sum = 0.0f;
+			for (int32_t k = 0; k < this->tapCount; k++) {
+				int32_t sourceIndex = firstIndex + k;
+				float weight = getKernelWeight(sampler, (float(sourceIndex) - center) / kernelScale);
+				this->sourceIndices.push(clamp(0, sourceIndex, sourceSize - 1));
+				this->weights.push(weight);
+				sum += weight;
+			}
+			if (sum == 0.0f) {
+				// Fall back on the nearest pixel if the kernel did not cover any source pixel.
+				this->weights[firstTap + clamp(0, int32_t(std::floor(center + 0.5f)) - firstIndex, this->tapCount - 1)] = 1.0f;
+			} else {
+				float normalization = 1.0f / sum;
+				for (int32_t k = 0; k < this->tapCount; k++) {
+					this->weights[firstTap + k] *= normalization;
+				}
+			}
+		}
+	}
+};
+
+static inline F32x4 unpackColor(uint32_t packedColor, const PackOrder &packOrder) {
+	return floatFromU32(U32x4(packOrder_getRed(packedColor, packOrder), packOrder_getGreen(packedColor, packOrder), packOrder_getBlue(packedColor, packOrder), packOrder_getAlpha(packedColor, packOrder)));
+}
+
+// Resample horizontally from source to the channels of temp, which has the same height as source.
+static void resampleRows(const ImageF32 &temp, const ImageRgbaU8 &source, const ResampleWeights &horizontal) {
+	PackOrder packOrder = image_getPackOrder(source);
+	int32_t targetWidth = image_getWidth(temp) / 4;
+	threadedSplit(0, image_getHeight(source), [&temp, &source, &horizontal, packOrder, targetWidth](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<const uint32_t> sourceRow = image_getSafePointer<uint32_t>(source, y);
+			SafePointer<float> targetPixel = image_getSafePointer(temp, y);
+			const int32_t *sourceIndex = &(horizontal.sourceIndices[0]);
+			const float *weight = &(horizontal.weights[0]);
+			for (int32_t x = 0; x < targetWidth; x++) {
+				F32x4 sum = F32x4(0.0f);
+				for (int32_t k = 0; k < horizontal.tapCount; k++) {
+					sum = sum + unpackColor(sourceRow[sourceIndex[k]], packOrder) * weight[k];
+				}
+				sum.writeAligned(targetPixel, "resampleRows @ write sum");
+				sourceIndex += horizontal.tapCount;
+				weight += horizontal.tapCount;
+				targetPixel += 4;
+			}
+		}
+	}, 4);
+}
+// Resample horizontally from source to temp, four target pixels at a time.
+//   The taps of each group of four neighboring target pixels are interleaved once for the whole image, so that each tap is one vector multiplication.
+static void resampleRows(const ImageF32 &temp, const ImageU8 &source, const ResampleWeights &horizontal) {
+	int32_t targetWidth = image_getWidth(temp);
+	int32_t tapCount = horizontal.tapCount;
+	int32_t groupCount = (targetWidth + 3) / 4;
+	List<int32_t> groupIndices;
+	List<float> groupWeights;
+	groupIndices.reserve(groupCount * tapCount * 4);
+	groupWeights.reserve(groupCount * tapCount * 4);
+	for (int32_t g = 0; g < groupCount; g++) {
+		for (int32_t k = 0; k < tapCount; k++) {
+			for (int32_t l = 0; l < 4; l++) {
+				// Lanes beyond the last target pixel repeat it and are written to the padding of temp.
+				int32_t t = min(g * 4 + l, targetWidth - 1);
+				groupIndices.push(horizontal.sourceIndices[t * tapCount + k]);
+				groupWeights.push(horizontal.weights[t * tapCount + k]);
+			}
+		}
+	}
+	threadedSplit(0, image_getHeight(source), [&temp, &source, &groupIndices, &groupWeights, tapCount, groupCount](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<const uint8_t> sourceRow = image_getSafePointer(source, y);
+			SafePointer<float> targetPixel = image_getSafePointer(temp, y);
+			const int32_t *sourceIndex = &(groupIndices[0]);
+			// Heap allocations are aligned for SIMD vectors, so each group of four weights is aligned.
+			const float *weight = &(groupWeights[0]);
+			for (int32_t g = 0; g < groupCount; g++) {
+				F32x4 sum = F32x4(0.0f);
+				for (int32_t k = 0; k < tapCount; k++) {
+					U32x4 values = U32x4(sourceRow[sourceIndex[0]], sourceRow[sourceIndex[1]], sourceRow[sourceIndex[2]], sourceRow[sourceIndex[3]]);
+					sum = sum + floatFromU32(values) * F32x4::readAlignedUnsafe(weight);
+					sourceIndex += 4;
+					weight += 4;
+				}
+				sum.writeAligned(targetPixel, "resampleRows @ write sum");
+				targetPixel += 4;
+			}
+		}
+	}, 4);
+}
+
+// Resample vertically from the channels in temp to target, using SIMD vectors along each row.
+//   The channels are rounded and saturated to bytes, which are written to target in the same order as stored in temp.
+//   For RGBA images, red, green, blue and alpha are stored in each group of four floats and packed into target's pack order.
+//   byteIndices converts from channel index to byte index in the target pixel, with one element per channel.
+template <typename IMAGE_TYPE>
+static void resampleColumns(const IMAGE_TYPE &target, const ImageF32 &temp, const ResampleWeights &vertical, const int32_t *byteIndices) {
+	int32_t channelCount = image_getPixelSize(target);
+	int32_t valueCount = image_getWidth(temp);
+	threadedSplit(0, image_getHeight(target), [&target, &temp, &vertical, channelCount, valueCount, byteIndices](int32_t startIndex, int32_t stopIndex) {
+		F32xX lowest = F32xX(0.0f);
+		F32xX highest = F32xX(255.0f);
+		F32xX half = F32xX(0.5f);
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<uint8_t> targetRow = image_getSafePointer<uint8_t>(target, y);
+			int64_t firstTap = int64_t(y) * vertical.tapCount;
+			// Temp is aligned with padding, so whole SIMD vectors can be read beyond the last value on each row.
+			for (int32_t v = 0; v < valueCount; v += laneCountX_32Bit) {
+				F32xX sum = F32xX(0.0f);
+				for (int32_t k = 0; k < vertical.tapCount; k++) {
+					SafePointer<const float> sourceValues = image_getSafePointer(temp, vertical.sourceIndices[firstTap + k]) + v;
+					sum = sum + F32xX::readAligned(sourceValues, "resampleColumns @ read sourceValues") * vertical.weights[firstTap + k];
+				}
+				// Round to the closest value within 0..255.
+				ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint32_t rounded[laneCountX_32Bit];
+				truncateToU32(min(max(sum, lowest), highest) + half).writeAlignedUnsafe(rounded);
+				int32_t laneCount = min(laneCountX_32Bit, valueCount - v);
+				for (int32_t l = 0; l < laneCount; l++) {
+					int32_t channelIndex = v + l;
+					targetRow[(channelIndex - (channelIndex % channelCount)) + byteIndices[channelIndex % channelCount]] = rounded[l];
+				}
+			}
+		}
+	}, 4);
+}
+
+// Resampling first horizontally from source to temp and then vertically from temp to target.
+template <typename IMAGE_TYPE>
+static void resampleSeparable(const IMAGE_TYPE &target, const IMAGE_TYPE &source, Sampler sampler, const int32_t *byteIndices) {
+	ResampleWeights horizontal = ResampleWeights(sampler, image_getWidth(source), image_getWidth(target));
+	ResampleWeights vertical = ResampleWeights(sampler, image_getHeight(source), image_getHeight(target));
+	AlignedImageF32 temp = image_create_F32(image_getWidth(target) * image_getPixelSize(target), image_getHeight(source), false);
+	resampleRows(temp, source, horizontal);
+	resampleColumns(target, temp, vertical, byteIndices);
+}
+
 template <bool CONVERT_COLOR>
 static inline uint32_t convertRead(const ImageRgbaU8& target, const ImageRgbaU8& source, int32_t x, int32_t y) {
 	uint32_t result = image_readPixel_clamp_packed(source, x, y);
@@ -845,6 +1036,89 @@ AlignedImageF32 filter_generateF32(int32_t width, int32_t height, const ImageGen
 	return result;
 }
 
+// Calls writeRow for every row of target, using multiple threads.
+//   Rows are assigned to threads in groups with at least 4096 pixels, so that a thread is not started for a tiny amount of work.
+template <typename IMAGE_TYPE, typename PIXEL_TYPE>
+static void mapRows_simd(const IMAGE_TYPE& target, int32_t startX, int32_t startY, const TemporaryCallback<void(PIXEL_TYPE *targetPixels, const F32x8 &x, const F32x8 &y)> &writeVector) {
+	const int32_t targetWidth = image_getWidth(target);
+	threadedSplit(0, image_getHeight(target), [&target, &writeVector, targetWidth, startX, startY](int32_t startIndex, int32_t stopIndex) {
+		// Writing to a temporary array first, so that the last vector can not write to the next row belonging to another thread.
+		ALIGN32 PIXEL_TYPE lanes[8];
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<PIXEL_TYPE> targetPixel = image_getSafePointer<PIXEL_TYPE>(target, y);
+			F32x8 vectorY = F32x8(float(y + startY));
+			for (int32_t x = 0; x < targetWidth; x += 8) {
+				writeVector(lanes, F32x8::createGradient(float(x + startX), 1.0f), vectorY);
+				int32_t laneCount = min(8, targetWidth - x);
+				for (int32_t l = 0; l < laneCount; l++) {
+					targetPixel[l] = lanes[l];
+				}
+				targetPixel += 8;
+			}
+		}
+	}, max(1, 4096 / max(1, targetWidth)));
+}
+
+void filter_mapRgbaU8_simd(const ImageRgbaU8 &target, const ImageGenRgbaF32x8& lambda, int32_t startX, int32_t startY) {
+	if (image_exists(target)) {
+		PackOrder packOrder = image_getPackOrder(target);
+		mapRows_simd<ImageRgbaU8, uint32_t>(target, startX, startY, [&lambda, &packOrder](uint32_t *targetPixels, const F32x8 &x, const F32x8 &y) {
+			Rgba_F32x8 color = lambda(x, y);
+			F32x8 lowest = F32x8(0.0f);
+			F32x8 highest = F32x8(255.0f);
+			Rgba_F32x8 saturated = Rgba_F32x8(clamp(lowest, color.red, highest), clamp(lowest, color.green, highest), clamp(lowest, color.blue, highest), clamp(lowest, color.alpha, highest));
+			saturated.toSaturatedByte(packOrder).writeAlignedUnsafe(targetPixels);
+		});
+	}
+}
+OrderedImageRgbaU8 filter_generateRgbaU8_simd(int32_t width, int32_t height, const ImageGenRgbaF32x8& lambda, int32_t startX, int32_t startY) {
+	OrderedImageRgbaU8 result = image_create_RgbaU8(width, height, false);
+	filter_mapRgbaU8_simd(result, lambda, startX, startY);
+	return result;
+}
+template <typename IMAGE_TYPE, typename PIXEL_TYPE, int32_t MAX_VALUE>
+static void mapMonochrome_simd(const IMAGE_TYPE& target, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	mapRows_simd<IMAGE_TYPE, PIXEL_TYPE>(target, startX, startY, [&lambda](PIXEL_TYPE *targetPixels, const F32x8 &x, const F32x8 &y) {
+		ALIGN32 uint32_t values[8];
+		truncateToU32(clamp(F32x8(0.0f), lambda(x, y), F32x8(float(MAX_VALUE)))).writeAlignedUnsafe(values);
+		for (int32_t l = 0; l < 8; l++) {
+			targetPixels[l] = PIXEL_TYPE(values[l]);
+		}
+	});
+}
+void filter_mapU8_simd(const ImageU8 &target, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	if (image_exists(target)) {
+		mapMonochrome_simd<ImageU8, uint8_t, 255>(target, lambda, startX, startY);
+	}
+}
+AlignedImageU8 filter_generateU8_simd(int32_t width, int32_t height, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	AlignedImageU8 result = image_create_U8(width, height, false);
+	filter_mapU8_simd(result, lambda, startX, startY);
+	return result;
+}
+void filter_mapU16_simd(const ImageU16 &target, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	if (image_exists(target)) {
+		mapMonochrome_simd<ImageU16, uint16_t, 65535>(target, lambda, startX, startY);
+	}
+}
+AlignedImageU16 filter_generateU16_simd(int32_t width, int32_t height, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	AlignedImageU16 result = image_create_U16(width, height, false);
+	filter_mapU16_simd(result, lambda, startX, startY);
+	return result;
+}
+void filter_mapF32_simd(const ImageF32 &target, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	if (image_exists(target)) {
+		mapRows_simd<ImageF32, float>(target, startX, startY, [&lambda](float *targetPixels, const F32x8 &x, const F32x8 &y) {
+			lambda(x, y).writeAlignedUnsafe(targetPixels);
+		});
+	}
+}
+AlignedImageF32 filter_generateF32_simd(int32_t width, int32_t height, const ImageGenF32x8& lambda, int32_t startX, int32_t startY) {
+	AlignedImageF32 result = image_create_F32(width, height, false);
+	filter_mapF32_simd(result, lambda, startX, startY);
+	return result;
+}
+
 
 // -------------------------------- Resize --------------------------------
 
@@ -852,7 +1126,15 @@ AlignedImageF32 filter_generateF32(int32_t width, int32_t height, const ImageGen
 OrderedImageRgbaU8 filter_resize(const ImageRgbaU8 &source, Sampler interpolation, int32_t newWidth, int32_t newHeight) {
 	if (image_exists(source)) {
 		OrderedImageRgbaU8 resultImage = image_create_RgbaU8(newWidth, newHeight, false);
-		resizeToTarget<ImageRgbaU8>(resultImage, source, interpolation == Sampler::Linear);
+		if (interpolation == Sampler::Nearest || interpolation == Sampler::Linear) {
+			resizeToTarget<ImageRgbaU8>(resultImage, source, interpolation == Sampler::Linear);
+		} else {
+			PackOrder packOrder = image_getPackOrder(resultImage);
+			int32_t byteIndices[4] = {packOrder.redIndex, packOrder.greenIndex, packOrder.blueIndex, packOrder.alphaIndex};
+			resampleSeparable<ImageRgbaU8>(resultImage, source, interpolation, byteIndices);
+		}
+		// Resampling keeps the meaning of the color channels.
+		resultImage.impl_dimensions.setPremultiplied(image_isPremultiplied(source));
 		return resultImage;
 	} else {
 		return OrderedImageRgbaU8(); // Null gives null
@@ -862,7 +1144,12 @@ OrderedImageRgbaU8 filter_resize(const ImageRgbaU8 &source, Sampler interpolatio
 AlignedImageU8 filter_resize(const ImageU8 &source, Sampler interpolation, int32_t newWidth, int32_t newHeight) {
 	if (image_exists(source)) {
 		AlignedImageU8 resultImage = image_create_U8(newWidth, newHeight, false);
-		resizeToTarget<ImageU8>(resultImage, source, interpolation == Sampler::Linear);
+		if (interpolation == Sampler::Nearest || interpolation == Sampler::Linear) {
+			resizeToTarget<ImageU8>(resultImage, source, interpolation == Sampler::Linear);
+		} else {
+			int32_t byteIndices[1] = {0};
+			resampleSeparable<ImageU8>(resultImage, source, interpolation, byteIndices);
+		}
 		return resultImage;
 	} else {
 		return AlignedImageU8(); // Null gives null
@@ -875,4 +1162,515 @@ void filter_blockMagnify(const ImageRgbaU8 &target, const ImageRgbaU8& source, i
 	}
 }
 
+
+// -------------------------------- Blur --------------------------------
+
+
+// Copies the channels of source into a float image with one value per channel, in the source's pack order.
+template <typename IMAGE_TYPE, typename ELEMENT_TYPE>
+static AlignedImageF32 blurToValues(const IMAGE_TYPE &source) {
+	int32_t valueCount = image_getWidth(source) * image_getPixelSize(source) / int32_t(sizeof(ELEMENT_TYPE));
+	AlignedImageF32 result = image_create_F32(valueCount, image_getHeight(source), false);
+	threadedSplit(0, image_getHeight(source), [&result, &source, valueCount](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<const ELEMENT_TYPE> sourceRow = image_getSafePointer<ELEMENT_TYPE>(source, y);
+			SafePointer<float> targetRow = image_getSafePointer(result, y);
+			for (int32_t v = 0; v < valueCount; v++) {
+				targetRow[v] = float(sourceRow[v]);
+			}
+		}
+	}, max(1, 16384 / valueCount));
+	return result;
+}
+// Half precision floats are converted using SIMD when drawn to a float image.
+static AlignedImageF32 blurToValues(const ImageF16 &source) {
+	AlignedImageF32 result = image_create_F32(image_getWidth(source), image_getHeight(source), false);
+	draw_copy(result, source);
+	return result;
+}
+
+// Writes the values back to a byte image with rounding and saturation.
+template <typename IMAGE_TYPE>
+static void blurFromValues(const IMAGE_TYPE &target, const ImageF32 &values) {
+	int32_t valueCount = image_getWidth(values);
+	threadedSplit(0, image_getHeight(target), [&target, &values, valueCount](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<const float> sourceRow = image_getSafePointer(values, y);
+			SafePointer<uint8_t> targetRow = image_getSafePointer<uint8_t>(target, y);
+			for (int32_t v = 0; v < valueCount; v++) {
+				targetRow[v] = uint8_t(clamp(0, int32_t(sourceRow[v] + 0.5f), 255));
+			}
+		}
+	}, max(1, 16384 / valueCount));
+}
+
+// Averages 2 * radius + 1 values along each row, where channelCount values are interleaved for each pixel.
+//   A sum is slid along the row, so that the cost per value does not depend on the radius.
+//   The sum is accumulated using double precision, so that long rows do not drift from repeatedly adding and subtracting.
+//   Pixels outside of the row are taken from the closest edge, so the edges are multiplied by the number of outside pixels instead of being added one at a time.
+//   Indices are calculated using 64-bit integers, so that any non-negative 32-bit radius can be used.
+static void blurRows(const ImageF32 &target, const ImageF32 &source, int32_t channelCount, int32_t radius) {
+	int32_t pixelCount = image_getWidth(source) / channelCount;
+	threadedSplit(0, image_getHeight(source), [&target, &source, channelCount, radius, pixelCount](int32_t startIndex, int32_t stopIndex) {
+		double scale = 1.0 / (double(radius) * 2.0 + 1.0);
+		int64_t lastPixel = pixelCount - 1;
+		// The number of pixels outside of the right side at the start.
+		int64_t outsideRight = max(int64_t(0), int64_t(radius) - lastPixel);
+		int64_t insideRight = min(int64_t(radius), lastPixel);
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<const float> sourceRow = image_getSafePointer(source, y);
+			SafePointer<float> targetRow = image_getSafePointer(target, y);
+			for (int32_t c = 0; c < channelCount; c++) {
+				double sum = double(radius) * sourceRow[c] + double(outsideRight) * sourceRow[lastPixel * channelCount + c];
+				for (int64_t x = 0; x <= insideRight; x++) {
+					sum += sourceRow[x * channelCount + c];
+				}
+				for (int64_t x = 0; x < pixelCount; x++) {
+					targetRow[x * channelCount + c] = float(sum * scale);
+					sum += sourceRow[min(x + radius + 1, lastPixel) * channelCount + c];
+					sum -= sourceRow[max(x - radius, int64_t(0)) * channelCount + c];
+				}
+			}
+		}
+	}, max(1, 16384 / image_getWidth(source)));
+}
+
+// Adds value to sum using Kahan summation, where compensation keeps the low bits that were lost in the previous addition.
+static inline void compensatedAddition(F32xX &sum, F32xX &compensation, const F32xX &value) {
+	F32xX correctedValue = value - compensation;
+	F32xX newSum = sum + correctedValue;
+	compensation = (newSum - sum) - correctedValue;
+	sum = newSum;
+}
+
+// Averages 2 * radius + 1 values along each column, using SIMD vectors of neighboring columns.
+//   Source and target are aligned with padding, so whole SIMD vectors can be read and written beyond the last value on each row.
+//   There are no double precision SIMD vectors, so the float sum is instead compensated for rounding errors, to not drift along tall columns.
+//   Rows outside of the image are taken from the closest edge, which is multiplied by the number of outside rows like in blurRows.
+static void blurColumns(const ImageF32 &target, const ImageF32 &source, int32_t radius) {
+	int32_t valueCount = image_getWidth(source);
+	int32_t height = image_getHeight(source);
+	int32_t vectorCount = (valueCount + laneCountX_32Bit - 1) / laneCountX_32Bit;
+	threadedSplit(0, vectorCount, [&target, &source, radius, height](int32_t startIndex, int32_t stopIndex) {
+		F32xX scale = F32xX(float(1.0 / (double(radius) * 2.0 + 1.0)));
+		int64_t lastRow = height - 1;
+		// The number of rows outside of the bottom at the start.
+		int64_t outsideBottom = max(int64_t(0), int64_t(radius) - lastRow);
+		int64_t insideBottom = min(int64_t(radius), lastRow);
+		for (int32_t vectorIndex = startIndex; vectorIndex < stopIndex; vectorIndex++) {
+			int32_t v = vectorIndex * laneCountX_32Bit;
+			F32xX sum = F32xX(0.0f);
+			F32xX compensation = F32xX(0.0f);
+			compensatedAddition(sum, compensation, F32xX::readAligned(image_getSafePointer(source, 0) + v, "blurColumns @ read top edge") * float(radius));
+			compensatedAddition(sum, compensation, F32xX::readAligned(image_getSafePointer(source, lastRow) + v, "blurColumns @ read bottom edge") * float(outsideBottom));
+			for (int64_t y = 0; y <= insideBottom; y++) {
+				compensatedAddition(sum, compensation, F32xX::readAligned(image_getSafePointer(source, y) + v, "blurColumns @ read initial sum"));
+			}
+			for (int64_t y = 0; y < height; y++) {
+				(sum * scale).writeAligned(image_getSafePointer(target, y) + v, "blurColumns @ write target");
+				F32xX added = F32xX::readAligned(image_getSafePointer(source, min(y + radius + 1, lastRow)) + v, "blurColumns @ read added row");
+				F32xX removed = F32xX::readAligned(image_getSafePointer(source, max(y - radius, int64_t(0))) + v, "blurColumns @ read removed row");
+				compensatedAddition(sum, compensation, added - removed);
+			}
+		}
+	}, max(1, 1024 / height));
+}
+
+// Applies a box blur for each radius in radii to values, with channelCount values per pixel.
+//   Returns the image containing the result, which is either values or temp.
+static AlignedImageF32 blurValues(AlignedImageF32 values, int32_t channelCount, const int32_t *radii, int32_t passCount) {
+	AlignedImageF32 temp = image_create_F32(image_getWidth(values), image_getHeight(values), false);
+	for (int32_t p = 0; p < passCount; p++) {
+		if (radii[p] > 0) {
+			blurRows(temp, values, channelCount, radii[p]);
+			blurColumns(values, temp, radii[p]);
+		}
+	}
+	return values;
+}
+
+// Calculates the radii of three box blurs approximating a Gaussian blur with the given standard deviation.
+//   The sizes are chosen so that the variance of the box blurs added together is as close as possible to the variance of the Gaussian blur.
+static void getGaussianRadii(float standardDeviation, int32_t radii[3]) {
+	const int32_t passCount = 3;
+	double variance = double(standardDeviation) * double(standardDeviation);
+	// The ideal box size if all passes had the same odd size.
+	double idealSize = sqrt(12.0 * variance / passCount + 1.0);
+	int32_t smallSize = int32_t(floor(idealSize));
+	if (smallSize % 2 == 0) {
+		smallSize--;
+	}
+	int32_t largeSize = smallSize + 2;
+	// How many passes should use the smaller size for the variances to add up.
+	double idealSmallCount = (12.0 * variance - passCount * smallSize * smallSize - 4.0 * passCount * smallSize - 3.0 * passCount) / (-4.0 * smallSize - 4.0);
+	int32_t smallCount = int32_t(round(idealSmallCount));
+	for (int32_t p = 0; p < passCount; p++) {
+		radii[p] = ((p < smallCount ? smallSize : largeSize) - 1) / 2;
+	}
+}
+
+// Post-condition: Returns true iff the radius is valid.
+static bool checkRadius(int32_t radius, const char32_t *methodName) {
+	if (radius < 0) {
+		throwError(methodName, U" got the negative radius ", radius, U"!\n");
+		return false;
+	} else {
+		return true;
+	}
+}
+
+static void checkDeviation(float standardDeviation, const char32_t *methodName) {
+	if (!(standardDeviation >= 0.0f)) {
+		throwError(methodName, U" got the invalid standard deviation ", standardDeviation, U"!\n");
+	}
+}
+
+AlignedImageU8 filter_boxBlur(const ImageU8 &source, int32_t radius) {
+	checkRadius(radius, U"filter_boxBlur");
+	if (!image_exists(source)) {
+		return AlignedImageU8(); // Null gives null
+	}
+	AlignedImageU8 result = image_create_U8(image_getWidth(source), image_getHeight(source), false);
+	blurFromValues(result, blurValues(blurToValues<ImageU8, uint8_t>(source), 1, &radius, 1));
+	return result;
+}
+
+AlignedImageF32 filter_boxBlur(const ImageF32 &source, int32_t radius) {
+	checkRadius(radius, U"filter_boxBlur");
+	if (!image_exists(source)) {
+		return AlignedImageF32(); // Null gives null
+	}
+	return blurValues(blurToValues<ImageF32, float>(source), 1, &radius, 1);
+}
+
+AlignedImageF16 filter_boxBlur(const ImageF16 &source, int32_t radius) {
+	checkRadius(radius, U"filter_boxBlur");
+	if (!image_exists(source)) {
+		return AlignedImageF16(); // Null gives null
+	}
+	AlignedImageF16 result = image_create_F16(image_getWidth(source), image_getHeight(source), false);
+	// Rounded back to half precision using SIMD.
+	draw_copy(result, blurValues(blurToValues(source), 1, &radius, 1));
+	return result;
+}
+
+AlignedImageRgbaU8 filter_boxBlur(const ImageRgbaU8 &source, int32_t radius) {
+	checkRadius(radius, U"filter_boxBlur");
+	if (!image_exists(source)) {
+		return AlignedImageRgbaU8(); // Null gives null
+	}
+	AlignedImageRgbaU8 result = image_create_RgbaU8_native(image_getWidth(source), image_getHeight(source), image_getPackOrderIndex(source), false);
+	blurFromValues(result, blurValues(blurToValues<ImageRgbaU8, uint8_t>(source), 4, &radius, 1));
+	result.impl_dimensions.setPremultiplied(image_isPremultiplied(source));
+	return result;
+}
+
+AlignedImageU8 filter_gaussianBlur(const ImageU8 &source, float standardDeviation) {
+	checkDeviation(standardDeviation, U"filter_gaussianBlur");
+	if (!image_exists(source)) {
+		return AlignedImageU8(); // Null gives null
+	}
+	int32_t radii[3];
+	getGaussianRadii(standardDeviation, radii);
+	AlignedImageU8 result = image_create_U8(image_getWidth(source), image_getHeight(source), false);
+	blurFromValues(result, blurValues(blurToValues<ImageU8, uint8_t>(source), 1, radii, 3));
+	return result;
+}
+
+AlignedImageF32 filter_gaussianBlur(const ImageF32 &source, float standardDeviation) {
+	checkDeviation(standardDeviation, U"filter_gaussianBlur");
+	if (!image_exists(source)) {
+		return AlignedImageF32(); // Null gives null
+	}
+	int32_t radii[3];
+	getGaussianRadii(standardDeviation, radii);
+	return blurValues(blurToValues<ImageF32, float>(source), 1, radii, 3);
+}
+
+AlignedImageF16 filter_gaussianBlur(const ImageF16 &source, float standardDeviation) {
+	checkDeviation(standardDeviation, U"filter_gaussianBlur");
+	if (!image_exists(source)) {
+		return AlignedImageF16(); // Null gives null
+	}
+	int32_t radii[3];
+	getGaussianRadii(standardDeviation, radii);
+	AlignedImageF16 result = image_create_F16(image_getWidth(source), image_getHeight(source), false);
+	// Rounded back to half precision using SIMD.
+	draw_copy(result, blurValues(blurToValues(source), 1, radii, 3));
+	return result;
+}
+
+AlignedImageRgbaU8 filter_gaussianBlur(const ImageRgbaU8 &source, float standardDeviation) {
+	checkDeviation(standardDeviation, U"filter_gaussianBlur");
+	if (!image_exists(source)) {
+		return AlignedImageRgbaU8(); // Null gives null
+	}
+	int32_t radii[3];
+	getGaussianRadii(standardDeviation, radii);
+	AlignedImageRgbaU8 result = image_create_RgbaU8_native(image_getWidth(source), image_getHeight(source), image_getPackOrderIndex(source), false);
+	blurFromValues(result, blurValues(blurToValues<ImageRgbaU8, uint8_t>(source), 4, radii, 3));
+	result.impl_dimensions.setPremultiplied(image_isPremultiplied(source));
+	return result;
+}
+
+// -------------------------------- Premultiplied alpha --------------------------------
+
+AlignedImageRgbaU8 filter_premultiplyAlpha(const ImageRgbaU8 &source) {
+	if (!image_exists(source)) {
+		return AlignedImageRgbaU8(); // Null gives null
+	}
+	int32_t width = image_getWidth(source);
+	AlignedImageRgbaU8 result = image_create_RgbaU8_native(width, image_getHeight(source), image_getPackOrderIndex(source), false);
+	if (image_isPremultiplied(source)) {
+		draw_copy(result, source);
+	} else {
+		PackOrder packOrder = image_getPackOrder(source);
+		threadedSplit(0, image_getHeight(source), [&result, &source, &packOrder, width](int32_t startIndex, int32_t stopIndex) {
+			U32xX alphaMask = U32xX(packOrder.alphaMask);
+			for (int32_t y = startIndex; y < stopIndex; y++) {
+				SafePointer<const uint32_t> sourcePixel = image_getSafePointer<uint32_t>(source, y);
+				SafePointer<uint32_t> targetPixel = image_getSafePointer<uint32_t>(result, y);
+				for (int32_t x = 0; x < width; x += laneCountX_32Bit) {
+					int32_t laneCount = min(laneCountX_32Bit, width - x);
+					U32xX pixels = readPixels(sourcePixel, laneCount);
+					// Repeat alpha in each byte of the pixel, with 255 for the alpha channel so that alpha stays the same.
+					U32xX ratio = packOrder_getAlpha(pixels, packOrder);
+					ratio = ratio | (ratio << 8u);
+					ratio = ratio | (ratio << 16u);
+					U8xX ratios = reinterpret_U8FromU32(ratio | alphaMask);
+					U8xX bytes = reinterpret_U8FromU32(pixels);
+					U16xX lower = normalizedByteMultiplication(lowerToU16(bytes), lowerToU16(ratios));
+					U16xX upper = normalizedByteMultiplication(higherToU16(bytes), higherToU16(ratios));
+					writePixels(targetPixel, reinterpret_U32FromU8(truncateToU8(lower, upper)), laneCount);
+					sourcePixel += laneCountX_32Bit;
+					targetPixel += laneCountX_32Bit;
+				}
+			}
+		}, max(1, 16384 / width));
+	}
+	result.impl_dimensions.setPremultiplied(true);
+	return result;
+}
+
+AlignedImageRgbaU8 filter_straightenAlpha(const ImageRgbaU8 &source) {
+	if (!image_exists(source)) {
+		return AlignedImageRgbaU8(); // Null gives null
+	}
+	int32_t width = image_getWidth(source);
+	AlignedImageRgbaU8 result = image_create_RgbaU8_native(width, image_getHeight(source), image_getPackOrderIndex(source), false);
+	if (!image_isPremultiplied(source)) {
+		draw_copy(result, source);
+	} else {
+		PackOrder packOrder = image_getPackOrder(source);
+		threadedSplit(0, image_getHeight(source), [&result, &source, &packOrder, width](int32_t startIndex, int32_t stopIndex) {
+			for (int32_t y = startIndex; y < stopIndex; y++) {
+				SafePointer<const uint8_t> sourcePixel = image_getSafePointer<uint8_t>(source, y);
+				SafePointer<uint8_t> targetPixel = image_getSafePointer<uint8_t>(result, y);
+				for (int32_t x = 0; x < width; x++) {
+					uint32_t alpha = sourcePixel[packOrder.alphaIndex];
+					if (alpha == 0) {
+						// The color of invisible pixels is lost when premultiplying, so black is used.
+						targetPixel[packOrder.redIndex] = 0;
+						targetPixel[packOrder.greenIndex] = 0;
+						targetPixel[packOrder.blueIndex] = 0;
+					} else {
+						uint32_t half = alpha / 2;
+						targetPixel[packOrder.redIndex]   = min(255u, (sourcePixel[packOrder.redIndex]   * 255u + half) / alpha);
+						targetPixel[packOrder.greenIndex] = min(255u, (sourcePixel[packOrder.greenIndex] * 255u + half) / alpha);
+						targetPixel[packOrder.blueIndex]  = min(255u, (sourcePixel[packOrder.blueIndex]  * 255u + half) / alpha);
+					}
+					targetPixel[packOrder.alphaIndex] = alpha;
+					sourcePixel += 4;
+					targetPixel += 4;
+				}
+			}
+		}, max(1, 16384 / width));
+	}
+	return result;
+}
+
+
+// -------------------------------- Summed-area tables --------------------------------
+
+
+struct IntegralImageImpl {
+	int32_t width, height;
+	// Each table has (width + 1) * (height + 1) values, where the first row and column are zeroes.
+	//   The value at (x, y) is the sum of all pixels to the left of x and above y.
+	int32_t valuesPerRow;
+	Buffer sums, squares;
+	IntegralImageImpl(int32_t width, int32_t height)
+	: width(width), height(height), valuesPerRow(width + 1),
+	  sums(buffer_create(intptr_t(width + 1) * intptr_t(height + 1) * intptr_t(sizeof(double)))),
+	  squares(buffer_create(intptr_t(width + 1) * intptr_t(height + 1) * intptr_t(sizeof(double)))) {}
+};
+
+template <typename IMAGE_TYPE, typename ELEMENT_TYPE>
+static IntegralImage createIntegralImage(const IMAGE_TYPE &source) {
+	if (!image_exists(source)) {
+		return IntegralImage(); // Null gives null
+	}
+	int32_t width = image_getWidth(source);
+	int32_t height = image_getHeight(source);
+	IntegralImage result = handle_create<IntegralImageImpl>(width, height).setName("Integral image");
+	SafePointer<double> sums = buffer_getSafeData<double>(result->sums, "Integral image sums");
+	SafePointer<double> squares = buffer_getSafeData<double>(result->squares, "Integral image squares");
+	int32_t valuesPerRow = result->valuesPerRow;
+	// Sum each row by itself, so that rows can be processed on separate threads.
+	threadedSplit(0, height, [&source, sums, squares, width, valuesPerRow](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<const ELEMENT_TYPE> sourceRow = image_getSafePointer<ELEMENT_TYPE>(source, y);
+			SafePointer<double> sumRow = sums + (y + 1) * valuesPerRow;
+			SafePointer<double> squareRow = squares + (y + 1) * valuesPerRow;
+			double sum = 0.0;
+			double square = 0.0;
+			for (int32_t x = 0; x < width; x++) {
+				double value = double(sourceRow[x]);
+				sum += value;
+				square += value * value;
+				sumRow[x + 1] = sum;
+				squareRow[x + 1] = square;
+			}
+		}
+	}, max(1, 16384 / width));
+	// Add each row to the next in independent columns, which are split into ranges for each thread and vectorized by the compiler within each range.
+	threadedSplit(1, valuesPerRow, [sums, squares, height, valuesPerRow](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = 2; y <= height; y++) {
+			SafePointer<const double> previousSumRow = sums + (y - 1) * valuesPerRow;
+			SafePointer<const double> previousSquareRow = squares + (y - 1) * valuesPerRow;
+			SafePointer<double> sumRow = sums + y * valuesPerRow;
+			SafePointer<double> squareRow = squares + y * valuesPerRow;
+			for (int32_t x = startIndex; x < stopIndex; x++) {
+				sumRow[x] += previousSumRow[x];
+				squareRow[x] += previousSquareRow[x];
+			}
+		}
+	}, max(1, 16384 / max(1, height)));
+	return result;
+}
+
+IntegralImage filter_createIntegralImage(const ImageU8 &source) {
+	return createIntegralImage<ImageU8, uint8_t>(source);
+}
+
+IntegralImage filter_createIntegralImage(const ImageU16 &source) {
+	return createIntegralImage<ImageU16, uint16_t>(source);
+}
+
+IntegralImage filter_createIntegralImage(const ImageF32 &source) {
+	return createIntegralImage<ImageF32, float>(source);
+}
+
+int32_t integral_getWidth(const IntegralImage &table) {
+	return table.isNotNull() ? table->width : 0;
+}
+
+int32_t integral_getHeight(const IntegralImage &table) {
+	return table.isNotNull() ? table->height : 0;
+}
+
+// Returns the sum of the clipped region in values from four corners, or 0 if the clipped region is empty.
+//   Writes the number of pixels in the clipped region to area.
+static double getRegionSum(const IntegralImage &table, const Buffer &values, const IRect &region, int32_t &area) {
+	IRect cut = IRect::cut(IRect(0, 0, table->width, table->height), region);
+	if (cut.hasArea()) {
+		SafePointer<const double> data = buffer_getSafeData<const double>(values, "Integral image values");
+		SafePointer<const double> topRow = data + cut.top() * table->valuesPerRow;
+		SafePointer<const double> bottomRow = data + cut.bottom() * table->valuesPerRow;
+		area = cut.area();
+		return bottomRow[cut.right()] - bottomRow[cut.left()] - topRow[cut.right()] + topRow[cut.left()];
+	} else {
+		area = 0;
+		return 0.0;
+	}
+}
+
+double integral_getSum(const IntegralImage &table, const IRect &region) {
+	if (table.isNull()) {
+		return 0.0;
+	}
+	int32_t area;
+	return getRegionSum(table, table->sums, region, area);
+}
+
+double integral_getMean(const IntegralImage &table, const IRect &region) {
+	if (table.isNull()) {
+		return 0.0;
+	}
+	int32_t area;
+	double sum = getRegionSum(table, table->sums, region, area);
+	return area > 0 ? sum / double(area) : 0.0;
+}
+
+// The variance is the mean of squares minus the squared mean, which can be slightly negative from rounding when all pixels are the same.
+static double getVariance(double sum, double squareSum, int32_t area) {
+	if (area > 0) {
+		double mean = sum / double(area);
+		return max(0.0, squareSum / double(area) - mean * mean);
+	} else {
+		return 0.0;
+	}
+}
+
+double integral_getVariance(const IntegralImage &table, const IRect &region) {
+	if (table.isNull()) {
+		return 0.0;
+	}
+	int32_t area;
+	double sum = getRegionSum(table, table->sums, region, area);
+	double squareSum = getRegionSum(table, table->squares, region, area);
+	return getVariance(sum, squareSum, area);
+}
+
+// Calls calculatePixel(sum, squareSum, area) for each pixel to get the value written to the result.
+//   Borders clip the region to the table's image, so the variable area is only needed near the edges.
+template <typename CALCULATE_PIXEL>
+static AlignedImageF32 filterIntegralBoxes(const IntegralImage &table, int32_t radius, bool useSquares, const CALCULATE_PIXEL &calculatePixel) {
+	int32_t width = table->width;
+	int32_t height = table->height;
+	int32_t valuesPerRow = table->valuesPerRow;
+	// Boxes are clipped by the image, so larger radii give the same result and would only overflow the bounds.
+	radius = min(radius, max(width, height));
+	AlignedImageF32 result = image_create_F32(width, height, false);
+	SafePointer<const double> sums = buffer_getSafeData<const double>(table->sums, "Integral image sums");
+	SafePointer<const double> squares = buffer_getSafeData<const double>(table->squares, "Integral image squares");
+	threadedSplit(0, height, [&result, &calculatePixel, sums, squares, useSquares, width, height, valuesPerRow, radius](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			int32_t top = max(y - radius, 0);
+			int32_t bottom = min(y + radius + 1, height);
+			SafePointer<const double> topSums = sums + top * valuesPerRow;
+			SafePointer<const double> bottomSums = sums + bottom * valuesPerRow;
+			SafePointer<const double> topSquares = squares + top * valuesPerRow;
+			SafePointer<const double> bottomSquares = squares + bottom * valuesPerRow;
+			SafePointer<float> targetRow = image_getSafePointer(result, y);
+			for (int32_t x = 0; x < width; x++) {
+				int32_t left = max(x - radius, 0);
+				int32_t right = min(x + radius + 1, width);
+				double sum = bottomSums[right] - bottomSums[left] - topSums[right] + topSums[left];
+				double squareSum = useSquares ? bottomSquares[right] - bottomSquares[left] - topSquares[right] + topSquares[left] : 0.0;
+				targetRow[x] = float(calculatePixel(sum, squareSum, (right - left) * (bottom - top)));
+			}
+		}
+	}, max(1, 16384 / width));
+	return result;
+}
+
+AlignedImageF32 filter_boxMean(const IntegralImage &table, int32_t radius) {
+	if (!checkRadius(radius, U"filter_boxMean") || table.isNull()) {
+		return AlignedImageF32(); // Null gives null
+	}
+	return filterIntegralBoxes(table, radius, false, [](double sum, double, int32_t area) -> double {
+		return sum / double(area);
+	});
+}
+
+AlignedImageF32 filter_boxVariance(const IntegralImage &table, int32_t radius) {
+	if (!checkRadius(radius, U"filter_boxVariance") || table.isNull()) {
+		return AlignedImageF32(); // Null gives null
+	}
+	return filterIntegralBoxes(table, radius, true, [](double sum, double squareSum, int32_t area) -> double {
+		return getVariance(sum, squareSum, area);
+	});
+}
+
 }
@@ -33,11 +33,16 @@ namespace dsr {
 // Sampling modes
 	enum class Sampler {
 		Nearest, // Taking the nearest value to create square pixels.
-		Linear   // Taking a linear interpolation of the nearest pixels.
+		Linear,  // Taking a linear interpolation of the nearest pixels.
+		// Filters that are widened when downscaling, so that all source pixels contribute to the result without aliasing.
+		Box,      // Averaging the covered source pixels. Same as Nearest when upscaling.
+		Triangle, // Weighting source pixels linearly by distance. Interpolates linearly when upscaling.
+		Lanczos   // A windowed sinc filter over three target pixels in each direction, which is sharper than Triangle but may ring around edges.
 	};
 
 // Image resizing
 	// Create a stretched version of the source image with the given dimensions and default RGBA pack order.
+	//   Box, Triangle and Lanczos resample rows and columns in two passes using SIMD and multiple threads.
 	OrderedImageRgbaU8 filter_resize(const ImageRgbaU8 &source, Sampler interpolation, int32_t newWidth, int32_t newHeight);
 	AlignedImageU8     filter_resize(const ImageU8 &source,     Sampler interpolation, int32_t newWidth, int32_t newHeight);
 	// The nearest-neighbor resize used for up-scaling the window canvas.
@@ -47,6 +52,65 @@ namespace dsr {
 	//   Letting the images have the same pack order and be aligned to 16-bytes will increase speed.
 	void filter_blockMagnify(const ImageRgbaU8 &target, const ImageRgbaU8 &source, int32_t pixelWidth, int32_t pixelHeight);
 
+// Blurring
+//   Pixels outside of the source image are taken from the closest edge, so that the borders do not fade into black.
+//   Each pass slides a sum along rows on multiple threads and down SIMD vectors of columns, so the time per pixel does not depend on the radius.
+//   RGBA images keep the source's pack order and blur each channel by itself, including alpha.
+//   Half precision images are blurred using floats and rounded back to half precision.
+	// Post-condition: Returns a new image where each pixel is the average of (radius * 2 + 1)² pixels around the same location in source.
+	// Pre-condition: radius >= 0, where a radius of zero returns a copy of source.
+	AlignedImageU8     filter_boxBlur(const ImageU8 &source,     int32_t radius);
+	AlignedImageF32    filter_boxBlur(const ImageF32 &source,    int32_t radius);
+	AlignedImageF16    filter_boxBlur(const ImageF16 &source,    int32_t radius);
+	AlignedImageRgbaU8 filter_boxBlur(const ImageRgbaU8 &source, int32_t radius);
+	// Post-condition: Returns a new image blurred with an approximated Gaussian distribution of the given standard deviation in pixels.
+	//   The approximation applies three box blurs with sizes chosen to get the same variance.
+	// Pre-condition: standardDeviation >= 0, where deviations below 0.58 pixels give a copy of source.
+	AlignedImageU8     filter_gaussianBlur(const ImageU8 &source,     float standardDeviation);
+	AlignedImageF32    filter_gaussianBlur(const ImageF32 &source,    float standardDeviation);
+	AlignedImageF16    filter_gaussianBlur(const ImageF16 &source,    float standardDeviation);
+	AlignedImageRgbaU8 filter_gaussianBlur(const ImageRgbaU8 &source, float standardDeviation);
+
+// Summed-area tables
+//   An integral image stores the sum of all pixels above and to the left of each location, together with the sum of their squares,
+//   so that the sum, mean and variance of any rectangular region can be calculated from four corners in constant time.
+//   Sums are stored using double precision, which is exact for U8 and U16 images of up to 2097152 pixels and limited by rounding for larger images.
+//   Rows are summed on multiple threads before columns are accumulated with independent additions of whole rows.
+	struct IntegralImageImpl;
+	using IntegralImage = Handle<IntegralImageImpl>;
+	// Post-condition: Returns a summed-area table of source, or an empty handle if source does not exist.
+	IntegralImage filter_createIntegralImage(const ImageU8 &source);
+	IntegralImage filter_createIntegralImage(const ImageU16 &source);
+	IntegralImage filter_createIntegralImage(const ImageF32 &source);
+	// Post-condition: Returns the dimensions of the image that table was created from, or 0 if table does not exist.
+	int32_t integral_getWidth(const IntegralImage &table);
+	int32_t integral_getHeight(const IntegralImage &table);
+	// The region is clipped to the image's bounds, so that pixels outside of the image are ignored instead of counted as zeroes.
+	// Post-condition: Returns the sum of all pixels in region, or 0 if the region has no pixels inside of the image.
+	double integral_getSum(const IntegralImage &table, const IRect &region);
+	// Post-condition: Returns the average of the pixels in region, or 0 if the region has no pixels inside of the image.
+	double integral_getMean(const IntegralImage &table, const IRect &region);
+	// Post-condition: Returns the variance of the pixels in region, which is the squared standard deviation, or 0 if the region has no pixels inside of the image.
+	double integral_getVariance(const IntegralImage &table, const IRect &region);
+	// Box filters of any radius, taking four lookups per pixel from the summed-area table on multiple threads.
+	//   Unlike filter_boxBlur, only pixels inside of the image are counted, so that each border pixel gets the average of a smaller region.
+	// Pre-condition: radius >= 0
+	// Post-condition: Returns a new image where each pixel is the average of the pixels within radius from the same location in the table's image.
+	AlignedImageF32 filter_boxMean(const IntegralImage &table, int32_t radius);
+	// Post-condition: Returns a new image where each pixel is the variance of the pixels within radius from the same location in the table's image.
+	AlignedImageF32 filter_boxVariance(const IntegralImage &table, int32_t radius);
+
+// Premultiplied alpha
+//   Premultiplied images store red, green and blue multiplied by alpha / 255, which is flagged in the image so that it can be checked using image_isPremultiplied.
+//   Blurring, resizing and generating mip levels from premultiplied images give each pixel an influence proportional to its opacity,
+//   and blending premultiplied colors takes one multiply-add per channel using draw_alphaFilter_premultiplied.
+//   Resizing and blurring return images with the same flag as the source, because the color channels keep their meaning.
+	// Post-condition: Returns a premultiplied copy of source with the same pack order, or a plain copy if source is already premultiplied.
+	AlignedImageRgbaU8 filter_premultiplyAlpha(const ImageRgbaU8 &source);
+	// Post-condition: Returns a copy of source with straight alpha and the same pack order, or a plain copy if source is not premultiplied.
+	//   Fully transparent pixels become transparent black, because their colors were lost when premultiplying.
+	AlignedImageRgbaU8 filter_straightenAlpha(const ImageRgbaU8 &source);
+
 // Image generation and filtering
 //   Create images from Lambda expressions when speed is not critical.
 //     Capture images within [] and sample pixels from them using image_readPixel_border, image_readPixel_clamp and image_readPixel_tile.
@@ -76,6 +140,37 @@ namespace dsr {
 	AlignedImageU16 filter_generateU16(int32_t width, int32_t height, const ImageGenI32& lambda, int32_t startX = 0, int32_t startY = 0);
 	AlignedImageF32 filter_generateF32(int32_t width, int32_t height, const ImageGenF32& lambda, int32_t startX = 0, int32_t startY = 0);
 
+// Vectorized image generation
+//   The same as filter_map and filter_generate, but calling the lambda once for every 8 pixels along a row.
+//     This allows writing procedural textures using SIMD math on F32x8 from simd.h.
+//   x contains the coordinates of 8 neighboring pixels, and all lanes in y have the same coordinate.
+//   Rows are split across multiple threads, so the lambda must be safe to call from multiple threads at the same time.
+//   Lanes outside of the image are computed but not written.
+//   Colors are saturated to the range of the image format and truncated to integers.
+//   The vector types are only declared here, so include base/simd.h and implementation/render/shader/shaderTypes.h where the lambdas are written.
+	struct F32x8;
+	struct U32x8;
+	template<typename U, typename F>
+	struct Rgba_F32;
+	using Rgba_F32x8 = Rgba_F32<U32x8, F32x8>;
+	// Lambda expressions for generating images from vectorized coordinates.
+	using ImageGenRgbaF32x8 = TemporaryCallback<Rgba_F32x8(const F32x8 &x, const F32x8 &y)>;
+	using ImageGenF32x8 = TemporaryCallback<F32x8(const F32x8 &x, const F32x8 &y)>; // Used for U8, U16 and F32 images using different saturations.
+	// In-place image generation to an existing image.
+	void filter_mapRgbaU8_simd(const ImageRgbaU8 &target, const ImageGenRgbaF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	void filter_mapU8_simd(const ImageU8 &target, const ImageGenF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	void filter_mapU16_simd(const ImageU16 &target, const ImageGenF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	void filter_mapF32_simd(const ImageF32 &target, const ImageGenF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	// Constructing the image as a result.
+	// Example:
+	//     OrderedImageRgbaU8 fadeImage = filter_generateRgbaU8_simd(64, 64, [](const F32x8 &x, const F32x8 &y) -> Rgba_F32x8 {
+	//         return Rgba_F32x8(x * 4.0f, y * 4.0f, F32x8(0.0f), F32x8(255.0f));
+	//     });
+	OrderedImageRgbaU8 filter_generateRgbaU8_simd(int32_t width, int32_t height, const ImageGenRgbaF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	AlignedImageU8 filter_generateU8_simd(int32_t width, int32_t height, const ImageGenF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	AlignedImageU16 filter_generateU16_simd(int32_t width, int32_t height, const ImageGenF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+	AlignedImageF32 filter_generateF32_simd(int32_t width, int32_t height, const ImageGenF32x8& lambda, int32_t startX = 0, int32_t startY = 0);
+
 }
 
 #endif
@@ -26,13 +26,25 @@
 
 #include <limits>
 #include <cassert>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
 #include "imageAPI.h"
 #include "drawAPI.h"
 #include "fileAPI.h"
 #include "../implementation/image/stbImage/stbImageWrapper.h"
+#include "../implementation/image/qoiImage/qoiImage.h"
 #include "../implementation/math/scalar.h"
+#include "../base/threading.h"
+#include "../base/simd.h"
+#include "../collection/Array.h"
 #include "../settings.h"
 
+#ifndef DISABLE_MULTI_THREADING
+	// Requires -pthread for linking
+	#include <thread>
+#endif
+
 namespace dsr {
 
 static const int32_t maximumImageWidth = 65536;
@@ -67,6 +79,10 @@ AlignedImageF32 image_create_F32(int32_t width, int32_t height, bool zeroed) {
 	return image_create_template<AlignedImageF32>("F32 pixel buffer", width, height, PackOrderIndex::RGBA, zeroed);
 }
 
+AlignedImageF16 image_create_F16(int32_t width, int32_t height, bool zeroed) {
+	return image_create_template<AlignedImageF16>("F16 pixel buffer", width, height, PackOrderIndex::RGBA, zeroed);
+}
+
 OrderedImageRgbaU8 image_create_RgbaU8(int32_t width, int32_t height, bool zeroed) {
 	return image_create_template<OrderedImageRgbaU8>("RgbaU8 pixel buffer", width, height, PackOrderIndex::RGBA, zeroed);
 }
@@ -84,7 +100,9 @@ inline bool imageIsPadded(const IMAGE_TYPE &image) {
 
 // Loading from data pointer
 OrderedImageRgbaU8 image_decode_RgbaU8(SafePointer<const uint8_t> data, int32_t size) {
-	if (data.isNotNull()) {
+	if (image_qoi_isEncoded(data, size)) {
+		return image_qoi_decode_RgbaU8(data, size);
+	} else if (data.isNotNull()) {
 		return image_stb_decode_RgbaU8(data, size);
 	} else {
 		return OrderedImageRgbaU8();
@@ -107,6 +125,106 @@ OrderedImageRgbaU8 image_load_RgbaU8(const ReadableString& filename, bool mustEx
 	return result;
 }
 
+struct ImageBatchImpl {
+	List<String> filenames;
+	List<OrderedImageRgbaU8> images;
+	// Non-zero when the image at the same index has finished loading.
+	//   Images and finished are protected by lock.
+	List<uint8_t> finished;
+	std::mutex lock;
+	std::condition_variable finishedCondition;
+	#ifndef DISABLE_MULTI_THREADING
+		// The thread calling the worker threads, which is joined when the batch is destroyed.
+		std::thread loader;
+	#endif
+	explicit ImageBatchImpl(const List<String> &filenames) : filenames(filenames) {
+		for (int32_t i = 0; i < filenames.length(); i++) {
+			this->images.push(OrderedImageRgbaU8());
+			this->finished.push(0);
+		}
+	}
+	~ImageBatchImpl() {
+		#ifndef DISABLE_MULTI_THREADING
+			if (this->loader.joinable()) {
+				if (this->loader.get_id() == std::this_thread::get_id()) {
+					// The loader released the last handle on its own thread after all images were loaded, so it is about to return.
+					this->loader.detach();
+				} else {
+					// The loader has already released its handle, so it does not allocate any more memory while the heap is locked for this destructor.
+					this->loader.join();
+				}
+			}
+		#endif
+	}
+};
+
+static void loadBatchImage(void *context, int32_t jobIndex) {
+	ImageBatchImpl *batch = (ImageBatchImpl*)context;
+	// Failure is reported by image_batch_getImage, because exceptions can not be thrown back to the caller from another thread.
+	OrderedImageRgbaU8 image = image_load_RgbaU8(batch->filenames[jobIndex], false);
+	batch->lock.lock();
+		batch->images[jobIndex] = image;
+		batch->finished[jobIndex] = 1;
+	batch->lock.unlock();
+	batch->finishedCondition.notify_all();
+}
+
+ImageBatch image_loadBatch(const List<String> &filenames, int32_t maxConcurrentLoads) {
+	ImageBatch result = handle_create<ImageBatchImpl>(filenames).setName("Image batch");
+	#ifdef DISABLE_MULTI_THREADING
+		// Without threads, all images are loaded before returning.
+		threadedWorkByIndex(&loadBatchImage, result.getUnsafe(), result->filenames.length(), maxConcurrentLoads);
+	#else
+		// The loading thread keeps its own handle to the batch until all images are loaded, so that the batch is not destroyed while writing to it.
+		//   Destructors are called while the heap is locked, which would deadlock if the destructor waited for threads that are still allocating memory.
+		// Only the worker threads are limited by maxConcurrentLoads, so the calling thread can continue without waiting.
+		result->loader = std::thread([result, maxConcurrentLoads]() mutable {
+			threadedWorkByIndex(&loadBatchImage, result.getUnsafe(), result->filenames.length(), maxConcurrentLoads);
+			// Release the handle before returning, so that a destructor joining the thread only waits for it to return.
+			result = ImageBatch();
+		});
+	#endif
+	return result;
+}
+
+int32_t image_batch_getCount(const ImageBatch &batch) {
+	return batch.isNotNull() ? batch->filenames.length() : 0;
+}
+
+// Post-condition: Returns true iff index refers to an image in batch.
+static bool checkBatchIndex(const ImageBatch &batch, int32_t index, const char32_t *functionName) {
+	if (index < 0 || index >= image_batch_getCount(batch)) {
+		throwError(functionName, U" got the index ", index, U", which is outside of the batch's ", image_batch_getCount(batch), U" images!\n");
+		return false;
+	} else {
+		return true;
+	}
+}
+
+bool image_batch_isReady(const ImageBatch &batch, int32_t index) {
+	if (!checkBatchIndex(batch, index, U"image_batch_isReady")) {
+		return false;
+	}
+	batch->lock.lock();
+		bool result = batch->finished[index] != 0;
+	batch->lock.unlock();
+	return result;
+}
+
+OrderedImageRgbaU8 image_batch_getImage(const ImageBatch &batch, int32_t index, bool mustExist) {
+	if (!checkBatchIndex(batch, index, U"image_batch_getImage")) {
+		return OrderedImageRgbaU8();
+	}
+	std::unique_lock<std::mutex> guard(batch->lock);
+	batch->finishedCondition.wait(guard, [&batch, index]() { return batch->finished[index] != 0; });
+	OrderedImageRgbaU8 result = batch->images[index];
+	guard.unlock();
+	if (mustExist && !image_exists(result)) {
+		throwError(U"image_batch_getImage: Failed to load the image at ", batch->filenames[index], U".\n");
+	}
+	return result;
+}
+
 Buffer image_encode(const ImageRgbaU8 &image, ImageFileFormat format, int32_t quality) {
 	if (image_exists(image)) {
 		ImageRgbaU8 orderedImage;
@@ -117,7 +235,10 @@ Buffer image_encode(const ImageRgbaU8 &image, ImageFileFormat format, int32_t qu
 			// Take the image handle as is.
 			orderedImage = image;
 		}
-		if (imageIsPadded(orderedImage) && format != ImageFileFormat::PNG) {
+		if (format == ImageFileFormat::QOI) {
+			// The QOI encoder reads rows using the stride, so padding does not have to be removed.
+			return image_qoi_encode(orderedImage);
+		} else if (imageIsPadded(orderedImage) && format != ImageFileFormat::PNG) {
 			// If orderedImage is padded and it's not requested as PNG, the padding has to be removed first.
 			return image_stb_encode(image_removePadding(orderedImage), format, quality);
 		} else {
@@ -142,6 +263,8 @@ static ImageFileFormat detectImageFileExtension(const ReadableString& filename)
 			result = ImageFileFormat::TGA;
 		} else if (string_match(extension, U"BMP")) {
 			result = ImageFileFormat::BMP;
+		} else if (string_match(extension, U"QOI")) {
+			result = ImageFileFormat::QOI;
 		}
 	}
 	return result;
@@ -164,6 +287,166 @@ bool image_save(const ImageRgbaU8 &image, const ReadableString& filename, bool m
 	}
 }
 
+// The header is padded to a whole page, so that the pixels can be mapped directly from the file.
+static const int32_t rawHeaderSize = 4096;
+static const uint32_t rawVersion = 1;
+static const uint32_t rawByteOrderMarker = 0x01020304;
+static const char rawIdentifier[8] = {'D', 'S', 'R', 'I', 'M', 'A', 'G', 'E'};
+struct RawImageHeader {
+	char identifier[8];
+	uint32_t byteOrder; // rawByteOrderMarker in the byte order of the computer that saved the file.
+	uint32_t version;
+	uint32_t pixelFormat;
+	uint32_t packOrderIndex;
+	uint32_t width;
+	uint32_t height;
+	uint32_t stride; // Bytes from the start of one row to the next.
+	uint32_t dataOffset; // Bytes from the start of the file to the first pixel.
+};
+
+template <typename IMAGE_TYPE>
+static bool image_saveRaw_template(const IMAGE_TYPE &image, PixelFormat pixelFormat, const ReadableString& filename, bool mustWork) {
+	if (!image_exists(image)) {
+		if (mustWork) { throwError(U"image_saveRaw: Can't save an image that does not exist as ", filename, U".\n"); }
+		return false;
+	}
+	int32_t width = image_getWidth(image);
+	int32_t height = image_getHeight(image);
+	int32_t rowSize = width * image_getPixelSize(image);
+	// Pad each row the same way as image_create, so that the image can be mapped without copying.
+	int32_t stride = memory_getPaddedSize(rowSize, heap_getHeapAlignment());
+	RawImageHeader header;
+	memcpy(header.identifier, rawIdentifier, sizeof(rawIdentifier));
+	header.byteOrder = rawByteOrderMarker;
+	header.version = rawVersion;
+	header.pixelFormat = uint32_t(pixelFormat);
+	header.packOrderIndex = uint32_t(image.impl_dimensions.getPackOrderIndex());
+	header.width = width;
+	header.height = height;
+	header.stride = stride;
+	header.dataOffset = rawHeaderSize;
+	Buffer content = buffer_create(intptr_t(rawHeaderSize) + intptr_t(stride) * height);
+	uint8_t *target = buffer_dangerous_getUnsafeData(content);
+	memcpy(target, &header, sizeof(RawImageHeader));
+	const uint8_t *sourceRow = image_dangerous_getData(image);
+	uint8_t *targetRow = target + rawHeaderSize;
+	for (int32_t y = 0; y < height; y++) {
+		// Copy a row without touching the padding
+		memcpy(targetRow, sourceRow, rowSize);
+		sourceRow += image_getStride(image);
+		targetRow += stride;
+	}
+	return file_saveBuffer(filename, content, mustWork);
+}
+bool image_saveRaw(const ImageU8 &image, const ReadableString& filename, bool mustWork) {
+	return image_saveRaw_template(image, PixelFormat::MonoU8, filename, mustWork);
+}
+bool image_saveRaw(const ImageU16 &image, const ReadableString& filename, bool mustWork) {
+	return image_saveRaw_template(image, PixelFormat::MonoU16, filename, mustWork);
+}
+bool image_saveRaw(const ImageF32 &image, const ReadableString& filename, bool mustWork) {
+	return image_saveRaw_template(image, PixelFormat::MonoF32, filename, mustWork);
+}
+bool image_saveRaw(const ImageF16 &image, const ReadableString& filename, bool mustWork) {
+	return image_saveRaw_template(image, PixelFormat::MonoF16, filename, mustWork);
+}
+bool image_saveRaw(const ImageRgbaU8 &image, const ReadableString& filename, bool mustWork) {
+	return image_saveRaw_template(image, PixelFormat::RgbaU8, filename, mustWork);
+}
+
+// Side-effect: Maps the file to content and reads the header.
+// Post-condition: Returns true iff the file is a raw image of pixelFormat with pixels inside of the file.
+static bool loadRawImage(const ReadableString& filename, PixelFormat pixelFormat, uint32_t pixelSize, bool mustExist, Buffer &content, RawImageHeader &header) {
+	content = file_mapBuffer(filename, mustExist);
+	if (!buffer_exists(content)) {
+		return false;
+	}
+	intptr_t size = buffer_getSize(content);
+	bool valid = false;
+	if (size >= rawHeaderSize) {
+		memcpy(&header, buffer_dangerous_getUnsafeData(content), sizeof(RawImageHeader));
+		valid = memcmp(header.identifier, rawIdentifier, sizeof(rawIdentifier)) == 0
+		     && header.byteOrder == rawByteOrderMarker
+		     && header.version == rawVersion
+		     && header.pixelFormat == uint32_t(pixelFormat)
+		     && header.packOrderIndex <= uint32_t(PackOrderIndex::ABGR)
+		     && header.width >= 1 && header.width <= uint32_t(maximumImageWidth)
+		     && header.height >= 1 && header.height <= uint32_t(maximumImageHeight)
+		     && header.stride >= header.width * pixelSize && header.stride % pixelSize == 0
+		     && header.dataOffset >= sizeof(RawImageHeader) && header.dataOffset % pixelSize == 0
+		     && int64_t(header.dataOffset) + int64_t(header.stride) * int64_t(header.height) <= int64_t(size);
+	}
+	if (!valid) {
+		content = Buffer();
+		if (mustExist) { throwError(U"image_loadRaw: ", filename, U" is not a raw image of the expected pixel format.\n"); }
+	}
+	return valid;
+}
+// Post-condition: Returns true iff the pixels can be used directly as an aligned image.
+static bool isRawImageAligned(const RawImageHeader &header) {
+	return header.stride % heap_getHeapAlignment() == 0 && header.dataOffset % heap_getHeapAlignment() == 0;
+}
+AlignedImageU8 image_loadRaw_U8(const ReadableString& filename, bool mustExist) {
+	Buffer content;
+	RawImageHeader header;
+	if (!loadRawImage(filename, PixelFormat::MonoU8, 1, mustExist, content, header)) {
+		return AlignedImageU8();
+	} else if (isRawImageAligned(header)) {
+		return AlignedImageU8(content, header.dataOffset, header.width, header.height, header.stride, PackOrderIndex::RGBA);
+	} else {
+		return image_clone(ImageU8(content, header.dataOffset, header.width, header.height, header.stride, PackOrderIndex::RGBA));
+	}
+}
+AlignedImageU16 image_loadRaw_U16(const ReadableString& filename, bool mustExist) {
+	Buffer content;
+	RawImageHeader header;
+	if (!loadRawImage(filename, PixelFormat::MonoU16, 2, mustExist, content, header)) {
+		return AlignedImageU16();
+	} else if (isRawImageAligned(header)) {
+		return AlignedImageU16(content, header.dataOffset / 2, header.width, header.height, header.stride / 2, PackOrderIndex::RGBA);
+	} else {
+		return image_clone(ImageU16(content, header.dataOffset / 2, header.width, header.height, header.stride / 2, PackOrderIndex::RGBA));
+	}
+}
+AlignedImageF32 image_loadRaw_F32(const ReadableString& filename, bool mustExist) {
+	Buffer content;
+	RawImageHeader header;
+	if (!loadRawImage(filename, PixelFormat::MonoF32, 4, mustExist, content, header)) {
+		return AlignedImageF32();
+	} else if (isRawImageAligned(header)) {
+		return AlignedImageF32(content, header.dataOffset / 4, header.width, header.height, header.stride / 4, PackOrderIndex::RGBA);
+	} else {
+		return image_clone(ImageF32(content, header.dataOffset / 4, header.width, header.height, header.stride / 4, PackOrderIndex::RGBA));
+	}
+}
+AlignedImageF16 image_loadRaw_F16(const ReadableString& filename, bool mustExist) {
+	Buffer content;
+	RawImageHeader header;
+	if (!loadRawImage(filename, PixelFormat::MonoF16, 2, mustExist, content, header)) {
+		return AlignedImageF16();
+	} else if (isRawImageAligned(header)) {
+		return AlignedImageF16(content, header.dataOffset / 2, header.width, header.height, header.stride / 2, PackOrderIndex::RGBA);
+	} else {
+		return image_clone(ImageF16(content, header.dataOffset / 2, header.width, header.height, header.stride / 2, PackOrderIndex::RGBA));
+	}
+}
+AlignedImageRgbaU8 image_loadRaw_RgbaU8(const ReadableString& filename, bool mustExist) {
+	Buffer content;
+	RawImageHeader header;
+	if (!loadRawImage(filename, PixelFormat::RgbaU8, 4, mustExist, content, header)) {
+		return AlignedImageRgbaU8();
+	}
+	PackOrderIndex packOrderIndex = PackOrderIndex(header.packOrderIndex);
+	if (isRawImageAligned(header)) {
+		return AlignedImageRgbaU8(content, header.dataOffset / 4, header.width, header.height, header.stride / 4, packOrderIndex);
+	} else {
+		// Copy to an image of the same pack order, so that the pixels are copied without being repacked.
+		AlignedImageRgbaU8 result = image_create_RgbaU8_native(header.width, header.height, packOrderIndex, false);
+		draw_copy(result, ImageRgbaU8(content, header.dataOffset / 4, header.width, header.height, header.stride / 4, packOrderIndex));
+		return result;
+	}
+}
+
 void image_fill(const ImageU8& image, int32_t color) {
 	if (image_exists(image)) {
 		draw_rectangle(image, image_getBound(image), color);
@@ -179,6 +462,11 @@ void image_fill(const ImageF32& image, float color) {
 		draw_rectangle(image, image_getBound(image), color);
 	}
 }
+void image_fill(const ImageF16& image, float color) {
+	if (image_exists(image)) {
+		draw_rectangle(image, image_getBound(image), color);
+	}
+}
 void image_fill(const ImageRgbaU8& image, const ColorRgbaI32& color) {
 	if (image_exists(image)) {
 		draw_rectangle(image, image_getBound(image), color);
@@ -212,10 +500,20 @@ AlignedImageF32 image_clone(const ImageF32& image) {
 		return AlignedImageF32(); // Null gives null
 	}
 }
+AlignedImageF16 image_clone(const ImageF16& image) {
+	if (image_exists(image)) {
+		AlignedImageF16 result = image_create_F16(image_getWidth(image), image_getHeight(image));
+		draw_copy(result, image);
+		return result;
+	} else {
+		return AlignedImageF16(); // Null gives null
+	}
+}
 OrderedImageRgbaU8 image_clone(const ImageRgbaU8& image) {
 	if (image_exists(image)) {
 		OrderedImageRgbaU8 result = image_create_RgbaU8(image_getWidth(image), image_getHeight(image));
 		draw_copy(result, image);
+		result.impl_dimensions.setPremultiplied(image_isPremultiplied(image));
 		return result;
 	} else {
 		return OrderedImageRgbaU8(); // Null gives null
@@ -238,7 +536,9 @@ ImageRgbaU8 image_removePadding(const ImageRgbaU8& image) {
 			sourceRow.increaseBytes(sourceStride);
 			targetRow.increaseBytes(targetStride);
 		}
-		return ImageRgbaU8(newBuffer, 0, image_getWidth(image), image_getHeight(image), targetStride * image_getPixelSize<ImageRgbaU8>(), image_getPackOrderIndex(image));
+		ImageRgbaU8 result = ImageRgbaU8(newBuffer, 0, image_getWidth(image), image_getHeight(image), targetStride * image_getPixelSize<ImageRgbaU8>(), image_getPackOrderIndex(image));
+		result.impl_dimensions.setPremultiplied(image_isPremultiplied(image));
+		return result;
 	}
 }
 
@@ -557,6 +857,25 @@ float image_maxDifference(const ImageF32& imageA, const ImageF32& imageB) {
 		return DSR_FLOAT_INF;
 	}
 }
+float image_maxDifference(const ImageF16& imageA, const ImageF16& imageB) {
+	if (!image_exists(imageA) || !image_exists(imageB) || image_getWidth(imageA) != image_getWidth(imageB) || image_getHeight(imageA) != image_getHeight(imageB)) {
+		return DSR_FLOAT_INF;
+	} else {
+		// Half precision floats are compared after converting them into floats.
+		float maxDifference = 0.0f;
+		for (int32_t y = 0; y < image_getHeight(imageA); y++) {
+			SafePointer<const uint16_t> pixelDataA = image_getSafePointer<uint16_t>(imageA, y);
+			SafePointer<const uint16_t> pixelDataB = image_getSafePointer<uint16_t>(imageB, y);
+			for (int32_t x = 0; x < image_getWidth(imageA); x++) {
+				float difference = absDiff(floatFromF16(pixelDataA[x]), floatFromF16(pixelDataB[x]));
+				if (difference > maxDifference) {
+					maxDifference = difference;
+				}
+			}
+		}
+		return maxDifference;
+	}
+}
 uint8_t image_maxDifference(const ImageRgbaU8& imageA, const ImageRgbaU8& imageB) {
 	if (image_exists(imageA) && image_exists(imageB)) {
 		return maxDifference_template<ImageRgbaU8, 4, uint8_t>(imageA, imageB);
@@ -565,4 +884,146 @@ uint8_t image_maxDifference(const ImageRgbaU8& imageA, const ImageRgbaU8& imageB
 	}
 }
 
+
+// Returns true iff the pixels from startX to stopX differ between the rows.
+//   Whole SIMD vectors are compared while both rows are aligned, because unchanged pixels are expected to be the most common.
+template <typename PIXEL_TYPE>
+static bool rowSpanDiffers(const uint8_t *rowA, const uint8_t *rowB, int32_t startX, int32_t stopX) {
+	static const int32_t pixelsPerVector = int32_t(sizeof(U32xX) / sizeof(PIXEL_TYPE));
+	const PIXEL_TYPE *pixelsA = (const PIXEL_TYPE*)rowA;
+	const PIXEL_TYPE *pixelsB = (const PIXEL_TYPE*)rowB;
+	int32_t x = startX;
+	while (x < stopX) {
+		if (((uintptr_t(pixelsA + x) | uintptr_t(pixelsB + x)) & uintptr_t(sizeof(U32xX) - 1)) == 0) {
+			while (x + pixelsPerVector <= stopX) {
+				if (!allLanesEqual(U32xX::readAlignedUnsafe((const uint32_t*)(pixelsA + x)), U32xX::readAlignedUnsafe((const uint32_t*)(pixelsB + x)))) {
+					return true;
+				}
+				x += pixelsPerVector;
+			}
+			if (x >= stopX) {
+				return false;
+			}
+		}
+		if (pixelsA[x] != pixelsB[x]) {
+			return true;
+		}
+		x++;
+	}
+	return false;
+}
+
+template <typename IMAGE_TYPE, typename PIXEL_TYPE>
+static List<IRect> findChangedRegions_template(const IMAGE_TYPE &previous, const IMAGE_TYPE &current, int32_t blockSize) {
+	List<IRect> result;
+	if (blockSize < 1) {
+		throwError(U"image_findChangedRegions got the block size ", blockSize, U", which must be at least 1!\n");
+		return result;
+	}
+	if (!image_exists(current)) {
+		return result;
+	}
+	int32_t width = image_getWidth(current);
+	int32_t height = image_getHeight(current);
+	if (!image_exists(previous) || image_getWidth(previous) != width || image_getHeight(previous) != height) {
+		// Nothing can be reused when the dimensions are different.
+		result.push(image_getBound(current));
+		return result;
+	}
+	// A single block covering the whole image is the largest size needed, which also prevents overflow when rounding up.
+	blockSize = min(blockSize, max(width, height));
+	int32_t blockColumns = (width + blockSize - 1) / blockSize;
+	int32_t blockRows = (height + blockSize - 1) / blockSize;
+	// One flag for each block, which is set when any pixel within the block changed.
+	//   Each thread writes to its own rows of blocks.
+	Array<uint8_t> changed = Array<uint8_t>(blockColumns * blockRows, 0);
+	SafePointer<const uint8_t> dataA = image_getSafePointer<uint8_t>(previous);
+	SafePointer<const uint8_t> dataB = image_getSafePointer<uint8_t>(current);
+	intptr_t strideA = image_getStride(previous);
+	intptr_t strideB = image_getStride(current);
+	threadedSplit(0, blockRows, [&changed, dataA, dataB, strideA, strideB, blockSize, blockColumns, width, height](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t blockY = startIndex; blockY < stopIndex; blockY++) {
+			int32_t startY = blockY * blockSize;
+			int32_t stopY = min(startY + blockSize, height);
+			for (int32_t y = startY; y < stopY; y++) {
+				// Bound checks are made once for each row, so that the comparisons can use raw pointers.
+				const uint8_t *rowA = (dataA + strideA * y).getUnchecked();
+				const uint8_t *rowB = (dataB + strideB * y).getUnchecked();
+				#ifdef SAFE_POINTER_CHECKS
+					(dataA + strideA * y).assertInside("image_findChangedRegions @ previous row", rowA, width * sizeof(PIXEL_TYPE));
+					(dataB + strideB * y).assertInside("image_findChangedRegions @ current row", rowB, width * sizeof(PIXEL_TYPE));
+				#endif
+				for (int32_t blockX = 0; blockX < blockColumns; blockX++) {
+					int32_t flagIndex = blockY * blockColumns + blockX;
+					// Blocks that already changed on a previous row do not have to be compared again.
+					if (!changed[flagIndex]) {
+						int32_t startX = blockX * blockSize;
+						if (rowSpanDiffers<PIXEL_TYPE>(rowA, rowB, startX, min(startX + blockSize, width))) {
+							changed[flagIndex] = 1;
+						}
+					}
+				}
+			}
+		}
+	}, int32_t(max((int64_t)1, (int64_t)65536 / max((int64_t)1, int64_t(width) * int64_t(blockSize)))));
+	// Merge horizontal runs of changed blocks into rectangles, which are extended downwards when the next row of blocks has a run of the same width.
+	//   Rectangles in openRegions can still be extended, and are moved to the result once a row of blocks does not continue them.
+	List<IRect> openRegions;
+	List<IRect> nextOpenRegions;
+	for (int32_t blockY = 0; blockY < blockRows; blockY++) {
+		int32_t top = blockY * blockSize;
+		int32_t bottom = min(top + blockSize, height);
+		int32_t blockX = 0;
+		while (blockX < blockColumns) {
+			if (changed[blockY * blockColumns + blockX]) {
+				int32_t startBlockX = blockX;
+				while (blockX < blockColumns && changed[blockY * blockColumns + blockX]) {
+					blockX++;
+				}
+				IRect run = IRect::FromBounds(startBlockX * blockSize, top, min(blockX * blockSize, width), bottom);
+				bool extended = false;
+				for (int32_t r = 0; r < openRegions.length(); r++) {
+					if (openRegions[r].left() == run.left() && openRegions[r].right() == run.right()) {
+						nextOpenRegions.push(IRect::merge(openRegions[r], run));
+						openRegions.remove(r);
+						extended = true;
+						break;
+					}
+				}
+				if (!extended) {
+					nextOpenRegions.push(run);
+				}
+			} else {
+				blockX++;
+			}
+		}
+		// Regions that were not extended by this row of blocks are finished.
+		for (int32_t r = 0; r < openRegions.length(); r++) {
+			result.push(openRegions[r]);
+		}
+		openRegions = nextOpenRegions;
+		nextOpenRegions.clear();
+	}
+	for (int32_t r = 0; r < openRegions.length(); r++) {
+		result.push(openRegions[r]);
+	}
+	return result;
+}
+
+List<IRect> image_findChangedRegions(const ImageU8& previous, const ImageU8& current, int32_t blockSize) {
+	return findChangedRegions_template<ImageU8, uint8_t>(previous, current, blockSize);
+}
+List<IRect> image_findChangedRegions(const ImageU16& previous, const ImageU16& current, int32_t blockSize) {
+	return findChangedRegions_template<ImageU16, uint16_t>(previous, current, blockSize);
+}
+List<IRect> image_findChangedRegions(const ImageF32& previous, const ImageF32& current, int32_t blockSize) {
+	return findChangedRegions_template<ImageF32, uint32_t>(previous, current, blockSize);
+}
+List<IRect> image_findChangedRegions(const ImageF16& previous, const ImageF16& current, int32_t blockSize) {
+	return findChangedRegions_template<ImageF16, uint16_t>(previous, current, blockSize);
+}
+List<IRect> image_findChangedRegions(const ImageRgbaU8& previous, const ImageRgbaU8& current, int32_t blockSize) {
+	return findChangedRegions_template<ImageRgbaU8, uint32_t>(previous, current, blockSize);
+}
+
 }
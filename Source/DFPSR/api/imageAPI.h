@@ -47,6 +47,8 @@ namespace dsr {
 	AlignedImageU8 image_create_U8(int32_t width, int32_t height, bool zeroed = true);
 	AlignedImageU16 image_create_U16(int32_t width, int32_t height, bool zeroed = true);
 	AlignedImageF32 image_create_F32(int32_t width, int32_t height, bool zeroed = true);
+	// Half precision floats use half the memory of F32 for high dynamic range buffers, with 11 bits of precision and a range of ±65504.
+	AlignedImageF16 image_create_F16(int32_t width, int32_t height, bool zeroed = true);
 	OrderedImageRgbaU8 image_create_RgbaU8(int32_t width, int32_t height, bool zeroed = true);
 	AlignedImageRgbaU8 image_create_RgbaU8_native(int32_t width, int32_t height, PackOrderIndex packOrderIndex, bool zeroed = true);
 
@@ -71,6 +73,7 @@ namespace dsr {
 	inline int32_t image_getStride(const ImageU8&     image) { return image_getPixelStride(image);      } // pixelStride * sizeof(uint8_t )
 	inline int32_t image_getStride(const ImageU16&    image) { return image_getPixelStride(image) << 1; } // pixelStride * sizeof(uint16_t)
 	inline int32_t image_getStride(const ImageF32&    image) { return image_getPixelStride(image) << 2; } // pixelStride * sizeof(float   )
+	inline int32_t image_getStride(const ImageF16&    image) { return image_getPixelStride(image) << 1; } // pixelStride * sizeof(uint16_t)
 	inline int32_t image_getStride(const ImageRgbaU8& image) { return image_getPixelStride(image) << 2; } // pixelStride * sizeof(uint32_t)
 	// Returns image's offset from the allocation start in whole pixels, or 0 from an empty image
 	inline int64_t image_getPixelStartOffset(const Image& image) { return (int64_t)image.impl_dimensions.getPixelStartOffset(); }
@@ -78,6 +81,7 @@ namespace dsr {
 	inline int64_t image_getStartOffset(const ImageU8&     image) { return image_getPixelStartOffset(image);      } // pixelStartOffset * sizeof(uint8_t )
 	inline int64_t image_getStartOffset(const ImageU16&    image) { return image_getPixelStartOffset(image) << 1; } // pixelStartOffset * sizeof(uint16_t)
 	inline int64_t image_getStartOffset(const ImageF32&    image) { return image_getPixelStartOffset(image) << 2; } // pixelStartOffset * sizeof(float   )
+	inline int64_t image_getStartOffset(const ImageF16&    image) { return image_getPixelStartOffset(image) << 1; } // pixelStartOffset * sizeof(uint16_t)
 	inline int64_t image_getStartOffset(const ImageRgbaU8& image) { return image_getPixelStartOffset(image) << 2; } // pixelStartOffset * sizeof(uint32_t)
 
 	// Get a rectangle from the image's dimensions with the top left corner set to (0, 0).
@@ -98,6 +102,18 @@ namespace dsr {
 	// Returns the image's pack order, containing bit masks and offsets needed to pack and unpack colors.
 	inline PackOrder image_getPackOrder(const ImageRgbaU8& image) { return PackOrder::getPackOrder(image.impl_dimensions.getPackOrderIndex()); };
 
+	// Returns true iff image is flagged as premultiplied, meaning that red, green and blue have already been multiplied by alpha / 255.
+	//   Newly created images have straight alpha, and filter_premultiplyAlpha and filter_straightenAlpha convert between the two.
+	//   The flag is stored in the handle, so sub-images inherit it while other handles to the same pixels keep their own flag.
+	inline bool image_isPremultiplied(const ImageRgbaU8& image) { return image.impl_dimensions.isPremultiplied(); }
+	// Returns a handle to the same pixels as image, flagged as premultiplied or not without changing any pixels.
+	//   Used when the pixels are already known to be premultiplied, such as when drawn using draw_alphaFilter_premultiplied.
+	inline ImageRgbaU8 image_setPremultiplied(const ImageRgbaU8& image, bool premultiplied) {
+		ImageDimensions dimensions = image.impl_dimensions;
+		dimensions.setPremultiplied(premultiplied);
+		return ImageRgbaU8(image.impl_buffer, dimensions);
+	}
+
 	// Returns true iff the pixel at (x, y) is inside of image.
 	inline bool image_isPixelInside(const Image& image, int32_t x, int32_t y) {
 		return x >= 0 && x < image_getWidth(image) && y >= 0 && y < image_getHeight(image);
@@ -171,6 +187,11 @@ namespace dsr {
 		uintptr_t pixelOffset = image_getPixelStartOffset(image) + y * image_getPixelStride(image) + x;
 		return *(buffer_getSafeData<float>(image.impl_buffer, "ImageF32 pixel access buffer") + pixelOffset);
 	}
+	// Returns the half precision float's bits, which can be converted using floatFromF16 and roundToF16.
+	inline uint16_t &image_accessPixel(const ImageF16& image, int32_t x, int32_t y) {
+		uintptr_t pixelOffset = image_getPixelStartOffset(image) + y * image_getPixelStride(image) + x;
+		return *(buffer_getSafeData<uint16_t>(image.impl_buffer, "ImageF16 pixel access buffer") + pixelOffset);
+	}
 	inline uint32_t &image_accessPixel(const ImageRgbaU8& image, int32_t x, int32_t y) {
 		uintptr_t pixelOffset = image_getPixelStartOffset(image) + y * image_getPixelStride(image) + x;
 		return *(buffer_getSafeData<uint32_t>(image.impl_buffer, "ImageRgbaU8 pixel access buffer") + pixelOffset);
@@ -192,6 +213,10 @@ namespace dsr {
 	inline void image_writePixel(const ImageF32& image, int32_t x, int32_t y, float color) {
 		if (image_isPixelInside(image, x, y)) image_accessPixel(image, x, y) = color;
 	}
+	// Rounded to the nearest half precision float, with infinity above 65504
+	inline void image_writePixel(const ImageF16& image, int32_t x, int32_t y, float color) {
+		if (image_isPixelInside(image, x, y)) image_accessPixel(image, x, y) = roundToF16(color);
+	}
 	// Saturated to 0..255 in all channels
 	inline void image_writePixel(const ImageRgbaU8& image, int32_t x, int32_t y, const ColorRgbaI32& color) {
 		if (image_isPixelInside(image, x, y)) image_accessPixel(image, x, y) = image_saturateAndPack(image, color);
@@ -235,6 +260,15 @@ namespace dsr {
 		}
 	}
 	//inline float image_readPixel_border_packed(const ImageF32& image, int32_t x, int32_t y, int32_t border = 0) { return image_readPixel_border(image, x, y, border); }
+	inline float image_readPixel_border(const ImageF16& image, int32_t x, int32_t y, float border = 0.0f) {
+		if (!image_exists(image)) {
+			return 0.0f;
+		} else if (image_isPixelInside(image, x, y)) {
+			return floatFromF16(image_accessPixel(image, x, y));
+		} else {
+			return border;
+		}
+	}
 	inline ColorRgbaI32 image_readPixel_border(const ImageRgbaU8& image, int32_t x, int32_t y, const ColorRgbaI32& border = ColorRgbaI32()) {
 		if (!image_exists(image)) {
 			return ColorRgbaI32(0, 0, 0, 0);
@@ -281,6 +315,13 @@ namespace dsr {
 		}
 	}
 	//inline float image_readPixel_clamp_packed(const ImageF32& image, int32_t x, int32_t y) { return image_readPixel_clamp(image, x, y); }
+	inline float image_readPixel_clamp(const ImageF16& image, int32_t x, int32_t y) {
+		if (image_exists(image)) {
+			return floatFromF16(image_accessPixel(image, clamp(0, x, image_getWidth(image) - 1), clamp(0, y, image_getHeight(image) - 1)));
+		} else {
+			return 0.0f;
+		}
+	}
 	inline ColorRgbaI32 image_readPixel_clamp(const ImageRgbaU8& image, int32_t x, int32_t y) {
 		if (image_exists(image)) {
 			return image_unpack(image, image_accessPixel(image, clamp(0, x, image_getWidth(image) - 1), clamp(0, y, image_getHeight(image) - 1)));
@@ -324,6 +365,13 @@ namespace dsr {
 		}
 	}
 	//inline float image_readPixel_tile_packed(const ImageF32& image, int32_t x, int32_t y) { return image_readPixel_tile(image, x, y); }
+	inline float image_readPixel_tile(const ImageF16& image, int32_t x, int32_t y) {
+		if (image_exists(image)) {
+			return floatFromF16(image_accessPixel(image, signedModulo(x, image_getWidth(image)), signedModulo(y, image_getHeight(image))));
+		} else {
+			return 0.0f;
+		}
+	}
 	inline ColorRgbaI32 image_readPixel_tile(const ImageRgbaU8& image, int32_t x, int32_t y) {
 		if (image_exists(image)) {
 			return image_unpack(image, image_accessPixel(image, signedModulo(x, image_getWidth(image)), signedModulo(y, image_getHeight(image))));
@@ -344,6 +392,7 @@ namespace dsr {
 	// Load an image from a file by giving the filename including folder path and extension.
 	// If mustExist is true, an exception will be raised on failure.
 	// If mustExist is false, failure will return an empty handle.
+	// QOI images saved by image_save or image_encode are stored in strips, which are decoded on multiple threads.
 	OrderedImageRgbaU8 image_load_RgbaU8(const ReadableString& filename, bool mustExist = true);
 	// Load an image from a memory buffer, which can be loaded with file_loadBuffer to get the same result as loading directly from the file.
 	// A convenient way of loading compressed images from larger files.
@@ -354,6 +403,26 @@ namespace dsr {
 	// Failure will return an empty handle.
 	OrderedImageRgbaU8 image_decode_RgbaU8(SafePointer<const uint8_t> data, int32_t size);
 
+// Batch loading
+	// A handle to images being loaded on background threads by image_loadBatch.
+	struct ImageBatchImpl;
+	using ImageBatch = Handle<ImageBatchImpl>;
+	// Side-effect: Starts loading the images at filenames on background threads, as if calling image_load_RgbaU8 for each file.
+	//   At most maxConcurrentLoads files are read and decoded at the same time, or one for each available thread when 0.
+	//   Keeping the returned handle is not required for the loading to continue, because the background thread holds its own handle until all files are loaded.
+	//   If DISABLE_MULTI_THREADING is defined in settings.h, all images are loaded on the calling thread before returning.
+	// Post-condition: Returns a handle to the batch without waiting for any image to load.
+	ImageBatch image_loadBatch(const List<String> &filenames, int32_t maxConcurrentLoads = 0);
+	// Post-condition: Returns the number of images in batch, or 0 if batch does not exist.
+	int32_t image_batch_getCount(const ImageBatch &batch);
+	// Post-condition: Returns true iff the image at index has finished loading, so that image_batch_getImage will return without waiting.
+	bool image_batch_isReady(const ImageBatch &batch, int32_t index);
+	// Side-effect: Waits until the image at index has finished loading.
+	// If mustExist is true, an exception will be raised if the image could not be loaded.
+	// If mustExist is false, failure will return an empty handle.
+	// Post-condition: Returns the image loaded from the file at index in the filenames given to image_loadBatch.
+	OrderedImageRgbaU8 image_batch_getImage(const ImageBatch &batch, int32_t index, bool mustExist = true);
+
 // Saving
 	// Save the image to the path specified by filename and return true iff the operation was successful.
 	// The file extension is case insensitive after the last dot in filename.
@@ -362,9 +431,11 @@ namespace dsr {
 	//     *.png
 	//     *.tga or *.targa
 	//     *.bmp
+	//     *.qoi
 	// If mustWork is true, an exception will be raised on failure.
 	// If mustWork is false, failure will return false.
 	// The optional quality setting goes from 1% to 100% and is at the maximum by default.
+	// QOI is recommended for intermediate assets and cached conversions, because it is lossless and many times faster to decode than PNG.
 	bool image_save(const ImageRgbaU8 &image, const ReadableString& filename, bool mustWork = true, int32_t quality = 100);
 	// Save the image to a memory buffer.
 	// Post-condition: Returns a buffer with the encoded image format as it would be saved to a file, or empty on failure.
@@ -372,18 +443,48 @@ namespace dsr {
 	// The optional quality setting goes from 1% to 100% and is at the maximum by default.
 	Buffer image_encode(const ImageRgbaU8 &image, ImageFileFormat format, int32_t quality = 90);
 
+// Raw images
+//   Raw image files store uncompressed pixels together with the pixel format, pack order, dimensions and stride,
+//   so that loading can map the file's pages directly into the image without decoding or copying any pixels.
+//   Loading takes the same time no matter how large the image is, because pages are only read from the disk when accessed,
+//   and pages that are not written to are shared with other processes loading the same file.
+//   Writing to the pixels of a loaded image only modifies the process' own copy of the page, so the file is not modified.
+//   The memory mapping is released together with the image's buffer, so the buffer's destructor must not be replaced.
+//   Values larger than a byte are stored in the local computer's byte order, so raw images are meant for cached data, not for distribution.
+	// Save the image to the path specified by filename and return true iff the operation was successful.
+	// If mustWork is true, an exception will be raised on failure.
+	// If mustWork is false, failure will return false.
+	bool image_saveRaw(const ImageU8 &image, const ReadableString& filename, bool mustWork = true);
+	bool image_saveRaw(const ImageU16 &image, const ReadableString& filename, bool mustWork = true);
+	bool image_saveRaw(const ImageF32 &image, const ReadableString& filename, bool mustWork = true);
+	bool image_saveRaw(const ImageF16 &image, const ReadableString& filename, bool mustWork = true);
+	bool image_saveRaw(const ImageRgbaU8 &image, const ReadableString& filename, bool mustWork = true);
+	// Load a raw image of the given pixel format.
+	//   Images saved with a stride that is not aligned for the local computer are copied into a new aligned image instead of being mapped.
+	// If mustExist is true, an exception will be raised on failure, including files of other pixel formats.
+	// If mustExist is false, failure will return an empty handle.
+	AlignedImageU8 image_loadRaw_U8(const ReadableString& filename, bool mustExist = true);
+	AlignedImageU16 image_loadRaw_U16(const ReadableString& filename, bool mustExist = true);
+	AlignedImageF32 image_loadRaw_F32(const ReadableString& filename, bool mustExist = true);
+	AlignedImageF16 image_loadRaw_F16(const ReadableString& filename, bool mustExist = true);
+	// The pack order is preserved from the saved image.
+	AlignedImageRgbaU8 image_loadRaw_RgbaU8(const ReadableString& filename, bool mustExist = true);
+
 // Fill all pixels with a uniform color
 	void image_fill(const ImageU8& image, int32_t color);
 	void image_fill(const ImageU16& image, int32_t color);
 	void image_fill(const ImageF32& image, float color);
+	void image_fill(const ImageF16& image, float color);
 	void image_fill(const ImageRgbaU8& image, const ColorRgbaI32& color);
 
 // Clone
 	// Get a deep clone of an image's content while discarding any pack order, padding and texture pyramids.
 	// If the input image had a different pack order, it will automatically be converted into RGBA to preserve the colors.
+	// The premultiplied flag of RgbaU8 images is kept, because the colors still have the same meaning.
 	AlignedImageU8 image_clone(const ImageU8& image);
 	AlignedImageU16 image_clone(const ImageU16& image);
 	AlignedImageF32 image_clone(const ImageF32& image);
+	AlignedImageF16 image_clone(const ImageF16& image);
 	OrderedImageRgbaU8 image_clone(const ImageRgbaU8& image);
 	// Returns a copy of the image without any padding, which means that alignment cannot be guaranteed.
 	// The pack order is the same as the input, becuase it just copies the memory one row at a time to be fast.
@@ -416,7 +517,21 @@ namespace dsr {
 	uint8_t  image_maxDifference(const ImageU8&     imageA, const ImageU8&     imageB);
 	uint16_t image_maxDifference(const ImageU16&    imageA, const ImageU16&    imageB);
 	float    image_maxDifference(const ImageF32&    imageA, const ImageF32&    imageB);
+	float    image_maxDifference(const ImageF16&    imageA, const ImageF16&    imageB);
 	uint8_t  image_maxDifference(const ImageRgbaU8& imageA, const ImageRgbaU8& imageB);
+	// Find which regions of current have changed since previous, for presenting or encoding only the pixels that changed between frames.
+	//   The images are divided into blocks of blockSize x blockSize pixels, which are compared on multiple threads using SIMD while the rows are aligned.
+	//   Pixels are compared bit by bit, so both images should have the same pack order and floats are only equal when stored identically.
+	// Pre-condition: blockSize >= 1
+	// Post-condition: Returns a list of non-overlapping rectangles covering all changed blocks, clipped to the image bounds.
+	//   Neighboring changed blocks on the same row of blocks are merged, and merged rows are extended downwards while the next row has the same horizontal span.
+	//   If the images have different dimensions or previous does not exist, the whole bound of current is returned as one rectangle.
+	//   If current does not exist, an empty list is returned.
+	List<IRect> image_findChangedRegions(const ImageU8&     previous, const ImageU8&     current, int32_t blockSize);
+	List<IRect> image_findChangedRegions(const ImageU16&    previous, const ImageU16&    current, int32_t blockSize);
+	List<IRect> image_findChangedRegions(const ImageF32&    previous, const ImageF32&    current, int32_t blockSize);
+	List<IRect> image_findChangedRegions(const ImageF16&    previous, const ImageF16&    current, int32_t blockSize);
+	List<IRect> image_findChangedRegions(const ImageRgbaU8& previous, const ImageRgbaU8& current, int32_t blockSize);
 
 // TODO: Create sub-image constructors in the image types.
 
@@ -436,6 +551,10 @@ namespace dsr {
 		static_assert(sizeof(ImageF32) == sizeof(Image), "ImageF32 must have the same size as Image, to prevent slicing in assignments!");
 		return ImageF32(image, region);
 	}
+	inline ImageF16 image_getSubImage(const ImageF16& image, const IRect& region) {
+		static_assert(sizeof(ImageF16) == sizeof(Image), "ImageF16 must have the same size as Image, to prevent slicing in assignments!");
+		return ImageF16(image, region);
+	}
 	inline ImageRgbaU8 image_getSubImage(const ImageRgbaU8& image, const IRect& region) {
 		static_assert(sizeof(ImageRgbaU8) == sizeof(Image), "ImageRgbaU8 must have the same size as Image, to prevent slicing in assignments!");
 		return ImageRgbaU8(image, region);
@@ -479,6 +598,16 @@ namespace dsr {
 		return image_getSafePointer<T>(image).increaseBytes(image_getStride(image) * rowIndex);
 	}
 	// Returns a bound-checked pointer to the first pixel.
+	template <typename T = uint16_t>
+	inline SafePointer<T> image_getSafePointer(const ImageF16& image) {
+		return image.impl_buffer.getSafe<T>("Pointer to ImageF16 pixels").increaseBytes(image_getStartOffset(image));
+	}
+	// Returns a bound-checked pointer to the first pixel at rowIndex.
+	template <typename T = uint16_t>
+	inline SafePointer<T> image_getSafePointer(const ImageF16& image, int32_t rowIndex) {
+		return image_getSafePointer<T>(image).increaseBytes(image_getStride(image) * rowIndex);
+	}
+	// Returns a bound-checked pointer to the first pixel.
 	template <typename T = uint32_t>
 	inline SafePointer<T> image_getSafePointer(const ImageRgbaU8& image) {
 		return image.impl_buffer.getSafe<T>("Pointer to ImageRgbaU8 pixels").increaseBytes(image_getStartOffset(image));
@@ -510,6 +639,9 @@ namespace dsr {
 	inline void image_dangerous_replaceDestructor(ImageF32& image, const HeapDestructor &newDestructor) {
 		if (image_exists(image)) { return buffer_replaceDestructor(image.impl_buffer, newDestructor); }
 	}
+	inline void image_dangerous_replaceDestructor(ImageF16& image, const HeapDestructor &newDestructor) {
+		if (image_exists(image)) { return buffer_replaceDestructor(image.impl_buffer, newDestructor); }
+	}
 	inline void image_dangerous_replaceDestructor(ImageRgbaU8& image, const HeapDestructor &newDestructor) {
 		if (image_exists(image)) { return buffer_replaceDestructor(image.impl_buffer, newDestructor); }
 	}
@@ -521,6 +653,7 @@ namespace dsr {
 	inline uint8_t* image_dangerous_getData(const ImageU8&     image) { return image.impl_buffer.getUnsafe() + image_getStartOffset(image); }
 	inline uint8_t* image_dangerous_getData(const ImageU16&    image) { return image.impl_buffer.getUnsafe() + image_getStartOffset(image); }
 	inline uint8_t* image_dangerous_getData(const ImageF32&    image) { return image.impl_buffer.getUnsafe() + image_getStartOffset(image); }
+	inline uint8_t* image_dangerous_getData(const ImageF16&    image) { return image.impl_buffer.getUnsafe() + image_getStartOffset(image); }
 	inline uint8_t* image_dangerous_getData(const ImageRgbaU8& image) { return image.impl_buffer.getUnsafe() + image_getStartOffset(image); }
 }
 
@@ -0,0 +1,355 @@
+﻿
+// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+#include "imageExpressionAPI.h"
+#include "imageAPI.h"
+#include "../base/simd.h"
+#include "../base/threading.h"
+#include "../base/virtualStack.h"
+#include "../implementation/render/shader/shaderTypes.h"
+
+#define MUST_EXIST(OBJECT, METHOD) if (OBJECT.isNull()) { throwError(U"The " #OBJECT U" handle was null in " #METHOD U"\n"); }
+
+namespace dsr {
+
+// The number of pixels evaluated at a time by each instruction.
+//   Each instruction stores spanWidth * 16 bytes of intermediate values, which should fit in the data cache together with the other instructions.
+static const int32_t spanWidth = 128;
+static const int32_t groupsPerSpan = spanWidth / 8;
+
+enum class ExpressionOperation {
+	Image,
+	Color,
+	Add,
+	Subtract,
+	Multiply,
+	Scale,
+	AlphaFilter,
+	Resize
+};
+
+struct ImageExpressionImpl {
+	ExpressionOperation operation;
+	// Inputs to the operation.
+	ImageExpression left, right;
+	// The image to read from.
+	ImageRgbaU8 image;
+	ColorRgbaI32 color;
+	float factor = 1.0f;
+	Sampler interpolation = Sampler::Nearest;
+	// Expressions without dimensions have zero width and height.
+	int32_t width = 0;
+	int32_t height = 0;
+	explicit ImageExpressionImpl(ExpressionOperation operation) : operation(operation) {}
+};
+
+// An operation on registers, where each instruction writes to the register with the same index as the instruction.
+struct ExpressionInstruction {
+	ExpressionOperation operation;
+	int32_t left = -1;
+	int32_t right = -1;
+	ImageRgbaU8 image;
+	PackOrder packOrder;
+	float color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	float factor = 1.0f;
+	explicit ExpressionInstruction(ExpressionOperation operation) : operation(operation) {}
+};
+
+static ImageExpression createBinary(ExpressionOperation operation, const ImageExpression &left, const ImageExpression &right, const char32_t *methodName) {
+	if (left.isNull() || right.isNull()) {
+		throwError(U"Null expression given to ", methodName, U"!\n");
+	}
+	ImageExpression result = handle_create<ImageExpressionImpl>(operation).setName("Image expression");
+	if (expression_hasDimensions(left) && expression_hasDimensions(right) && (left->width != right->width || left->height != right->height)) {
+		throwError(U"The expressions given to ", methodName, U" have different dimensions (", left->width, U"x", left->height, U" and ", right->width, U"x", right->height, U")!\n");
+	}
+	result->left = left;
+	result->right = right;
+	const ImageExpression &bounded = expression_hasDimensions(left) ? left : right;
+	result->width = bounded->width;
+	result->height = bounded->height;
+	return result;
+}
+
+ImageExpression expression_image(const ImageRgbaU8 &image) {
+	if (!image_exists(image)) {
+		throwError(U"expression_image got an image that does not exist!\n");
+	}
+	ImageExpression result = handle_create<ImageExpressionImpl>(ExpressionOperation::Image).setName("Image expression");
+	result->image = image;
+	result->width = image_getWidth(image);
+	result->height = image_getHeight(image);
+	return result;
+}
+
+ImageExpression expression_color(const ColorRgbaI32 &color) {
+	ImageExpression result = handle_create<ImageExpressionImpl>(ExpressionOperation::Color).setName("Image expression");
+	result->color = color;
+	return result;
+}
+
+ImageExpression expression_add(const ImageExpression &left, const ImageExpression &right) {
+	return createBinary(ExpressionOperation::Add, left, right, U"expression_add");
+}
+
+ImageExpression expression_subtract(const ImageExpression &left, const ImageExpression &right) {
+	return createBinary(ExpressionOperation::Subtract, left, right, U"expression_subtract");
+}
+
+ImageExpression expression_multiply(const ImageExpression &left, const ImageExpression &right) {
+	return createBinary(ExpressionOperation::Multiply, left, right, U"expression_multiply");
+}
+
+ImageExpression expression_scale(const ImageExpression &source, float factor) {
+	MUST_EXIST(source, expression_scale);
+	ImageExpression result = handle_create<ImageExpressionImpl>(ExpressionOperation::Scale).setName("Image expression");
+	result->left = source;
+	result->factor = factor;
+	result->width = source->width;
+	result->height = source->height;
+	return result;
+}
+
+ImageExpression expression_alphaFilter(const ImageExpression &background, const ImageExpression &foreground) {
+	return createBinary(ExpressionOperation::AlphaFilter, background, foreground, U"expression_alphaFilter");
+}
+
+ImageExpression expression_resize(const ImageExpression &source, Sampler interpolation, int32_t newWidth, int32_t newHeight) {
+	MUST_EXIST(source, expression_resize);
+	if (!expression_hasDimensions(source)) {
+		throwError(U"expression_resize got an expression without dimensions!\n");
+	}
+	if (newWidth < 1 || newHeight < 1) {
+		throwError(U"expression_resize got the invalid dimensions ", newWidth, U"x", newHeight, U"!\n");
+	}
+	ImageExpression result = handle_create<ImageExpressionImpl>(ExpressionOperation::Resize).setName("Image expression");
+	result->left = source;
+	result->interpolation = interpolation;
+	result->width = newWidth;
+	result->height = newHeight;
+	return result;
+}
+
+bool expression_exists(const ImageExpression &expression) {
+	return expression.isNotNull();
+}
+
+bool expression_hasDimensions(const ImageExpression &expression) {
+	return expression.isNotNull() && expression->width > 0;
+}
+
+int32_t expression_getWidth(const ImageExpression &expression) {
+	return expression.isNotNull() ? expression->width : 0;
+}
+
+int32_t expression_getHeight(const ImageExpression &expression) {
+	return expression.isNotNull() ? expression->height : 0;
+}
+
+// Adds each node that compileExpression will create an instruction for to nodes once.
+//   Used to reserve all instructions before compiling, because growing a list would copy the images in the instructions without releasing the old copies.
+static void collectNodes(List<const ImageExpressionImpl*> &nodes, const ImageExpression &expression) {
+	for (int32_t n = 0; n < nodes.length(); n++) {
+		if (nodes[n] == expression.getUnsafe()) {
+			return;
+		}
+	}
+	ExpressionOperation operation = expression->operation;
+	if (operation != ExpressionOperation::Resize && operation != ExpressionOperation::Image && operation != ExpressionOperation::Color) {
+		collectNodes(nodes, expression->left);
+		if (expression->right.isNotNull()) {
+			collectNodes(nodes, expression->right);
+		}
+	}
+	nodes.push(expression.getUnsafe());
+}
+
+// Appends the instructions needed to evaluate expression and returns the index of the register containing the result.
+//   Expressions that were already compiled reuse the register from the first time, so that shared expressions are only evaluated once.
+static int32_t compileExpression(List<ExpressionInstruction> &instructions, List<const ImageExpressionImpl*> &compiledNodes, const ImageExpression &expression) {
+	for (int32_t n = 0; n < compiledNodes.length(); n++) {
+		if (compiledNodes[n] == expression.getUnsafe()) {
+			return n;
+		}
+	}
+	ExpressionOperation operation = expression->operation;
+	ExpressionInstruction instruction(operation == ExpressionOperation::Resize ? ExpressionOperation::Image : operation);
+	if (operation == ExpressionOperation::Resize) {
+		// Neighboring pixels are needed, so the input is evaluated into a full image.
+		//   The result is only kept by the instruction, so that each evaluation sees the current pixels of its inputs
+		//   and evaluations on different threads do not write to the shared expression.
+		instruction.image = filter_resize(expression_evaluate(expression->left), expression->interpolation, expression->width, expression->height);
+		instruction.packOrder = image_getPackOrder(instruction.image);
+	} else if (operation == ExpressionOperation::Image) {
+		instruction.image = expression->image;
+		instruction.packOrder = image_getPackOrder(expression->image);
+	} else if (operation == ExpressionOperation::Color) {
+		instruction.color[0] = float(clamp(0, expression->color.red, 255));
+		instruction.color[1] = float(clamp(0, expression->color.green, 255));
+		instruction.color[2] = float(clamp(0, expression->color.blue, 255));
+		instruction.color[3] = float(clamp(0, expression->color.alpha, 255));
+	} else {
+		instruction.factor = expression->factor;
+		instruction.left = compileExpression(instructions, compiledNodes, expression->left);
+		if (expression->right.isNotNull()) {
+			instruction.right = compileExpression(instructions, compiledNodes, expression->right);
+		}
+	}
+	instructions.push(instruction);
+	compiledNodes.push(expression.getUnsafe());
+	return instructions.length() - 1;
+}
+
+// Evaluates all instructions for pixelCount pixels starting at (left, y), with the result in the last instruction's register.
+static void evaluateSpan(const List<ExpressionInstruction> &instructions, SafePointer<Rgba_F32x8> registers, int32_t left, int32_t y, int32_t pixelCount) {
+	int32_t groupCount = (pixelCount + 7) / 8;
+	for (int32_t i = 0; i < instructions.length(); i++) {
+		const ExpressionInstruction &instruction = instructions[i];
+		SafePointer<Rgba_F32x8> result = registers + i * groupsPerSpan;
+		SafePointer<Rgba_F32x8> a = registers + max(0, instruction.left) * groupsPerSpan;
+		SafePointer<Rgba_F32x8> b = registers + max(0, instruction.right) * groupsPerSpan;
+		switch (instruction.operation) {
+			case ExpressionOperation::Image: {
+				SafePointer<uint32_t> sourcePixel = image_getSafePointer<uint32_t>(instruction.image, y) + left;
+				// Copying to a temporary array first, so that the last vector does not read outside of the image.
+				ALIGN32 uint32_t lanes[8];
+				for (int32_t g = 0; g < groupCount; g++) {
+					int32_t laneCount = min(8, pixelCount - g * 8);
+					for (int32_t l = 0; l < 8; l++) {
+						lanes[l] = l < laneCount ? sourcePixel[l] : 0u;
+					}
+					result[g] = Rgba_F32x8(U32x8::readAlignedUnsafe(lanes), instruction.packOrder);
+					sourcePixel += 8;
+				}
+			} break;
+			case ExpressionOperation::Color: {
+				Rgba_F32x8 color = Rgba_F32x8(F32x8(instruction.color[0]), F32x8(instruction.color[1]), F32x8(instruction.color[2]), F32x8(instruction.color[3]));
+				for (int32_t g = 0; g < groupCount; g++) {
+					result[g] = color;
+				}
+			} break;
+			case ExpressionOperation::Add:
+				for (int32_t g = 0; g < groupCount; g++) {
+					result[g] = a[g] + b[g];
+				}
+				break;
+			case ExpressionOperation::Subtract:
+				for (int32_t g = 0; g < groupCount; g++) {
+					result[g] = a[g] - b[g];
+				}
+				break;
+			case ExpressionOperation::Multiply: {
+				F32x8 normalize = F32x8(1.0f / 255.0f);
+				for (int32_t g = 0; g < groupCount; g++) {
+					result[g] = a[g] * b[g] * normalize;
+				}
+			} break;
+			case ExpressionOperation::Scale: {
+				F32x8 factor = F32x8(instruction.factor);
+				for (int32_t g = 0; g < groupCount; g++) {
+					result[g] = a[g] * factor;
+				}
+			} break;
+			case ExpressionOperation::AlphaFilter: {
+				F32x8 normalize = F32x8(1.0f / 255.0f);
+				F32x8 one = F32x8(1.0f);
+				for (int32_t g = 0; g < groupCount; g++) {
+					const Rgba_F32x8 &background = a[g];
+					const Rgba_F32x8 &foreground = b[g];
+					F32x8 ratio = foreground.alpha * normalize;
+					result[g] = Rgba_F32x8(
+					  background.red + (foreground.red - background.red) * ratio,
+					  background.green + (foreground.green - background.green) * ratio,
+					  background.blue + (foreground.blue - background.blue) * ratio,
+					  foreground.alpha + background.alpha * (one - ratio)
+					);
+				}
+			} break;
+			default:
+				throwError(U"Unhandled operation in evaluateSpan!\n");
+		}
+	}
+}
+
+void expression_evaluate(const ImageRgbaU8 &target, const ImageExpression &expression, int32_t maxThreadCount) {
+	MUST_EXIST(expression, expression_evaluate);
+	if (!image_exists(target)) {
+		return;
+	}
+	int32_t width = image_getWidth(target);
+	int32_t height = image_getHeight(target);
+	if (expression_hasDimensions(expression) && (expression->width != width || expression->height != height)) {
+		throwError(U"expression_evaluate got a ", width, U"x", height, U" target for a ", expression->width, U"x", expression->height, U" expression!\n");
+		return;
+	}
+	// Materialized inputs are evaluated here on the calling thread, before the fused pass begins.
+	List<const ImageExpressionImpl*> compiledNodes;
+	collectNodes(compiledNodes, expression);
+	List<ExpressionInstruction> instructions;
+	instructions.reserve(compiledNodes.length());
+	compiledNodes.clear();
+	compileExpression(instructions, compiledNodes, expression);
+	PackOrder targetOrder = image_getPackOrder(target);
+	threadedSplit(0, height, [&target, &instructions, &targetOrder, width](int32_t startIndex, int32_t stopIndex) {
+		int32_t registerCount = instructions.length();
+		VirtualStackAllocation<Rgba_F32x8> registers(registerCount * groupsPerSpan, "Registers in expression_evaluate");
+		SafePointer<Rgba_F32x8> output = registers + (registerCount - 1) * groupsPerSpan;
+		F32x8 lowest = F32x8(0.0f);
+		F32x8 highest = F32x8(255.0f);
+		F32x8 half = F32x8(0.5f);
+		// Writing to a temporary array first, so that the last vector can not write to the next row belonging to another thread.
+		ALIGN32 uint32_t lanes[8];
+		for (int32_t y = startIndex; y < stopIndex; y++) {
+			SafePointer<uint32_t> targetPixel = image_getSafePointer<uint32_t>(target, y);
+			for (int32_t left = 0; left < width; left += spanWidth) {
+				int32_t pixelCount = min(spanWidth, width - left);
+				evaluateSpan(instructions, registers, left, y, pixelCount);
+				for (int32_t x = 0; x < pixelCount; x += 8) {
+					const Rgba_F32x8 &color = output[x / 8];
+					// Rounding to the nearest integer.
+					Rgba_F32x8 saturated = Rgba_F32x8(clamp(lowest, color.red, highest) + half, clamp(lowest, color.green, highest) + half, clamp(lowest, color.blue, highest) + half, clamp(lowest, color.alpha, highest) + half);
+					saturated.toSaturatedByte(targetOrder).writeAlignedUnsafe(lanes);
+					int32_t laneCount = min(8, pixelCount - x);
+					for (int32_t l = 0; l < laneCount; l++) {
+						targetPixel[l] = lanes[l];
+					}
+					targetPixel += 8;
+				}
+			}
+		}
+	}, max(1, 4096 / width), 2, maxThreadCount);
+}
+
+OrderedImageRgbaU8 expression_evaluate(const ImageExpression &expression) {
+	MUST_EXIST(expression, expression_evaluate);
+	if (!expression_hasDimensions(expression)) {
+		throwError(U"expression_evaluate can not create an image from an expression without dimensions!\n");
+		return OrderedImageRgbaU8();
+	}
+	OrderedImageRgbaU8 result = image_create_RgbaU8(expression->width, expression->height, false);
+	expression_evaluate(result, expression);
+	return result;
+}
+
+}
@@ -0,0 +1,105 @@
+﻿
+// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+// Lazy image expressions
+//   Chaining image operations by calling one filter at a time allocates a full intermediate image for each step,
+//   which has to be written to memory and read back again by the next step.
+//   An image expression only records the operations, so that the whole chain can be evaluated in one pass when the result is requested.
+//   The target is split into blocks of rows for multiple threads, and each row is processed in spans that are small enough to stay in the cache,
+//   so that intermediate values are never written to full images.
+//   Operations that need neighboring pixels, such as resizing, can not be fused with the operations before them,
+//   so their inputs are evaluated into an intermediate image each time the result is evaluated.
+// Example:
+//     ImageExpression background = expression_resize(expression_image(photo), Sampler::Triangle, 1024, 768);
+//     ImageExpression tinted = expression_multiply(background, expression_color(ColorRgbaI32(255, 200, 150, 255)));
+//     OrderedImageRgbaU8 result = expression_evaluate(expression_alphaFilter(tinted, expression_image(overlay)));
+
+#ifndef DFPSR_API_IMAGE_EXPRESSION
+#define DFPSR_API_IMAGE_EXPRESSION
+
+#include "../implementation/image/Image.h"
+#include "filterAPI.h"
+
+namespace dsr {
+
+	// A handle to an immutable node in an expression graph.
+	//   Expressions may be shared by multiple other expressions without being evaluated more than once within the same evaluation.
+	struct ImageExpressionImpl;
+	using ImageExpression = Handle<ImageExpressionImpl>;
+
+// Sources
+	// Post-condition: Returns an expression reading pixels from image.
+	//   The image is not cloned, so any changes to the pixels before evaluating will be visible in the result.
+	// Pre-condition: image must exist.
+	ImageExpression expression_image(const ImageRgbaU8 &image);
+	// Post-condition: Returns an expression where every pixel has the same color.
+	//   Colors do not have any dimensions, so they must be combined with other expressions or evaluated to an existing image.
+	ImageExpression expression_color(const ColorRgbaI32 &color);
+
+// Per-pixel operations
+//   Channels are stored as floats from 0 to 255 while evaluating, so that intermediate values may go outside of the byte range.
+//   Values are only clamped to the 0..255 range when written to the target.
+//   The expressions given as arguments must either have the same dimensions or be colors without dimensions.
+	// Post-condition: Returns left + right for each channel.
+	ImageExpression expression_add(const ImageExpression &left, const ImageExpression &right);
+	// Post-condition: Returns left - right for each channel.
+	ImageExpression expression_subtract(const ImageExpression &left, const ImageExpression &right);
+	// Post-condition: Returns left * right / 255 for each channel, which modulates colors without changing the range.
+	ImageExpression expression_multiply(const ImageExpression &left, const ImageExpression &right);
+	// Post-condition: Returns source * factor for each channel.
+	ImageExpression expression_scale(const ImageExpression &source, float factor);
+	// Post-condition: Returns foreground drawn over background using the foreground's alpha channel.
+	//   Like draw_alphaFilter, the background's alpha does not affect the colors.
+	//   The resulting alpha is foreground alpha + background alpha * (1 - foreground alpha / 255).
+	ImageExpression expression_alphaFilter(const ImageExpression &background, const ImageExpression &foreground);
+
+// Operations that materialize their input
+	// Post-condition: Returns source resized to newWidth x newHeight pixels using filter_resize.
+	//   Source is evaluated into an intermediate image once for each evaluation, so that changes to the pixels of source's images are visible.
+	// Pre-condition: source must have dimensions.
+	ImageExpression expression_resize(const ImageExpression &source, Sampler interpolation, int32_t newWidth, int32_t newHeight);
+
+// Information
+	// Post-condition: Returns true iff expression exists.
+	bool expression_exists(const ImageExpression &expression);
+	// Post-condition: Returns true iff expression has dimensions, which is false for expressions only made from colors.
+	bool expression_hasDimensions(const ImageExpression &expression);
+	// Post-condition: Returns the width of expression, or 0 if it has no dimensions.
+	int32_t expression_getWidth(const ImageExpression &expression);
+	// Post-condition: Returns the height of expression, or 0 if it has no dimensions.
+	int32_t expression_getHeight(const ImageExpression &expression);
+
+// Evaluation
+	// Post-condition: Returns a new image with the pixels of expression.
+	// Pre-condition: expression must have dimensions.
+	OrderedImageRgbaU8 expression_evaluate(const ImageExpression &expression);
+	// Side-effect: Writes the pixels of expression to target, using target's pack order.
+	//   The same image may be both read by expression and written to as target, because each pixel only depends on the pixels at the same location.
+	//   Set maxThreadCount to 1 to evaluate on the calling thread.
+	// Pre-condition: target must have the same dimensions as expression, unless expression has no dimensions.
+	void expression_evaluate(const ImageRgbaU8 &target, const ImageExpression &expression, int32_t maxThreadCount = 0);
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "drawAPI.h"
 // TODO: Inline as much as possible from Model.h to modelAPI.cpp, to reduce call depth and make it easy to copy and modify the model implementation.
 #include "../implementation/render/model/Model.h"
+#include "../implementation/render/model/simplify.h"
 #include "../base/virtualStack.h"
 #include <limits>
 
@@ -173,6 +174,28 @@ void model_setDiffuseMap(Model& model, int32_t partIndex, const TextureRgbaU8 &d
 	model->setDiffuseMap(diffuseMap, partIndex);
 }
 
+void model_setDiffuseMapFromAtlas(Model& model, int32_t partIndex, const TextureAtlas &atlas, int32_t imageIndex) {
+	MUST_EXIST(model,model_setDiffuseMapFromAtlas);
+	if (imageIndex < 0 || imageIndex >= atlas.regions.length()) {
+		throwError(U"model_setDiffuseMapFromAtlas got the image index ", imageIndex, U", which is not within the atlas' 0..", atlas.regions.length() - 1, U" range!\n");
+		return;
+	}
+	model->setDiffuseMap(atlas.texture, partIndex);
+	const IRect &region = atlas.regions[imageIndex];
+	float scaleU = 1.0f / float(texture_getMaxWidth(atlas.texture));
+	float scaleV = 1.0f / float(texture_getMaxHeight(atlas.texture));
+	float offsetU = float(region.left()) * scaleU;
+	float offsetV = float(region.top()) * scaleV;
+	float widthU = float(region.width()) * scaleU;
+	float heightV = float(region.height()) * scaleV;
+	for (int32_t polygon = 0; polygon < model->getNumberOfPolygons(partIndex); polygon++) {
+		for (int32_t vertex = 0; vertex < model->getPolygonVertexCount(partIndex, polygon); vertex++) {
+			FVector4D texCoord = model->getTexCoord(partIndex, polygon, vertex);
+			model->setTexCoord(partIndex, polygon, vertex, FVector4D(offsetU + texCoord.x * widthU, offsetV + texCoord.y * heightV, texCoord.z, texCoord.w));
+		}
+	}
+}
+
 void model_setDiffuseMapByName(Model& model, int32_t partIndex, ResourcePool &pool, const String &filename) {
 	MUST_EXIST(model,model_setDiffuseMapByName);
 	model->setDiffuseMapByName(pool, filename, partIndex);
@@ -244,8 +267,8 @@ void model_render_threaded(const Model& model, const Transform3D &modelToWorldTr
 		// Get a pointer to the current part.
 		Part *part = &(model->partBuffer[partIndex]);
 		// Get textures.
-		const TextureRgbaU8 diffuse = part->diffuseMap;
-		const TextureRgbaU8 light = part->lightMap;
+		const TextureRgbaU8 diffuse = part->useDiffuseMap();
+		const TextureRgbaU8 light = part->useLightMap();
 		for (int32_t p = 0; p < part->polygonBuffer.length(); p++) {
 			Polygon polygon = part->polygonBuffer[p];
 			// Render first triangle in the polygon of indices 0, 1, 2.
@@ -280,4 +303,85 @@ void model_render_threaded(const Model& model, const Transform3D &modelToWorldTr
 	}
 }
 
+List<Model> model_generateLevelsOfDetail(const Model& model, int32_t levelCount, float triangleRatio) {
+	MUST_EXIST(model, model_generateLevelsOfDetail);
+	if (levelCount < 1) {
+		throwError(U"model_generateLevelsOfDetail needs at least one level, but got ", levelCount, U"!\n");
+		return List<Model>();
+	}
+	if (triangleRatio <= 0.0f || triangleRatio >= 1.0f) {
+		throwError(U"model_generateLevelsOfDetail got the triangle ratio ", triangleRatio, U", which is not between 0 and 1!\n");
+		return List<Model>();
+	}
+	List<Model> result;
+	result.push(model);
+	if (levelCount < 2) {
+		return result;
+	}
+	List<Model> simplified = simplifyModel(*model.getUnsafe(), levelCount, triangleRatio);
+	for (int32_t level = 0; level < simplified.length(); level++) {
+		result.push(simplified[level]);
+	}
+	return result;
+}
+
+int32_t model_getNumberOfTriangles(const Model& model) {
+	MUST_EXIST(model, model_getNumberOfTriangles);
+	int32_t result = 0;
+	for (int32_t partIndex = 0; partIndex < model->partBuffer.length(); partIndex++) {
+		const List<Polygon> &polygons = model->partBuffer[partIndex].polygonBuffer;
+		for (int32_t p = 0; p < polygons.length(); p++) {
+			result += (polygons[p].pointIndices[3] == -1) ? 1 : 2;
+		}
+	}
+	return result;
+}
+
+List<int32_t> model_getNumberOfTriangles(const List<Model>& levels) {
+	List<int32_t> result;
+	result.reserve(levels.length());
+	for (int32_t level = 0; level < levels.length(); level++) {
+		result.push(model_getNumberOfTriangles(levels[level]));
+	}
+	return result;
+}
+
+int32_t model_selectLevelOfDetail(const List<Model>& levels, const List<int32_t>& triangleCounts, const Transform3D &modelToWorldTransform, const Camera &camera, float pixelsPerTriangle) {
+	if (levels.length() == 0) {
+		throwError(U"model_selectLevelOfDetail got an empty list of levels!\n");
+		return 0;
+	}
+	if (triangleCounts.length() != levels.length()) {
+		throwError(U"model_selectLevelOfDetail got ", triangleCounts.length(), U" triangle counts for ", levels.length(), U" levels!\n");
+		return 0;
+	}
+	const Model &highest = levels[0];
+	MUST_EXIST(highest, model_selectLevelOfDetail);
+	// Get a bounding sphere in world space, using the longest axis to be safe with non-uniform scaling.
+	FVector3D center = (highest->minBound + highest->maxBound) * 0.5f;
+	float scale = std::max(std::max(length(modelToWorldTransform.transform.xAxis), length(modelToWorldTransform.transform.yAxis)), length(modelToWorldTransform.transform.zAxis));
+	float radius = length(highest->maxBound - center) * scale;
+	float depth = camera.worldToCamera(modelToWorldTransform.transformPoint(center)).z;
+	float pixelsPerUnit = camera.invWidthSlope * camera.imageWidth;
+	if (camera.perspective) {
+		float closestDepth = depth - radius;
+		if (closestDepth <= camera.nearClip) {
+			return 0;
+		}
+		pixelsPerUnit = pixelsPerUnit / closestDepth;
+	}
+	float pixelRadius = radius * pixelsPerUnit;
+	float projectedArea = 3.14159265f * pixelRadius * pixelRadius;
+	for (int32_t level = 0; level < levels.length(); level++) {
+		if (float(triangleCounts[level]) * pixelsPerTriangle <= projectedArea) {
+			return level;
+		}
+	}
+	return levels.length() - 1;
+}
+
+void model_render_threaded(const List<Model>& levels, const List<int32_t>& triangleCounts, float pixelsPerTriangle, const Transform3D &modelToWorldTransform, Renderer& renderer, const Camera &camera) {
+	model_render_threaded(levels[model_selectLevelOfDetail(levels, triangleCounts, modelToWorldTransform, camera, pixelsPerTriangle)], modelToWorldTransform, renderer, camera);
+}
+
 }
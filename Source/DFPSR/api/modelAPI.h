@@ -70,6 +70,8 @@ namespace dsr {
 	//   Two separate models can be used if you need both solid and filtered geometry.
 	// Filters:
 	//   Filter::Alpha uses the alpha channel from the shader as opacity.
+	//   Filter::AlphaPremultiplied uses alpha as opacity for colors that are already multiplied by alpha, such as from textures where texture_isPremultiplied is true.
+	//     Only the target color has to be multiplied, and transparent texels do not bleed their colors into bi-linear samples.
 	//   Filter::Solid is the default setting for newly created models.
 	// Pre-condition: model must refer to an existing model.
 	// Side-effect: Sets the given model's filter to the given filter argument.
@@ -217,6 +219,17 @@ namespace dsr {
 	//   Sets the diffuse texture in the part at partIndex in model to diffuseMap.
 	//   If diffuseMap is an empty image handle, then the diffuse texture will be replaced by the default solid white color.
 	void model_setDiffuseMap(Model& model, int32_t partIndex, const TextureRgbaU8 &diffuseMap);
+	// Set the part's diffuse texture to an image packed into a texture atlas by texture_createAtlas.
+	//   Parts using the same atlas share the same texture, so that the renderer reads from fewer textures.
+	// Pre-condition:
+	//   model must refer to an existing model.
+	//   0 <= imageIndex < atlas.regions.length()
+	//   The part's diffuse texture coordinates (x, y) are within 0..1, because repeating the image would sample neighbor images in the atlas.
+	// Side-effect:
+	//   Sets the diffuse texture in the part at partIndex in model to atlas.texture.
+	//   Remaps the diffuse texture coordinates of all vertices in the part from the whole image to the image's region in the atlas.
+	//   Light-map texture coordinates (z, w) are kept.
+	void model_setDiffuseMapFromAtlas(Model& model, int32_t partIndex, const TextureAtlas &atlas, int32_t imageIndex);
 	// Automatically find the diffuse texture by name in the resource pool and assign it.
 	// Pre-condition:
 	//   model must refer to an existing model.
@@ -229,6 +242,7 @@ namespace dsr {
 	//     "Car_1.2" is rejected for using a dot in the actual name, just to catch more mistakes with file extensions.
 	// Side-effect:
 	//   Sets the diffuse texture in the part at partIndex in model to the image looked up by filename in pool.
+	//   If the pool streams textures, the texture is taken from a slot that the pool may replace with other resolutions in calls to update.
 	void model_setDiffuseMapByName(Model& model, int32_t partIndex, ResourcePool &pool, const String &filename);
 	// Get the part's light texture.
 	// Pre-condition:
@@ -255,6 +269,7 @@ namespace dsr {
 	//   filename must be the image's filename without any extension nor path.
 	// Side-effect:
 	//   Sets the light texture in the part at partIndex in model to the image looked up by filename in pool.
+	//   If the pool streams textures, the texture is taken from a slot that the pool may replace with other resolutions in calls to update.
 	void model_setLightMapByName(Model& model, int32_t partIndex, ResourcePool &pool, const String &filename);
 
 	// In order to draw two adjacent polygons without any missing pixels along the seam, they must:
@@ -300,6 +315,34 @@ namespace dsr {
 		model_render_threaded(model, modelToWorldTransform, renderer, camera);
 	}
 
+	// Level of detail
+	//   Distant models cover few pixels but cost as much to project and set up triangles for as when close to the camera.
+	//   A chain of simplified models can be generated once when loading, and the renderer picks a level from the projected size of each instance.
+	// Pre-condition:
+	//   model must exist.
+	//   levelCount >= 1
+	//   0.0f < triangleRatio < 1.0f
+	// Post-condition: Returns levelCount models, with model itself at index 0, followed by simplified models for increasing distances.
+	//   Each simplified level aims for triangleRatio times the triangles of the previous level, by collapsing the edges that change the shape the least.
+	//   Texture coordinates and vertex colors are preserved along seams, and open borders keep their outline.
+	//   The simplified models are made of triangles sharing the original model's parts, textures and bounding box.
+	List<Model> model_generateLevelsOfDetail(const Model& model, int32_t levelCount, float triangleRatio = 0.25f);
+	// Post-condition: Returns the number of triangles in model, counting each quad as two triangles.
+	int32_t model_getNumberOfTriangles(const Model& model);
+	// Post-condition: Returns the number of triangles in each model of levels, to be counted once and given to model_selectLevelOfDetail.
+	List<int32_t> model_getNumberOfTriangles(const List<Model>& levels);
+	// Pre-condition:
+	//   levels must have at least one existing model, with the most detailed at index 0 and the same bounding box for all levels.
+	//   triangleCounts must contain the number of triangles for each model in levels, from model_getNumberOfTriangles.
+	// Post-condition: Returns the index of the most detailed level in levels where the triangles cover at least pixelsPerTriangle pixels on average,
+	//   using the projected bounding sphere of the model as its area in pixels.
+	//   Returns 0 when the camera is inside of the bounding sphere.
+	//   Returns the last index if no level has few enough triangles.
+	int32_t model_selectLevelOfDetail(const List<Model>& levels, const List<int32_t>& triangleCounts, const Transform3D &modelToWorldTransform, const Camera &camera, float pixelsPerTriangle);
+	// Side-effect: Calls model_render_threaded with the level selected by model_selectLevelOfDetail.
+	// Pre-condition: Same as for model_selectLevelOfDetail and model_render_threaded.
+	void model_render_threaded(const List<Model>& levels, const List<int32_t>& triangleCounts, float pixelsPerTriangle, const Transform3D &modelToWorldTransform, Renderer& renderer, const Camera &camera);
+
 	// Imports a DMF model from file content.
 	//   Use in combination with string_load or your own system for storing files.
 	//   Example:
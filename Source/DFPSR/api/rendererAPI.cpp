@@ -28,6 +28,7 @@
 #include "drawAPI.h"
 #include "../implementation/render/renderCore.h"
 #include "../base/virtualStack.h"
+#include "../base/simd.h"
 
 #define MUST_EXIST(OBJECT, METHOD) if (OBJECT.isNull()) { throwError(U"The " #OBJECT U" handle was null in " #METHOD U"\n"); }
 
@@ -99,6 +100,17 @@ static IRect getPixelBoundFromProjection(const ProjectedPoint* convexHullCorners
 	return result;
 }
 
+// Converts a floating-point pixel coordinate into an integer without overflowing when points are projected close to the camera.
+static int32_t clampedPixel(float value) {
+	if (value < -1000000.0f) {
+		return -1000000;
+	} else if (value > 1000000.0f) {
+		return 1000000;
+	} else {
+		return int32_t(floor(value));
+	}
+}
+
 static bool pointInsideOfEdge(const LVector2D &edgeA, const LVector2D &edgeB, const LVector2D &point) {
 	LVector2D edgeDirection = LVector2D(edgeB.y - edgeA.y, edgeA.x - edgeB.x);
 	LVector2D relativePosition = point - edgeA;
@@ -144,11 +156,12 @@ struct RendererImpl {
 	ImageF32 depthBuffer; // Linear depth for isometric cameras, 1 / depth for perspective cameras
 	ImageF32 depthGrid; // An occlusion grid of cellSize² cells representing the longest linear depth where something might be visible
 	CommandQueue commandQueue; // Triangles to be drawn
+	TileClear tileClear; // Clear values for the target images, which are applied one tile at a time while drawing
 	List<DebugLine> debugLines; // Additional lines to be drawn as an overlay for debugging occlusion
 	int32_t width = 0, height = 0, gridWidth = 0, gridHeight = 0;
 	bool occluded = false;
 	RendererImpl() {}
-	void beginFrame(ImageRgbaU8& colorBuffer, ImageF32& depthBuffer) {
+	void beginFrame(ImageRgbaU8& colorBuffer, ImageF32& depthBuffer, const TileClear &tileClear = TileClear()) {
 		if (this->receiving) {
 			throwError(U"Called renderer_begin on the same renderer twice without ending the previous batch!\n");
 		}
@@ -165,6 +178,14 @@ struct RendererImpl {
 		this->gridWidth = (this->width + (cellSize - 1)) / cellSize;
 		this->gridHeight = (this->height + (cellSize - 1)) / cellSize;
 		this->occluded = false;
+		this->tileClear = tileClear;
+	}
+	// Clears the whole target images at once if tile clearing is pending, so that the pixels can be read before renderer_end.
+	void resolveClear() {
+		if (this->tileClear.isActive()) {
+			this->tileClear.clearRegion(IRect::FromSize(this->width, this->height));
+			this->tileClear = TileClear();
+		}
 	}
 	IRect getOuterCellBound(const IRect &pixelBound) const {
 		int32_t minCellX = pixelBound.left() / cellSize;
@@ -327,6 +348,10 @@ struct RendererImpl {
 		for (int32_t c = 0; c < cornerCount; c++) {
 			replaceWithSmaller(closestDistance, outputHullCorners[c].cs.z);
 		}
+		return isRegionOccluded(pixelBound, closestDistance);
+	}
+	// Returns true iff all cells touched by pixelBound in the occlusion grid are closer than closestDistance.
+	bool isRegionOccluded(const IRect &pixelBound, float closestDistance) const {
 		// Loop over all cells within the bound
 		IRect outerBound = getOuterCellBound(pixelBound);
 		for (int32_t cellY = outerBound.top(); cellY < outerBound.bottom(); cellY++) {
@@ -338,6 +363,174 @@ struct RendererImpl {
 		}
 		return true; // Occluded, because none of the cells had a more distant depth.
 	}
+	// Tests the visibility of eight boxes at a time, with one box in each SIMD lane.
+	// Returns a mask with bit l set iff box firstBox + l may be visible. Lanes outside of boxCount are cleared.
+	uint32_t getBoxVisibility8(SafePointer<const FVector3D> minimums, SafePointer<const FVector3D> maximums, SafePointer<const Transform3D> modelToWorldTransforms, int32_t firstBox, int32_t boxCount, const Camera &camera) const {
+		// Transpose box data into one array per value, so that each lane can be read as a vector.
+		//   Lanes outside of the boxes repeat the last box, so that no invalid data is processed.
+		ALIGN32 float lanes[18 * 8];
+		int32_t laneCount = boxCount - firstBox;
+		if (laneCount > 8) { laneCount = 8; }
+		for (int32_t l = 0; l < 8; l++) {
+			int32_t b = firstBox + (l < laneCount ? l : laneCount - 1);
+			const FVector3D &minimum = minimums[b];
+			const FVector3D &maximum = maximums[b];
+			const Transform3D &transform = modelToWorldTransforms[b];
+			lanes[ 0 * 8 + l] = minimum.x;
+			lanes[ 1 * 8 + l] = minimum.y;
+			lanes[ 2 * 8 + l] = minimum.z;
+			lanes[ 3 * 8 + l] = maximum.x;
+			lanes[ 4 * 8 + l] = maximum.y;
+			lanes[ 5 * 8 + l] = maximum.z;
+			lanes[ 6 * 8 + l] = transform.transform.xAxis.x;
+			lanes[ 7 * 8 + l] = transform.transform.xAxis.y;
+			lanes[ 8 * 8 + l] = transform.transform.xAxis.z;
+			lanes[ 9 * 8 + l] = transform.transform.yAxis.x;
+			lanes[10 * 8 + l] = transform.transform.yAxis.y;
+			lanes[11 * 8 + l] = transform.transform.yAxis.z;
+			lanes[12 * 8 + l] = transform.transform.zAxis.x;
+			lanes[13 * 8 + l] = transform.transform.zAxis.y;
+			lanes[14 * 8 + l] = transform.transform.zAxis.z;
+			lanes[15 * 8 + l] = transform.position.x;
+			lanes[16 * 8 + l] = transform.position.y;
+			lanes[17 * 8 + l] = transform.position.z;
+		}
+		F32x8 minX = F32x8::readAlignedUnsafe(lanes +  0 * 8);
+		F32x8 minY = F32x8::readAlignedUnsafe(lanes +  1 * 8);
+		F32x8 minZ = F32x8::readAlignedUnsafe(lanes +  2 * 8);
+		F32x8 maxX = F32x8::readAlignedUnsafe(lanes +  3 * 8);
+		F32x8 maxY = F32x8::readAlignedUnsafe(lanes +  4 * 8);
+		F32x8 maxZ = F32x8::readAlignedUnsafe(lanes +  5 * 8);
+		F32x8 xAxisX = F32x8::readAlignedUnsafe(lanes +  6 * 8);
+		F32x8 xAxisY = F32x8::readAlignedUnsafe(lanes +  7 * 8);
+		F32x8 xAxisZ = F32x8::readAlignedUnsafe(lanes +  8 * 8);
+		F32x8 yAxisX = F32x8::readAlignedUnsafe(lanes +  9 * 8);
+		F32x8 yAxisY = F32x8::readAlignedUnsafe(lanes + 10 * 8);
+		F32x8 yAxisZ = F32x8::readAlignedUnsafe(lanes + 11 * 8);
+		F32x8 zAxisX = F32x8::readAlignedUnsafe(lanes + 12 * 8);
+		F32x8 zAxisY = F32x8::readAlignedUnsafe(lanes + 13 * 8);
+		F32x8 zAxisZ = F32x8::readAlignedUnsafe(lanes + 14 * 8);
+		F32x8 positionX = F32x8::readAlignedUnsafe(lanes + 15 * 8);
+		F32x8 positionY = F32x8::readAlignedUnsafe(lanes + 16 * 8);
+		F32x8 positionZ = F32x8::readAlignedUnsafe(lanes + 17 * 8);
+		// The camera is the same for all lanes.
+		const Transform3D &cameraLocation = camera.location;
+		F32x8 cameraPositionX = F32x8(cameraLocation.position.x);
+		F32x8 cameraPositionY = F32x8(cameraLocation.position.y);
+		F32x8 cameraPositionZ = F32x8(cameraLocation.position.z);
+		int32_t planeCount = camera.cullFrustum.getPlaneCount();
+		// The smallest signed distance to each plane in the culling frustum, where a positive distance means that all corners are outside.
+		ALIGN32 float minPlaneDistances[6 * 8];
+		for (int32_t i = 0; i < 6 * 8; i++) {
+			minPlaneDistances[i] = DSR_FLOAT_INF;
+		}
+		F32x8 closestDistance = F32x8(DSR_FLOAT_INF);
+		F32x8 minPixelX = F32x8(DSR_FLOAT_INF);
+		F32x8 minPixelY = F32x8(DSR_FLOAT_INF);
+		F32x8 maxPixelX = F32x8(-DSR_FLOAT_INF);
+		F32x8 maxPixelY = F32x8(-DSR_FLOAT_INF);
+		for (int32_t corner = 0; corner < 8; corner++) {
+			F32x8 localX = (corner & 4) ? maxX : minX;
+			F32x8 localY = (corner & 2) ? maxY : minY;
+			F32x8 localZ = (corner & 1) ? maxZ : minZ;
+			// Model to world space.
+			F32x8 worldX = localX * xAxisX + localY * yAxisX + localZ * zAxisX + positionX;
+			F32x8 worldY = localX * xAxisY + localY * yAxisY + localZ * zAxisY + positionY;
+			F32x8 worldZ = localX * xAxisZ + localY * yAxisZ + localZ * zAxisZ + positionZ;
+			// World to camera space.
+			F32x8 relativeX = worldX - cameraPositionX;
+			F32x8 relativeY = worldY - cameraPositionY;
+			F32x8 relativeZ = worldZ - cameraPositionZ;
+			F32x8 cameraX = relativeX * cameraLocation.transform.xAxis.x + relativeY * cameraLocation.transform.xAxis.y + relativeZ * cameraLocation.transform.xAxis.z;
+			F32x8 cameraY = relativeX * cameraLocation.transform.yAxis.x + relativeY * cameraLocation.transform.yAxis.y + relativeZ * cameraLocation.transform.yAxis.z;
+			F32x8 cameraZ = relativeX * cameraLocation.transform.zAxis.x + relativeY * cameraLocation.transform.zAxis.y + relativeZ * cameraLocation.transform.zAxis.z;
+			// Culling against each plane.
+			for (int32_t s = 0; s < planeCount; s++) {
+				FPlane3D plane = camera.cullFrustum.getPlane(s);
+				F32x8 distance = cameraX * plane.normal.x + cameraY * plane.normal.y + cameraZ * plane.normal.z - plane.offset;
+				min(F32x8::readAlignedUnsafe(minPlaneDistances + s * 8), distance).writeAlignedUnsafe(minPlaneDistances + s * 8);
+			}
+			closestDistance = min(closestDistance, cameraZ);
+			// Project to pixel coordinates.
+			F32x8 pixelX = F32x8::create_dangerous_uninitialized();
+			F32x8 pixelY = F32x8::create_dangerous_uninitialized();
+			if (camera.perspective) {
+				// Lanes with corners behind the camera are tested again without SIMD, so it does not matter if the result is garbage for them.
+				F32x8 invDepth = reciprocal(cameraZ);
+				F32x8 centerShear = cameraZ * 0.5f;
+				pixelX = (cameraX * camera.invWidthSlope + centerShear) * camera.imageWidth * invDepth;
+				pixelY = (centerShear - cameraY * camera.invHeightSlope) * camera.imageHeight * invDepth;
+			} else {
+				pixelX = (cameraX * camera.invWidthSlope + 0.5f) * camera.imageWidth;
+				pixelY = (0.5f - cameraY * camera.invHeightSlope) * camera.imageHeight;
+			}
+			minPixelX = min(minPixelX, pixelX);
+			minPixelY = min(minPixelY, pixelY);
+			maxPixelX = max(maxPixelX, pixelX);
+			maxPixelY = max(maxPixelY, pixelY);
+		}
+		ALIGN32 float closestDistances[8];
+		ALIGN32 float minPixelsX[8];
+		ALIGN32 float minPixelsY[8];
+		ALIGN32 float maxPixelsX[8];
+		ALIGN32 float maxPixelsY[8];
+		closestDistance.writeAlignedUnsafe(closestDistances);
+		minPixelX.writeAlignedUnsafe(minPixelsX);
+		minPixelY.writeAlignedUnsafe(minPixelsY);
+		maxPixelX.writeAlignedUnsafe(maxPixelsX);
+		maxPixelY.writeAlignedUnsafe(maxPixelsY);
+		uint32_t result = 0u;
+		for (int32_t l = 0; l < laneCount; l++) {
+			bool visible = true;
+			// Hidden if all corners are outside of the same plane.
+			for (int32_t s = 0; s < planeCount; s++) {
+				if (minPlaneDistances[s * 8 + l] > 0.0f) {
+					visible = false;
+					break;
+				}
+			}
+			if (visible && this->occluded) {
+				if (camera.perspective && closestDistances[l] <= 0.0f) {
+					// Corners behind the camera can not be projected using SIMD, so fall back on testing a single box.
+					int32_t b = firstBox + l;
+					visible = !isBoxOccluded(minimums[b], maximums[b], modelToWorldTransforms[b], camera);
+				} else {
+					// Expand the pixel bound by one pixel in each direction to be conservative about approximations.
+					int32_t left = clampedPixel(minPixelsX[l]) - 1;
+					int32_t top = clampedPixel(minPixelsY[l]) - 1;
+					int32_t right = clampedPixel(maxPixelsX[l]) + 2;
+					int32_t bottom = clampedPixel(maxPixelsY[l]) + 2;
+					visible = !isRegionOccluded(IRect(left, top, right - left, bottom - top), closestDistances[l]);
+				}
+			}
+			if (visible) {
+				result |= 1u << l;
+			}
+		}
+		return result;
+	}
+	void getBoxVisibility(SafePointer<const FVector3D> minimums, SafePointer<const FVector3D> maximums, SafePointer<const Transform3D> modelToWorldTransforms, int32_t boxCount, const Camera &camera, SafePointer<uint32_t> visibilityMask) const {
+		if (!this->receiving) {
+			throwError(U"Cannot call renderer_getBoxVisibility without first calling renderer_begin!\n");
+		}
+		if (boxCount <= 0) {
+			return;
+		}
+		int32_t wordCount = (boxCount + 31) / 32;
+		// Each job writes whole 32-bit words, so that no two threads write to the same element.
+		threadedSplit(0, wordCount, [this, &minimums, &maximums, &modelToWorldTransforms, boxCount, &camera, &visibilityMask](int32_t startIndex, int32_t stopIndex) {
+			for (int32_t w = startIndex; w < stopIndex; w++) {
+				uint32_t word = 0u;
+				for (int32_t group = 0; group < 4; group++) {
+					int32_t firstBox = w * 32 + group * 8;
+					if (firstBox < boxCount) {
+						word |= this->getBoxVisibility8(minimums, maximums, modelToWorldTransforms, firstBox, boxCount, camera) << (group * 8);
+					}
+				}
+				visibilityMask[w] = word;
+			}
+		}, 16);
+	}
 	// Checks if the box from minimum to maximum in object space is fully occluded when seen by the camera
 	// Must be the same camera as when occluders filled the grid with occlusion depth
 	bool isBoxOccluded(const FVector3D &minimum, const FVector3D &maximum, const Transform3D &modelToWorldTransform, const Camera &camera) const {
@@ -356,7 +549,8 @@ struct RendererImpl {
 		this->receiving = false;
 		// Mark occluded triangles to prevent them from being rendered
 		completeOcclusion();
-		this->commandQueue.execute(IRect::FromSize(this->width, this->height));
+		this->commandQueue.execute(IRect::FromSize(this->width, this->height), 12, this->tileClear);
+		this->tileClear = TileClear();
 		if (image_exists(this->colorBuffer)) {
 			// Debug drawn triangles
 			if (debugWireframe) {
@@ -409,6 +603,8 @@ struct RendererImpl {
 		if (!image_exists(this->depthBuffer)) {
 			throwError(U"Cannot call renderer_occludeFromTopRows without having given a depth buffer in renderer_begin!\n");
 		}
+		// The depth buffer must contain the cleared depth before it can be read.
+		this->resolveClear();
 		SafePointer<float> depthRow = image_getSafePointer(this->depthBuffer);
 		int32_t depthStride = image_getStride(this->depthBuffer);
 		SafePointer<float> gridRow = image_getSafePointer(this->depthGrid);
@@ -500,6 +696,11 @@ void renderer_begin(Renderer& renderer, ImageRgbaU8& colorBuffer, ImageF32& dept
 	renderer->beginFrame(colorBuffer, depthBuffer);
 }
 
+void renderer_begin(Renderer& renderer, ImageRgbaU8& colorBuffer, ImageF32& depthBuffer, const ColorRgbaI32& clearColor, float clearDepth) {
+	MUST_EXIST(renderer, renderer_begin);
+	renderer->beginFrame(colorBuffer, depthBuffer, TileClear(colorBuffer, clearColor, depthBuffer, clearDepth));
+}
+
 void renderer_giveTask_triangle(Renderer& renderer,
   const ProjectedPoint &posA, const ProjectedPoint &posB, const ProjectedPoint &posC,
   const FVector4D &colorA, const FVector4D &colorB, const FVector4D &colorC,
@@ -542,6 +743,11 @@ bool renderer_isBoxVisible(const Renderer& renderer, const FVector3D &minimum, c
 	return !(renderer->isBoxOccluded(minimum, maximum, modelToWorldTransform, camera));
 }
 
+void renderer_getBoxVisibility(const Renderer& renderer, SafePointer<const FVector3D> minimums, SafePointer<const FVector3D> maximums, SafePointer<const Transform3D> modelToWorldTransforms, int32_t boxCount, const Camera &camera, SafePointer<uint32_t> visibilityMask) {
+	MUST_EXIST(renderer, renderer_getBoxVisibility);
+	renderer->getBoxVisibility(minimums, maximums, modelToWorldTransforms, boxCount, camera, visibilityMask);
+}
+
 void renderer_end(Renderer& renderer, bool debugWireframe) {
 	MUST_EXIST(renderer, renderer_end);
 	renderer->endFrame(debugWireframe);
@@ -63,6 +63,18 @@ namespace dsr {
 	//   renderer must refer to an existing renderer.
 	//   colorBuffer and depthBuffer must have the same dimensions.
 	void renderer_begin(Renderer& renderer, ImageRgbaU8& colorBuffer, ImageF32& depthBuffer);
+	// Equivalent to filling colorBuffer with clearColor and depthBuffer with clearDepth before calling renderer_begin, but faster.
+	//   Instead of sweeping over all memory before drawing, each tile is cleared by the rendering thread right before the first triangle drawing to it,
+	//   while the pixels are still in the cache. Tiles that nothing is drawn to are cleared when renderer_end draws the triangles.
+	//   Use 0.0f as clearDepth for perspective cameras storing 1 / depth, and DSR_FLOAT_INF for orthogonal cameras storing linear depth.
+	// Pre-condition:
+	//   renderer must refer to an existing renderer.
+	//   colorBuffer and depthBuffer must have the same dimensions.
+	//   Any image that does not exist will not be cleared.
+	// Side-effect:
+	//   The content of colorBuffer and depthBuffer is undefined until renderer_end has been called,
+	//   except for the depth buffer after calling renderer_occludeFromTopRows, which clears the whole depth buffer before reading it.
+	void renderer_begin(Renderer& renderer, ImageRgbaU8& colorBuffer, ImageF32& depthBuffer, const ColorRgbaI32& clearColor, float clearDepth);
 	// Pre-condition: Renderer must exist.
 	// Post-condition: Returns the color buffer given to renderer_begin, or an empty image handle if not rendering.
 	ImageRgbaU8 renderer_getColorBuffer(const Renderer& renderer);
@@ -91,6 +103,19 @@ namespace dsr {
 	//   This makes sure that renderer_isBoxVisible will only return false if it cannot be seen, with exception for near clipping and abused occluders.
 	//   False positives from having the bounding box seen is to be expected, because the purpose is to save time by doing less work.
 	bool renderer_isBoxVisible(const Renderer& renderer, const FVector3D &minimum, const FVector3D &maximum, const Transform3D &modelToWorldTransform, const Camera &camera);
+	// Visibility test for many bounding boxes at once, for broad-phase culling of large scenes.
+	//   Tests eight boxes at a time against the culling frustum using SIMD, and uses multiple threads for large batches.
+	//   If the renderer has occluders, the boxes are also tested against the occlusion grid, like in renderer_isBoxVisible.
+	//   The pixel bounds are expanded by one pixel to be conservative with approximated projections,
+	//     so boxes touching the edge of an occluder may be reported as visible when renderer_isBoxVisible would not.
+	// Pre-condition:
+	//   The renderer must have started a pass using renderer_begin.
+	//   minimums, maximums and modelToWorldTransforms must have at least boxCount elements, with one box and transform for each index.
+	//   visibilityMask must have at least (boxCount + 31) / 32 elements.
+	// Post-condition:
+	//   Bit b % 32 in visibilityMask[b / 32] is set iff box b may be visible.
+	//   Bits after the last box in the last element are cleared.
+	void renderer_getBoxVisibility(const Renderer& renderer, SafePointer<const FVector3D> minimums, SafePointer<const FVector3D> maximums, SafePointer<const Transform3D> modelToWorldTransforms, int32_t boxCount, const Camera &camera, SafePointer<uint32_t> visibilityMask);
 	// A move powerful alternative to renderer_giveTask, sending one triangle at a time without occlusion tests.
 	//   Call renderer_isBoxVisible for the whole model's bounding box to check if the triangles in your own representation should be drawn.
 	// Useful for engine specific model formats allowing vertex animation, vertex shading and texture shading.
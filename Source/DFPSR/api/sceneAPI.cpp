@@ -0,0 +1,380 @@
+﻿// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+// 
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// 
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+#include "sceneAPI.h"
+
+#define MUST_EXIST(OBJECT, METHOD) if (OBJECT.isNull()) { throwError(U"The " #OBJECT U" handle was null in " #METHOD U"\n"); }
+
+namespace dsr {
+
+// The maximum number of instances in each leaf of the hierarchy.
+static const int32_t maxInstancesPerLeaf = 4;
+
+struct SceneInstance {
+	Model model;
+	Transform3D modelToWorldTransform;
+	// Bounding box in world space.
+	FVector3D minimum, maximum;
+	// The leaf node containing the instance, or -1 if not yet inserted into the hierarchy.
+	int32_t leafNode = -1;
+	bool used = false;
+	SceneInstance() {}
+};
+
+struct SceneNode {
+	// Bounding box in world space, containing all instances in the branch.
+	FVector3D minimum, maximum;
+	int32_t parent = -1;
+	// Branches have two child nodes at firstChild and firstChild + 1.
+	// Leaves have firstChild set to -1 and refer to instanceCount elements in leafInstances from firstInstance.
+	int32_t firstChild = -1;
+	int32_t firstInstance = 0, instanceCount = 0;
+	// Set when the bound must be refitted before the next query.
+	bool dirty = false;
+	SceneNode() {}
+	SceneNode(int32_t parent) : parent(parent) {}
+};
+
+// Get the world space bound of a model's bounding box placed at modelToWorldTransform.
+static void getWorldBound(const Model& model, const Transform3D &modelToWorldTransform, FVector3D &resultMinimum, FVector3D &resultMaximum) {
+	FVector3D minimum, maximum;
+	if (model_exists(model)) {
+		model_getBoundingBox(model, minimum, maximum);
+	}
+	for (int32_t corner = 0; corner < 8; corner++) {
+		FVector3D worldPoint = modelToWorldTransform.transformPoint(FVector3D(
+		  (corner & 4) ? maximum.x : minimum.x,
+		  (corner & 2) ? maximum.y : minimum.y,
+		  (corner & 1) ? maximum.z : minimum.z
+		));
+		if (corner == 0) {
+			resultMinimum = worldPoint;
+			resultMaximum = worldPoint;
+		} else {
+			resultMinimum = FVector3D(min(resultMinimum.x, worldPoint.x), min(resultMinimum.y, worldPoint.y), min(resultMinimum.z, worldPoint.z));
+			resultMaximum = FVector3D(max(resultMaximum.x, worldPoint.x), max(resultMaximum.y, worldPoint.y), max(resultMaximum.z, worldPoint.z));
+		}
+	}
+}
+
+static float getAxis(const FVector3D &vector, int32_t axis) {
+	return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+}
+
+struct SceneImpl {
+	List<SceneInstance> instances;
+	// Indices to unused elements in instances, for reuse.
+	List<int32_t> freeInstances;
+	// The hierarchy with the root at index 0 when not empty.
+	List<SceneNode> nodes;
+	// Instance indices referred to by leaf nodes.
+	List<int32_t> leafInstances;
+	int32_t instanceCount = 0;
+	bool needsRebuild = false;
+	bool needsRefit = false;
+	SceneImpl() {}
+	void validateInstance(int32_t instanceIndex, const char32_t *method) const {
+		if (instanceIndex < 0 || instanceIndex >= this->instances.length() || !this->instances[instanceIndex].used) {
+			throwError(U"The instance index ", instanceIndex, U" given to ", method, U" does not refer to an instance in the scene!\n");
+		}
+	}
+	int32_t addInstance(const Model& model, const Transform3D &modelToWorldTransform) {
+		int32_t instanceIndex;
+		if (this->freeInstances.length() > 0) {
+			instanceIndex = this->freeInstances.last();
+			this->freeInstances.pop();
+		} else {
+			instanceIndex = this->instances.length();
+			this->instances.pushConstruct();
+		}
+		SceneInstance &instance = this->instances[instanceIndex];
+		instance.model = model;
+		instance.modelToWorldTransform = modelToWorldTransform;
+		getWorldBound(model, modelToWorldTransform, instance.minimum, instance.maximum);
+		instance.leafNode = -1;
+		instance.used = true;
+		this->instanceCount++;
+		this->needsRebuild = true;
+		return instanceIndex;
+	}
+	void removeInstance(int32_t instanceIndex) {
+		this->validateInstance(instanceIndex, U"scene_removeInstance");
+		SceneInstance &instance = this->instances[instanceIndex];
+		instance.model = Model();
+		instance.leafNode = -1;
+		instance.used = false;
+		this->freeInstances.push(instanceIndex);
+		this->instanceCount--;
+		this->needsRebuild = true;
+	}
+	void setTransform(int32_t instanceIndex, const Transform3D &modelToWorldTransform) {
+		this->validateInstance(instanceIndex, U"scene_setTransform");
+		SceneInstance &instance = this->instances[instanceIndex];
+		instance.modelToWorldTransform = modelToWorldTransform;
+		getWorldBound(instance.model, modelToWorldTransform, instance.minimum, instance.maximum);
+		// Mark the path to the root for refitting, stopping early where it is already marked.
+		int32_t nodeIndex = instance.leafNode;
+		while (nodeIndex >= 0 && !this->nodes[nodeIndex].dirty) {
+			this->nodes[nodeIndex].dirty = true;
+			nodeIndex = this->nodes[nodeIndex].parent;
+		}
+		this->needsRefit = true;
+	}
+	// Recursively builds a branch from elements startIndex to stopIndex - 1 in leafInstances.
+	void buildNode(int32_t nodeIndex, int32_t startIndex, int32_t stopIndex) {
+		// Calculate the bound of the whole branch and the bound of instance centers for selecting the split axis.
+		FVector3D minimum, maximum, minCenter, maxCenter;
+		for (int32_t i = startIndex; i < stopIndex; i++) {
+			const SceneInstance &instance = this->instances[this->leafInstances[i]];
+			FVector3D center = (instance.minimum + instance.maximum) * 0.5f;
+			if (i == startIndex) {
+				minimum = instance.minimum;
+				maximum = instance.maximum;
+				minCenter = center;
+				maxCenter = center;
+			} else {
+				minimum = FVector3D(min(minimum.x, instance.minimum.x), min(minimum.y, instance.minimum.y), min(minimum.z, instance.minimum.z));
+				maximum = FVector3D(max(maximum.x, instance.maximum.x), max(maximum.y, instance.maximum.y), max(maximum.z, instance.maximum.z));
+				minCenter = FVector3D(min(minCenter.x, center.x), min(minCenter.y, center.y), min(minCenter.z, center.z));
+				maxCenter = FVector3D(max(maxCenter.x, center.x), max(maxCenter.y, center.y), max(maxCenter.z, center.z));
+			}
+		}
+		this->nodes[nodeIndex].minimum = minimum;
+		this->nodes[nodeIndex].maximum = maximum;
+		this->nodes[nodeIndex].dirty = false;
+		int32_t count = stopIndex - startIndex;
+		if (count <= maxInstancesPerLeaf) {
+			// Create a leaf.
+			this->nodes[nodeIndex].firstChild = -1;
+			this->nodes[nodeIndex].firstInstance = startIndex;
+			this->nodes[nodeIndex].instanceCount = count;
+			for (int32_t i = startIndex; i < stopIndex; i++) {
+				this->instances[this->leafInstances[i]].leafNode = nodeIndex;
+			}
+		} else {
+			// Split along the longest axis of the instance centers, with half of the instances on each side.
+			FVector3D extent = maxCenter - minCenter;
+			int32_t axis = 0;
+			if (extent.y > extent.x) { axis = 1; }
+			if (extent.z > getAxis(extent, axis)) { axis = 2; }
+			int32_t middleIndex = startIndex + count / 2;
+			this->selectMedian(startIndex, stopIndex, middleIndex, axis);
+			// Allocate both children next to each other before recursion, because the list may reallocate.
+			int32_t firstChild = this->nodes.length();
+			this->nodes.pushConstruct(nodeIndex);
+			this->nodes.pushConstruct(nodeIndex);
+			this->nodes[nodeIndex].firstChild = firstChild;
+			this->nodes[nodeIndex].firstInstance = 0;
+			this->nodes[nodeIndex].instanceCount = 0;
+			this->buildNode(firstChild, startIndex, middleIndex);
+			this->buildNode(firstChild + 1, middleIndex, stopIndex);
+		}
+	}
+	float getCenter(int32_t leafInstanceIndex, int32_t axis) const {
+		const SceneInstance &instance = this->instances[this->leafInstances[leafInstanceIndex]];
+		return getAxis(instance.minimum, axis) + getAxis(instance.maximum, axis);
+	}
+	// Partially sorts leafInstances from startIndex to stopIndex - 1 by their centers along axis,
+	// so that all elements before middleIndex are lesser or equal to all elements from middleIndex.
+	void selectMedian(int32_t startIndex, int32_t stopIndex, int32_t middleIndex, int32_t axis) {
+		int32_t left = startIndex;
+		int32_t right = stopIndex - 1;
+		while (left < right) {
+			float pivot = this->getCenter((left + right) / 2, axis);
+			int32_t i = left;
+			int32_t j = right;
+			while (i <= j) {
+				while (this->getCenter(i, axis) < pivot) { i++; }
+				while (this->getCenter(j, axis) > pivot) { j--; }
+				if (i <= j) {
+					int32_t swapped = this->leafInstances[i];
+					this->leafInstances[i] = this->leafInstances[j];
+					this->leafInstances[j] = swapped;
+					i++;
+					j--;
+				}
+			}
+			if (middleIndex <= j) {
+				right = j;
+			} else if (middleIndex >= i) {
+				left = i;
+			} else {
+				break;
+			}
+		}
+	}
+	void rebuild() {
+		this->nodes.clear();
+		this->leafInstances.clear();
+		for (int32_t i = 0; i < this->instances.length(); i++) {
+			if (this->instances[i].used) {
+				this->leafInstances.push(i);
+			}
+		}
+		if (this->leafInstances.length() > 0) {
+			this->nodes.pushConstruct(-1);
+			this->buildNode(0, 0, this->leafInstances.length());
+		}
+		this->needsRebuild = false;
+		this->needsRefit = false;
+	}
+	// Recalculates the bounds of dirty nodes from their children, without visiting any clean branch.
+	void refitNode(int32_t nodeIndex) {
+		SceneNode &node = this->nodes[nodeIndex];
+		if (node.dirty) {
+			FVector3D minimum, maximum;
+			if (node.firstChild < 0) {
+				for (int32_t i = 0; i < node.instanceCount; i++) {
+					const SceneInstance &instance = this->instances[this->leafInstances[node.firstInstance + i]];
+					if (i == 0) {
+						minimum = instance.minimum;
+						maximum = instance.maximum;
+					} else {
+						minimum = FVector3D(min(minimum.x, instance.minimum.x), min(minimum.y, instance.minimum.y), min(minimum.z, instance.minimum.z));
+						maximum = FVector3D(max(maximum.x, instance.maximum.x), max(maximum.y, instance.maximum.y), max(maximum.z, instance.maximum.z));
+					}
+				}
+			} else {
+				int32_t firstChild = node.firstChild;
+				this->refitNode(firstChild);
+				this->refitNode(firstChild + 1);
+				const SceneNode &childA = this->nodes[firstChild];
+				const SceneNode &childB = this->nodes[firstChild + 1];
+				minimum = FVector3D(min(childA.minimum.x, childB.minimum.x), min(childA.minimum.y, childB.minimum.y), min(childA.minimum.z, childB.minimum.z));
+				maximum = FVector3D(max(childA.maximum.x, childB.maximum.x), max(childA.maximum.y, childB.maximum.y), max(childA.maximum.z, childB.maximum.z));
+			}
+			// The list is not modified during refitting, so the reference is still valid.
+			node.minimum = minimum;
+			node.maximum = maximum;
+			node.dirty = false;
+		}
+	}
+	void update() {
+		if (this->needsRebuild) {
+			this->rebuild();
+		} else if (this->needsRefit) {
+			if (this->nodes.length() > 0) {
+				this->refitNode(0);
+			}
+			this->needsRefit = false;
+		}
+	}
+	// fullyInside is true when a parent was fully inside of the view frustum, so that no more frustum tests are needed within the branch.
+	void findVisible(int32_t nodeIndex, bool fullyInside, bool occlusion, const Renderer& renderer, const Camera &camera, List<int32_t>& visibleInstances) const {
+		const SceneNode &node = this->nodes[nodeIndex];
+		if (!fullyInside) {
+			int32_t seen = camera.isBoxSeen(node.minimum, node.maximum, Transform3D());
+			if (seen == 0) {
+				return;
+			} else if (seen == 2) {
+				fullyInside = true;
+			}
+		}
+		if (occlusion && !renderer_isBoxVisible(renderer, node.minimum, node.maximum, Transform3D(), camera)) {
+			return;
+		}
+		if (node.firstChild < 0) {
+			for (int32_t i = 0; i < node.instanceCount; i++) {
+				visibleInstances.push(this->leafInstances[node.firstInstance + i]);
+			}
+		} else {
+			this->findVisible(node.firstChild, fullyInside, occlusion, renderer, camera, visibleInstances);
+			this->findVisible(node.firstChild + 1, fullyInside, occlusion, renderer, camera, visibleInstances);
+		}
+	}
+	void findVisibleInstances(const Renderer& renderer, const Camera &camera, List<int32_t>& visibleInstances) {
+		this->update();
+		if (this->nodes.length() > 0) {
+			bool occlusion = renderer_exists(renderer) && renderer_hasOccluders(renderer);
+			this->findVisible(0, false, occlusion, renderer, camera, visibleInstances);
+		}
+	}
+};
+
+Scene scene_create() {
+	return handle_create<SceneImpl>().setName("Scene");
+}
+
+bool scene_exists(const Scene& scene) {
+	return scene.isNotNull();
+}
+
+int32_t scene_addInstance(Scene& scene, const Model& model, const Transform3D &modelToWorldTransform) {
+	MUST_EXIST(scene, scene_addInstance);
+	return scene->addInstance(model, modelToWorldTransform);
+}
+
+void scene_removeInstance(Scene& scene, int32_t instanceIndex) {
+	MUST_EXIST(scene, scene_removeInstance);
+	scene->removeInstance(instanceIndex);
+}
+
+bool scene_hasInstance(const Scene& scene, int32_t instanceIndex) {
+	MUST_EXIST(scene, scene_hasInstance);
+	return instanceIndex >= 0 && instanceIndex < scene->instances.length() && scene->instances[instanceIndex].used;
+}
+
+int32_t scene_getInstanceCount(const Scene& scene) {
+	MUST_EXIST(scene, scene_getInstanceCount);
+	return scene->instanceCount;
+}
+
+Model scene_getModel(const Scene& scene, int32_t instanceIndex) {
+	MUST_EXIST(scene, scene_getModel);
+	scene->validateInstance(instanceIndex, U"scene_getModel");
+	return scene->instances[instanceIndex].model;
+}
+
+Transform3D scene_getTransform(const Scene& scene, int32_t instanceIndex) {
+	MUST_EXIST(scene, scene_getTransform);
+	scene->validateInstance(instanceIndex, U"scene_getTransform");
+	return scene->instances[instanceIndex].modelToWorldTransform;
+}
+
+void scene_setTransform(Scene& scene, int32_t instanceIndex, const Transform3D &modelToWorldTransform) {
+	MUST_EXIST(scene, scene_setTransform);
+	scene->setTransform(instanceIndex, modelToWorldTransform);
+}
+
+void scene_rebuild(Scene& scene) {
+	MUST_EXIST(scene, scene_rebuild);
+	scene->rebuild();
+}
+
+void scene_findVisibleInstances(Scene& scene, const Renderer& renderer, const Camera &camera, List<int32_t>& visibleInstances) {
+	MUST_EXIST(scene, scene_findVisibleInstances);
+	scene->findVisibleInstances(renderer, camera, visibleInstances);
+}
+
+void scene_render_threaded(Scene& scene, Renderer& renderer, const Camera &camera) {
+	MUST_EXIST(scene, scene_render_threaded);
+	MUST_EXIST(renderer, scene_render_threaded);
+	List<int32_t> visibleInstances;
+	scene->findVisibleInstances(renderer, camera, visibleInstances);
+	for (int32_t i = 0; i < visibleInstances.length(); i++) {
+		const SceneInstance &instance = scene->instances[visibleInstances[i]];
+		model_render_threaded(instance.model, instance.modelToWorldTransform, renderer, camera);
+	}
+}
+
+}
@@ -0,0 +1,83 @@
+﻿// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+// 
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// 
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+// An API for large worlds of model instances, culled together using a bounding volume hierarchy.
+//   Instead of looping over every model and letting model_render_threaded test each bounding box,
+//   whole branches of the hierarchy can be skipped when outside of the view frustum or hidden behind occluders.
+//   This lets the cost of culling grow with the number of visible instances, rather than with the size of the world.
+//   * The hierarchy is built over the instances' bounding boxes in world space.
+//   * Adding or removing instances rebuilds the hierarchy on the next query.
+//   * Moving instances only refits the bounds along the path to the root on the next query.
+//     Instances moving far from where they were when the hierarchy was built make culling less efficient, so call scene_rebuild now and then if everything moves.
+
+#ifndef DFPSR_API_SCENE
+#define DFPSR_API_SCENE
+
+#include "modelAPI.h"
+
+namespace dsr {
+
+	// A handle to a scene of model instances.
+	struct SceneImpl;
+	using Scene = Handle<SceneImpl>;
+
+	// Side-effect: Creates a new empty scene.
+	// Post-condition: Returns a reference counted handle to the new scene.
+	Scene scene_create();
+	// Post-condition: Returns true iff the scene exists.
+	bool scene_exists(const Scene& scene);
+	// Side-effect: Places an instance of model at modelToWorldTransform in the scene.
+	// Pre-condition: scene must exist.
+	// Post-condition: Returns the instance index, which remains the same until the instance is removed.
+	//   Indices of removed instances may be reused by instances added later.
+	int32_t scene_addInstance(Scene& scene, const Model& model, const Transform3D &modelToWorldTransform);
+	// Side-effect: Removes the instance at instanceIndex from the scene.
+	// Pre-condition: instanceIndex must refer to an instance in the scene.
+	void scene_removeInstance(Scene& scene, int32_t instanceIndex);
+	// Post-condition: Returns true iff instanceIndex refers to an instance in the scene.
+	bool scene_hasInstance(const Scene& scene, int32_t instanceIndex);
+	// Post-condition: Returns the number of instances in the scene.
+	int32_t scene_getInstanceCount(const Scene& scene);
+	// Pre-condition: instanceIndex must refer to an instance in the scene.
+	// Post-condition: Returns the model of the instance.
+	Model scene_getModel(const Scene& scene, int32_t instanceIndex);
+	// Pre-condition: instanceIndex must refer to an instance in the scene.
+	// Post-condition: Returns the model to world transform of the instance.
+	Transform3D scene_getTransform(const Scene& scene, int32_t instanceIndex);
+	// Side-effect: Moves the instance at instanceIndex to modelToWorldTransform.
+	//   Also call this with the same transform if the instance's model changed its bounding box, so that the new bound is used.
+	// Pre-condition: instanceIndex must refer to an instance in the scene.
+	void scene_setTransform(Scene& scene, int32_t instanceIndex, const Transform3D &modelToWorldTransform);
+	// Side-effect: Builds the hierarchy again from all instances' current bounds.
+	//   Called automatically before queries when instances were added or removed.
+	void scene_rebuild(Scene& scene);
+	// Side-effect: Adds the index of each instance that may be visible from camera to visibleInstances, in no specific order.
+	//   Whole branches of the hierarchy are skipped when outside of the camera's view frustum.
+	//   If renderer exists and has occluders, branches hidden in the occlusion grid are also skipped, so call it after giving occluders to the renderer.
+	void scene_findVisibleInstances(Scene& scene, const Renderer& renderer, const Camera &camera, List<int32_t>& visibleInstances);
+	// Side-effect: Gives all potentially visible instances in the scene to renderer as tasks using model_render_threaded.
+	// Pre-condition: renderer must have started a pass using renderer_begin.
+	void scene_render_threaded(Scene& scene, Renderer& renderer, const Camera &camera);
+}
+
+#endif
@@ -25,6 +25,12 @@
 #include "textureAPI.h"
 #include "imageAPI.h"
 #include "filterAPI.h"
+#include "drawAPI.h"
+#include "../implementation/math/scalar.h"
+#include "../base/simd.h"
+#include "../base/threading.h"
+#include <algorithm>
+#include <cmath>
 
 namespace dsr {
 
@@ -40,17 +46,44 @@ static int32_t findLog2Size(uint32_t size) {
 	return maxLog2Size;
 }
 
-// TODO: Optimize using addition and SafePointer.
-static void downsample(const TextureRgbaU8 &texture, uint32_t targetLevel) {
+// Reads four pixels from memory that does not have to be aligned, because mip levels may start at any pixel offset.
+static inline U8x16 readFourPixels(SafePointer<const uint32_t> source) {
+	ALIGN16 uint32_t pixels[4];
+	safeMemoryCopy(SafePointer<uint32_t>("pixels", pixels, sizeof(pixels)), source, sizeof(pixels));
+	return reinterpret_U8FromU32(U32x4::readAlignedUnsafe(pixels));
+}
+
+// Writes four pixels to memory that does not have to be aligned.
+static inline void writeFourPixels(SafePointer<uint32_t> target, const U8x16 &colors) {
+	ALIGN16 uint32_t pixels[4];
+	reinterpret_U32FromU8(colors).writeAlignedUnsafe(pixels);
+	safeMemoryCopy(target, SafePointer<const uint32_t>("pixels", pixels, sizeof(pixels)), sizeof(pixels));
+}
+
+// Takes four pixels from an upper and a lower row, and returns the average of each 2x2 block as two pixels with 16-bit channels.
+//   The sums are truncated to the same result as averaging each channel using integers one pixel at a time.
+static inline U16x8 averageBlocks(const U8x16 &upper, const U8x16 &lower) {
+	// Two pixels with four channels in each vector.
+	U16x8 sum01 = lowerToU16(upper) + lowerToU16(lower);
+	U16x8 sum23 = higherToU16(upper) + higherToU16(lower);
+	// Add the other pixel in each vector, so that both halves contain the sum of the block.
+	U16x8 block01 = sum01 + vectorExtract_4(sum01, sum01);
+	U16x8 block23 = sum23 + vectorExtract_4(sum23, sum23);
+	// Take one half from each block and divide by four.
+	return bitShiftRightImmediate<2>(vectorExtract_4(block01, block23));
+}
+
+// Averages 2x2 pixels one at a time, for mip levels that are too narrow to fit four pixels in each row.
+template <bool TILED>
+static void downsampleRows_scalar(const TextureRgbaU8 &texture, uint32_t targetLevel, int32_t startY, int32_t stopY) {
 	uint32_t sourceLevel = targetLevel - 1;
 	uint32_t targetWidth = texture_getWidth(texture, targetLevel);
-	uint32_t targetHeight = texture_getHeight(texture, targetLevel);
-	for (uint32_t y = 0; y < targetHeight; y++) {
+	for (uint32_t y = startY; y < uint32_t(stopY); y++) {
 		for (uint32_t x = 0; x < targetWidth; x++) {
-			uint32_t upperLeft  = texture_readPixel(texture, x * 2    , y * 2    , sourceLevel);
-			uint32_t upperRight = texture_readPixel(texture, x * 2 + 1, y * 2    , sourceLevel);
-			uint32_t lowerLeft  = texture_readPixel(texture, x * 2    , y * 2 + 1, sourceLevel);
-			uint32_t lowerRight = texture_readPixel(texture, x * 2 + 1, y * 2 + 1, sourceLevel);
+			uint32_t upperLeft  = texture_readPixel<false, false, false, false, false, TILED>(texture, x * 2    , y * 2    , sourceLevel);
+			uint32_t upperRight = texture_readPixel<false, false, false, false, false, TILED>(texture, x * 2 + 1, y * 2    , sourceLevel);
+			uint32_t lowerLeft  = texture_readPixel<false, false, false, false, false, TILED>(texture, x * 2    , y * 2 + 1, sourceLevel);
+			uint32_t lowerRight = texture_readPixel<false, false, false, false, false, TILED>(texture, x * 2 + 1, y * 2 + 1, sourceLevel);
 			uint32_t mixedColor = packOrder_packBytes(
 			  (packOrder_getRed  (upperLeft) + packOrder_getRed  (upperRight) + packOrder_getRed  (lowerLeft) + packOrder_getRed  (lowerRight)) / 4,
 			  (packOrder_getGreen(upperLeft) + packOrder_getGreen(upperRight) + packOrder_getGreen(lowerLeft) + packOrder_getGreen(lowerRight)) / 4,
@@ -62,7 +95,48 @@ static void downsample(const TextureRgbaU8 &texture, uint32_t targetLevel) {
 	}
 }
 
-TextureRgbaU8 texture_create_RgbaU8(int32_t width, int32_t height, int32_t resolutions) {
+// Averages 2x2 pixels four target pixels at a time.
+//   Both rows and tiles store four pixels in a row next to each other, so the same method works for both layouts by looking up the offset for each group of four pixels.
+// Pre-condition: texture_getWidth(texture, targetLevel) is a multiple of four.
+template <bool TILED>
+static void downsampleRows_simd(const TextureRgbaU8 &texture, uint32_t targetLevel, int32_t startY, int32_t stopY) {
+	uint32_t sourceLevel = targetLevel - 1;
+	uint32_t targetWidth = texture_getWidth(texture, targetLevel);
+	SafePointer<uint32_t> data = texture.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for downsampling");
+	for (uint32_t y = startY; y < uint32_t(stopY); y++) {
+		uint32_t upperY = y * 2;
+		uint32_t lowerY = upperY + 1;
+		for (uint32_t x = 0; x < targetWidth; x += 4) {
+			uint32_t leftX = x * 2;
+			uint32_t rightX = leftX + 4;
+			U8x16 upperLeft  = readFourPixels(data + texture_getPixelOffset<false, false, true, true, false, TILED>(texture, leftX , upperY, sourceLevel));
+			U8x16 upperRight = readFourPixels(data + texture_getPixelOffset<false, false, true, true, false, TILED>(texture, rightX, upperY, sourceLevel));
+			U8x16 lowerLeft  = readFourPixels(data + texture_getPixelOffset<false, false, true, true, false, TILED>(texture, leftX , lowerY, sourceLevel));
+			U8x16 lowerRight = readFourPixels(data + texture_getPixelOffset<false, false, true, true, false, TILED>(texture, rightX, lowerY, sourceLevel));
+			U8x16 mixedColors = truncateToU8(averageBlocks(upperLeft, lowerLeft), averageBlocks(upperRight, lowerRight));
+			writeFourPixels(data + texture_getPixelOffset<false, false, true, true, false, TILED>(texture, x, y, targetLevel), mixedColors);
+		}
+	}
+}
+
+// Generate targetLevel from the level above, with rows split across up to maxThreadCount threads.
+template <bool TILED>
+static void downsample(const TextureRgbaU8 &texture, uint32_t targetLevel, int32_t maxThreadCount) {
+	int32_t targetWidth = texture_getWidth(texture, targetLevel);
+	int32_t targetHeight = texture_getHeight(texture, targetLevel);
+	// Start new threads only when each job gets at least 16384 pixels to process.
+	int32_t minimumRowsPerJob = max(1, 16384 / targetWidth);
+	if (targetWidth < 4) {
+		// Narrow mip levels are so small that multi-threading and SIMD would not pay off.
+		downsampleRows_scalar<TILED>(texture, targetLevel, 0, targetHeight);
+	} else {
+		threadedSplit(0, targetHeight, [&texture, targetLevel](int32_t startY, int32_t stopY) {
+			downsampleRows_simd<TILED>(texture, targetLevel, startY, stopY);
+		}, minimumRowsPerJob, 2, maxThreadCount);
+	}
+}
+
+TextureRgbaU8 texture_create_RgbaU8(int32_t width, int32_t height, int32_t resolutions, bool tiled) {
 	if (resolutions < 1) {
 		throwError(U"Tried to create a texture without any resolutions stored, which would be empty!\n");
 		return TextureRgbaU8();
@@ -73,52 +147,404 @@ TextureRgbaU8 texture_create_RgbaU8(int32_t width, int32_t height, int32_t resol
 		throwError(U"Tried to create a texture of ", width, U" x ", height, U" pixels, which exceeds the maximum texture dimensions of 32768 x 32768 pixels!\n");
 		return TextureRgbaU8();
 	} else {
-		return TextureRgbaU8(findLog2Size(width), findLog2Size(height), resolutions - 1);
+		int32_t log2width = findLog2Size(width);
+		int32_t log2height = findLog2Size(height);
+		if (tiled) {
+			// Each mip level must fit at least one whole tile.
+			if (log2width < int32_t(DSR_TEXTURE_LOG2_TILE_SIZE)) log2width = DSR_TEXTURE_LOG2_TILE_SIZE;
+			if (log2height < int32_t(DSR_TEXTURE_LOG2_TILE_SIZE)) log2height = DSR_TEXTURE_LOG2_TILE_SIZE;
+		}
+		return TextureRgbaU8(log2width, log2height, resolutions - 1, tiled);
 	}
 }
 
-static uint64_t testCounter = 0;
-
-void texture_generatePyramid(const TextureRgbaU8& texture) {
+static void generatePyramid(const TextureRgbaU8& texture, int32_t maxThreadCount) {
 	uint32_t mipLevelCount = texture_getMipLevelCount(texture);
+	// Each level depends on the previous level, so only the rows within each level can be processed in parallel.
+	bool tiled = texture_isTiled(texture);
 	for (uint32_t targetLevel = 1; targetLevel < mipLevelCount; targetLevel++) {
-		downsample(texture, targetLevel);
+		if (tiled) {
+			downsample<true>(texture, targetLevel, maxThreadCount);
+		} else {
+			downsample<false>(texture, targetLevel, maxThreadCount);
+		}
+	}
+}
+
+void texture_generatePyramid(const TextureRgbaU8& texture) {
+	if (texture_isCompressed(texture)) {
+		throwError(U"Can not generate lower resolutions in a compressed texture, because all resolutions are compressed by texture_compress!\n");
+	} else {
+		generatePyramid(texture, 0);
 	}
 }
 
-TextureRgbaU8 texture_create_RgbaU8(const ImageRgbaU8& image, int32_t resolutions) {
+void texture_generatePyramids(const List<TextureRgbaU8>& textures) {
+	// Check all textures before starting, so that no texture is modified when one of them can not be processed.
+	for (int32_t i = 0; i < textures.length(); i++) {
+		if (texture_isCompressed(textures[i])) {
+			throwError(U"texture_generatePyramids got a compressed texture at index ", i, U", which can not generate lower resolutions because all resolutions are compressed by texture_compress!\n");
+			return;
+		}
+	}
+	threadedWorkByIndex([](void *context, int32_t jobIndex) {
+		const List<TextureRgbaU8> &textures = *((const List<TextureRgbaU8>*)context);
+		// Each texture is processed on a single thread, because all threads are already busy with other textures.
+		generatePyramid(textures[jobIndex], 1);
+	}, (void*)&textures, textures.length());
+}
+
+static TextureRgbaU8 createFromImage(const ImageRgbaU8& image, int32_t resolutions, bool tiled, int32_t maxThreadCount) {
 	if (!image_exists(image)) {
 		// An empty image returns an empty pyramid.
 		return TextureRgbaU8();
 	} else {
 		// Allocate a pyramid image.
-		TextureRgbaU8 result = texture_create_RgbaU8(image_getWidth(image), image_getHeight(image), resolutions);
+		TextureRgbaU8 result = texture_create_RgbaU8(image_getWidth(image), image_getHeight(image), resolutions, tiled);
 		uint32_t width = texture_getMaxWidth(result);
 		uint32_t height = texture_getMaxHeight(result);
-		// Create an image of the same size as the largest resolution.
-		OrderedImageRgbaU8 resized = filter_resize(image, Sampler::Linear, width, height);
-		testCounter++;
+		// Create an image of the same size as the largest resolution, unless the image can be copied directly.
+		ImageRgbaU8 resized = image;
+		if (image_getWidth(image) != int32_t(width) || image_getHeight(image) != int32_t(height) || image_getPackOrderIndex(image) != PackOrderIndex::RGBA) {
+			resized = filter_resize(image, Sampler::Linear, width, height);
+		}
 		// Copy from the resized image to the highest resolution in the pyramid.
-		for (uint32_t y = 0; y < height; y++) {
-			SafePointer<uint32_t> source = image_getSafePointer(resized, y);
-			SafePointer<uint32_t> target = texture_getSafePointer(result, 0u, y);
-			safeMemoryCopy(target, source, width * sizeof(uint32_t));
+		if (tiled) {
+			// Each row within a tile is four pixels in a row.
+			SafePointer<uint32_t> target = result.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for tiled copying");
+			for (uint32_t y = 0; y < height; y++) {
+				SafePointer<uint32_t> source = image_getSafePointer(resized, y);
+				for (uint32_t x = 0; x < width; x += 4) {
+					uint32_t offset = texture_getPixelOffset<false, false, true, true, true, true>(result, x, y, 0u);
+					safeMemoryCopy(target + offset, source + x, 4 * sizeof(uint32_t));
+				}
+			}
+		} else {
+			for (uint32_t y = 0; y < height; y++) {
+				SafePointer<uint32_t> source = image_getSafePointer(resized, y);
+				SafePointer<uint32_t> target = texture_getSafePointer(result, 0u, y);
+				safeMemoryCopy(target, source, width * sizeof(uint32_t));
+			}
 		}
-		texture_generatePyramid(result);
+		result.impl_premultiplied = image_isPremultiplied(image);
+		generatePyramid(result, maxThreadCount);
 		return result;
 	}
 }
 
+TextureRgbaU8 texture_create_RgbaU8(const ImageRgbaU8& image, int32_t resolutions, bool tiled) {
+	return createFromImage(image, resolutions, tiled, 0);
+}
+
+List<TextureRgbaU8> texture_create_RgbaU8(const List<ImageRgbaU8>& images, int32_t resolutions, bool tiled) {
+	List<TextureRgbaU8> result;
+	result.reserve(images.length());
+	for (int32_t i = 0; i < images.length(); i++) {
+		result.push(TextureRgbaU8());
+	}
+	threadedSplit(0, images.length(), [&result, &images, resolutions, tiled](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t i = startIndex; i < stopIndex; i++) {
+			// Each texture is created on a single thread, because all threads are already busy with other textures.
+			result[i] = createFromImage(images[i], resolutions, tiled, 1);
+		}
+	}, 1, 1);
+	return result;
+}
+
+// Places the cells in shelves sorted by decreasing height within width pixels.
+// Post-condition: Returns the total height of all shelves.
+static int32_t packShelves(const List<IRect> &cells, const List<int32_t> &order, int32_t width, List<IRect> &placedCells) {
+	int32_t shelfTop = 0;
+	int32_t shelfHeight = 0;
+	int32_t x = 0;
+	for (int32_t o = 0; o < order.length(); o++) {
+		const IRect &cell = cells[order[o]];
+		if (cell.hasArea()) {
+			if (x + cell.width() > width) {
+				// Start a new shelf below the previous one.
+				shelfTop += shelfHeight;
+				shelfHeight = 0;
+				x = 0;
+			}
+			placedCells[order[o]] = IRect(x, shelfTop, cell.width(), cell.height());
+			x += cell.width();
+			shelfHeight = max(shelfHeight, cell.height());
+		}
+	}
+	return shelfTop + shelfHeight;
+}
+
+static int32_t roundUpToPowerOfTwo(int32_t size) {
+	int32_t result = 1;
+	while (result < size) {
+		result = result * 2;
+	}
+	return result;
+}
+
+TextureAtlas texture_createAtlas(const List<ImageRgbaU8>& images, int32_t resolutions, bool tiled) {
+	TextureAtlas result;
+	if (resolutions < 1 || resolutions > 8) {
+		throwError(U"Tried to create a texture atlas with ", resolutions, U" resolutions, which is not within 1..8!\n");
+		return result;
+	}
+	// Each image is aligned to whole pixels in the lowest resolution, with one pixel of padding around it in the lowest resolution.
+	int32_t alignment = 1 << (resolutions - 1);
+	int32_t padding = alignment;
+	List<IRect> cells;
+	List<int32_t> order;
+	int64_t totalArea = 0;
+	int32_t maxCellWidth = 0;
+	for (int32_t i = 0; i < images.length(); i++) {
+		if (image_exists(images[i])) {
+			IRect cell = IRect(0, 0, roundUp(image_getWidth(images[i]), alignment) + padding * 2, roundUp(image_getHeight(images[i]), alignment) + padding * 2);
+			totalArea += int64_t(cell.width()) * int64_t(cell.height());
+			maxCellWidth = max(maxCellWidth, cell.width());
+			cells.push(cell);
+		} else {
+			cells.push(IRect());
+		}
+		order.push(i);
+	}
+	result.regions.reserve(images.length());
+	for (int32_t i = 0; i < images.length(); i++) {
+		result.regions.push(IRect());
+	}
+	if (totalArea == 0) {
+		return result;
+	}
+	std::sort(&(order[0]), &(order[0]) + order.length(), [&cells](int32_t left, int32_t right) {
+		return cells[left].height() > cells[right].height();
+	});
+	// Start with a square that has enough area, and double the width while the shelves are higher than wide.
+	//   At least 4x4 pixels are used, so that tiled textures get the same size as the image.
+	int32_t width = roundUpToPowerOfTwo(max(4, maxCellWidth, int32_t(sqrt(double(totalArea)))));
+	List<IRect> placedCells = cells;
+	int32_t height = roundUpToPowerOfTwo(max(4, packShelves(cells, order, width, placedCells)));
+	while (height > width && width < 32768) {
+		width = width * 2;
+		height = roundUpToPowerOfTwo(max(4, packShelves(cells, order, width, placedCells)));
+	}
+	if (width > 32768 || height > 32768) {
+		throwError(U"The images could not fit into a texture atlas of 32768 x 32768 pixels!\n");
+		return result;
+	}
+	// Premultiply all images if any image is premultiplied, because one texture can not mix both.
+	bool premultiplied = false;
+	for (int32_t i = 0; i < images.length(); i++) {
+		if (image_isPremultiplied(images[i])) {
+			premultiplied = true;
+		}
+	}
+	// Draw the images with padding into an image of the atlas' size.
+	ImageRgbaU8 atlasImage = image_create_RgbaU8(width, height);
+	for (int32_t i = 0; i < images.length(); i++) {
+		ImageRgbaU8 image = images[i];
+		if (image_exists(image)) {
+			if (premultiplied && !image_isPremultiplied(image)) {
+				image = filter_premultiplyAlpha(image);
+			}
+			const IRect &cell = placedCells[i];
+			IRect region = IRect(cell.left() + padding, cell.top() + padding, image_getWidth(image), image_getHeight(image));
+			result.regions[i] = region;
+			// Fill the whole cell with clamped edge pixels, before copying the image over the center.
+			for (int32_t y = cell.top(); y < cell.bottom(); y++) {
+				for (int32_t x = cell.left(); x < cell.right(); x++) {
+					if (y < region.top() || y >= region.bottom() || x < region.left() || x >= region.right()) {
+						image_writePixel(atlasImage, x, y, image_readPixel_clamp(image, x - region.left(), y - region.top()));
+					}
+				}
+			}
+			draw_copy(atlasImage, image, region.left(), region.top());
+		}
+	}
+	result.texture = texture_create_RgbaU8(image_setPremultiplied(atlasImage, premultiplied), resolutions, tiled);
+	return result;
+}
+
 ImageRgbaU8 texture_getMipLevelImage(const TextureRgbaU8& texture, int32_t mipLevel) {
 	if (!texture_exists(texture)) {
 		throwError(U"Can not get a mip level as an image from a texture that does not exist!\n");
 		return ImageRgbaU8();
+	} else if (texture_isTiled(texture)) {
+		throwError(U"Can not get a mip level as an image from a tiled texture, because the pixels are not stored in rows!\n");
+		return ImageRgbaU8();
 	} else if (mipLevel < 0 || mipLevel > texture_getSmallestMipLevel(texture)) {
 		throwError(U"Can not get a non-existing mip level at index ", mipLevel, U" from a texture with layers 0..", texture_getSmallestMipLevel(texture), U"!\n");
 		throwError(U"");
 		return ImageRgbaU8();
 	} else {
-		return ImageRgbaU8(texture.impl_buffer, texture_getPixelOffsetToLayer<false, uint32_t, uint32_t>(texture, mipLevel), texture_getWidth(texture, mipLevel), texture_getHeight(texture, mipLevel), texture_getWidth(texture, mipLevel), PackOrderIndex::RGBA);
+		ImageRgbaU8 result = ImageRgbaU8(texture.impl_buffer, texture_getPixelOffsetToLayer<false, uint32_t, uint32_t>(texture, mipLevel), texture_getWidth(texture, mipLevel), texture_getHeight(texture, mipLevel), texture_getWidth(texture, mipLevel), PackOrderIndex::RGBA);
+		return image_setPremultiplied(result, texture_isPremultiplied(texture));
+	}
+}
+
+TextureRgbaU8 texture_getLowerResolutions(const TextureRgbaU8& texture, int32_t mipLevel) {
+	if (!texture_exists(texture)) {
+		return TextureRgbaU8();
+	} else if (mipLevel < 0 || mipLevel > texture_getSmallestMipLevel(texture)) {
+		throwError(U"Can not get lower resolutions from the non-existing mip level at index ", mipLevel, U" in a texture with layers 0..", texture_getSmallestMipLevel(texture), U"!\n");
+		return TextureRgbaU8();
+	} else {
+		TextureRgbaU8 result = TextureRgbaU8(texture.impl_log2width - mipLevel, texture.impl_log2height - mipLevel, texture.impl_maxMipLevel - mipLevel, texture_isTiled(texture), texture_isCompressed(texture));
+		result.impl_premultiplied = texture.impl_premultiplied;
+		// The layers in the result have the same dimensions and offsets as the lowest layers in texture.
+		//   Compressed blocks are stored in the same order as tiles, so the same applies to compressed textures.
+		safeMemoryCopy(result.impl_buffer.getSafe<uint8_t>("Lower resolution texture pixels"), texture.impl_buffer.getSafe<uint8_t>("Source texture pixels"), buffer_getSize(result.impl_buffer));
+		return result;
+	}
+}
+
+static uint32_t getSquareDistance(uint32_t colorA, uint32_t colorB) {
+	uint32_t result = 0;
+	for (uint32_t channel = 0; channel < 32; channel += 8) {
+		int32_t difference = int32_t((colorA >> channel) & 255u) - int32_t((colorB >> channel) & 255u);
+		result += uint32_t(difference * difference);
+	}
+	return result;
+}
+
+// Selects the closest of the four colors for each pixel.
+// Post-condition: Returns the sum of square distances from pixels to the selected colors.
+static uint32_t selectBlockIndices(const uint32_t pixels[16], uint32_t colorA, uint32_t colorB, uint32_t &indices) {
+	uint32_t colors[4];
+	for (uint32_t index = 0; index < 4; index++) {
+		colors[index] = texture_getBlockColor(colorA, colorB, index);
+	}
+	uint32_t totalError = 0;
+	indices = 0;
+	for (uint32_t p = 0; p < 16; p++) {
+		uint32_t bestIndex = 0;
+		uint32_t bestError = getSquareDistance(pixels[p], colors[0]);
+		for (uint32_t index = 1; index < 4; index++) {
+			uint32_t error = getSquareDistance(pixels[p], colors[index]);
+			if (error < bestError) {
+				bestIndex = index;
+				bestError = error;
+			}
+		}
+		indices = indices | (bestIndex << (p * 2));
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// Encodes 16 pixels into a block of DSR_TEXTURE_BLOCK_WORDS words.
+static void encodeBlock(const uint32_t pixels[16], SafePointer<uint32_t> target) {
+	// Get the bounding box and average color.
+	int32_t minimum[4] = {255, 255, 255, 255};
+	int32_t maximum[4] = {0, 0, 0, 0};
+	int32_t sum[4] = {0, 0, 0, 0};
+	for (uint32_t p = 0; p < 16; p++) {
+		for (uint32_t c = 0; c < 4; c++) {
+			int32_t value = int32_t((pixels[p] >> (c * 8)) & 255u);
+			minimum[c] = min(minimum[c], value);
+			maximum[c] = max(maximum[c], value);
+			sum[c] += value;
+		}
+	}
+	// Use the channel with the largest range as a reference for which diagonal of the bounding box to use.
+	uint32_t mainChannel = 0;
+	for (uint32_t c = 1; c < 4; c++) {
+		if (maximum[c] - minimum[c] > maximum[mainChannel] - minimum[mainChannel]) {
+			mainChannel = c;
+		}
+	}
+	uint32_t colorA = 0;
+	uint32_t colorB = 0;
+	for (uint32_t c = 0; c < 4; c++) {
+		// Channels going down when the main channel goes up get their end points swapped.
+		int32_t covariance = 0;
+		for (uint32_t p = 0; p < 16; p++) {
+			int32_t value = int32_t((pixels[p] >> (c * 8)) & 255u) * 16 - sum[c];
+			int32_t mainValue = int32_t((pixels[p] >> (mainChannel * 8)) & 255u) * 16 - sum[mainChannel];
+			covariance += (value >> 4) * (mainValue >> 4);
+		}
+		bool swapped = covariance < 0;
+		colorA = colorA | (uint32_t(swapped ? maximum[c] : minimum[c]) << (c * 8));
+		colorB = colorB | (uint32_t(swapped ? minimum[c] : maximum[c]) << (c * 8));
+	}
+	uint32_t indices = 0;
+	uint32_t error = selectBlockIndices(pixels, colorA, colorB, indices);
+	if (error > 0) {
+		// Refine the end points using least squares for the selected indices, and keep the result if it is better.
+		int32_t weightAA = 0, weightBB = 0, weightAB = 0;
+		int32_t sumA[4] = {0, 0, 0, 0};
+		int32_t sumB[4] = {0, 0, 0, 0};
+		for (uint32_t p = 0; p < 16; p++) {
+			int32_t weightB = int32_t((indices >> (p * 2)) & 3u);
+			int32_t weightA = 3 - weightB;
+			weightAA += weightA * weightA;
+			weightBB += weightB * weightB;
+			weightAB += weightA * weightB;
+			for (uint32_t c = 0; c < 4; c++) {
+				int32_t value = int32_t((pixels[p] >> (c * 8)) & 255u);
+				sumA[c] += weightA * value;
+				sumB[c] += weightB * value;
+			}
+		}
+		int32_t determinant = weightAA * weightBB - weightAB * weightAB;
+		if (determinant != 0) {
+			uint32_t refinedA = 0;
+			uint32_t refinedB = 0;
+			for (uint32_t c = 0; c < 4; c++) {
+				// The weights are in thirds, so the solution is multiplied by three.
+				float endA = float(3 * (sumA[c] * weightBB - sumB[c] * weightAB)) / float(determinant);
+				float endB = float(3 * (sumB[c] * weightAA - sumA[c] * weightAB)) / float(determinant);
+				refinedA = refinedA | (uint32_t(clamp(0, int32_t(endA + 0.5f), 255)) << (c * 8));
+				refinedB = refinedB | (uint32_t(clamp(0, int32_t(endB + 0.5f), 255)) << (c * 8));
+			}
+			uint32_t refinedIndices = 0;
+			uint32_t refinedError = selectBlockIndices(pixels, refinedA, refinedB, refinedIndices);
+			if (refinedError < error) {
+				colorA = refinedA;
+				colorB = refinedB;
+				indices = refinedIndices;
+			}
+		}
+	}
+	target[0] = colorA;
+	target[1] = colorB;
+	target[2] = indices;
+}
+
+TextureRgbaU8 texture_compress(const TextureRgbaU8& texture) {
+	if (!texture_exists(texture)) {
+		return TextureRgbaU8();
+	} else if (texture_isCompressed(texture)) {
+		return texture;
+	} else if (texture.impl_log2width < DSR_TEXTURE_LOG2_TILE_SIZE || texture.impl_log2height < DSR_TEXTURE_LOG2_TILE_SIZE) {
+		throwError(U"Can not compress a texture of ", texture_getMaxWidth(texture), U"x", texture_getMaxHeight(texture), U" pixels, because compressed textures need at least 4x4 pixels!\n");
+		return TextureRgbaU8();
+	} else {
+		// The constructor limits the number of mip levels, so that the smallest level is at least one block.
+		TextureRgbaU8 result = TextureRgbaU8(texture.impl_log2width, texture.impl_log2height, texture.impl_maxMipLevel, true, true);
+		result.impl_premultiplied = texture.impl_premultiplied;
+		for (uint32_t level = 0; level <= result.impl_maxMipLevel; level++) {
+			int32_t blockColumns = texture_getWidth(result, level) >> DSR_TEXTURE_LOG2_TILE_SIZE;
+			int32_t blockRows = texture_getHeight(result, level) >> DSR_TEXTURE_LOG2_TILE_SIZE;
+			threadedSplit(0, blockRows, [&texture, &result, level, blockColumns](int32_t startRow, int32_t stopRow) {
+				SafePointer<uint32_t> blocks = result.impl_buffer.getSafe<uint32_t>("Compressed texture blocks for encoding");
+				bool tiled = texture_isTiled(texture);
+				uint32_t pixels[16];
+				for (int32_t blockY = startRow; blockY < stopRow; blockY++) {
+					for (int32_t blockX = 0; blockX < blockColumns; blockX++) {
+						uint32_t left = uint32_t(blockX) << DSR_TEXTURE_LOG2_TILE_SIZE;
+						uint32_t top = uint32_t(blockY) << DSR_TEXTURE_LOG2_TILE_SIZE;
+						for (uint32_t p = 0; p < 16; p++) {
+							uint32_t x = left + (p & 3u);
+							uint32_t y = top + (p >> 2);
+							pixels[p] = tiled ? texture_readPixel<false, false, true, true, false, true>(texture, x, y, level)
+							                  : texture_readPixel<false, false, true, true, false, false>(texture, x, y, level);
+						}
+						// The offset of the first pixel in the tile divided by the number of pixels per tile is the block index.
+						uint32_t blockIndex = texture_getPixelOffset<false, false, true, true, false, true>(result, left, top, level) >> (DSR_TEXTURE_LOG2_TILE_SIZE * 2);
+						encodeBlock(pixels, blocks + blockIndex * DSR_TEXTURE_BLOCK_WORDS);
+					}
+				}
+			}, max(1, 256 / blockColumns));
+		}
+		return result;
 	}
 }
 
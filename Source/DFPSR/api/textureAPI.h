@@ -34,6 +34,8 @@
 	#include "../api/stringAPI.h"
 #endif
 #include "../base/DsrTraits.h"
+#include "../collection/List.h"
+#include "../math/IRect.h"
 
 namespace dsr {
 	// Post-condition: Returns true iff texture exists.
@@ -63,9 +65,33 @@ namespace dsr {
 	// Post-condition: Returns true iff texture has more than one mip level, so that updating the highest resolution needs to update lower layers.
 	inline bool texture_hasPyramid(const Texture &texture) { return texture.impl_maxMipLevel != 0; }
 
+	// Post-condition: Returns true iff texture stores its pixels in tiles of 4x4 pixels instead of rows.
+	//   Tiled textures must be accessed with TILED set to true in texture_getPixelOffset, texture_readPixel and the sampling functions.
+	//   Rows of pixels can not be accessed directly as images or pointers to rows in tiled textures.
+	inline bool texture_isTiled(const Texture &texture) { return texture.impl_tiled; }
+
+	// Post-condition: Returns true iff texture stores each tile of 4x4 pixels as a compressed block, as created by texture_compress.
+	//   Compressed textures are also tiled and must be accessed with both TILED and COMPRESSED set to true in texture_readPixel and the sampling functions.
+	//   Pixels in compressed textures can not be written to or accessed using pointers.
+	inline bool texture_isCompressed(const Texture &texture) { return texture.impl_compressed; }
+
+	// Post-condition: Returns true iff the colors in texture have been multiplied by alpha, which is inherited from the image it was created from.
+	//   Averaging premultiplied colors gives each pixel an influence proportional to its opacity,
+	//   so that the invisible colors of transparent pixels do not bleed into lower resolutions or bi-linear samples.
+	//   Draw premultiplied textures using Filter::AlphaPremultiplied.
+	inline bool texture_isPremultiplied(const Texture &texture) { return texture.impl_premultiplied; }
+
 	// Side-effect: Update all lower resolutions from the highest resolution using a basic linear average.
+	//   The average is only correct for transparent pixels when the texture is premultiplied, because straight alpha lets invisible colors bleed into visible pixels.
+	//   Each mip level is generated from the previous using SIMD, with rows split across multiple threads when large enough.
 	void texture_generatePyramid(const TextureRgbaU8& texture);
 
+	// Side-effect: Update all lower resolutions from the highest resolution in each texture, with the same result as texture_generatePyramid.
+	//   Textures are processed in parallel with one thread per texture, which is faster than splitting rows when there are many small textures.
+	//   Textures that do not exist are ignored.
+	// Pre-condition: No texture in textures may be compressed, or an exception is raised before any texture is modified.
+	void texture_generatePyramids(const List<TextureRgbaU8>& textures);
+
 	// mipLevel starts from 0 at the highest resolution and ends with the lowest resolution.
 	// Pre-condition:
 	//   0 <= mipLevel <= 15
@@ -84,6 +110,19 @@ namespace dsr {
 		}
 	}
 
+	// Internal helper function, not a part of the API!
+	// Returns the offset of pixel (x, y) within a mip level, where each row has (1 << log2PixelStride) pixels.
+	//   If TILED is true, whole tiles are stored in rows of tiles, with 4x4 pixels in each tile stored row by row.
+	//   Because the tile rows are 4 pixels high, (y & ~3) << log2PixelStride gives the offset to the tile row, just like the offset to a pixel row.
+	template<bool TILED, typename U, typename M>
+	inline U texture_getCoordinateOffset(const U &x, const U &y, const M &log2PixelStride) {
+		if (TILED) {
+			return ((y & ~3u) << log2PixelStride) | bitShiftLeftImmediate<2>(x & ~3u) | bitShiftLeftImmediate<2>(y & 3u) | (x & 3u);
+		} else {
+			return (y << log2PixelStride) | x;
+		}
+	}
+
 	// TODO: Use SQUARE AND SINGLE_LAYER to generate faster specialized shaders.
 	// TODO: Generate an array of as many mip levels as the mip calculation generates ahead of time to accelerate texture sampling.
 
@@ -95,6 +134,9 @@ namespace dsr {
 	//   * MIP_INSIDE can be set to true if you know that the mip level will always be within used indices (mipLevel <= texture_getSmallestMipLevel(texture)) without clamping.
 	//     Either way, mipLevel must always be within the 0..15 range, because dynamic bit shifting might truncate offsets that are too big.
 	//   * HIGHEST_RESOLUTION can be set to true if you want to ignore mipLevel and always sample the highest resolution at mipLevel 0.
+	// Layout argument:
+	//   * TILED must be true for textures where texture_isTiled returns true, and false for other textures.
+	//     Tiled textures store 4x4 pixels together in each tile, so that the 2x2 pixels of a bi-linear sample usually share the same cache line.
 	// Pre-condition:
 	//   mipLevel <= 15
 	// Post-condition:
@@ -105,6 +147,7 @@ namespace dsr {
 	  bool XY_INSIDE = false,          // No pixels may be sampled outside.
 	  bool MIP_INSIDE = false,         // Mip level may not go outside of existing layer indices.
 	  bool HIGHEST_RESOLUTION = false, // Ignoring any lower layers.
+	  bool TILED = false,              // Pixels are stored in tiles of 4x4 pixels.
 	  typename U, // uint32_t, U32x4, U32x8, U32xX
 	  typename M, // uint32_t or the same type as U (TODO: Constrain M to this condition)
 	  DSR_ENABLE_IF(DSR_CHECK_PROPERTY(DsrTrait_Any_U32, U) && DSR_CHECK_PROPERTY(DsrTrait_Any_U32, M))>
@@ -139,9 +182,12 @@ namespace dsr {
 				tiledY = tiledY & tileMaskY;
 			}
 		}
-		U coordinateOffset = ((tiledY << log2PixelStride) | tiledX);
+		U coordinateOffset = texture_getCoordinateOffset<TILED>(tiledX, tiledY, log2PixelStride);
 		#ifndef NDEBUG
 			// In debug mode, wrong use of optimization arguments will throw errors.
+			if (TILED != texture_isTiled(texture)) {
+				throwError(U"texture_getPixelOffset was called with TILED set to ", TILED, U" for a texture where texture_isTiled returns ", texture_isTiled(texture), U"!\n");
+			}
 			if (SQUARE) {
 				if (texture.impl_log2width != texture.impl_log2height) {
 					throwError(U"texture_getPixelOffset was told that the texture would have square dimensions using SQUARE, but ", texture_getMaxWidth(texture), U"x", texture_getMaxHeight(texture), U" is not square!\n");
@@ -176,73 +222,6 @@ namespace dsr {
 		}
 	}
 
-	template<
-	  bool SQUARE = false,
-	  bool SINGLE_LAYER = false,
-	  bool XY_INSIDE = false,
-	  bool MIP_INSIDE = false,
-	  bool HIGHEST_RESOLUTION = false,
-	  typename U, // uint32_t, U32x4, U32x8, U32xX
-	  typename M, // uint32_t or the same type as U (TODO: Constrain M to this condition)
-	  DSR_ENABLE_IF(DSR_CHECK_PROPERTY(DsrTrait_Any_U32, U) && DSR_CHECK_PROPERTY(DsrTrait_Any_U32, M))>
-	inline U texture_readPixel(const TextureRgbaU8 &texture, const U &x, const U &y, const M &mipLevel) {
-		#ifndef NDEBUG
-			if (!texture_exists(texture)) {
-				throwError(U"Tried to read pixels from a texture that does not exist!\n");
-			}
-			if (!HIGHEST_RESOLUTION) {
-				if (!allLanesLesserOrEqual(mipLevel, M(15u))) {
-					throwError(U"Tried to read pixels from mip level ", mipLevel, U", which is outside of the allowed 4-bit range 0..4!\n");
-				}
-			}
-		#endif
-		SafePointer<uint32_t> data = texture.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for pixel reading");
-		return gather_U32(data, texture_getPixelOffset<SQUARE, SINGLE_LAYER, XY_INSIDE, MIP_INSIDE, HIGHEST_RESOLUTION, U>(texture, x, y, mipLevel));
-	}
-
-	// Pre-condition:
-	//   0 <= mipLevel <= 15
-	inline void texture_writePixel(const TextureRgbaU8 &texture, uint32_t x, uint32_t y, uint32_t mipLevel, uint32_t packedColor) {
-		#ifndef NDEBUG
-			if (!texture_exists(texture)) {
-				throwError(U"Tried to write a pixel to a texture that does not exist!\n");
-			}
-			if (mipLevel > 15u) {
-				throwError(U"Tried to write a pixel to mip level ", mipLevel, U", which is outside of the allowed 4-bit range 0..4!\n");
-			}
-		#endif
-		SafePointer<uint32_t> data = texture.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for pixel writing");
-		data[texture_getPixelOffset<false, false, false, false, false, uint32_t>(texture, x, y, mipLevel)] = packedColor;
-	}
-
-	// TODO: Use these template arguments in RgbaMultiply.h to improve performance for square textures with at least 4 mip levels and UV coordinates inside of the texture.
-	// TODO: Can EXISTS be an argument to disable when non-existing images should be replaced with U(255u) for fast prototyping?
-	// Sample the nearest pixel in a normalized UV scale where one unit equals one lap around the image.
-	// Pre-condition:
-	//   -256.0f <= u, -256.0f <= v
-	//   Negative texture coordinates may not go below -256, or else they will be stretched out on ARM NEON.
-	template<
-	  bool SQUARE = false,
-	  bool SINGLE_LAYER = false,
-	  bool MIP_INSIDE = false,
-	  bool HIGHEST_RESOLUTION = false,
-	  typename F, // float, F32x4, F32x8, F32xX, F32xF
-	  typename M, // uint32_t or a SIMD vector of 32-bit unsigned integers with the same number of lanes of u and v
-	  DSR_ENABLE_IF(DSR_CHECK_PROPERTY(DsrTrait_Any_F32, F) && DSR_CHECK_PROPERTY(DsrTrait_Any_U32, M))>
-	inline auto texture_sample_nearest(const TextureRgbaU8 &texture, const F &u, const F &v, const M &mipLevel) {
-		uint32_t scaleU = 1u << texture.impl_log2width;
-		uint32_t scaleV = 1u << texture.impl_log2height;
-		if (!HIGHEST_RESOLUTION) {
-			scaleU = scaleU >> mipLevel;
-			scaleV = scaleV >> mipLevel;
-		}
-		// A constant offset applied to texture coordinates to allow using negative coordinates.
-		static const float wrapOffset = 256.0f;
-		auto xPixel = truncateToU32((u + wrapOffset) * floatFromU32(scaleU));
-		auto yPixel = truncateToU32((v + wrapOffset) * floatFromU32(scaleV));
-		return texture_readPixel<SQUARE, SINGLE_LAYER, false, MIP_INSIDE, HIGHEST_RESOLUTION>(texture, xPixel, yPixel, mipLevel);
-	}
-
 	// Internal helper function, not a part of the API!
 	// Returns (colorA * weightA + colorB * weightB) / 256 as bytes
 	// weightA and weightB should contain pairs of the same 16-bit weights for each of the 4 pixels in the corresponding A and B colors
@@ -325,6 +304,100 @@ namespace dsr {
 		return weightColors(weightColors(colorA, weightXL, colorB, weightXR), weightYT, weightColors(colorC, weightXL, colorD, weightXR), weightYB);
 	}
 
+	// Internal helper function, not a part of the API!
+	// Returns the color selected by a 2-bit index between the end points colorA and colorB in a compressed block.
+	//   Gives the same result as texture_interpolate_color_linear, by multiplying two channels at a time with 16 bits each.
+	inline uint32_t texture_getBlockColor(uint32_t colorA, uint32_t colorB, uint32_t index) {
+		// Weights 0, 85, 171 and 256 out of 256 for the indices 0, 1, 2 and 3.
+		uint32_t weightB = index * 85u + (index >> 1);
+		uint32_t weightA = 256u - weightB;
+		uint32_t lowColor = (((colorA & 0x00FF00FFu) * weightA + (colorB & 0x00FF00FFu) * weightB) >> 8) & 0x00FF00FFu;
+		uint32_t highColor = (((colorA >> 8) & 0x00FF00FFu) * weightA + ((colorB >> 8) & 0x00FF00FFu) * weightB) & 0xFF00FF00u;
+		return lowColor | highColor;
+	}
+
+	// Internal helper function, not a part of the API!
+	// Returns the color of the pixel at pixelOffset from texture_getPixelOffset with TILED in a compressed texture.
+	//   Each tile has 16 pixels, so the pixel offset divided by 16 is the block index and the remainder is the pixel index within the block.
+	inline uint32_t texture_decodeBlockPixel(SafePointer<const uint32_t> blocks, const uint32_t &pixelOffset) {
+		uint32_t firstWord = (pixelOffset >> 4) * DSR_TEXTURE_BLOCK_WORDS;
+		uint32_t index = (blocks[firstWord + 2u] >> ((pixelOffset & 15u) * 2u)) & 3u;
+		return texture_getBlockColor(blocks[firstWord], blocks[firstWord + 1u], index);
+	}
+	template <typename U32, DSR_ENABLE_IF(DSR_CHECK_PROPERTY(DsrTrait_Any_U32, U32))>
+	inline U32 texture_decodeBlockPixel(SafePointer<const uint32_t> blocks, const U32 &pixelOffset) {
+		U32 blockIndex = bitShiftRightImmediate<4>(pixelOffset);
+		U32 firstWord = bitShiftLeftImmediate<1>(blockIndex) + blockIndex;
+		U32 colorA = gather_U32(blocks, firstWord);
+		U32 colorB = gather_U32(blocks, firstWord + 1u);
+		U32 index = (gather_U32(blocks, firstWord + 2u) >> bitShiftLeftImmediate<1>(pixelOffset & 15u)) & 3u;
+		// Weights 0, 85, 171 and 256 out of 256 for the indices 0, 1, 2 and 3.
+		U32 weight = bitShiftLeftImmediate<6>(index) + bitShiftLeftImmediate<4>(index) + bitShiftLeftImmediate<2>(index) + index + bitShiftRightImmediate<1>(index);
+		return texture_interpolate_color_linear(colorA, colorB, weight);
+	}
+
+	template<
+	  bool SQUARE = false,
+	  bool SINGLE_LAYER = false,
+	  bool XY_INSIDE = false,
+	  bool MIP_INSIDE = false,
+	  bool HIGHEST_RESOLUTION = false,
+	  bool TILED = false,
+	  bool COMPRESSED = false,
+	  typename U, // uint32_t, U32x4, U32x8, U32xX
+	  typename M, // uint32_t or the same type as U (TODO: Constrain M to this condition)
+	  DSR_ENABLE_IF(DSR_CHECK_PROPERTY(DsrTrait_Any_U32, U) && DSR_CHECK_PROPERTY(DsrTrait_Any_U32, M))>
+	inline U texture_readPixel(const TextureRgbaU8 &texture, const U &x, const U &y, const M &mipLevel) {
+		#ifndef NDEBUG
+			if (!texture_exists(texture)) {
+				throwError(U"Tried to read pixels from a texture that does not exist!\n");
+			}
+			if (!HIGHEST_RESOLUTION) {
+				if (!allLanesLesserOrEqual(mipLevel, M(15u))) {
+					throwError(U"Tried to read pixels from mip level ", mipLevel, U", which is outside of the allowed 4-bit range 0..4!\n");
+				}
+			}
+			if (COMPRESSED != texture_isCompressed(texture)) {
+				throwError(U"texture_readPixel was called with COMPRESSED set to ", COMPRESSED, U" for a texture where texture_isCompressed returns ", texture_isCompressed(texture), U"!\n");
+			}
+		#endif
+		SafePointer<uint32_t> data = texture.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for pixel reading");
+		U pixelOffset = texture_getPixelOffset<SQUARE, SINGLE_LAYER, XY_INSIDE, MIP_INSIDE, HIGHEST_RESOLUTION, TILED, U>(texture, x, y, mipLevel);
+		if (COMPRESSED) {
+			return texture_decodeBlockPixel(data, pixelOffset);
+		} else {
+			return gather_U32(data, pixelOffset);
+		}
+	}
+
+	// Writes to both tiled and untiled textures, by checking the layout in runtime.
+	// Pre-condition:
+	//   0 <= mipLevel <= 15
+	inline void texture_writePixel(const TextureRgbaU8 &texture, uint32_t x, uint32_t y, uint32_t mipLevel, uint32_t packedColor) {
+		#ifndef NDEBUG
+			if (!texture_exists(texture)) {
+				throwError(U"Tried to write a pixel to a texture that does not exist!\n");
+			}
+			if (mipLevel > 15u) {
+				throwError(U"Tried to write a pixel to mip level ", mipLevel, U", which is outside of the allowed 4-bit range 0..4!\n");
+			}
+		#endif
+		// Checked also in release builds, because writing block data as pixels would silently corrupt the compressed texture.
+		if (texture_isCompressed(texture)) {
+			throwError(U"Tried to write a pixel to a compressed texture!\n");
+			return;
+		}
+		SafePointer<uint32_t> data = texture.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for pixel writing");
+		if (texture_isTiled(texture)) {
+			data[texture_getPixelOffset<false, false, false, false, false, true, uint32_t>(texture, x, y, mipLevel)] = packedColor;
+		} else {
+			data[texture_getPixelOffset<false, false, false, false, false, false, uint32_t>(texture, x, y, mipLevel)] = packedColor;
+		}
+	}
+
+	// TODO: Use these template arguments in RgbaMultiply.h to improve performance for square textures with at least 4 mip levels and UV coordinates inside of the texture.
+	// TODO: Can EXISTS be an argument to disable when non-existing images should be replaced with U(255u) for fast prototyping?
+	// Sample the nearest pixel in a normalized UV scale where one unit equals one lap around the image.
 	// Pre-condition:
 	//   -256.0f <= u, -256.0f <= v
 	//   Negative texture coordinates may not go below -256, or else they will be stretched out on ARM NEON.
@@ -333,6 +406,35 @@ namespace dsr {
 	  bool SINGLE_LAYER = false,
 	  bool MIP_INSIDE = false,
 	  bool HIGHEST_RESOLUTION = false,
+	  bool TILED = false,
+	  bool COMPRESSED = false,
+	  typename F, // float, F32x4, F32x8, F32xX, F32xF
+	  typename M, // uint32_t or a SIMD vector of 32-bit unsigned integers with the same number of lanes of u and v
+	  DSR_ENABLE_IF(DSR_CHECK_PROPERTY(DsrTrait_Any_F32, F) && DSR_CHECK_PROPERTY(DsrTrait_Any_U32, M))>
+	inline auto texture_sample_nearest(const TextureRgbaU8 &texture, const F &u, const F &v, const M &mipLevel) {
+		uint32_t scaleU = 1u << texture.impl_log2width;
+		uint32_t scaleV = 1u << texture.impl_log2height;
+		if (!HIGHEST_RESOLUTION) {
+			scaleU = scaleU >> mipLevel;
+			scaleV = scaleV >> mipLevel;
+		}
+		// A constant offset applied to texture coordinates to allow using negative coordinates.
+		static const float wrapOffset = 256.0f;
+		auto xPixel = truncateToU32((u + wrapOffset) * floatFromU32(scaleU));
+		auto yPixel = truncateToU32((v + wrapOffset) * floatFromU32(scaleV));
+		return texture_readPixel<SQUARE, SINGLE_LAYER, false, MIP_INSIDE, HIGHEST_RESOLUTION, TILED, COMPRESSED>(texture, xPixel, yPixel, mipLevel);
+	}
+
+	// Pre-condition:
+	//   -256.0f <= u, -256.0f <= v
+	//   Negative texture coordinates may not go below -256, or else they will be stretched out on ARM NEON.
+	template<
+	  bool SQUARE = false,
+	  bool SINGLE_LAYER = false,
+	  bool MIP_INSIDE = false,
+	  bool HIGHEST_RESOLUTION = false,
+	  bool TILED = false,
+	  bool COMPRESSED = false,
 	  typename F32, // float, F32x4, F32x8, F32xX, F32xF
 	  typename M, // uint32_t or the same type as U (TODO: Constrain M to this condition)
 	  DSR_ENABLE_IF(
@@ -399,6 +501,12 @@ namespace dsr {
 		}
 		#ifndef NDEBUG
 			// In debug mode, wrong use of optimization arguments will throw errors.
+			if (TILED != texture_isTiled(texture)) {
+				throwError(U"texture_sample_bilinear was called with TILED set to ", TILED, U" for a texture where texture_isTiled returns ", texture_isTiled(texture), U"!\n");
+			}
+			if (COMPRESSED != texture_isCompressed(texture)) {
+				throwError(U"texture_sample_bilinear was called with COMPRESSED set to ", COMPRESSED, U" for a texture where texture_isCompressed returns ", texture_isCompressed(texture), U"!\n");
+			}
 			if (SQUARE && (texture.impl_log2width != texture.impl_log2height)) {
 				throwError(U"texture_getPixelOffset was told that the texture would have square dimensions using SQUARE, but ", texture_getMaxWidth(texture), U"x", texture_getMaxHeight(texture), U" is not square!\n");
 			}
@@ -416,12 +524,10 @@ namespace dsr {
 				}
 			}
 		#endif
-		auto upperOffset       = pixelTop    << log2PixelStride;
-		auto bottomOffset      = pixelBottom << log2PixelStride;
-		auto upperLeftOffset   = upperOffset  | pixelLeft;
-		auto upperRightOffset  = upperOffset  | pixelRight;
-		auto bottomLeftOffset  = bottomOffset | pixelLeft;
-		auto bottomRightOffset = bottomOffset | pixelRight;
+		auto upperLeftOffset   = texture_getCoordinateOffset<TILED>(pixelLeft , pixelTop   , log2PixelStride);
+		auto upperRightOffset  = texture_getCoordinateOffset<TILED>(pixelRight, pixelTop   , log2PixelStride);
+		auto bottomLeftOffset  = texture_getCoordinateOffset<TILED>(pixelLeft , pixelBottom, log2PixelStride);
+		auto bottomRightOffset = texture_getCoordinateOffset<TILED>(pixelRight, pixelBottom, log2PixelStride);
 		if (!SINGLE_LAYER) {
 			auto layerStartOffset(texture_getPixelOffsetToLayer<HIGHEST_RESOLUTION>(texture, mipLevel));
 			upperLeftOffset  = upperLeftOffset  + layerStartOffset;
@@ -430,40 +536,100 @@ namespace dsr {
 			bottomRightOffset = bottomRightOffset + layerStartOffset;
 		}
 		SafePointer<uint32_t> data = texture.impl_buffer.getSafe<uint32_t>("RgbaU8 pyramid pixel buffer for bi-linear pixel sampling");
-		auto upperLeftColor   = gather_U32(data, upperLeftOffset  );
-		auto upperRightColor  = gather_U32(data, upperRightOffset );
-		auto bottomLeftColor  = gather_U32(data, bottomLeftOffset );
-		auto bottomRightColor = gather_U32(data, bottomRightOffset);
-		return texture_interpolate_color_bilinear(upperLeftColor, upperRightColor, bottomLeftColor, bottomRightColor, weightX, weightY);
+		if (COMPRESSED) {
+			// Each of the four pixels is decoded from its block before interpolating, so that filtering works the same as for uncompressed textures.
+			auto upperLeftColor   = texture_decodeBlockPixel(data, upperLeftOffset  );
+			auto upperRightColor  = texture_decodeBlockPixel(data, upperRightOffset );
+			auto bottomLeftColor  = texture_decodeBlockPixel(data, bottomLeftOffset );
+			auto bottomRightColor = texture_decodeBlockPixel(data, bottomRightOffset);
+			return texture_interpolate_color_bilinear(upperLeftColor, upperRightColor, bottomLeftColor, bottomRightColor, weightX, weightY);
+		} else {
+			auto upperLeftColor   = gather_U32(data, upperLeftOffset  );
+			auto upperRightColor  = gather_U32(data, upperRightOffset );
+			auto bottomLeftColor  = gather_U32(data, bottomLeftOffset );
+			auto bottomRightColor = gather_U32(data, bottomRightOffset);
+			return texture_interpolate_color_bilinear(upperLeftColor, upperRightColor, bottomLeftColor, bottomRightColor, weightX, weightY);
+		}
 	}
 
 	// resolutions is the maximum number of resolutions to create.
 	//   The actual number of layers in the texture is limited by the most narrow dimension.
 	//   A texture of 16x4 pixels can have up to three resolutions, 4x1, 8x2 and 16x4.
 	//   A texture of 8x8 pixels can have up to four resolutions, 1x1, 2x2, 4x4 and 8x8.
+	// If tiled is true, the pixels will be stored in tiles of 4x4 pixels, which is faster to sample when rotated or minified.
+	//   Tiled textures are at least 4x4 pixels large, and can not have mip levels smaller than 4x4 pixels.
 	// Pre-condition:
 	//   1 <= width <= 32768
 	//   1 <= height <= 32768
 	//   0 <= resolutions <= 16
 	// Post-condition:
 	//   Returns a pyramid image of the smallest power of two size capable of storing width x height pixels, by scaling up the resolution with interpolation if needed.
-	TextureRgbaU8 texture_create_RgbaU8(int32_t width, int32_t height, int32_t resolutions);
+	TextureRgbaU8 texture_create_RgbaU8(int32_t width, int32_t height, int32_t resolutions, bool tiled = false);
 	// Pre-condition:
 	//   1 <= width <= 32768
 	//   1 <= height <= 32768
 	//   1 <= resolutions
 	// Post-condition:
 	//   Returns a pyramid image created from image, or an empty pyramid if the image is empty.
-	TextureRgbaU8 texture_create_RgbaU8(const ImageRgbaU8& image, int32_t resolutions);
+	//   Images that already have power of two dimensions are copied directly without resampling.
+	TextureRgbaU8 texture_create_RgbaU8(const ImageRgbaU8& image, int32_t resolutions, bool tiled = false);
+	// Create textures from many images at the same time, using one thread per texture.
+	// Pre-condition:
+	//   Each existing image is within 1..32768 x 1..32768 pixels.
+	//   1 <= resolutions
+	// Post-condition:
+	//   Returns a list of textures with the same length as images, where each texture is created from the image at the same index.
+	List<TextureRgbaU8> texture_create_RgbaU8(const List<ImageRgbaU8>& images, int32_t resolutions, bool tiled = false);
+
+	// Many small images packed into one texture, so that they can share the same texture in draw calls.
+	struct TextureAtlas {
+		TextureRgbaU8 texture;
+		// The pixel region of each image in the highest resolution of texture, in the same order as the images.
+		//   Images that did not exist get empty regions.
+		List<IRect> regions;
+	};
+
+	// Pack images into a texture atlas.
+	//   Each image is surrounded by padding with copies of its edge pixels, and aligned so that mip levels do not blend pixels from different images.
+	//   With N resolutions, images are aligned to 2^(N-1) pixels and padded with 2^(N-1) pixels on each side,
+	//     so that bi-linear sampling of the lowest resolution can not reach into neighbor images either.
+	//   Keep resolutions low when packing many small images, because the padding grows with each mip level.
+	// Pre-condition:
+	//   1 <= resolutions <= 8
+	// Post-condition:
+	//   Returns an atlas with a texture of power of two dimensions with the given number of resolutions, and one region per image.
+	//   If no image exists, an atlas without a texture is returned.
+	//   If any image is premultiplied, the texture is premultiplied and images with straight alpha are converted using filter_premultiplyAlpha.
+	TextureAtlas texture_createAtlas(const List<ImageRgbaU8>& images, int32_t resolutions, bool tiled = false);
 
 	// Get a layer from the texture as an image.
 	// Pre-condition:
 	//   texture_exists(texture)
+	//   !texture_isTiled(texture)
 	//   0 <= mipLevel <= texture_getSmallestMipLevel(texture)
 	// Post-condition:
 	//   Returns an unaligned RGBA image sharing pixel data with the requested texture layer.
 	ImageRgbaU8 texture_getMipLevelImage(const TextureRgbaU8& texture, int32_t mipLevel);
 
+	// Get a copy of the texture without the resolutions above mipLevel, for saving memory by removing the highest resolutions.
+	//   Lower resolutions are stored first, so the copy is made directly from the start of the pixel buffer.
+	// Pre-condition:
+	//   0 <= mipLevel <= texture_getSmallestMipLevel(texture)
+	// Post-condition:
+	//   Returns a new texture where mip level 0 has the pixels from mipLevel in texture, or an empty texture if texture does not exist.
+	TextureRgbaU8 texture_getLowerResolutions(const TextureRgbaU8& texture, int32_t mipLevel);
+
+	// Compress a texture to use 5.33 times less memory, by storing each tile of 4x4 pixels as a block of two end point colors and 2-bit indices.
+	//   All colors in a block are interpolated along one line in RGBA space, so blocks with more than one gradient will lose detail.
+	//   The end points are selected from each block's bounding box, with the diagonal following the correlation between channels.
+	//   Blocks are encoded in parallel using multiple threads.
+	// Pre-condition:
+	//   The highest resolution in texture is at least 4x4 pixels.
+	// Post-condition:
+	//   Returns a compressed texture with the same pixel dimensions as texture, or an empty texture if texture does not exist.
+	//   Mip levels smaller than 4x4 pixels are not included, because compressed textures are tiled.
+	TextureRgbaU8 texture_compress(const TextureRgbaU8& texture);
+
 	// TODO: Pre-calculate the pixel offset, float scales and tile masks and merge into a reusable multi-layer sampling method.
 	//       Because dynamic bit shifts can not be vectorized on Intel processors and would be the same for 2x2 pixels anyway.
 	//       The hard part will be to implement it for ARM SVE with variable width vectors, so maybe calculate the
@@ -501,18 +667,29 @@ namespace dsr {
 	//   Returns a safe pointer to the first pixel at mipLevel in texture.
 	template <typename U = uint32_t>
 	inline SafePointer<U> texture_getSafePointer(const TextureRgbaU8& texture, uint32_t mipLevel) {
+		#ifndef NDEBUG
+			if (texture_isCompressed(texture)) {
+				throwError(U"Can not get a pointer to pixels in a compressed texture!\n");
+			}
+		#endif
 		// Get a pointer to the start of the image.
 		return texture.impl_buffer.getSafe<U>("RgbaU8 pyramid pixel buffer").increaseBytes(texture_getPixelOffsetToLayer(texture, mipLevel) * sizeof(uint32_t));
 	}
 
 	// TODO: Optimize using template arguments.
 	// Pre-conditions:
+	//   !texture_isTiled(texture)
 	//   0 <= mipLevel <= texture_getSmallestMipLevel(texture)
 	//   0 <= rowIndex < (1 << mipLevel)
 	// Post-condition:
 	//   Returns a safe pointer to the first pixel at rowIndex in mipLevel in texture.
 	template <typename U = uint32_t>
 	inline SafePointer<U> texture_getSafePointer(const TextureRgbaU8& texture, int32_t mipLevel, int32_t rowIndex) {
+		#ifndef NDEBUG
+			if (texture_isTiled(texture)) {
+				throwError(U"Can not get a pointer to a row of pixels in a tiled texture!\n");
+			}
+		#endif
 		return texture_getSafePointer<U>(texture, mipLevel).increaseBytes(texture_getWidth(texture, mipLevel) * sizeof(uint32_t) * rowIndex);
 	}
 }
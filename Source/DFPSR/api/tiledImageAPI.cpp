@@ -0,0 +1,445 @@
+﻿
+// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+#define DSR_INTERNAL_ACCESS
+
+#include <cstring>
+#include <mutex>
+#include "tiledImageAPI.h"
+#include "drawAPI.h"
+#include "fileAPI.h"
+#include "../base/threading.h"
+#include "../collection/Array.h"
+#include "../collection/List.h"
+
+namespace dsr {
+
+// The header is padded to a whole page, so that each tile begins at the same alignment within the file.
+static const int32_t tilesHeaderSize = 4096;
+static const uint32_t tilesVersion = 1;
+static const uint32_t tilesByteOrderMarker = 0x01020304;
+static const char tilesIdentifier[8] = {'D', 'S', 'R', 'T', 'I', 'L', 'E', 'S'};
+struct TiledImageHeader {
+	char identifier[8];
+	uint32_t byteOrder; // tilesByteOrderMarker in the byte order of the computer that saved the file.
+	uint32_t version;
+	uint32_t pixelFormat;
+	uint32_t width;
+	uint32_t height;
+	uint32_t tileSize; // Width and height of each tile in pixels.
+};
+static const int32_t maxTileSize = 4096;
+// Limits the size of the tile table, which is allocated in memory.
+static const int64_t maxTileCount = 16777216;
+
+static int32_t getPixelSize(PixelFormat pixelFormat) {
+	switch (pixelFormat) {
+		case PixelFormat::MonoU8:  return 1;
+		case PixelFormat::MonoU16: return 2;
+		case PixelFormat::MonoF16: return 2;
+		default:                   return 4;
+	}
+}
+
+struct CachedTile {
+	int32_t tileIndex;
+	// The whole tile, including pixels outside of the image at the right and bottom edges.
+	Image image;
+	// True if the pixels have changed since loaded from the file.
+	bool dirty;
+	// The value of useCounter when last requested, for finding the least recently used tile.
+	uint64_t lastUse;
+	CachedTile(int32_t tileIndex, const Image &image, bool dirty, uint64_t lastUse)
+	: tileIndex(tileIndex), image(image), dirty(dirty), lastUse(lastUse) {}
+};
+
+struct TiledImageImpl {
+	RandomAccessFile file;
+	PixelFormat pixelFormat;
+	int32_t width, height, tileSize, tileCountX, tileCountY, maxCachedTiles;
+	// Bytes in each row of a tile and the whole tile within the file.
+	int32_t tileRowSize;
+	int64_t tileByteSize;
+	// Protects the cache, so that each tile is only loaded once and not evicted while being requested.
+	std::mutex lock;
+	List<CachedTile> cache;
+	// The index in cache for each tile, or -1 if not in memory.
+	Array<int32_t> slotOfTile;
+	uint64_t useCounter = 0;
+	TiledImageImpl(const RandomAccessFile &file, PixelFormat pixelFormat, int32_t width, int32_t height, int32_t tileSize, int32_t maxCachedTiles)
+	: file(file), pixelFormat(pixelFormat), width(width), height(height), tileSize(tileSize),
+	  tileCountX((width + tileSize - 1) / tileSize), tileCountY((height + tileSize - 1) / tileSize), maxCachedTiles(maxCachedTiles),
+	  tileRowSize(tileSize * getPixelSize(pixelFormat)), tileByteSize(int64_t(tileSize) * int64_t(tileRowSize)),
+	  slotOfTile(tileCountX * tileCountY, -1) {}
+	// Only file operations are used here, because heap allocations are not allowed while destructing a handle.
+	~TiledImageImpl() {
+		// Failures are ignored, because destructors can not throw. Callers who need to know call tiledImage_flush first.
+		for (intptr_t c = 0; c < this->cache.length(); c++) {
+			this->writeTile(this->cache[c]);
+		}
+	}
+	int64_t getTileOffset(int32_t tileIndex) const {
+		return int64_t(tilesHeaderSize) + int64_t(tileIndex) * this->tileByteSize;
+	}
+	bool writeTile(CachedTile &tile) {
+		if (tile.dirty) {
+			int64_t fileOffset = this->getTileOffset(tile.tileIndex);
+			int32_t stride = image_getStride(tile.image);
+			SafePointer<const uint8_t> source = buffer_getSafeData<uint8_t>(tile.image.impl_buffer, "Tile pixels");
+			if (stride == this->tileRowSize) {
+				if (!file_writeAt(this->file, fileOffset, source, this->tileByteSize)) return false;
+			} else {
+				for (int32_t y = 0; y < this->tileSize; y++) {
+					if (!file_writeAt(this->file, fileOffset, source, this->tileRowSize)) return false;
+					fileOffset += this->tileRowSize;
+					source.increaseBytes(stride);
+				}
+			}
+			tile.dirty = false;
+		}
+		return true;
+	}
+	Image createTile(bool zeroed) const {
+		switch (this->pixelFormat) {
+			case PixelFormat::MonoU8:  return image_create_U8 (this->tileSize, this->tileSize, zeroed);
+			case PixelFormat::MonoU16: return image_create_U16(this->tileSize, this->tileSize, zeroed);
+			case PixelFormat::MonoF32: return image_create_F32(this->tileSize, this->tileSize, zeroed);
+			case PixelFormat::MonoF16: return image_create_F16(this->tileSize, this->tileSize, zeroed);
+			default:                   return image_create_RgbaU8(this->tileSize, this->tileSize, zeroed);
+		}
+	}
+	bool readTile(int32_t tileIndex, const Image &target) {
+		int64_t fileOffset = this->getTileOffset(tileIndex);
+		int32_t stride = image_getStride(target);
+		SafePointer<uint8_t> destination = buffer_getSafeData<uint8_t>(target.impl_buffer, "Tile pixels");
+		if (stride == this->tileRowSize) {
+			return file_readAt(this->file, fileOffset, destination, this->tileByteSize);
+		} else {
+			for (int32_t y = 0; y < this->tileSize; y++) {
+				if (!file_readAt(this->file, fileOffset, destination, this->tileRowSize)) return false;
+				fileOffset += this->tileRowSize;
+				destination.increaseBytes(stride);
+			}
+			return true;
+		}
+	}
+	// Pre-condition: The lock is held.
+	// Side-effect: Evicts the least recently used tiles that are only referenced by the cache, until there is room for one more tile.
+	//   If all tiles are referenced from outside of the cache, the cache is allowed to grow beyond maxCachedTiles.
+	void makeRoom() {
+		while (this->cache.length() >= this->maxCachedTiles) {
+			intptr_t oldestSlot = -1;
+			for (intptr_t c = 0; c < this->cache.length(); c++) {
+				if (image_useCount(this->cache[c].image) == 1 && (oldestSlot == -1 || this->cache[c].lastUse < this->cache[oldestSlot].lastUse)) {
+					oldestSlot = c;
+				}
+			}
+			if (oldestSlot == -1) {
+				return;
+			}
+			if (!this->writeTile(this->cache[oldestSlot])) {
+				throwError(U"Failed to write a tile to the tiled image's file!\n");
+				return;
+			}
+			// Remove by moving the last tile into the evicted slot.
+			this->slotOfTile[this->cache[oldestSlot].tileIndex] = -1;
+			intptr_t lastSlot = this->cache.lastIndex();
+			if (oldestSlot != lastSlot) {
+				this->cache.swap(oldestSlot, lastSlot);
+				this->slotOfTile[this->cache[oldestSlot].tileIndex] = oldestSlot;
+			}
+			this->cache.pop();
+		}
+	}
+	// Side-effect: Loads the tile at tileIndex into the cache if not already there, and marks it as modified if modify is true.
+	//   If overwrite is true, the tile is not read from the file, because the caller will overwrite all pixels inside of the image.
+	// Post-condition: Returns the whole tile, which stays in memory for as long as the returned image is referenced.
+	Image getTile(int32_t tileIndex, bool modify, bool overwrite) {
+		std::unique_lock<std::mutex> lock(this->lock);
+		this->useCounter++;
+		int32_t slot = this->slotOfTile[tileIndex];
+		if (slot == -1) {
+			this->makeRoom();
+			Image newTile = this->createTile(overwrite);
+			if (!overwrite && !this->readTile(tileIndex, newTile)) {
+				throwError(U"Failed to read a tile from the tiled image's file!\n");
+				return Image();
+			}
+			slot = this->cache.pushConstructGetIndex(tileIndex, newTile, false, this->useCounter);
+			this->slotOfTile[tileIndex] = slot;
+		}
+		CachedTile &tile = this->cache[slot];
+		tile.lastUse = this->useCounter;
+		if (modify) tile.dirty = true;
+		return tile.image;
+	}
+	void flush() {
+		std::unique_lock<std::mutex> lock(this->lock);
+		for (intptr_t c = 0; c < this->cache.length(); c++) {
+			if (!this->writeTile(this->cache[c])) {
+				throwError(U"Failed to write a tile to the tiled image's file!\n");
+				return;
+			}
+		}
+	}
+};
+
+static bool validTileSettings(int32_t width, int32_t height, int32_t tileSize) {
+	if (width < 1 || height < 1 || tileSize < 1 || tileSize > maxTileSize) {
+		return false;
+	}
+	int64_t tileCountX = (int64_t(width) + tileSize - 1) / tileSize;
+	int64_t tileCountY = (int64_t(height) + tileSize - 1) / tileSize;
+	return tileCountX * tileCountY <= maxTileCount;
+}
+
+TiledImage tiledImage_create(const ReadableString& filename, PixelFormat pixelFormat, int32_t width, int32_t height, int32_t tileSize, int32_t maxCachedTiles, bool mustWork) {
+	if (!validTileSettings(width, height, tileSize) || maxCachedTiles < 1) {
+		if (mustWork) { throwError(U"tiledImage_create: Invalid dimensions ", width, U"x", height, U" with tile size ", tileSize, U" and ", maxCachedTiles, U" cached tiles for ", filename, U".\n"); }
+		return TiledImage();
+	}
+	RandomAccessFile file = file_openRandomAccess(filename, true, mustWork);
+	if (file.isNull()) {
+		return TiledImage();
+	}
+	// Only the header is written, so that tiles not yet written will be read as zeroes.
+	uint8_t headerBlock[tilesHeaderSize] = {};
+	TiledImageHeader header;
+	memcpy(header.identifier, tilesIdentifier, sizeof(tilesIdentifier));
+	header.byteOrder = tilesByteOrderMarker;
+	header.version = tilesVersion;
+	header.pixelFormat = uint32_t(pixelFormat);
+	header.width = width;
+	header.height = height;
+	header.tileSize = tileSize;
+	memcpy(headerBlock, &header, sizeof(TiledImageHeader));
+	if (!file_writeAt(file, 0, SafePointer<const uint8_t>("Tiled image header", headerBlock, tilesHeaderSize), tilesHeaderSize)) {
+		if (mustWork) { throwError(U"tiledImage_create: Failed to write the header of ", filename, U".\n"); }
+		return TiledImage();
+	}
+	return TiledImage(handle_create<TiledImageImpl>(file, pixelFormat, width, height, tileSize, maxCachedTiles).setName("Tiled image"), IRect(0, 0, width, height));
+}
+
+TiledImage tiledImage_open(const ReadableString& filename, int32_t maxCachedTiles, bool mustExist) {
+	RandomAccessFile file = file_openRandomAccess(filename, false, mustExist);
+	if (file.isNull()) {
+		return TiledImage();
+	}
+	TiledImageHeader header;
+	if (!file_readAt(file, 0, SafePointer<uint8_t>("Tiled image header", (uint8_t*)&header, sizeof(TiledImageHeader)), sizeof(TiledImageHeader))
+	 || memcmp(header.identifier, tilesIdentifier, sizeof(tilesIdentifier)) != 0) {
+		if (mustExist) { throwError(U"tiledImage_open: ", filename, U" is not a tiled image!\n"); }
+		return TiledImage();
+	}
+	if (header.byteOrder != tilesByteOrderMarker) {
+		if (mustExist) { throwError(U"tiledImage_open: ", filename, U" was saved with a different byte order!\n"); }
+		return TiledImage();
+	}
+	if (header.version != tilesVersion) {
+		if (mustExist) { throwError(U"tiledImage_open: ", filename, U" has the unknown version ", header.version, U"!\n"); }
+		return TiledImage();
+	}
+	if (header.pixelFormat > uint32_t(PixelFormat::MonoF16) || header.width > 0x7FFFFFFF || header.height > 0x7FFFFFFF
+	 || !validTileSettings(int32_t(header.width), int32_t(header.height), int32_t(header.tileSize)) || maxCachedTiles < 1) {
+		if (mustExist) { throwError(U"tiledImage_open: ", filename, U" has invalid dimensions or pixel format!\n"); }
+		return TiledImage();
+	}
+	int32_t width = int32_t(header.width);
+	int32_t height = int32_t(header.height);
+	return TiledImage(handle_create<TiledImageImpl>(file, PixelFormat(header.pixelFormat), width, height, int32_t(header.tileSize), maxCachedTiles).setName("Tiled image"), IRect(0, 0, width, height));
+}
+
+PixelFormat tiledImage_getPixelFormat(const TiledImage& image) {
+	return image.impl_tiles.isNotNull() ? image.impl_tiles->pixelFormat : PixelFormat::MonoU8;
+}
+
+int32_t tiledImage_getTileSize(const TiledImage& image) {
+	return image.impl_tiles.isNotNull() ? image.impl_tiles->tileSize : 0;
+}
+
+int32_t tiledImage_getCachedTileCount(const TiledImage& image) {
+	if (image.impl_tiles.isNull()) {
+		return 0;
+	} else {
+		std::unique_lock<std::mutex> lock(image.impl_tiles->lock);
+		return image.impl_tiles->cache.length();
+	}
+}
+
+TiledImage tiledImage_getSubImage(const TiledImage& image, const IRect& region) {
+	IRect cut = IRect::cut(tiledImage_getBound(image), region);
+	if (image.impl_tiles.isNotNull() && cut.hasArea()) {
+		return TiledImage(image.impl_tiles, cut + image.impl_region.upperLeft());
+	} else {
+		return TiledImage(); // Null gives null
+	}
+}
+
+void tiledImage_flush(const TiledImage& image) {
+	if (image.impl_tiles.isNotNull()) {
+		image.impl_tiles->flush();
+	}
+}
+
+static const char32_t* getPixelFormatName(PixelFormat pixelFormat) {
+	switch (pixelFormat) {
+		case PixelFormat::MonoU8:  return U"U8";
+		case PixelFormat::MonoU16: return U"U16";
+		case PixelFormat::MonoF32: return U"F32";
+		case PixelFormat::MonoF16: return U"F16";
+		default:                   return U"RgbaU8";
+	}
+}
+
+static bool matchingPixelFormat(const TiledImage& image, PixelFormat pixelFormat, const char32_t *functionName) {
+	if (image.impl_tiles->pixelFormat != pixelFormat) {
+		throwError(functionName, U": Expected a tiled image of ", getPixelFormatName(pixelFormat), U" pixels, but got ", getPixelFormatName(image.impl_tiles->pixelFormat), U".\n");
+		return false;
+	}
+	return true;
+}
+
+// Calls visitTile with each tile overlapping region, given in pixel coordinates of the whole tiled image.
+//   cut is the part of region within the tile, and tileLeft, tileTop is the tile's upper left corner in the whole image.
+template <typename F>
+static void forEachTile(const TiledImageImpl &tiles, const IRect &region, const F &visitTile) {
+	int32_t tileSize = tiles.tileSize;
+	for (int32_t tileY = region.top() / tileSize; tileY <= (region.bottom() - 1) / tileSize; tileY++) {
+		for (int32_t tileX = region.left() / tileSize; tileX <= (region.right() - 1) / tileSize; tileX++) {
+			IRect cut = IRect::cut(region, IRect(tileX * tileSize, tileY * tileSize, tileSize, tileSize));
+			visitTile(tileY * tiles.tileCountX + tileX, cut, tileX * tileSize, tileY * tileSize);
+		}
+	}
+}
+
+template <typename IMAGE_TYPE>
+static void tiledImage_filter_template(const TiledImage& image, PixelFormat pixelFormat, const TemporaryCallback<void(const IMAGE_TYPE &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount) {
+	if (image.impl_tiles.isNull() || !matchingPixelFormat(image, pixelFormat, U"tiledImage_filter")) {
+		return;
+	}
+	TiledImageImpl *tiles = image.impl_tiles.getUnsafe();
+	IRect region = image.impl_region;
+	int32_t tileSize = tiles->tileSize;
+	int32_t firstTileX = region.left() / tileSize;
+	int32_t firstTileY = region.top() / tileSize;
+	int32_t columns = (region.right() - 1) / tileSize - firstTileX + 1;
+	int32_t rows = (region.bottom() - 1) / tileSize - firstTileY + 1;
+	threadedWorkByIndex([tiles, region, tileSize, firstTileX, firstTileY, columns, &filter](void *, int32_t jobIndex) {
+		int32_t tileX = firstTileX + jobIndex % columns;
+		int32_t tileY = firstTileY + jobIndex / columns;
+		int32_t tileLeft = tileX * tileSize;
+		int32_t tileTop = tileY * tileSize;
+		IRect cut = IRect::cut(region, IRect(tileLeft, tileTop, tileSize, tileSize));
+		// The tile is released when the filter returns, so that it can be evicted when other tiles are loaded.
+		Image tile = tiles->getTile(tileY * tiles->tileCountX + tileX, true, false);
+		filter(IMAGE_TYPE(IMAGE_TYPE(tile.impl_buffer, tile.impl_dimensions), IRect(cut.left() - tileLeft, cut.top() - tileTop, cut.width(), cut.height())), cut.left() - region.left(), cut.top() - region.top());
+	}, nullptr, columns * rows, maxThreadCount);
+}
+void tiledImage_filterU8(const TiledImage& image, const TemporaryCallback<void(const ImageU8 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount) {
+	tiledImage_filter_template<ImageU8>(image, PixelFormat::MonoU8, filter, maxThreadCount);
+}
+void tiledImage_filterU16(const TiledImage& image, const TemporaryCallback<void(const ImageU16 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount) {
+	tiledImage_filter_template<ImageU16>(image, PixelFormat::MonoU16, filter, maxThreadCount);
+}
+void tiledImage_filterF32(const TiledImage& image, const TemporaryCallback<void(const ImageF32 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount) {
+	tiledImage_filter_template<ImageF32>(image, PixelFormat::MonoF32, filter, maxThreadCount);
+}
+void tiledImage_filterF16(const TiledImage& image, const TemporaryCallback<void(const ImageF16 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount) {
+	tiledImage_filter_template<ImageF16>(image, PixelFormat::MonoF16, filter, maxThreadCount);
+}
+void tiledImage_filterRgbaU8(const TiledImage& image, const TemporaryCallback<void(const ImageRgbaU8 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount) {
+	tiledImage_filter_template<ImageRgbaU8>(image, PixelFormat::RgbaU8, filter, maxThreadCount);
+}
+
+template <typename IMAGE_TYPE>
+static void draw_copy_fromTiles(const IMAGE_TYPE& target, const TiledImage& source, PixelFormat pixelFormat, int32_t left, int32_t top) {
+	if (!image_exists(target) || source.impl_tiles.isNull() || !matchingPixelFormat(source, pixelFormat, U"draw_copy")) {
+		return;
+	}
+	TiledImageImpl &tiles = *(source.impl_tiles.getUnsafe());
+	IVector2D sourceOffset = source.impl_region.upperLeft();
+	// The region of the whole tiled image that is visible within target.
+	IRect region = IRect::cut(source.impl_region, IRect(-left, -top, image_getWidth(target), image_getHeight(target)) + sourceOffset);
+	if (!region.hasArea()) {
+		return;
+	}
+	forEachTile(tiles, region, [&](int32_t tileIndex, const IRect &cut, int32_t tileLeft, int32_t tileTop) {
+		Image tile = tiles.getTile(tileIndex, false, false);
+		IMAGE_TYPE part = IMAGE_TYPE(IMAGE_TYPE(tile.impl_buffer, tile.impl_dimensions), IRect(cut.left() - tileLeft, cut.top() - tileTop, cut.width(), cut.height()));
+		draw_copy(target, part, left + cut.left() - sourceOffset.x, top + cut.top() - sourceOffset.y);
+	});
+}
+void draw_copy(const ImageU8& target, const TiledImage& source, int32_t left, int32_t top) {
+	draw_copy_fromTiles(target, source, PixelFormat::MonoU8, left, top);
+}
+void draw_copy(const ImageU16& target, const TiledImage& source, int32_t left, int32_t top) {
+	draw_copy_fromTiles(target, source, PixelFormat::MonoU16, left, top);
+}
+void draw_copy(const ImageF32& target, const TiledImage& source, int32_t left, int32_t top) {
+	draw_copy_fromTiles(target, source, PixelFormat::MonoF32, left, top);
+}
+void draw_copy(const ImageF16& target, const TiledImage& source, int32_t left, int32_t top) {
+	draw_copy_fromTiles(target, source, PixelFormat::MonoF16, left, top);
+}
+void draw_copy(const ImageRgbaU8& target, const TiledImage& source, int32_t left, int32_t top) {
+	draw_copy_fromTiles(target, source, PixelFormat::RgbaU8, left, top);
+}
+
+template <typename IMAGE_TYPE>
+static void draw_copy_toTiles(const TiledImage& target, const IMAGE_TYPE& source, PixelFormat pixelFormat, int32_t left, int32_t top) {
+	if (target.impl_tiles.isNull() || !image_exists(source) || !matchingPixelFormat(target, pixelFormat, U"draw_copy")) {
+		return;
+	}
+	TiledImageImpl &tiles = *(target.impl_tiles.getUnsafe());
+	IVector2D targetOffset = target.impl_region.upperLeft();
+	// The region of the whole tiled image that is covered by source.
+	IRect region = IRect::cut(target.impl_region, IRect(left, top, image_getWidth(source), image_getHeight(source)) + targetOffset);
+	if (!region.hasArea()) {
+		return;
+	}
+	forEachTile(tiles, region, [&](int32_t tileIndex, const IRect &cut, int32_t tileLeft, int32_t tileTop) {
+		// Tiles that are completely overwritten within the image do not have to be read from the file first.
+		IRect tileInsideImage = IRect::cut(IRect(tileLeft, tileTop, tiles.tileSize, tiles.tileSize), IRect(0, 0, tiles.width, tiles.height));
+		Image tile = tiles.getTile(tileIndex, true, cut == tileInsideImage);
+		IMAGE_TYPE part = IMAGE_TYPE(IMAGE_TYPE(tile.impl_buffer, tile.impl_dimensions), IRect(cut.left() - tileLeft, cut.top() - tileTop, cut.width(), cut.height()));
+		draw_copy(part, source, targetOffset.x + left - cut.left(), targetOffset.y + top - cut.top());
+	});
+}
+void draw_copy(const TiledImage& target, const ImageU8& source, int32_t left, int32_t top) {
+	draw_copy_toTiles(target, source, PixelFormat::MonoU8, left, top);
+}
+void draw_copy(const TiledImage& target, const ImageU16& source, int32_t left, int32_t top) {
+	draw_copy_toTiles(target, source, PixelFormat::MonoU16, left, top);
+}
+void draw_copy(const TiledImage& target, const ImageF32& source, int32_t left, int32_t top) {
+	draw_copy_toTiles(target, source, PixelFormat::MonoF32, left, top);
+}
+void draw_copy(const TiledImage& target, const ImageF16& source, int32_t left, int32_t top) {
+	draw_copy_toTiles(target, source, PixelFormat::MonoF16, left, top);
+}
+void draw_copy(const TiledImage& target, const ImageRgbaU8& source, int32_t left, int32_t top) {
+	draw_copy_toTiles(target, source, PixelFormat::RgbaU8, left, top);
+}
+
+}
@@ -0,0 +1,135 @@
+﻿
+// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+// Tiled images
+//   Images and buffers need one contiguous allocation, which does not work for images that are larger than the available memory.
+//   A tiled image stores its pixels in a file as square tiles of tileSize x tileSize pixels, and keeps the most recently used tiles in memory.
+//   When more than maxCachedTiles are in memory, the least recently used tile that is not referenced from outside of the cache is
+//     written back to the file if modified, and then released.
+//   Tiles are ordinary aligned images, so the rest of the library can be used on each tile by itself.
+//   Tiles that have never been written are read as zeroes, without having to fill the whole file when created.
+//   Values larger than a byte are stored in the local computer's byte order, so tiled image files are meant for local processing, not for distribution.
+//   TiledImage is a value type pointing to a region of the shared tiles, so that sub-images can be taken without copying anything, like with images.
+
+#ifndef DFPSR_API_TILED_IMAGE
+#define DFPSR_API_TILED_IMAGE
+
+#include "imageAPI.h"
+#include "../base/Handle.h"
+#include "../base/TemporaryCallback.h"
+
+namespace dsr {
+
+struct TiledImageImpl;
+
+struct TiledImage {
+// PRIVATE:
+// Use the functions in tiledImageAPI.h instead.
+	// Reference counted pointer to the file and its cached tiles.
+	Handle<TiledImageImpl> impl_tiles;
+	// The visible region in pixel coordinates of the whole tiled image.
+	IRect impl_region;
+	TiledImage() {}
+	TiledImage(const Handle<TiledImageImpl> &tiles, const IRect &region) : impl_tiles(tiles), impl_region(region) {}
+};
+
+// Constructors
+	// Pre-conditions:
+	//   width >= 1 and height >= 1
+	//   1 <= tileSize <= 4096
+	//   maxCachedTiles >= 1
+	// Side-effect: Creates a tiled image file at filename, replacing any existing file.
+	// Post-condition: Returns a tiled image of width x height pixels with all pixels set to zero.
+	//   RgbaU8 pixels are stored in RGBA order.
+	//   If mustWork is true, an exception will be raised on failure.
+	//   If mustWork is false, failure will return an empty handle.
+	TiledImage tiledImage_create(const ReadableString& filename, PixelFormat pixelFormat, int32_t width, int32_t height, int32_t tileSize = 256, int32_t maxCachedTiles = 64, bool mustWork = true);
+	// Pre-condition: maxCachedTiles >= 1
+	// Post-condition: Returns a tiled image from a file created by tiledImage_create.
+	//   If mustExist is true, an exception will be raised on failure.
+	//   If mustExist is false, failure will return an empty handle.
+	TiledImage tiledImage_open(const ReadableString& filename, int32_t maxCachedTiles = 64, bool mustExist = true);
+
+// Properties
+	// Returns false on null, true otherwise.
+	inline bool tiledImage_exists(const TiledImage& image) { return image.impl_tiles.isNotNull(); }
+	// Returns the width of image's region in pixels, or 0 from an empty image.
+	inline int32_t tiledImage_getWidth(const TiledImage& image) { return image.impl_region.width(); }
+	// Returns the height of image's region in pixels, or 0 from an empty image.
+	inline int32_t tiledImage_getHeight(const TiledImage& image) { return image.impl_region.height(); }
+	// Returns IRect(0, 0, width, height) with the dimensions of image's region.
+	inline IRect tiledImage_getBound(const TiledImage& image) { return IRect(0, 0, image.impl_region.width(), image.impl_region.height()); }
+	// Returns the pixel format given when the file was created.
+	PixelFormat tiledImage_getPixelFormat(const TiledImage& image);
+	// Returns the width and height of each tile in pixels.
+	int32_t tiledImage_getTileSize(const TiledImage& image);
+	// Returns the number of tiles currently held in memory, including tiles that are still referenced from outside of the cache.
+	int32_t tiledImage_getCachedTileCount(const TiledImage& image);
+
+// Sub-images
+	// Returns a view to region of image, using the same tiles and file.
+	//   Returns the overlapping region if out of bound.
+	//   Returns an empty image if there are no overlapping pixels.
+	TiledImage tiledImage_getSubImage(const TiledImage& image, const IRect& region);
+
+// Saving
+	// Side-effect: Writes all modified tiles in memory to the file, so that the file is up to date without waiting for the last handle to be released.
+	//   Modified tiles are also written when evicted from the cache and when the last handle is released.
+	//   Failing to write while releasing the last handle can not be reported, because exceptions can not be thrown from destructors,
+	//     so call tiledImage_flush before releasing the image if you need to know that all pixels were saved.
+	//   Raises an exception if a tile could not be written to the file.
+	void tiledImage_flush(const TiledImage& image);
+
+// Tile filters
+	// Side-effect: Calls filter once for each tile overlapping image, with tile clipped to the image's region and marked as modified.
+	//   left and top are the tile's location relative to the upper left corner of image.
+	//   Tiles are processed on up to maxThreadCount threads at the same time, where 0 uses all available threads.
+	//   Each tile is only referenced while its filter is running, so that images much larger than the cache can be processed in a streaming fashion.
+	//   The filter may not keep any handle to the tile after returning, because the cache would then keep it in memory without knowing when it changes.
+	// Pre-condition: The pixel format of image must match the type of tile, or an exception will be raised.
+	void tiledImage_filterU8(const TiledImage& image, const TemporaryCallback<void(const ImageU8 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount = 0);
+	void tiledImage_filterU16(const TiledImage& image, const TemporaryCallback<void(const ImageU16 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount = 0);
+	void tiledImage_filterF32(const TiledImage& image, const TemporaryCallback<void(const ImageF32 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount = 0);
+	void tiledImage_filterF16(const TiledImage& image, const TemporaryCallback<void(const ImageF16 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount = 0);
+	void tiledImage_filterRgbaU8(const TiledImage& image, const TemporaryCallback<void(const ImageRgbaU8 &tile, int32_t left, int32_t top)> &filter, int32_t maxThreadCount = 0);
+
+// Drawing between tiled images and images
+	// Draw source to target with the upper left corner of source at (left, top) in target, without any conversion of pixel formats.
+	//   Only the tiles overlapping the drawn region are loaded.
+	// Pre-condition: The pixel format of the tiled image must match the type of the other image, or an exception will be raised.
+	void draw_copy(const ImageU8& target, const TiledImage& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageU16& target, const TiledImage& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageF32& target, const TiledImage& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageF16& target, const TiledImage& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const ImageRgbaU8& target, const TiledImage& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const TiledImage& target, const ImageU8& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const TiledImage& target, const ImageU16& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const TiledImage& target, const ImageF32& source, int32_t left = 0, int32_t top = 0);
+	void draw_copy(const TiledImage& target, const ImageF16& source, int32_t left = 0, int32_t top = 0);
+	// source may have any pack order, because the tiles are stored in RGBA order and draw_copy converts between pack orders.
+	void draw_copy(const TiledImage& target, const ImageRgbaU8& source, int32_t left = 0, int32_t top = 0);
+
+}
+
+#endif
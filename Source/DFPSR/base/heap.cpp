@@ -319,6 +319,7 @@ namespace dsr {
 	static const int32_t MIN_BIN_COUNT = getBinIndex(heap_getHeapAlignment(), 0);
 
 	static const HeapFlag heapFlag_recycled = 1 << 0;
+	static const HeapFlag heapFlag_external = 1 << 1; // Adopted using heap_adoptExternalMemory instead of being allocated from an arena.
 	struct HeapHeader : public AllocationHeader {
 		// Because nextRecycled and usedSize have mutually exclusive lifetimes, they can share memory location.
 		union {
@@ -335,7 +336,12 @@ namespace dsr {
 		HeapHeader(uintptr_t totalSize)
 		: AllocationHeader(totalSize, false, "Nameless heap allocation") {}
 		inline uintptr_t getAllocationSize() {
-			return getBinSize(this->binIndex);
+			if (this->isExternal()) {
+				// External memory can not grow beyond the padded size that was given when adopting it.
+				return memory_getPaddedSize_usingAndMask(this->usedSize, heap_getHeapAlignmentAndMask());
+			} else {
+				return getBinSize(this->binIndex);
+			}
 		}
 		inline uintptr_t getUsedSize() {
 			if (this->isRecycled()) {
@@ -366,6 +372,9 @@ namespace dsr {
 		inline void makeUsed() {
 			this->flags &= ~heapFlag_recycled;
 		}
+		inline bool isExternal() const {
+			return (this->flags & heapFlag_external) != 0;
+		}
 	};
 
 	// TODO: Allow using the header directly for manipulation in the API, now that the offset is not known in compile time.
@@ -377,6 +386,10 @@ namespace dsr {
 		return heapHeaderPaddedSize;
 	}
 
+	uintptr_t heap_getHeaderSize() {
+		return heap_getHeapHeaderPaddedSize();
+	}
+
 	AllocationHeader *heap_getHeader(void * const allocation) {
 		return (AllocationHeader*)((uint8_t*)allocation - heap_getHeapHeaderPaddedSize());
 	}
@@ -497,7 +510,7 @@ namespace dsr {
 	uintptr_t heap_getAllocationSize(AllocationHeader const * const header) {
 		uintptr_t result = 0;
 		if (header != nullptr) {
-			result = getBinSize(((HeapHeader *)header)->binIndex);
+			result = ((HeapHeader *)header)->getAllocationSize();
 		}
 		return result;
 	}
@@ -506,7 +519,7 @@ namespace dsr {
 		uintptr_t result = 0;
 		if (allocation != nullptr) {
 			HeapHeader *header = headerFromAllocation(allocation);
-			result = getBinSize(header->binIndex);
+			result = header->getAllocationSize();
 		}
 		return result;
 	}
@@ -751,6 +764,18 @@ namespace dsr {
 		return result;
 	}
 
+	UnsafeAllocation heap_adoptExternalMemory(void * const data, uintptr_t size, const HeapDestructor &destructor) {
+		HeapHeader *header = headerFromAllocation(data);
+		*header = HeapHeader(heap_getHeapHeaderPaddedSize() + memory_getPaddedSize_usingAndMask(size, heap_getHeapAlignmentAndMask()));
+		header->flags = heapFlag_external;
+		header->usedSize = size;
+		header->destructor = destructor;
+		lockMemory();
+			allocationCount++;
+		unlockMemory();
+		return UnsafeAllocation((uint8_t*)data, header);
+	}
+
 	void heap_setAllocationDestructor(void * const allocation, const HeapDestructor &destructor) {
 		HeapHeader *header = headerFromAllocation(allocation);		
 		header->destructor = destructor;
@@ -762,6 +787,12 @@ namespace dsr {
 			HeapHeader *header = headerFromAllocation(allocation);
 			if (header->isRecycled()) {
 				printf("Heap error: A heap allocation was freed twice!\n");
+			} else if (header->isExternal()) {
+				// The destructor returns the memory to its owner, so the header can not be accessed after calling it.
+				HeapDestructor destructor = header->destructor;
+				if (destructor.destructor) {
+					destructor.destructor(allocation, destructor.externalResource);
+				}
 			} else {
 				// Call the destructor provided with any external resource that also needs to be freed.
 				if (header->destructor.destructor) {
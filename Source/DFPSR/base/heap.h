@@ -127,6 +127,16 @@ namespace dsr {
 	//   externalResource is the second argument that will be given to destructor together with the freed memory to destruct.
 	void heap_setAllocationDestructor(void * const allocation, const HeapDestructor &destructor);
 
+	// Let the heap reference count memory that is owned by something else, such as the pages of a memory mapped file.
+	//   The allocation header is written to the heap_getHeaderSize() bytes in front of data, which must be writable.
+	//   The destructor is responsible for returning both data and the header to their owner when the use count reaches zero,
+	//   so replacing the destructor of an adopted allocation will leak the memory.
+	// Pre-condition:
+	//   data is aligned to heap_getHeapAlignment().
+	//   size bytes rounded up to whole blocks of heap_getHeapAlignment() can be read and written, for the padding accessed with SafePointer.
+	// Post-condition: Returns pointers to the payload and header, with a use count of zero like heap_allocate.
+	UnsafeAllocation heap_adoptExternalMemory(void * const data, uintptr_t size, const HeapDestructor &destructor);
+
 	// Get the use count outside of transactions without locking.
 	uintptr_t heap_getUseCount(void const * const allocation);
 	uintptr_t heap_getUseCount(AllocationHeader const * const header);
@@ -141,6 +151,9 @@ namespace dsr {
 	// Get the alignment of the heap, which depends on the largest cache line size.
 	uintptr_t heap_getHeapAlignment();
 
+	// Get the number of bytes in front of each allocation's payload that are used by its header, padded to the heap's alignment.
+	uintptr_t heap_getHeaderSize();
+
 	// Pre-condition: The allocation pointer must point to the start of a payload allocated using heap_allocate, no offsets nor other allocators allowed.
 	// Post-condition: Returns a pointer to the heap allocation's header, which is used to construct safe pointers.
 	AllocationHeader *heap_getHeader(void * const allocation);
@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <cmath>
+#include <cstring>
 #include "SafePointer.h"
 #include "DsrTraits.h"
 #include <limits>
@@ -60,6 +61,58 @@ namespace dsr {
 	inline int32_t I32FromU32(uint32_t value) { return (int32_t)value; }
 	inline uint32_t U32FromI32(int32_t value) { return (uint32_t)value; }
 
+	// Half precision floats are stored as uint16_t with 1 sign bit, 5 exponent bits and 10 mantissa bits.
+	//   The vectorized versions in simd.h use F16C on Intel/AMD and native conversion on ARM.
+	// Post-condition: Returns the half precision float in value converted exactly into a 32-bit float.
+	inline float floatFromF16(uint16_t value) {
+		uint32_t sign = uint32_t(value & 0x8000u) << 16;
+		uint32_t exponent = (value >> 10) & 0x1fu;
+		uint32_t mantissa = value & 0x3ffu;
+		uint32_t bits;
+		if (exponent == 0u) {
+			// Zero or subnormal, scaled by the smallest subnormal 2⁻²⁴.
+			float magnitude = float(mantissa) * (1.0f / 16777216.0f);
+			std::memcpy(&bits, &magnitude, sizeof(float));
+			bits |= sign;
+		} else if (exponent == 31u) {
+			// Infinity or NaN.
+			bits = sign | 0x7f800000u | (mantissa << 13);
+		} else {
+			// Normal numbers only need the exponent bias changed from 15 to 127.
+			bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+		}
+		float result;
+		std::memcpy(&result, &bits, sizeof(float));
+		return result;
+	}
+	// Post-condition: Returns value rounded to the nearest half precision float, with ties to even.
+	//   Values too large to be represented become infinity and NaN remains NaN.
+	inline uint16_t roundToF16(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(float));
+		uint32_t sign = (bits >> 16) & 0x8000u;
+		uint32_t absBits = bits & 0x7fffffffu;
+		if (absBits >= 0x7f800000u) {
+			// Infinity or NaN.
+			return uint16_t(sign | 0x7c00u | (absBits > 0x7f800000u ? 0x200u : 0u));
+		} else if (absBits >= 0x477ff000u) {
+			// Rounds up to infinity from 65520 and above.
+			return uint16_t(sign | 0x7c00u);
+		} else if (absBits < 0x38800000u) {
+			// Below the smallest normal 2⁻¹⁴, so let the float addition round away the bits below 2⁻²⁴.
+			float magnitude;
+			std::memcpy(&magnitude, &absBits, sizeof(float));
+			magnitude += 0.5f;
+			uint32_t magnitudeBits;
+			std::memcpy(&magnitudeBits, &magnitude, sizeof(float));
+			return uint16_t(sign | (magnitudeBits - 0x3f000000u));
+		} else {
+			// Change the exponent bias from 127 to 15 and round the 13 truncated mantissa bits to even.
+			absBits += 0xc8000fffu + ((absBits >> 13) & 1u);
+			return uint16_t(sign | (absBits >> 13));
+		}
+	}
+
 	// Memory read operations.
 	inline uint32_t gather_U32(dsr::SafePointer<const uint32_t> data, const uint32_t &elementOffset) { return data[elementOffset]; }
 	inline int32_t gather_I32(dsr::SafePointer<const int32_t> data, const uint32_t &elementOffset) { return data[elementOffset]; }
@@ -112,8 +112,8 @@
 		#ifdef USE_SSSE3
 			#include <tmmintrin.h> // SSSE3
 		#endif
-		#ifdef USE_AVX
-			#include <immintrin.h> // AVX / AVX2
+		#if defined(USE_AVX) || defined(USE_F16C)
+			#include <immintrin.h> // AVX / AVX2 / F16C
 		#endif
 	#endif
 	#ifdef USE_NEON
@@ -163,6 +163,8 @@
 		#define U8_HIGH_TO_U16_SIMD(A) _mm_unpackhi_epi8(A, _mm_set1_epi8(0))
 		#define U16_LOW_TO_U32_SIMD(A) _mm_unpacklo_epi16(A, _mm_set1_epi16(0))
 		#define U16_HIGH_TO_U32_SIMD(A) _mm_unpackhi_epi16(A, _mm_set1_epi16(0))
+		// Packing conversions
+		#define U16_TRUNCATE_TO_U8_SIMD(A, B) _mm_packus_epi16(_mm_and_si128(A, _mm_set1_epi16(0x00FF)), _mm_and_si128(B, _mm_set1_epi16(0x00FF)))
 
 		// Reinterpret casting
 		#define REINTERPRET_U32_TO_U8_SIMD(A) (A)
@@ -243,6 +245,9 @@
 				#define U16_LOW_TO_U32_SIMD256(A) _mm256_unpacklo_epi16(_mm256_permute4x64_epi64(A, 0b11011000), _mm256_set1_epi16(0))
 				#define U16_HIGH_TO_U32_SIMD256(A) _mm256_unpackhi_epi16(_mm256_permute4x64_epi64(A, 0b11011000), _mm256_set1_epi16(0))
 
+				// Packing conversions
+				#define U16_TRUNCATE_TO_U8_SIMD256(A, B) _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(A, _mm256_set1_epi16(0x00FF)), _mm256_and_si256(B, _mm256_set1_epi16(0x00FF))), 0b11011000)
+
 				// Reinterpret casting
 				#define REINTERPRET_U32_TO_U8_SIMD256(A) (A)
 				#define REINTERPRET_U32_TO_U16_SIMD256(A) (A)
@@ -355,6 +360,8 @@
 		#define U8_HIGH_TO_U16_SIMD(A) vmovl_u8(vget_high_u8(A))
 		#define U16_LOW_TO_U32_SIMD(A) vmovl_u16(vget_low_u16(A))
 		#define U16_HIGH_TO_U32_SIMD(A) vmovl_u16(vget_high_u16(A))
+		// Packing conversions
+		#define U16_TRUNCATE_TO_U8_SIMD(A, B) vcombine_u8(vmovn_u16(A), vmovn_u16(B))
 
 		// Reinterpret casting
 		#define REINTERPRET_U32_TO_U8_SIMD(A) vreinterpretq_u8_u32(A)
@@ -2836,6 +2843,94 @@
 		#endif
 	}
 
+	// Packing to smaller integers
+	// Returns the lowest 8 bits from each element in lower followed by the lowest 8 bits from each element in upper.
+	//   The inverse of lowerToU16 and higherToU16 when all values are within 0..255.
+	inline U8x16 truncateToU8(const U16x8& lower, const U16x8& upper) {
+		#if defined(USE_BASIC_SIMD)
+			return U8x16(U16_TRUNCATE_TO_U8_SIMD(lower.v, upper.v));
+		#else
+			return U8x16(
+			  uint8_t(lower.scalars[0]), uint8_t(lower.scalars[1]), uint8_t(lower.scalars[2]), uint8_t(lower.scalars[3]),
+			  uint8_t(lower.scalars[4]), uint8_t(lower.scalars[5]), uint8_t(lower.scalars[6]), uint8_t(lower.scalars[7]),
+			  uint8_t(upper.scalars[0]), uint8_t(upper.scalars[1]), uint8_t(upper.scalars[2]), uint8_t(upper.scalars[3]),
+			  uint8_t(upper.scalars[4]), uint8_t(upper.scalars[5]), uint8_t(upper.scalars[6]), uint8_t(upper.scalars[7])
+			);
+		#endif
+	}
+
+	// Shuffling bytes
+	// Returns a vector where each lane i contains the lane of source selected by indices[i].
+	// Pre-condition: All indices are within 0..15.
+	//   Used for reordering channels of packed pixels, such as converting between pack orders.
+	//   Uses a single instruction with SSSE3 or NEON, and is emulated using memory on SSE2.
+	inline U8x16 shuffleBytes(const U8x16& source, const U8x16& indices) {
+		#if defined(USE_SSSE3)
+			return U8x16(_mm_shuffle_epi8(source.v, indices.v));
+		#elif defined(USE_NEON) && defined(__aarch64__)
+			return U8x16(vqtbl1q_u8(source.v, indices.v));
+		#elif defined(USE_NEON)
+			uint8x8x2_t table = {{vget_low_u8(source.v), vget_high_u8(source.v)}};
+			return U8x16(vcombine_u8(vtbl2_u8(table, vget_low_u8(indices.v)), vtbl2_u8(table, vget_high_u8(indices.v))));
+		#else
+			ALIGN16 uint8_t sourceBytes[16];
+			ALIGN16 uint8_t indexBytes[16];
+			ALIGN16 uint8_t resultBytes[16];
+			source.writeAlignedUnsafe(sourceBytes);
+			indices.writeAlignedUnsafe(indexBytes);
+			for (int32_t i = 0; i < 16; i++) {
+				resultBytes[i] = sourceBytes[indexBytes[i] & 15u];
+			}
+			return U8x16::readAlignedUnsafe(resultBytes);
+		#endif
+	}
+
+	// Half precision floats
+	//   Stored as uint16_t lanes with the same bits as in the scalar floatFromF16 and roundToF16 from noSimd.h.
+	//   Uses F16C on Intel/AMD and native conversion on 64-bit ARM, with one scalar conversion per lane as a fallback.
+	// Returns the first four half precision floats in vector converted into 32-bit floats.
+	inline F32x4 lowerFloatFromF16(const U16x8& vector) {
+		#if defined(USE_F16C)
+			return F32x4(_mm_cvtph_ps(vector.v));
+		#elif defined(USE_NEON) && defined(__aarch64__)
+			return F32x4(vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(vector.v))));
+		#else
+			ALIGN16 uint16_t halves[8];
+			vector.writeAlignedUnsafe(halves);
+			return F32x4(floatFromF16(halves[0]), floatFromF16(halves[1]), floatFromF16(halves[2]), floatFromF16(halves[3]));
+		#endif
+	}
+	// Returns the last four half precision floats in vector converted into 32-bit floats.
+	inline F32x4 higherFloatFromF16(const U16x8& vector) {
+		#if defined(USE_F16C)
+			return F32x4(_mm_cvtph_ps(_mm_unpackhi_epi64(vector.v, vector.v)));
+		#elif defined(USE_NEON) && defined(__aarch64__)
+			return F32x4(vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(vector.v))));
+		#else
+			ALIGN16 uint16_t halves[8];
+			vector.writeAlignedUnsafe(halves);
+			return F32x4(floatFromF16(halves[4]), floatFromF16(halves[5]), floatFromF16(halves[6]), floatFromF16(halves[7]));
+		#endif
+	}
+	// Returns lower followed by upper rounded to the nearest half precision floats, with ties to even.
+	//   The inverse of lowerFloatFromF16 and higherFloatFromF16 when all values can be represented exactly.
+	inline U16x8 roundToF16(const F32x4& lower, const F32x4& upper) {
+		#if defined(USE_F16C)
+			return U16x8(_mm_unpacklo_epi64(_mm_cvtps_ph(lower.v, _MM_FROUND_TO_NEAREST_INT), _mm_cvtps_ph(upper.v, _MM_FROUND_TO_NEAREST_INT)));
+		#elif defined(USE_NEON) && defined(__aarch64__)
+			return U16x8(vcombine_u16(vreinterpret_u16_f16(vcvt_f16_f32(lower.v)), vreinterpret_u16_f16(vcvt_f16_f32(upper.v))));
+		#else
+			ALIGN16 float lowerFloats[4];
+			ALIGN16 float upperFloats[4];
+			lower.writeAlignedUnsafe(lowerFloats);
+			upper.writeAlignedUnsafe(upperFloats);
+			return U16x8(
+			  roundToF16(lowerFloats[0]), roundToF16(lowerFloats[1]), roundToF16(lowerFloats[2]), roundToF16(lowerFloats[3]),
+			  roundToF16(upperFloats[0]), roundToF16(upperFloats[1]), roundToF16(upperFloats[2]), roundToF16(upperFloats[3])
+			);
+		#endif
+	}
+
 	// Unary negation for convenience and code readability.
 	//   Before using unary negation, always check if:
 	//    * An addition can be turned into a subtraction?
@@ -3692,6 +3787,90 @@
 		#endif
 	}
 
+	// Packing to smaller integers
+	// Returns the lowest 8 bits from each element in lower followed by the lowest 8 bits from each element in upper.
+	//   The inverse of lowerToU16 and higherToU16 when all values are within 0..255.
+	inline U8x32 truncateToU8(const U16x16& lower, const U16x16& upper) {
+		#if defined(USE_256BIT_X_SIMD)
+			return U8x32(U16_TRUNCATE_TO_U8_SIMD256(lower.v, upper.v));
+		#else
+			U8x32 result = U8x32::create_dangerous_uninitialized();
+			for (int32_t i = 0; i < 16; i++) {
+				result.scalars[i] = uint8_t(lower.scalars[i]);
+				result.scalars[i + 16] = uint8_t(upper.scalars[i]);
+			}
+			return result;
+		#endif
+	}
+
+	// Shuffling bytes
+	// Returns a vector where each lane i contains a lane selected by indices[i] from the same 16-byte half of source.
+	// Pre-condition: All indices are within 0..15, because lanes can not be moved between the halves.
+	//   Used for reordering channels of packed pixels, where the same 16 indices are repeated in both halves.
+	//   Uses a single instruction with AVX2.
+	inline U8x32 shuffleBytes(const U8x32& source, const U8x32& indices) {
+		#if defined(USE_AVX2)
+			return U8x32(_mm256_shuffle_epi8(source.v, indices.v));
+		#else
+			ALIGN32 uint8_t sourceBytes[32];
+			ALIGN32 uint8_t indexBytes[32];
+			ALIGN32 uint8_t resultBytes[32];
+			source.writeAlignedUnsafe(sourceBytes);
+			indices.writeAlignedUnsafe(indexBytes);
+			for (int32_t i = 0; i < 32; i++) {
+				resultBytes[i] = sourceBytes[(i & 16) | (indexBytes[i] & 15u)];
+			}
+			return U8x32::readAlignedUnsafe(resultBytes);
+		#endif
+	}
+
+	// Half precision floats
+	// Returns the first eight half precision floats in vector converted into 32-bit floats.
+	inline F32x8 lowerFloatFromF16(const U16x16& vector) {
+		#if defined(USE_AVX2) && defined(USE_F16C)
+			return F32x8(_mm256_cvtph_ps(_mm256_castsi256_si128(vector.v)));
+		#else
+			ALIGN32 uint16_t halves[16];
+			ALIGN32 float result[8];
+			vector.writeAlignedUnsafe(halves);
+			for (int32_t i = 0; i < 8; i++) {
+				result[i] = floatFromF16(halves[i]);
+			}
+			return F32x8::readAlignedUnsafe(result);
+		#endif
+	}
+	// Returns the last eight half precision floats in vector converted into 32-bit floats.
+	inline F32x8 higherFloatFromF16(const U16x16& vector) {
+		#if defined(USE_AVX2) && defined(USE_F16C)
+			return F32x8(_mm256_cvtph_ps(_mm256_extracti128_si256(vector.v, 1)));
+		#else
+			ALIGN32 uint16_t halves[16];
+			ALIGN32 float result[8];
+			vector.writeAlignedUnsafe(halves);
+			for (int32_t i = 0; i < 8; i++) {
+				result[i] = floatFromF16(halves[i + 8]);
+			}
+			return F32x8::readAlignedUnsafe(result);
+		#endif
+	}
+	// Returns lower followed by upper rounded to the nearest half precision floats, with ties to even.
+	inline U16x16 roundToF16(const F32x8& lower, const F32x8& upper) {
+		#if defined(USE_AVX2) && defined(USE_F16C)
+			return U16x16(_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvtps_ph(lower.v, _MM_FROUND_TO_NEAREST_INT)), _mm256_cvtps_ph(upper.v, _MM_FROUND_TO_NEAREST_INT), 1));
+		#else
+			ALIGN32 float lowerFloats[8];
+			ALIGN32 float upperFloats[8];
+			ALIGN32 uint16_t result[16];
+			lower.writeAlignedUnsafe(lowerFloats);
+			upper.writeAlignedUnsafe(upperFloats);
+			for (int32_t i = 0; i < 8; i++) {
+				result[i] = roundToF16(lowerFloats[i]);
+				result[i + 8] = roundToF16(upperFloats[i]);
+			}
+			return U16x16::readAlignedUnsafe(result);
+		#endif
+	}
+
 	// Unary negation for convenience and code readability.
 	//   Before using unary negation, always check if:
 	//    * An addition can be turned into a subtraction?
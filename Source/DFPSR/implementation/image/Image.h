@@ -36,15 +36,18 @@ enum class ImageFileFormat {
 	JPG, // Lossy compressed image format storing brightness separated from red and blue offsets using the discrete cosine transform of each block.
 	PNG, // Lossless compressed image format. Some image editors don't save RGB values where alpha is zero, which will bleed through black edges in bi-linear interpolation when the interpolated alpha is not zero.
 	TGA, // Lossless compressed format. Applications usually give Targa better control over the alpha channel than PNG, but it's more common that the Targa specification is interpreted in incompatible ways.
-	BMP // Uncompressed image format for storing data that does not really represent an image and you just want it to be exact.
+	BMP, // Uncompressed image format for storing data that does not really represent an image and you just want it to be exact.
+	QOI // Lossless compressed image format that is fast to encode and decode, for intermediate assets and cached conversions. Encoded in strips that can be decoded on multiple threads.
 };
 
-// Packed into 2 bits in ImageDimensions.
+// Packed into 3 bits in ImageDimensions.
+//   New formats are added at the end, because the index is also stored in raw image files.
 enum class PixelFormat : uint32_t {
 	MonoU8, // Gray-scale image of 8 bits per pixel (0..255).
 	MonoU16,
 	MonoF32,
-	RgbaU8 // RGBA colors in any order. 8 bits per channel (0..255). 32 bits per pixel.
+	RgbaU8, // RGBA colors in any order. 8 bits per channel (0..255). 32 bits per pixel.
+	MonoF16 // Half precision floats stored as uint16_t, for high dynamic range buffers that do not need the precision of MonoF32.
 };
 
 // Start offset and stride is stored in pixels and the getters in imageAPI can automatically convert them into byte offsets as needed.
@@ -70,10 +73,11 @@ private:
 	static const uint64_t  readMask_packOrder     = 0b0000000000000000000000000000000000000000000000000001100000000000; // 51 zeroes,  2 ones, 11 zeroes
 	static const uint32_t  inputMask_packOrder    =                                                    0b11           ; //             2 ones
 	static const int       bitOffset_packOrder    =                                                        11         ;
-	static const uint64_t  readMask_format        = 0b0000000000000000000000000000000000000000000000000000011000000000; // 52 zeroes,  2 ones,  9 zeroes
-	static const uint32_t  inputMask_format       =                                                      0b11         ; //             2 ones
-	static const int       bitOffset_format       =                                                          9        ;
-	static const uint64_t  readMask_subImage      = 0b0000000000000000000000000000000000000000000000000000000100000000; // 55 zeroes,  1 ones,  8 zeroes
+	static const uint64_t  readMask_format        = 0b0000000000000000000000000000000000000000000000000000011100000000; // 53 zeroes,  3 ones,  8 zeroes
+	static const uint32_t  inputMask_format       =                                                      0b111        ; //             3 ones
+	static const int       bitOffset_format       =                                                          8        ;
+	static const uint64_t  readMask_subImage      = 0b0000000000000000000000000000000000000000000000000000000010000000; // 56 zeroes,  1 ones,  7 zeroes
+	static const uint64_t  readMask_premultiplied = 0b0000000000000000000000000000000000000000000000000000000001000000; // 57 zeroes,  1 ones,  6 zeroes
 private:
 	// Actual members.
 	uint64_t data = 0;
@@ -104,6 +108,10 @@ public:
 		// No need to shift the bit before normalizing, because anything else than zero becomes 1.
 		return (this->data & readMask_subImage) != 0;
 	}
+	// Returns true iff the color channels have already been multiplied by alpha.
+	inline bool isPremultiplied() const {
+		return (this->data & readMask_premultiplied) != 0;
+	}
 	inline uint32_t getLog2PixelSize() const {
 		// Shift the constants instead of the index to save a cycle.
 		uint64_t shifterPixelFormatIndex = this->data & readMask_format;
@@ -115,6 +123,8 @@ public:
 			return 2;
 		} else if (shifterPixelFormatIndex == ((uint64_t)PixelFormat::RgbaU8  << bitOffset_format)) {
 			return 2;
+		} else if (shifterPixelFormatIndex == ((uint64_t)PixelFormat::MonoF16 << bitOffset_format)) {
+			return 1;
 		} else {
 			return 0; // Unknown pixel format!
 		}
@@ -130,6 +140,8 @@ public:
 			return 4;
 		} else if (shifterPixelFormatIndex == ((uint64_t)PixelFormat::RgbaU8  << bitOffset_format)) {
 			return 4;
+		} else if (shifterPixelFormatIndex == ((uint64_t)PixelFormat::MonoF16 << bitOffset_format)) {
+			return 2;
 		} else {
 			return 0; // Unknown pixel format!
 		}
@@ -159,6 +171,9 @@ public:
 				   | readMask_subImage;
 		this->pixelStartOffset = pixelStartOffset;
 	}
+	void setPremultiplied(bool premultiplied) {
+		this->data = premultiplied ? (this->data | readMask_premultiplied) : (this->data & ~readMask_premultiplied);
+	}
 };
 
 #define IMPL_IMAGE_CONSTRUCTORS(NEW_TYPE, BASE_TYPE) \
@@ -261,6 +276,24 @@ struct AlignedImageF32
 	IMPL_IMAGE_HIGHER_CONSTRUCTORS(AlignedImageF32, ImageF32)
 };
 
+// Can be unaligned.
+//   Is not allowed to overwrite padding bytes, because it does not know the difference between padding and pixels belonging to a larger image sharing the same pixel buffer.
+// Each pixel is a half precision float stored as uint16_t, using floatFromF16 and roundToF16 to convert from and to float.
+struct ImageF16
+: public Image {
+	static const int impl_pixelSize = 2;
+	ImageF16(const Buffer &buffer, uint32_t pixelStartOffset, uint32_t width, uint32_t height, uint32_t pixelStride, const PackOrderIndex &packOrderIndex)
+	: Image(buffer, ImageDimensions(width, height, pixelStride, packOrderIndex, PixelFormat::MonoF16, pixelStartOffset)) {}
+	IMPL_IMAGE_CONSTRUCTORS(ImageF16, Image)
+};
+
+// The start of each row is aligned to DSR_MAXIMUM_ALIGNMENT for SIMD vectorization and thread safety.
+//   Owns the padding bytes and may overwrite them during SIMD vectorization.
+struct AlignedImageF16
+: public ImageF16 {
+	IMPL_IMAGE_HIGHER_CONSTRUCTORS(AlignedImageF16, ImageF16)
+};
+
 // Can be unaligned.
 //   Is not allowed to overwrite padding bytes, because it does not know the difference between padding and pixels belonging to a larger image sharing the same pixel buffer.
 // Can have any pack order.
@@ -0,0 +1,74 @@
+﻿// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+// 
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// 
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+// Internal helpers for processing a whole SIMD vector of RgbaU8 pixels at a time, shared between the drawing and filtering APIs.
+
+#ifndef DFPSR_IMAGE_PIXEL_VECTORS
+#define DFPSR_IMAGE_PIXEL_VECTORS
+
+#include <cstdint>
+#include <cstring>
+#include "../../base/simd.h"
+#include "../../base/SafePointer.h"
+
+namespace dsr {
+
+// Rounds a * b / 255 to the closest integer for each 16-bit lane, without exceeding 16 bits.
+//   With t = a * b + 128, (t + (t >> 8)) >> 8 gives the same result as dividing by 255 with rounding for all byte inputs.
+inline U16xX normalizedByteMultiplication(const U16xX &a, const U16xX &b) {
+	U16xX t = a * b + U16xX(uint16_t(128));
+	return bitShiftRightImmediate<8>(t + bitShiftRightImmediate<8>(t));
+}
+
+// Reading and writing a whole SIMD vector of pixels from rows that may not be aligned.
+inline U32xX readPixels(const uint8_t *data) {
+	ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint32_t lanes[laneCountX_32Bit];
+	std::memcpy(lanes, data, sizeof(lanes));
+	return U32xX::readAlignedUnsafe(lanes);
+}
+inline void writePixels(uint8_t *data, const U32xX &pixels) {
+	ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint32_t lanes[laneCountX_32Bit];
+	pixels.writeAlignedUnsafe(lanes);
+	std::memcpy(data, lanes, sizeof(lanes));
+}
+
+// Reading and writing the first laneCount pixels of a SIMD vector, for the end of rows that are not padded.
+//   Lanes outside of laneCount are read as zero and are not written.
+inline U32xX readPixels(SafePointer<const uint32_t> data, int32_t laneCount) {
+	ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint32_t lanes[laneCountX_32Bit];
+	for (int32_t l = 0; l < laneCountX_32Bit; l++) {
+		lanes[l] = l < laneCount ? data[l] : 0u;
+	}
+	return U32xX::readAlignedUnsafe(lanes);
+}
+inline void writePixels(SafePointer<uint32_t> data, const U32xX &pixels, int32_t laneCount) {
+	ALIGN_BYTES(DSR_DEFAULT_ALIGNMENT) uint32_t lanes[laneCountX_32Bit];
+	pixels.writeAlignedUnsafe(lanes);
+	for (int32_t l = 0; l < laneCount; l++) {
+		data[l] = lanes[l];
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,360 @@
+﻿
+// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+#define DSR_INTERNAL_ACCESS
+
+#include "qoiImage.h"
+#include "../../../api/imageAPI.h"
+#include "../../../base/simd.h"
+#include "../../../base/threading.h"
+#include <cstring>
+
+namespace dsr {
+
+static const int32_t headerSize = 14;
+static const int32_t endMarkerSize = 8;
+static const uint8_t endMarker[endMarkerSize] = {0, 0, 0, 0, 0, 0, 0, 1};
+// The strip table is identified by a tag at the end of the file.
+static const uint8_t stripTag[4] = {'D', 'S', 'R', 'S'};
+// The number of pixels to encode in each strip, rounded down to whole rows.
+static const int32_t stripPixelCount = 65536;
+// Each chunk can at most repeat the previous color 62 times.
+static const int32_t maxRunLength = 62;
+
+static const uint8_t QOI_OP_INDEX = 0x00; // 00iiiiii
+static const uint8_t QOI_OP_DIFF  = 0x40; // 01rrggbb
+static const uint8_t QOI_OP_LUMA  = 0x80; // 10gggggg rrrrbbbb
+static const uint8_t QOI_OP_RUN   = 0xC0; // 11llllll
+static const uint8_t QOI_OP_RGB   = 0xFE; // 11111110 r g b
+static const uint8_t QOI_OP_RGBA  = 0xFF; // 11111111 r g b a
+static const uint8_t QOI_MASK_2   = 0xC0;
+
+static inline uint32_t getHash(const uint8_t *color) {
+	return (color[0] * 3 + color[1] * 5 + color[2] * 7 + color[3] * 11) & 63;
+}
+
+static inline uint32_t readBigEndian(const uint8_t *source) {
+	return (uint32_t(source[0]) << 24) | (uint32_t(source[1]) << 16) | (uint32_t(source[2]) << 8) | uint32_t(source[3]);
+}
+
+static inline void writeBigEndian(uint8_t *target, uint32_t value) {
+	target[0] = uint8_t(value >> 24);
+	target[1] = uint8_t(value >> 16);
+	target[2] = uint8_t(value >> 8);
+	target[3] = uint8_t(value);
+}
+
+static void encodeRun(List<uint8_t> &target, int32_t &run) {
+	while (run > 0) {
+		int32_t length = run < maxRunLength ? run : maxRunLength;
+		target.push(QOI_OP_RUN | uint8_t(length - 1));
+		run -= length;
+	}
+}
+
+// Encodes rows startY..stopY-1 without depending on any colors from other strips.
+static void encodeStrip(List<uint8_t> &target, const uint8_t *data, int32_t stride, int32_t width, int32_t startY, int32_t stopY) {
+	uint32_t index[64];
+	// One bit for each index that has been assigned within the strip, because the decoder can not know the colors from previous strips.
+	uint64_t assignedIndices = 0;
+	uint32_t previous = 0;
+	bool first = true;
+	int32_t run = 0;
+	for (int32_t y = startY; y < stopY; y++) {
+		const uint32_t *row = (const uint32_t*)(data + intptr_t(y) * stride);
+		int32_t x = 0;
+		while (x < width) {
+			uint32_t pixel = row[x];
+			if (pixel == previous && !first) {
+				run++;
+				x++;
+				// Large areas of the same color are common in sprite atlases, so whole SIMD vectors are compared while the address is aligned.
+				if ((uintptr_t(row + x) & uintptr_t(laneCountX_32Bit * sizeof(uint32_t) - 1)) == 0) {
+					U32xX repeated = U32xX(previous);
+					while (x + laneCountX_32Bit <= width && allLanesEqual(U32xX::readAlignedUnsafe(row + x), repeated)) {
+						run += laneCountX_32Bit;
+						x += laneCountX_32Bit;
+					}
+				}
+			} else {
+				encodeRun(target, run);
+				const uint8_t *color = (const uint8_t*)(row + x);
+				const uint8_t *previousColor = (const uint8_t*)&previous;
+				uint32_t hash = getHash(color);
+				if (((assignedIndices >> hash) & 1u) && index[hash] == pixel) {
+					target.push(QOI_OP_INDEX | uint8_t(hash));
+				} else {
+					index[hash] = pixel;
+					assignedIndices |= uint64_t(1) << hash;
+					// The first pixel in each strip is stored as a whole color, so that it does not depend on the previous strip.
+					if (!first && color[3] == previousColor[3]) {
+						int32_t dr = int8_t(color[0] - previousColor[0]);
+						int32_t dg = int8_t(color[1] - previousColor[1]);
+						int32_t db = int8_t(color[2] - previousColor[2]);
+						int32_t dr_dg = dr - dg;
+						int32_t db_dg = db - dg;
+						if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+							target.push(QOI_OP_DIFF | uint8_t((dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+						} else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+							target.push(QOI_OP_LUMA | uint8_t(dg + 32));
+							target.push(uint8_t((dr_dg + 8) << 4 | (db_dg + 8)));
+						} else {
+							target.push(QOI_OP_RGB);
+							target.push(color[0]);
+							target.push(color[1]);
+							target.push(color[2]);
+						}
+					} else {
+						target.push(QOI_OP_RGBA);
+						target.push(color[0]);
+						target.push(color[1]);
+						target.push(color[2]);
+						target.push(color[3]);
+					}
+				}
+				previous = pixel;
+				first = false;
+				x++;
+			}
+		}
+	}
+	// Runs may not continue into the next strip.
+	encodeRun(target, run);
+}
+
+// Decodes rowCount rows of width pixels from source to target, starting from the initial state of a QOI decoder.
+// Post-condition: Returns true on success, or false if the data ended too early or had runs going outside of the strip.
+static bool decodeStrip(const uint8_t *source, const uint8_t *sourceEnd, uint8_t *target, int32_t stride, int32_t width, int32_t rowCount) {
+	uint8_t index[64][4] = {};
+	uint8_t color[4] = {0, 0, 0, 255};
+	int64_t remainingPixels = int64_t(width) * int64_t(rowCount);
+	uint32_t *row = (uint32_t*)target;
+	int32_t x = 0;
+	while (remainingPixels > 0) {
+		if (source >= sourceEnd) {
+			return false;
+		}
+		uint8_t code = *source++;
+		int32_t repeat = 1;
+		if (code == QOI_OP_RGB) {
+			if (sourceEnd - source < 3) {
+				return false;
+			}
+			color[0] = source[0];
+			color[1] = source[1];
+			color[2] = source[2];
+			source += 3;
+		} else if (code == QOI_OP_RGBA) {
+			if (sourceEnd - source < 4) {
+				return false;
+			}
+			memcpy(color, source, 4);
+			source += 4;
+		} else {
+			uint8_t tag = code & QOI_MASK_2;
+			if (tag == QOI_OP_INDEX) {
+				memcpy(color, index[code], 4);
+			} else if (tag == QOI_OP_DIFF) {
+				color[0] = uint8_t(color[0] + ((code >> 4) & 3) - 2);
+				color[1] = uint8_t(color[1] + ((code >> 2) & 3) - 2);
+				color[2] = uint8_t(color[2] + (code & 3) - 2);
+			} else if (tag == QOI_OP_LUMA) {
+				if (source >= sourceEnd) {
+					return false;
+				}
+				uint8_t second = *source++;
+				int32_t dg = int32_t(code & 63) - 32;
+				color[0] = uint8_t(color[0] + dg - 8 + (second >> 4));
+				color[1] = uint8_t(color[1] + dg);
+				color[2] = uint8_t(color[2] + dg - 8 + (second & 15));
+			} else {
+				repeat = (code & 63) + 1;
+				if (repeat > remainingPixels) {
+					return false;
+				}
+			}
+		}
+		memcpy(index[getHash(color)], color, 4);
+		uint32_t packed;
+		memcpy(&packed, color, 4);
+		remainingPixels -= repeat;
+		for (int32_t i = 0; i < repeat; i++) {
+			row[x] = packed;
+			x++;
+			if (x >= width) {
+				x = 0;
+				row = (uint32_t*)((uint8_t*)row + stride);
+			}
+		}
+	}
+	return true;
+}
+
+bool image_qoi_isEncoded(SafePointer<const uint8_t> data, int32_t size) {
+	return data.isNotNull() && size >= headerSize && data[0] == 'q' && data[1] == 'o' && data[2] == 'i' && data[3] == 'f';
+}
+
+OrderedImageRgbaU8 image_qoi_decode_RgbaU8(SafePointer<const uint8_t> data, int32_t size, int32_t maxThreadCount) {
+	if (!image_qoi_isEncoded(data, size)) {
+		return OrderedImageRgbaU8(); // Return null
+	}
+	#ifdef SAFE_POINTER_CHECKS
+		// If the safe pointer has debug information, use it to assert that size is within bound.
+		data.assertInside("image_qoi_decode_RgbaU8 (data)", data.getUnsafe(), (size_t)size);
+	#endif
+	const uint8_t *source = data.getUnsafe();
+	uint32_t width = readBigEndian(source + 4);
+	uint32_t height = readBigEndian(source + 8);
+	uint8_t channels = source[12];
+	if (width < 1 || width > 65536 || height < 1 || height > 65536 || (channels != 3 && channels != 4)) {
+		return OrderedImageRgbaU8(); // Return null
+	}
+	// Each byte can at most represent the pixels of a full run, so larger dimensions are rejected before allocating memory for them.
+	if (int64_t(width) * int64_t(height) > int64_t(size) * maxRunLength) {
+		return OrderedImageRgbaU8(); // Return null
+	}
+	// Without a strip table, the whole image is decoded as one strip, which stops when all pixels are decoded.
+	int32_t stripHeight = height;
+	int32_t stripCount = 1;
+	List<int32_t> stripOffsets;
+	stripOffsets.push(headerSize);
+	stripOffsets.push(size);
+	if (size >= headerSize + endMarkerSize + 12 && memcmp(source + size - 4, stripTag, 4) == 0) {
+		int64_t tableCount = readBigEndian(source + size - 8);
+		int64_t tableSize = 12 + tableCount * 4;
+		if (tableCount >= 1 && tableSize <= size - headerSize - endMarkerSize) {
+			const uint8_t *table = source + size - tableSize;
+			int64_t tableStripHeight = readBigEndian(table);
+			int32_t chunkEnd = size - int32_t(tableSize) - endMarkerSize;
+			if (tableStripHeight >= 1 && (height + tableStripHeight - 1) / tableStripHeight == tableCount) {
+				List<int32_t> tableOffsets;
+				int64_t previousOffset = headerSize - 1;
+				for (int32_t s = 0; s < tableCount; s++) {
+					int64_t offset = readBigEndian(table + 4 + s * 4);
+					if (offset <= previousOffset || offset >= chunkEnd || (s == 0 && offset != headerSize)) {
+						break;
+					}
+					tableOffsets.push(int32_t(offset));
+					previousOffset = offset;
+				}
+				// If the strip table is invalid, it is ignored and the image is decoded on a single thread.
+				if (tableOffsets.length() == tableCount) {
+					tableOffsets.push(chunkEnd);
+					stripOffsets = tableOffsets;
+					stripHeight = int32_t(tableStripHeight);
+					stripCount = int32_t(tableCount);
+				}
+			}
+		}
+	}
+	OrderedImageRgbaU8 result = image_create_RgbaU8(width, height, false);
+	uint8_t *target = image_dangerous_getData(result);
+	int32_t stride = image_getStride(result);
+	List<uint8_t> stripSucceeded;
+	for (int32_t s = 0; s < stripCount; s++) {
+		stripSucceeded.push(0);
+	}
+	threadedSplit(0, stripCount, [&stripSucceeded, &stripOffsets, source, target, stride, width, height, stripHeight](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t s = startIndex; s < stopIndex; s++) {
+			int32_t startY = s * stripHeight;
+			int32_t stopY = startY + stripHeight;
+			if (stopY > int32_t(height)) {
+				stopY = height;
+			}
+			stripSucceeded[s] = decodeStrip(source + stripOffsets[s], source + stripOffsets[s + 1], target + intptr_t(startY) * stride, stride, width, stopY - startY);
+		}
+	}, 1, 2, maxThreadCount);
+	for (int32_t s = 0; s < stripCount; s++) {
+		if (!stripSucceeded[s]) {
+			return OrderedImageRgbaU8(); // Return null
+		}
+	}
+	return result;
+}
+
+Buffer image_qoi_encode(const ImageRgbaU8 &image, int32_t maxThreadCount) {
+	int32_t width = image_getWidth(image);
+	int32_t height = image_getHeight(image);
+	int32_t stride = image_getStride(image);
+	const uint8_t *data = image_dangerous_getData(image);
+	int32_t stripHeight = stripPixelCount / width;
+	if (stripHeight < 1) {
+		stripHeight = 1;
+	}
+	int32_t stripCount = (height + stripHeight - 1) / stripHeight;
+	// Encode each strip to a separate list.
+	List<List<uint8_t>> strips;
+	for (int32_t s = 0; s < stripCount; s++) {
+		strips.pushConstruct();
+	}
+	threadedSplit(0, stripCount, [&strips, data, stride, width, height, stripHeight](int32_t startIndex, int32_t stopIndex) {
+		for (int32_t s = startIndex; s < stopIndex; s++) {
+			int32_t startY = s * stripHeight;
+			int32_t stopY = startY + stripHeight;
+			if (stopY > height) {
+				stopY = height;
+			}
+			// Reserve enough memory for an uncompressed strip to reduce the need for reallocation.
+			strips[s].reserve(intptr_t(width) * (stopY - startY) + 64);
+			encodeStrip(strips[s], data, stride, width, startY, stopY);
+		}
+	}, 1, 2, maxThreadCount);
+	// Concatenate the strips once the total size is known.
+	intptr_t chunkSize = 0;
+	for (int32_t s = 0; s < stripCount; s++) {
+		chunkSize += strips[s].length();
+	}
+	intptr_t tableSize = 12 + intptr_t(stripCount) * 4;
+	intptr_t totalSize = headerSize + chunkSize + endMarkerSize + tableSize;
+	if (totalSize > 2147483647) {
+		return Buffer(); // The strip offsets and the decoder's size can not express larger files.
+	}
+	Buffer result = buffer_create(totalSize);
+	uint8_t *target = buffer_dangerous_getUnsafeData(result);
+	// Header
+	memcpy(target, "qoif", 4);
+	writeBigEndian(target + 4, width);
+	writeBigEndian(target + 8, height);
+	target[12] = 4; // RGBA
+	target[13] = 0; // sRGB with linear alpha
+	// Chunks
+	uint8_t *table = target + headerSize + chunkSize + endMarkerSize;
+	writeBigEndian(table, stripHeight);
+	intptr_t offset = headerSize;
+	for (int32_t s = 0; s < stripCount; s++) {
+		writeBigEndian(table + 4 + s * 4, uint32_t(offset));
+		if (strips[s].length() > 0) {
+			memcpy(target + offset, &(strips[s][0]), strips[s].length());
+		}
+		offset += strips[s].length();
+	}
+	// End marker
+	memcpy(target + offset, endMarker, endMarkerSize);
+	// Strip table
+	writeBigEndian(table + 4 + stripCount * 4, stripCount);
+	memcpy(table + 8 + stripCount * 4, stripTag, 4);
+	return result;
+}
+
+}
@@ -0,0 +1,55 @@
+﻿
+// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+//
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+//
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+// The Quite OK Image format
+//   A lossless format storing each pixel as a run of the previous color, an index into recently used colors,
+//   a small difference from the previous color or the color itself, which is many times faster to decode than PNG.
+// Strips
+//   The encoder splits the image into strips of rows that do not depend on each other's colors,
+//   by starting each strip with a complete color, only referring to recently used colors from the same strip and ending runs at the end of each strip.
+//   The strip offsets are stored after the end marker, where other QOI decoders will ignore them,
+//   so that each strip can be decoded on a separate thread while the file remains a valid QOI image.
+//   QOI files from other encoders do not have strips, and will be decoded on a single thread.
+
+#ifndef DFPSR_API_IMAGE_QOI
+#define DFPSR_API_IMAGE_QOI
+
+#include "../Image.h"
+
+namespace dsr {
+
+// Post-condition: Returns true iff data begins with the QOI signature.
+bool image_qoi_isEncoded(SafePointer<const uint8_t> data, int32_t size);
+
+// Post-condition: Returns the decoded image, or an empty handle if the data is not a valid QOI image.
+OrderedImageRgbaU8 image_qoi_decode_RgbaU8(SafePointer<const uint8_t> data, int32_t size, int32_t maxThreadCount = 0);
+
+// Pre-conditions:
+// * The image must be packed in RGBA order at runtime.
+// * The image may be a padded image or sub-image, because the stride is used when reading the pixels.
+Buffer image_qoi_encode(const ImageRgbaU8 &image, int32_t maxThreadCount = 0);
+
+}
+
+#endif
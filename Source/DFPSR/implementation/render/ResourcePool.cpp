@@ -26,9 +26,44 @@
 #include "../../api/fileAPI.h"
 #include "../../api/imageAPI.h"
 #include "../../api/textureAPI.h"
+#include "../../api/bufferAPI.h"
+#include <chrono>
 
 using namespace dsr;
 
+// Returns the path to the first existing image file named extensionless with one of the supported extensions, or an empty string if none exists.
+static String findImageFile(const ReadableString& extensionless) {
+	static const ReadableString extensions[3] = {U".png", U".gif", U".jpg"};
+	for (int32_t e = 0; e < 3; e++) {
+		String filename = extensionless + extensions[e];
+		if (file_getEntryType(filename) == EntryType::File) {
+			return filename;
+		}
+	}
+	return String();
+}
+
+// Called from a background thread, so it must not access the resource pool.
+static TextureRgbaU8 loadTextureRgba(String filename, int32_t resolutions) {
+	return texture_create_RgbaU8(image_load_RgbaU8(filename, false), resolutions);
+}
+
+// Returns the number of bytes used by texture's pixels from firstLevel to the lowest resolution.
+static intptr_t getTextureSize(const TextureRgbaU8& texture, int32_t firstLevel) {
+	intptr_t result = 0;
+	for (int32_t level = firstLevel; level < texture_getMipLevelCount(texture); level++) {
+		result += intptr_t(texture_getWidth(texture, level)) * intptr_t(texture_getHeight(texture, level)) * intptr_t(sizeof(uint32_t));
+	}
+	return result;
+}
+
+BasicResourcePool::~BasicResourcePool() {
+	// Let background threads finish before the textures they are loading are destroyed.
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		this->streamedTextureList[i]->waitForLoading();
+	}
+}
+
 int32_t BasicResourcePool::findImageRgba(const ReadableString& name) const {
 	for (int32_t i = 0; i < this->imageRgbaList.length(); i++) {
 		// Warning!
@@ -50,6 +85,15 @@ int32_t BasicResourcePool::findTextureRgba(const ReadableString& name) const {
 	return -1;
 }
 
+int32_t BasicResourcePool::findStreamedTextureRgba(const ReadableString& name) const {
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		if (string_caseInsensitiveMatch(name, this->streamedTextureList[i]->name)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 const ImageRgbaU8 BasicResourcePool::fetchImageRgba(const ReadableString& name) {
 	ImageRgbaU8 result;
 	// Using U"" will return an empty reference to allow removing textures
@@ -111,3 +155,200 @@ const TextureRgbaU8 BasicResourcePool::fetchTextureRgba(const ReadableString& na
 	}
 	return result;
 }
+
+Handle<TextureSlot> BasicResourcePool::fetchTextureSlotRgba(const ReadableString& name, int32_t resolutions) {
+	if (!this->streamTextures) {
+		return ResourcePool::fetchTextureSlotRgba(name, resolutions);
+	}
+	Handle<TextureSlot> result;
+	// Using U"" will return an empty reference to allow removing textures
+	if (string_length(name) > 0) {
+		int32_t existingIndex = this->findStreamedTextureRgba(name);
+		if (existingIndex > -1) {
+			result = this->streamedTextureList[existingIndex]->slot;
+		} else if (string_findFirst(name, U'.') > -1) {
+			throwError(U"The texture \"", name, U"\" had a forbidden dot in the name. Textures in resource pools are fetched without the extension to allow changing image format without changing what it's called in other resources.\n");
+		} else {
+			const String extensionless = file_combinePaths(this->path, name);
+			String filename = findImageFile(extensionless);
+			if (string_length(filename) > 0) {
+				// The slot starts empty and gets the texture once loaded.
+				result = handle_create<TextureSlot>(TextureRgbaU8()).setName("Streamed texture slot");
+				Handle<StreamedTexture> entry = handle_create<StreamedTexture>(name, filename, resolutions, result).setName("Streamed texture");
+				this->streamedTextureList.push(entry);
+				if (this->getLoadingCount() < this->maxConcurrentLoads) {
+					this->startLoading(entry.getReference());
+				}
+			} else {
+				printText(U"The image ", extensionless, U".* couldn't be loaded as either png, gif nor jpg!\n");
+			}
+		}
+	}
+	return result;
+}
+
+int32_t BasicResourcePool::getLoadingCount() const {
+	int32_t result = 0;
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		if (this->streamedTextureList[i]->isLoading()) {
+			result++;
+		}
+	}
+	return result;
+}
+
+void StreamedTexture::startLoading() {
+	#ifndef DISABLE_MULTI_THREADING
+		this->loading = std::async(std::launch::async, &loadTextureRgba, this->filename, this->resolutions);
+	#else
+		this->loadedTexture = loadTextureRgba(this->filename, this->resolutions);
+		this->loading = true;
+	#endif
+}
+
+bool StreamedTexture::isLoading() const {
+	#ifndef DISABLE_MULTI_THREADING
+		return this->loading.valid();
+	#else
+		return this->loading;
+	#endif
+}
+
+bool StreamedTexture::isLoaded() const {
+	#ifndef DISABLE_MULTI_THREADING
+		return this->loading.valid() && this->loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	#else
+		return this->loading;
+	#endif
+}
+
+void StreamedTexture::waitForLoading() const {
+	#ifndef DISABLE_MULTI_THREADING
+		if (this->loading.valid()) {
+			this->loading.wait();
+		}
+	#endif
+}
+
+TextureRgbaU8 StreamedTexture::takeLoaded() {
+	#ifndef DISABLE_MULTI_THREADING
+		return this->loading.get();
+	#else
+		TextureRgbaU8 result = this->loadedTexture;
+		this->loadedTexture = TextureRgbaU8();
+		this->loading = false;
+		return result;
+	#endif
+}
+
+void BasicResourcePool::startLoading(StreamedTexture &entry) {
+	entry.requested = false;
+	entry.startLoading();
+}
+
+void BasicResourcePool::install(StreamedTexture &entry, const TextureRgbaU8 &completeTexture) {
+	if (!texture_exists(completeTexture)) {
+		printText(U"The streamed texture ", entry.filename, U" could not be loaded!\n");
+		return;
+	}
+	entry.completeLevelCount = texture_getMipLevelCount(completeTexture);
+	int32_t firstLevel = 0;
+	if (this->textureMemoryBudget > 0) {
+		// Skip the highest resolutions that do not fit within the budget, but always keep the lowest resolution.
+		intptr_t otherUsage = this->getTextureMemoryUsage() - buffer_getSize(entry.slot->texture.impl_buffer);
+		while (firstLevel < texture_getSmallestMipLevel(completeTexture) && otherUsage + getTextureSize(completeTexture, firstLevel) > this->textureMemoryBudget) {
+			firstLevel++;
+		}
+	}
+	entry.slot->texture = (firstLevel == 0) ? completeTexture : texture_getLowerResolutions(completeTexture, firstLevel);
+}
+
+void BasicResourcePool::evict() {
+	if (this->textureMemoryBudget <= 0) {
+		return;
+	}
+	intptr_t usage = this->getTextureMemoryUsage();
+	while (usage > this->textureMemoryBudget) {
+		// Find the least recently used texture that has a resolution to remove.
+		int32_t leastRecentlyUsed = -1;
+		for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+			const StreamedTexture &entry = this->streamedTextureList[i].getReference();
+			if (texture_getMipLevelCount(entry.slot->texture) > 1 && (leastRecentlyUsed == -1 || entry.lastUsed < this->streamedTextureList[leastRecentlyUsed]->lastUsed)) {
+				leastRecentlyUsed = i;
+			}
+		}
+		if (leastRecentlyUsed == -1) {
+			// Only the lowest resolutions remain.
+			break;
+		}
+		TextureRgbaU8 &texture = this->streamedTextureList[leastRecentlyUsed]->slot->texture;
+		intptr_t oldSize = buffer_getSize(texture.impl_buffer);
+		texture = texture_getLowerResolutions(texture, 1);
+		usage += buffer_getSize(texture.impl_buffer) - oldSize;
+	}
+}
+
+void BasicResourcePool::update() {
+	this->updateIndex++;
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		StreamedTexture &entry = this->streamedTextureList[i].getReference();
+		if (entry.slot->used.exchange(false)) {
+			entry.lastUsed = this->updateIndex;
+		}
+	}
+	// Place loaded textures in their slots.
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		StreamedTexture &entry = this->streamedTextureList[i].getReference();
+		if (entry.isLoaded()) {
+			this->install(entry, entry.takeLoaded());
+		}
+	}
+	this->evict();
+	// Load textures again if they are used without all resolutions and there is memory for the next resolution.
+	intptr_t usage = this->getTextureMemoryUsage();
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		StreamedTexture &entry = this->streamedTextureList[i].getReference();
+		const TextureRgbaU8 &texture = entry.slot->texture;
+		int32_t levelCount = texture_getMipLevelCount(texture);
+		if (entry.lastUsed == this->updateIndex && !entry.isLoading() && levelCount > 0 && levelCount < entry.completeLevelCount) {
+			intptr_t nextLevelSize = intptr_t(texture_getMaxWidth(texture)) * intptr_t(texture_getMaxHeight(texture)) * intptr_t(sizeof(uint32_t) * 4);
+			if (this->textureMemoryBudget <= 0 || usage + nextLevelSize <= this->textureMemoryBudget) {
+				entry.requested = true;
+			}
+		}
+	}
+	// Start loading requested textures.
+	int32_t loadingCount = this->getLoadingCount();
+	for (int32_t i = 0; i < this->streamedTextureList.length() && loadingCount < this->maxConcurrentLoads; i++) {
+		StreamedTexture &entry = this->streamedTextureList[i].getReference();
+		if (entry.requested && !entry.isLoading()) {
+			this->startLoading(entry);
+			loadingCount++;
+		}
+	}
+}
+
+void BasicResourcePool::finishStreaming() {
+	do {
+		for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+			this->streamedTextureList[i]->waitForLoading();
+		}
+		this->update();
+	} while (this->getLoadingCount() > 0);
+}
+
+void BasicResourcePool::setTextureMemoryBudget(intptr_t budget) {
+	this->textureMemoryBudget = budget;
+}
+
+intptr_t BasicResourcePool::getTextureMemoryUsage() const {
+	intptr_t result = 0;
+	for (int32_t i = 0; i < this->streamedTextureList.length(); i++) {
+		result += buffer_getSize(this->streamedTextureList[i]->slot->texture.impl_buffer);
+	}
+	return result;
+}
+
+void BasicResourcePool::setMaxConcurrentLoads(int32_t count) {
+	this->maxConcurrentLoads = count < 1 ? 1 : count;
+}
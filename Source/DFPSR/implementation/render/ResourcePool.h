@@ -27,14 +27,37 @@
 #include "../image/Texture.h"
 #include "../../collection/List.h"
 #include "../../api/stringAPI.h"
+#include "../../api/textureAPI.h"
+#include "../../base/Handle.h"
+#include "../../settings.h"
+#include <atomic>
+#ifndef DISABLE_MULTI_THREADING
+	#include <future>
+#endif
 
 namespace dsr {
 
+// A texture that can be replaced while models are using it, so that a resource pool can stream in and evict resolutions between frames.
+//   Rendering a model part that uses the slot sets used to true, so that the resource pool knows which textures are needed.
+struct TextureSlot {
+	TextureRgbaU8 texture;
+	std::atomic<bool> used;
+	explicit TextureSlot(const TextureRgbaU8 &texture) : texture(texture), used(false) {}
+};
+
 // A resource pool is responsible for storing things that might be reused in order to avoid loading the same file multiple times
 class ResourcePool {
 public:
 	virtual const ImageRgbaU8 fetchImageRgba(const ReadableString& name) = 0;
 	virtual const TextureRgbaU8 fetchTextureRgba(const ReadableString& name, int32_t resolutions = 4) = 0;
+	// Returns a slot that the resource pool may update with other resolutions of the texture when update is called, or a null handle if it could not be found.
+	//   The default implementation places the texture from fetchTextureRgba in a new slot that will not be updated.
+	virtual Handle<TextureSlot> fetchTextureSlotRgba(const ReadableString& name, int32_t resolutions = 4) {
+		TextureRgbaU8 texture = this->fetchTextureRgba(name, resolutions);
+		return texture_exists(texture) ? handle_create<TextureSlot>(texture).setName("Texture slot") : Handle<TextureSlot>();
+	}
+	// Call between frames to let the resource pool replace textures in slots, which must not happen while rendering.
+	virtual void update() {}
 };
 
 // TODO: Keep track of reference count to resources and have a clean-up method for removing unused resources.
@@ -45,18 +68,85 @@ struct namedEntry {
 	namedEntry(const String& name, const T& resource) : name(name), resource(resource) {}
 };
 
+// A texture being streamed into a slot by BasicResourcePool.
+struct StreamedTexture {
+	String name;
+	// The path to the image file to load the texture from.
+	String filename;
+	int32_t resolutions;
+	Handle<TextureSlot> slot;
+	// The number of mip levels in the texture with all resolutions, or 0 before it has been loaded.
+	int32_t completeLevelCount = 0;
+	// The index of the last update when the slot was used, for evicting the least recently used textures first.
+	int64_t lastUsed = 0;
+	// True when the texture should be loaded again, because it is being used without all of its resolutions.
+	bool requested = true;
+	#ifndef DISABLE_MULTI_THREADING
+		// Loads the texture with all resolutions on a background thread.
+		std::future<TextureRgbaU8> loading;
+	#else
+		// Without threads, the texture is loaded when requested and kept here until the next update.
+		TextureRgbaU8 loadedTexture;
+		bool loading = false;
+	#endif
+	StreamedTexture(const String &name, const String &filename, int32_t resolutions, const Handle<TextureSlot> &slot)
+	: name(name), filename(filename), resolutions(resolutions), slot(slot) {}
+	// Starts loading the texture with all resolutions.
+	void startLoading();
+	// Returns true from when loading starts until the loaded texture is taken.
+	bool isLoading() const;
+	// Returns true if isLoading and the texture can be taken without waiting.
+	bool isLoaded() const;
+	// Waits until the texture has been loaded, if it is loading.
+	void waitForLoading() const;
+	// Pre-condition: isLoading()
+	// Side-effect: Waits until the texture has been loaded and stops loading.
+	// Post-condition: Returns the loaded texture.
+	TextureRgbaU8 takeLoaded();
+};
+
 class BasicResourcePool : public ResourcePool {
 private:
 	List<namedEntry<ImageRgbaU8>> imageRgbaList;
 	List<namedEntry<TextureRgbaU8>> textureRgbaList;
+	List<Handle<StreamedTexture>> streamedTextureList;
+	bool streamTextures;
+	intptr_t textureMemoryBudget = 0;
+	int32_t maxConcurrentLoads = 4;
+	int64_t updateIndex = 0;
 	int32_t findImageRgba(const ReadableString& name) const;
 	int32_t findTextureRgba(const ReadableString& name) const;
+	int32_t findStreamedTextureRgba(const ReadableString& name) const;
+	int32_t getLoadingCount() const;
+	void startLoading(StreamedTexture &entry);
+	void install(StreamedTexture &entry, const TextureRgbaU8 &completeTexture);
+	void evict();
 public:
 	String path;
-	explicit BasicResourcePool(const ReadableString& path) : path(path) {}
+	// If streamTextures is true, fetchTextureSlotRgba returns immediately and loads the texture on a background thread.
+	//   Then update must be called between frames to let the loaded textures into their slots.
+	explicit BasicResourcePool(const ReadableString& path, bool streamTextures = false) : streamTextures(streamTextures), path(path) {}
+	~BasicResourcePool();
 	const ImageRgbaU8 fetchImageRgba(const ReadableString& name) override;
 	// The resolutions argument can be used to limit the number of mip levels for a specific rendering engine.
 	const TextureRgbaU8 fetchTextureRgba(const ReadableString& name, int32_t resolutions) override;
+	// When streaming, the slot starts empty and gets the texture in a later call to update.
+	//   Then the highest resolutions may be evicted to stay within the memory budget, and loaded again when used.
+	Handle<TextureSlot> fetchTextureSlotRgba(const ReadableString& name, int32_t resolutions) override;
+	// Side-effects:
+	//   Places textures that finished loading into their slots, from the lowest resolution up to as many resolutions as fit within the memory budget.
+	//   Removes the highest resolution from the least recently used textures until the streamed textures fit within the memory budget.
+	//   Starts loading textures again when they are used without all of their resolutions and there is memory for at least one more resolution.
+	void update() override;
+	// Side-effect: Waits for all textures being loaded and then calls update, so that all loaded textures are resident when returning.
+	void finishStreaming();
+	// Limits the number of bytes used by the pixels of streamed textures, or removes the limit if budget is 0.
+	//   The lowest resolution of each texture is always kept, even if it exceeds the budget.
+	void setTextureMemoryBudget(intptr_t budget);
+	// Post-condition: Returns the number of bytes used by streamed textures in their slots.
+	intptr_t getTextureMemoryUsage() const;
+	// Limits the number of background threads loading textures at the same time.
+	void setMaxConcurrentLoads(int32_t count);
 };
 
 }
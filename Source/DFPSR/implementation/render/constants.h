@@ -31,7 +31,7 @@ enum class Visibility { Hidden, Full, Partial };
 
 enum class Interpolation { NN, BL };
 
-enum class Filter { Solid, Alpha };
+enum class Filter { Solid, Alpha, AlphaPremultiplied };
 
 // A set of global constants that should be easy to access without getting cyclic dependencies
 namespace constants {
@@ -118,7 +118,23 @@ int32_t Polygon::getVertexCount() const {
 Part::Part(const ReadableString &name) : name(name) {}
 Part::Part(const TextureRgbaU8 &diffuseMap, const TextureRgbaU8 &lightMap, const List<Polygon> &polygonBuffer, const String &name) :
   diffuseMap(diffuseMap), lightMap(lightMap), polygonBuffer(polygonBuffer), name(name) {}
-Part Part::clone() const { return Part(this->diffuseMap, this->lightMap, this->polygonBuffer, this->name); }
+Part Part::clone() const {
+	Part result = Part(this->diffuseMap, this->lightMap, this->polygonBuffer, this->name);
+	result.diffuseSlot = this->diffuseSlot;
+	result.lightSlot = this->lightSlot;
+	return result;
+}
+
+static const TextureRgbaU8 &useTexture(const TextureRgbaU8 &texture, const Handle<TextureSlot> &slot) {
+	if (slot.isNotNull()) {
+		slot->used.store(true, std::memory_order_relaxed);
+		return slot->texture;
+	} else {
+		return texture;
+	}
+}
+const TextureRgbaU8 &Part::useDiffuseMap() const { return useTexture(this->diffuseMap, this->diffuseSlot); }
+const TextureRgbaU8 &Part::useLightMap() const { return useTexture(this->lightMap, this->lightSlot); }
 int32_t Part::getPolygonCount() const {
 	return this->polygonBuffer.length();
 }
@@ -148,15 +164,17 @@ static void renderTriangleFromPolygon(CommandQueue *commandQueue, const ImageRgb
 }
 
 void Part::render(CommandQueue *commandQueue, const ImageRgbaU8 &targetImage, const ImageF32 &depthBuffer, const Transform3D &modelToWorldTransform, const Camera &camera, Filter filter, const ProjectedPoint* projected) const {
+	const TextureRgbaU8 &diffuse = this->useDiffuseMap();
+	const TextureRgbaU8 &light = this->useLightMap();
 	for (int32_t p = 0; p < this->polygonBuffer.length(); p++) {
 		Polygon polygon = this->polygonBuffer[p];
 		if (polygon.pointIndices[3] == -1) {
 			// Render triangle
-			renderTriangleFromPolygon(commandQueue, targetImage, depthBuffer, camera, polygon, 0, projected, filter, this->diffuseMap, this->lightMap);
+			renderTriangleFromPolygon(commandQueue, targetImage, depthBuffer, camera, polygon, 0, projected, filter, diffuse, light);
 		} else {
 			// Render quad
-			renderTriangleFromPolygon(commandQueue, targetImage, depthBuffer, camera, polygon, 0, projected, filter, this->diffuseMap, this->lightMap);
-			renderTriangleFromPolygon(commandQueue, targetImage, depthBuffer, camera, polygon, 1, projected, filter, this->diffuseMap, this->lightMap);
+			renderTriangleFromPolygon(commandQueue, targetImage, depthBuffer, camera, polygon, 0, projected, filter, diffuse, light);
+			renderTriangleFromPolygon(commandQueue, targetImage, depthBuffer, camera, polygon, 1, projected, filter, diffuse, light);
 		}
 	}
 }
@@ -235,32 +253,39 @@ String ModelImpl::getPartName(int32_t partIndex) const {
 }
 TextureRgbaU8 ModelImpl::getDiffuseMap(int32_t partIndex) const {
 	CHECK_PART_INDEX(partIndex, return TextureRgbaU8());
-	return this->partBuffer[partIndex].diffuseMap;
+	const Part &part = this->partBuffer[partIndex];
+	return part.diffuseSlot.isNotNull() ? part.diffuseSlot->texture : part.diffuseMap;
 }
 void ModelImpl::setDiffuseMap(const TextureRgbaU8 &diffuseMap, int32_t partIndex) {
 	CHECK_PART_INDEX(partIndex, return);
 	this->partBuffer[partIndex].diffuseMap = diffuseMap;
+	this->partBuffer[partIndex].diffuseSlot = Handle<TextureSlot>();
 }
 void ModelImpl::setDiffuseMapByName(ResourcePool &pool, const String &filename, int32_t partIndex) {
 	CHECK_PART_INDEX(partIndex, return);
-	const TextureRgbaU8 texture = pool.fetchTextureRgba(filename, 5);
-	if (texture_exists(texture)) {
-		this->setDiffuseMap(texture, partIndex);
+	// Using a slot lets pools that stream textures replace the texture later.
+	const Handle<TextureSlot> slot = pool.fetchTextureSlotRgba(filename, 5);
+	if (slot.isNotNull()) {
+		this->partBuffer[partIndex].diffuseMap = TextureRgbaU8();
+		this->partBuffer[partIndex].diffuseSlot = slot;
 	}
 }
 TextureRgbaU8 ModelImpl::getLightMap(int32_t partIndex) const {
 	CHECK_PART_INDEX(partIndex, return TextureRgbaU8());
-	return this->partBuffer[partIndex].lightMap;
+	const Part &part = this->partBuffer[partIndex];
+	return part.lightSlot.isNotNull() ? part.lightSlot->texture : part.lightMap;
 }
 void ModelImpl::setLightMap(const TextureRgbaU8 &lightMap, int32_t partIndex) {
 	CHECK_PART_INDEX(partIndex, return);
 	this->partBuffer[partIndex].lightMap = lightMap;
+	this->partBuffer[partIndex].lightSlot = Handle<TextureSlot>();
 }
 void ModelImpl::setLightMapByName(ResourcePool &pool, const String &filename, int32_t partIndex) {
 	CHECK_PART_INDEX(partIndex, return);
-	const TextureRgbaU8 texture = pool.fetchTextureRgba(filename, 1); // TODO: Allow configuring the number of mip levels and selecting a sampler somehow.
-	if (texture_exists(texture)) {
-		this->setLightMap(texture, partIndex);
+	const Handle<TextureSlot> slot = pool.fetchTextureSlotRgba(filename, 1); // TODO: Allow configuring the number of mip levels and selecting a sampler somehow.
+	if (slot.isNotNull()) {
+		this->partBuffer[partIndex].lightMap = TextureRgbaU8();
+		this->partBuffer[partIndex].lightSlot = slot;
 	}
 }
 int32_t ModelImpl::addPolygon(Polygon polygon, int32_t partIndex) {
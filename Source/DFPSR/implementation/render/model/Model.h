@@ -65,11 +65,16 @@ struct Polygon {
 
 struct Part {
 	TextureRgbaU8 diffuseMap, lightMap;
+	// When a slot is assigned, the texture is taken from the slot instead, so that a resource pool can replace it between frames.
+	Handle<TextureSlot> diffuseSlot, lightSlot;
 	List<Polygon> polygonBuffer;
 	String name;
 	explicit Part(const ReadableString &name);
 	Part(const TextureRgbaU8 &diffuseMap, const TextureRgbaU8 &lightMap, const List<Polygon> &polygonBuffer, const String &name);
 	Part clone() const;
+	// Get the textures to render with, and mark any slots as used.
+	const TextureRgbaU8 &useDiffuseMap() const;
+	const TextureRgbaU8 &useLightMap() const;
 	void render(CommandQueue *commandQueue, const ImageRgbaU8 &targetImage, const ImageF32 &depthBuffer, const Transform3D &modelToWorldTransform, const Camera &camera, Filter filter, const ProjectedPoint* projected) const;
 	void renderDepth(const ImageF32 &depthBuffer, const Transform3D &modelToWorldTransform, const Camera &camera, const ProjectedPoint* projected) const;
 	int32_t getPolygonCount() const;
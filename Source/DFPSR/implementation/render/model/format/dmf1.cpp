@@ -118,6 +118,8 @@ static void setProperty(ParserState &state, const String &propertyName, int32_t
 			PARSER_NOINDEX
 			if CONTENT_MATCH(Alpha) {
 				state.model->filter = Filter::Alpha;
+			} else if CONTENT_MATCH(AlphaPremultiplied) {
+				state.model->filter = Filter::AlphaPremultiplied;
 			} else { // None
 				state.model->filter = Filter::Solid;
 			}
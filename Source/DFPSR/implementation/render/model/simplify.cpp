@@ -0,0 +1,385 @@
+﻿// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+// 
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// 
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+#include "simplify.h"
+#include <algorithm>
+
+namespace dsr {
+
+// How much more it costs to move a point away from an open border than away from the surface.
+static const double borderWeight = 1000.0;
+
+// A symmetric 4x4 matrix, summing up squared distances to a set of planes.
+struct Quadric {
+	double v[10] = {};
+	void addPlane(const FVector3D &normal, double offset, double weight) {
+		double a = normal.x, b = normal.y, c = normal.z, d = offset;
+		this->v[0] += a * a * weight; this->v[1] += a * b * weight; this->v[2] += a * c * weight; this->v[3] += a * d * weight;
+		this->v[4] += b * b * weight; this->v[5] += b * c * weight; this->v[6] += b * d * weight;
+		this->v[7] += c * c * weight; this->v[8] += c * d * weight;
+		this->v[9] += d * d * weight;
+	}
+	void add(const Quadric &other) {
+		for (int32_t i = 0; i < 10; i++) {
+			this->v[i] += other.v[i];
+		}
+	}
+	// Returns the weighted sum of squared distances from point to all planes.
+	double evaluate(const FVector3D &point) const {
+		double x = point.x, y = point.y, z = point.z;
+		return this->v[0] * x * x + 2.0 * this->v[1] * x * y + 2.0 * this->v[2] * x * z + 2.0 * this->v[3] * x
+		     + this->v[4] * y * y + 2.0 * this->v[5] * y * z + 2.0 * this->v[6] * y
+		     + this->v[7] * z * z + 2.0 * this->v[8] * z
+		     + this->v[9];
+	}
+};
+
+struct SimplifiedTriangle {
+	int32_t pointIndices[3];
+	FVector4D texCoords[3];
+	FVector4D colors[3];
+	int32_t partIndex;
+	bool removed = false;
+	SimplifiedTriangle(const Polygon &polygon, int32_t cornerA, int32_t cornerB, int32_t cornerC, int32_t partIndex) : partIndex(partIndex) {
+		int32_t corners[3] = {cornerA, cornerB, cornerC};
+		for (int32_t c = 0; c < 3; c++) {
+			this->pointIndices[c] = polygon.pointIndices[corners[c]];
+			this->texCoords[c] = polygon.texCoords[corners[c]];
+			this->colors[c] = polygon.colors[corners[c]];
+		}
+	}
+	int32_t findCorner(int32_t pointIndex) const {
+		for (int32_t c = 0; c < 3; c++) {
+			if (this->pointIndices[c] == pointIndex) return c;
+		}
+		return -1;
+	}
+	bool hasAttributes(int32_t corner, const FVector4D &texCoord, const FVector4D &color) const {
+		return this->texCoords[corner] == texCoord && this->colors[corner] == color;
+	}
+};
+
+// Moving the from point onto the to point.
+struct Collapse {
+	double cost;
+	int32_t from, to;
+	Collapse(double cost, int32_t from, int32_t to) : cost(cost), from(from), to(to) {}
+};
+
+static FVector3D getNormal(const FVector3D &a, const FVector3D &b, const FVector3D &c) {
+	return crossProduct(b - a, c - a);
+}
+
+class Simplifier {
+private:
+	List<FVector3D> positions;
+	List<SimplifiedTriangle> triangles;
+	// The indices of triangles using each point, including removed triangles until compacted.
+	List<List<int32_t>> pointTriangles;
+	List<Quadric> quadrics;
+	// True for points along open borders, where only one triangle uses an edge.
+	List<bool> border;
+	// True for points that were already changed in the current pass.
+	List<bool> touched;
+public:
+	int32_t triangleCount = 0;
+	explicit Simplifier(const ModelImpl &model) : positions(model.positionBuffer) {
+		int32_t pointCount = this->positions.length();
+		for (int32_t p = 0; p < pointCount; p++) {
+			this->pointTriangles.pushConstruct();
+			this->quadrics.pushConstruct();
+			this->border.push(false);
+			this->touched.push(false);
+		}
+		// Split polygons into triangles.
+		for (int32_t part = 0; part < model.partBuffer.length(); part++) {
+			const List<Polygon> &polygons = model.partBuffer[part].polygonBuffer;
+			for (int32_t p = 0; p < polygons.length(); p++) {
+				const Polygon &polygon = polygons[p];
+				this->addTriangle(SimplifiedTriangle(polygon, 0, 1, 2, part));
+				if (polygon.pointIndices[3] != -1) {
+					this->addTriangle(SimplifiedTriangle(polygon, 0, 2, 3, part));
+				}
+			}
+		}
+		// Sum up the squared distances to the planes of surrounding triangles.
+		this->findBorders();
+		for (int32_t t = 0; t < this->triangles.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[t];
+			FVector3D normal = this->getTriangleNormal(triangle);
+			float doubleArea = length(normal);
+			if (doubleArea <= 0.0f) continue;
+			normal = normal / doubleArea;
+			double offset = -dotProduct(normal, this->positions[triangle.pointIndices[0]]);
+			for (int32_t c = 0; c < 3; c++) {
+				this->quadrics[triangle.pointIndices[c]].addPlane(normal, offset, doubleArea * 0.5f);
+			}
+			// Open borders get planes perpendicular to the triangle, so that the outline is kept.
+			for (int32_t c = 0; c < 3; c++) {
+				int32_t pointA = triangle.pointIndices[c];
+				int32_t pointB = triangle.pointIndices[(c + 1) % 3];
+				if (this->countSharedTriangles(pointA, pointB) == 1) {
+					FVector3D edge = this->positions[pointB] - this->positions[pointA];
+					FVector3D borderNormal = normalize(crossProduct(edge, normal));
+					double borderOffset = -dotProduct(borderNormal, this->positions[pointA]);
+					double weight = borderWeight * squareLength(edge);
+					this->quadrics[pointA].addPlane(borderNormal, borderOffset, weight);
+					this->quadrics[pointB].addPlane(borderNormal, borderOffset, weight);
+				}
+			}
+		}
+	}
+	// Returns true iff any edge was collapsed.
+	bool simplifyPass(int32_t targetTriangleCount) {
+		this->compact();
+		this->findBorders();
+		// Collect collapses in both directions along each edge.
+		List<Collapse> collapses;
+		for (int32_t t = 0; t < this->triangles.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[t];
+			if (triangle.removed) continue;
+			for (int32_t c = 0; c < 3; c++) {
+				int32_t pointA = triangle.pointIndices[c];
+				int32_t pointB = triangle.pointIndices[(c + 1) % 3];
+				Quadric sum = this->quadrics[pointA];
+				sum.add(this->quadrics[pointB]);
+				collapses.pushConstruct(sum.evaluate(this->positions[pointB]), pointA, pointB);
+				collapses.pushConstruct(sum.evaluate(this->positions[pointA]), pointB, pointA);
+			}
+		}
+		if (collapses.length() == 0) return false;
+		// Sorting indices, because the collapses would be swapped using dsr::swap.
+		List<int32_t> order;
+		for (int32_t i = 0; i < collapses.length(); i++) {
+			order.push(i);
+		}
+		std::sort(&(order[0]), &(order[0]) + order.length(), [&collapses](int32_t left, int32_t right) {
+			return collapses[left].cost < collapses[right].cost;
+		});
+		// Collapse the cheapest edges whose surroundings have not yet been modified in this pass.
+		for (int32_t p = 0; p < this->touched.length(); p++) {
+			this->touched[p] = false;
+		}
+		bool collapsedAny = false;
+		for (int32_t i = 0; i < collapses.length() && this->triangleCount > targetTriangleCount; i++) {
+			const Collapse &collapse = collapses[order[i]];
+			if (this->touched[collapse.from] || this->touched[collapse.to]) continue;
+			if (this->tryCollapse(collapse.from, collapse.to)) {
+				collapsedAny = true;
+				this->touched[collapse.from] = true;
+				const List<int32_t> &changedTriangles = this->pointTriangles[collapse.to];
+				for (int32_t t = 0; t < changedTriangles.length(); t++) {
+					const SimplifiedTriangle &triangle = this->triangles[changedTriangles[t]];
+					if (triangle.removed) continue;
+					for (int32_t c = 0; c < 3; c++) {
+						this->touched[triangle.pointIndices[c]] = true;
+					}
+				}
+			}
+		}
+		return collapsedAny;
+	}
+	// Returns a new model with the remaining triangles and the points that they use.
+	Model createModel(const ModelImpl &source) const {
+		List<int32_t> newIndices;
+		for (int32_t p = 0; p < this->positions.length(); p++) {
+			newIndices.push(-1);
+		}
+		List<FVector3D> newPositions;
+		List<Part> newParts;
+		for (int32_t part = 0; part < source.partBuffer.length(); part++) {
+			const Part &sourcePart = source.partBuffer[part];
+			Part &newPart = newParts.pushConstruct(sourcePart.diffuseMap, sourcePart.lightMap, List<Polygon>(), sourcePart.name);
+			newPart.diffuseSlot = sourcePart.diffuseSlot;
+			newPart.lightSlot = sourcePart.lightSlot;
+		}
+		for (int32_t t = 0; t < this->triangles.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[t];
+			if (triangle.removed) continue;
+			Vertex vertices[3];
+			for (int32_t c = 0; c < 3; c++) {
+				int32_t oldIndex = triangle.pointIndices[c];
+				if (newIndices[oldIndex] == -1) {
+					newIndices[oldIndex] = newPositions.pushGetIndex(this->positions[oldIndex]);
+				}
+				vertices[c] = Vertex(newIndices[oldIndex], VertexData(triangle.texCoords[c], triangle.colors[c]));
+			}
+			newParts[triangle.partIndex].polygonBuffer.pushConstruct(vertices[0], vertices[1], vertices[2]);
+		}
+		Model result = handle_create<ModelImpl>(source.filter, newParts, newPositions).setName("Simplified model");
+		// Points only move onto each other, so the original bound is still valid.
+		result->minBound = source.minBound;
+		result->maxBound = source.maxBound;
+		return result;
+	}
+private:
+	void addTriangle(const SimplifiedTriangle &triangle) {
+		int32_t pointA = triangle.pointIndices[0], pointB = triangle.pointIndices[1], pointC = triangle.pointIndices[2];
+		// Skip triangles that are already collapsed.
+		if (pointA == pointB || pointB == pointC || pointC == pointA) return;
+		int32_t triangleIndex = this->triangles.pushGetIndex(triangle);
+		for (int32_t c = 0; c < 3; c++) {
+			this->pointTriangles[triangle.pointIndices[c]].push(triangleIndex);
+		}
+		this->triangleCount++;
+	}
+	FVector3D getTriangleNormal(const SimplifiedTriangle &triangle) const {
+		return getNormal(this->positions[triangle.pointIndices[0]], this->positions[triangle.pointIndices[1]], this->positions[triangle.pointIndices[2]]);
+	}
+	int32_t countSharedTriangles(int32_t pointA, int32_t pointB) const {
+		int32_t result = 0;
+		const List<int32_t> &triangleIndices = this->pointTriangles[pointA];
+		for (int32_t t = 0; t < triangleIndices.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[triangleIndices[t]];
+			if (!triangle.removed && triangle.findCorner(pointB) != -1) result++;
+		}
+		return result;
+	}
+	bool isNeighbor(int32_t pointA, int32_t pointB) const {
+		return this->countSharedTriangles(pointA, pointB) > 0;
+	}
+	// Removes indices to removed triangles.
+	void compact() {
+		for (int32_t p = 0; p < this->pointTriangles.length(); p++) {
+			List<int32_t> &triangleIndices = this->pointTriangles[p];
+			int32_t writeIndex = 0;
+			for (int32_t t = 0; t < triangleIndices.length(); t++) {
+				if (!this->triangles[triangleIndices[t]].removed) {
+					triangleIndices[writeIndex] = triangleIndices[t];
+					writeIndex++;
+				}
+			}
+			while (triangleIndices.length() > writeIndex) {
+				triangleIndices.pop();
+			}
+		}
+	}
+	void findBorders() {
+		for (int32_t p = 0; p < this->border.length(); p++) {
+			this->border[p] = false;
+		}
+		for (int32_t t = 0; t < this->triangles.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[t];
+			if (triangle.removed) continue;
+			for (int32_t c = 0; c < 3; c++) {
+				int32_t pointA = triangle.pointIndices[c];
+				int32_t pointB = triangle.pointIndices[(c + 1) % 3];
+				if (this->countSharedTriangles(pointA, pointB) == 1) {
+					this->border[pointA] = true;
+					this->border[pointB] = true;
+				}
+			}
+		}
+	}
+	// Returns the index of a triangle sharing the edge between from and to, with the same part and attributes at from as the corner in triangle.
+	//   Returns -1 if the collapse would tear a seam.
+	int32_t findAttributeSource(const SimplifiedTriangle &triangle, int32_t corner, int32_t from, int32_t to) const {
+		const List<int32_t> &triangleIndices = this->pointTriangles[from];
+		for (int32_t t = 0; t < triangleIndices.length(); t++) {
+			const SimplifiedTriangle &shared = this->triangles[triangleIndices[t]];
+			if (shared.removed || shared.partIndex != triangle.partIndex || shared.findCorner(to) == -1) continue;
+			int32_t sharedCorner = shared.findCorner(from);
+			if (sharedCorner != -1 && shared.hasAttributes(sharedCorner, triangle.texCoords[corner], triangle.colors[corner])) {
+				return triangleIndices[t];
+			}
+		}
+		return -1;
+	}
+	bool tryCollapse(int32_t from, int32_t to) {
+		const List<int32_t> &fromTriangles = this->pointTriangles[from];
+		int32_t sharedCount = this->countSharedTriangles(from, to);
+		// Only collapse edges with one or two triangles, where points on open borders may only move along the border.
+		if (sharedCount == 0 || sharedCount > 2 || (this->border[from] && sharedCount != 1)) return false;
+		// The link condition, where the edge's points may only have the neighbors in common that are in the collapsed triangles.
+		//   Otherwise the surface would fold into itself.
+		int32_t commonNeighborCount = 0;
+		for (int32_t t = 0; t < fromTriangles.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[fromTriangles[t]];
+			if (triangle.removed) continue;
+			for (int32_t c = 0; c < 3; c++) {
+				int32_t neighbor = triangle.pointIndices[c];
+				if (neighbor == from || neighbor == to) continue;
+				// Only count the neighbor from its first occurence.
+				bool counted = false;
+				for (int32_t u = 0; u < t && !counted; u++) {
+					const SimplifiedTriangle &previous = this->triangles[fromTriangles[u]];
+					if (!previous.removed && previous.findCorner(neighbor) != -1) counted = true;
+				}
+				if (!counted && this->isNeighbor(neighbor, to)) commonNeighborCount++;
+			}
+		}
+		if (commonNeighborCount != sharedCount) return false;
+		// Check the triangles that remain after the collapse.
+		for (int32_t t = 0; t < fromTriangles.length(); t++) {
+			const SimplifiedTriangle &triangle = this->triangles[fromTriangles[t]];
+			if (triangle.removed || triangle.findCorner(to) != -1) continue;
+			int32_t corner = triangle.findCorner(from);
+			// Must not flip the triangle.
+			FVector3D oldNormal = this->getTriangleNormal(triangle);
+			FVector3D corners[3] = {this->positions[triangle.pointIndices[0]], this->positions[triangle.pointIndices[1]], this->positions[triangle.pointIndices[2]]};
+			corners[corner] = this->positions[to];
+			FVector3D newNormal = getNormal(corners[0], corners[1], corners[2]);
+			if (dotProduct(oldNormal, newNormal) <= 0.0f) return false;
+			// Must have attributes to take from the same side of any seam.
+			if (this->findAttributeSource(triangle, corner, from, to) == -1) return false;
+		}
+		// Apply the collapse.
+		for (int32_t t = 0; t < fromTriangles.length(); t++) {
+			int32_t triangleIndex = fromTriangles[t];
+			SimplifiedTriangle &triangle = this->triangles[triangleIndex];
+			if (triangle.removed || triangle.findCorner(to) != -1) continue;
+			int32_t corner = triangle.findCorner(from);
+			const SimplifiedTriangle &source = this->triangles[this->findAttributeSource(triangle, corner, from, to)];
+			int32_t sourceCorner = source.findCorner(to);
+			triangle.pointIndices[corner] = to;
+			triangle.texCoords[corner] = source.texCoords[sourceCorner];
+			triangle.colors[corner] = source.colors[sourceCorner];
+			this->pointTriangles[to].push(triangleIndex);
+		}
+		// Remove the triangles along the collapsed edge after taking their attributes.
+		for (int32_t t = 0; t < fromTriangles.length(); t++) {
+			SimplifiedTriangle &triangle = this->triangles[fromTriangles[t]];
+			if (!triangle.removed && triangle.findCorner(to) != -1 && triangle.findCorner(from) != -1) {
+				triangle.removed = true;
+				this->triangleCount--;
+			}
+		}
+		this->pointTriangles[from].clear();
+		this->quadrics[to].add(this->quadrics[from]);
+		return true;
+	}
+};
+
+List<Model> simplifyModel(const ModelImpl &model, int32_t levelCount, float triangleRatio) {
+	List<Model> result;
+	Simplifier simplifier(model);
+	double targetCount = simplifier.triangleCount;
+	for (int32_t level = 1; level < levelCount; level++) {
+		targetCount *= triangleRatio;
+		while (simplifier.triangleCount > int32_t(targetCount) && simplifier.simplifyPass(int32_t(targetCount))) {}
+		result.push(simplifier.createModel(model));
+	}
+	return result;
+}
+
+}
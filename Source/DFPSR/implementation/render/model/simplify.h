@@ -0,0 +1,43 @@
+﻿// zlib open source license
+//
+// Copyright (c) 2026 David Forsgren Piuva
+// 
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// 
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 
+//    1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 
+//    2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 
+//    3. This notice may not be removed or altered from any source
+//    distribution.
+
+#ifndef DFPSR_RENDER_MODEL_SIMPLIFY
+#define DFPSR_RENDER_MODEL_SIMPLIFY
+
+#include "Model.h"
+#include "../../../api/modelAPI.h"
+
+namespace dsr {
+
+// Simplifies the model by collapsing edges in the order of least geometric error, measured using quadric error metrics.
+//   Each collapse moves one point onto a neighbor, so no new positions are created and the bounding box can be kept.
+//   Texture coordinates and colors are taken from the neighbor's corners on the same side of any seam.
+//   Collapses that would tear seams, flip triangles or erode open borders are not made.
+// Post-condition: Returns levelCount - 1 models, where each has at most triangleRatio times the triangles of the previous level.
+//   Quads are counted as two triangles and all simplified models consist of triangles.
+//   If no more edges can be collapsed, the remaining levels will get the same number of triangles.
+List<Model> simplifyModel(const ModelImpl &model, int32_t levelCount, float triangleRatio);
+
+}
+
+#endif
@@ -23,6 +23,8 @@
 
 #include <cassert>
 #include "renderCore.h"
+#include "../../api/imageAPI.h"
+#include "../../api/drawAPI.h"
 #include "../../base/virtualStack.h"
 #include "../../base/TemporaryCallback.h"
 #include "shader/RgbaMultiply.h"
@@ -446,14 +448,77 @@ void CommandQueue::add(const TriangleDrawCommand &command) {
 	this->buffer.push(command);
 }
 
-void CommandQueue::execute(const IRect &clipBound, int32_t jobCount) const {
-	if (jobCount <= 1) {
+bool TileClear::isActive() const {
+	return image_exists(this->colorBuffer) || image_exists(this->depthBuffer);
+}
+
+void TileClear::clearRegion(const IRect &region) const {
+	if (image_exists(this->colorBuffer)) {
+		draw_rectangle(this->colorBuffer, region, this->color);
+	}
+	if (image_exists(this->depthBuffer)) {
+		draw_rectangle(this->depthBuffer, region, this->depth);
+	}
+}
+
+// Small enough for a tile of color and depth pixels to remain in the cache while drawing the first triangle.
+static const int32_t clearTileWidth = 64;
+static const int32_t clearTileHeight = 16;
+
+// Draws all visible triangles in the queue within region, using a single thread.
+// If tileClear is active, each tile is cleared before the first triangle touching it, so that pixels are still in the cache when drawn to.
+static void executeRegion(const List<TriangleDrawCommand> &buffer, const IRect &region, const TileClear &tileClear) {
+	if (tileClear.isActive() && region.hasArea()) {
+		int32_t tileCountX = (region.width() + (clearTileWidth - 1)) / clearTileWidth;
+		int32_t tileCountY = (region.height() + (clearTileHeight - 1)) / clearTileHeight;
+		VirtualStackAllocation<bool> cleared(tileCountX * tileCountY, "Tile clear flags in CommandQueue::execute");
+		safeMemorySet(cleared, 0, tileCountX * tileCountY * sizeof(bool));
+		auto clearTiles = [&region, &tileClear, &cleared, tileCountX](const IRect &tileBound) {
+			for (int32_t tileY = tileBound.top(); tileY < tileBound.bottom(); tileY++) {
+				for (int32_t tileX = tileBound.left(); tileX < tileBound.right(); tileX++) {
+					bool &tileCleared = cleared[tileX + tileY * tileCountX];
+					if (!tileCleared) {
+						IRect tileRegion = IRect(region.left() + tileX * clearTileWidth, region.top() + tileY * clearTileHeight, clearTileWidth, clearTileHeight);
+						tileClear.clearRegion(IRect::cut(tileRegion, region));
+						tileCleared = true;
+					}
+				}
+			}
+		};
+		for (int32_t i = 0; i < buffer.length(); i++) {
+			if (!buffer[i].occluded) {
+				// Clear all tiles that the triangle's bound touches before drawing it.
+				//   Expanded to whole 2x2 pixel quads, because the rasterizer aligns rows to quads.
+				IRect triangleBound = buffer[i].triangle.wholeBound;
+				int32_t left = roundDown(triangleBound.left(), alignX);
+				int32_t top = roundDown(triangleBound.top(), alignY);
+				IRect quadBound = IRect(left, top, roundUp(triangleBound.right(), alignX) - left, roundUp(triangleBound.bottom(), alignY) - top);
+				IRect drawnBound = IRect::cut(IRect::cut(quadBound, buffer[i].clipBound), region);
+				if (drawnBound.hasArea()) {
+					int32_t minTileX = (drawnBound.left() - region.left()) / clearTileWidth;
+					int32_t minTileY = (drawnBound.top() - region.top()) / clearTileHeight;
+					int32_t maxTileX = (drawnBound.right() - 1 - region.left()) / clearTileWidth + 1;
+					int32_t maxTileY = (drawnBound.bottom() - 1 - region.top()) / clearTileHeight + 1;
+					clearTiles(IRect(minTileX, minTileY, maxTileX - minTileX, maxTileY - minTileY));
+					executeTriangleDrawing(buffer[i], region);
+				}
+			}
+		}
+		// Resolve tiles that no triangle touched.
+		clearTiles(IRect(0, 0, tileCountX, tileCountY));
+	} else {
 		// TODO: Make a setting for sorting triangles using indices within each job
-		for (int32_t i = 0; i < this->buffer.length(); i++) {
-			if (!this->buffer[i].occluded) {
-				executeTriangleDrawing(this->buffer[i], clipBound);
+		for (int32_t i = 0; i < buffer.length(); i++) {
+			if (!buffer[i].occluded) {
+				executeTriangleDrawing(buffer[i], region);
 			}
 		}
+	}
+}
+
+void CommandQueue::execute(const IRect &clipBound, int32_t jobCount, const TileClear &tileClear) const {
+	if (jobCount <= 1) {
+		executeRegion(this->buffer, clipBound, tileClear);
 	} else {
 		// Split the target region for multiple threads, with one slice per job.
 		VirtualStackAllocation<IRect> regions(jobCount, "Multi-threaded target pixel regions in CommandQueue::execute");
@@ -468,13 +533,9 @@ void CommandQueue::execute(const IRect &clipBound, int32_t jobCount) const {
 			regions[j] = IRect(clipBound.left(), y1, clipBound.width(), height);
 			y1 = y2;
 		}
-		threadedWorkByIndex([&regions](void *context, int32_t jobIndex) {
+		threadedWorkByIndex([&regions, &tileClear](void *context, int32_t jobIndex) {
 			CommandQueue *commandQueue = (CommandQueue*)context;
-			for (int32_t i = 0; i < commandQueue->buffer.length(); i++) {
-				if (!commandQueue->buffer[i].occluded) {
-					executeTriangleDrawing(commandQueue->buffer[i], regions[jobIndex]);
-				}
-			}
+			executeRegion(commandQueue->buffer, regions[jobIndex], tileClear);
 		}, (void*)this, jobCount);
 	}
 }
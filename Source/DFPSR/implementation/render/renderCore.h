@@ -26,6 +26,7 @@
 
 #include <cstdint>
 #include "Camera.h"
+#include "../image/Color.h"
 #include "shader/Shader.h"
 #include "../../base/threading.h"
 #include "../../collection/List.h"
@@ -80,13 +81,32 @@ Visibility getTriangleVisibility(const ITriangle2D &triangle, const Camera &came
 // Draws according to a draw command.
 void executeTriangleDrawing(const TriangleDrawCommand &command, const IRect &clipBound);
 
+// Deferred clearing of target images, so that each tile is cleared by the thread drawing to it, right before the first triangle touching the tile.
+//   Tiles that no triangle touches are cleared at the end of the job, which gives the same result as filling the whole images before drawing.
+struct TileClear {
+	// Cleared to color if the image exists.
+	ImageRgbaU8 colorBuffer;
+	ColorRgbaI32 color;
+	// Cleared to depth if the image exists.
+	ImageF32 depthBuffer;
+	float depth = 0.0f;
+	TileClear() {}
+	TileClear(const ImageRgbaU8 &colorBuffer, const ColorRgbaI32 &color, const ImageF32 &depthBuffer, float depth)
+	: colorBuffer(colorBuffer), color(color), depthBuffer(depthBuffer), depth(depth) {}
+	// Returns true iff any image will be cleared.
+	bool isActive() const;
+	// Side-effect: Fills region in the existing images with the clear values.
+	void clearRegion(const IRect &region) const;
+};
+
 // A queue of draw commands
 class CommandQueue {
 public:
 	List<TriangleDrawCommand> buffer;
 	void add(const TriangleDrawCommand &command);
 	// Multi-threading will be disabled if jobCount equals 1.
-	void execute(const IRect &clipBound, int32_t jobCount = 12) const;
+	// If tileClear is active, its images will be cleared one tile at a time right before being drawn to.
+	void execute(const IRect &clipBound, int32_t jobCount = 12, const TileClear &tileClear = TileClear()) const;
 	void clear();
 };
 
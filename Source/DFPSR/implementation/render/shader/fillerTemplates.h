@@ -173,6 +173,12 @@ inline void fillQuadSuper(void *data, PixelShadingCallback pixelShaderFunction,
 				Rgba_F32<U32x4, F32x4> planarTargetColor(packedTargetColor, targetPackingOrder);
 				// Blend linearly using floats
 				planarSourceColor = (planarSourceColor * opacity) + (planarTargetColor * (1.0f - opacity));
+			} else if (FILTER == Filter::AlphaPremultiplied) {
+				// The source color is already multiplied by its opacity, so only the target needs to be multiplied
+				F32x4 targetRatio = 1.0f - planarSourceColor.alpha * (1.0f / 255.0f);
+				U32x4 packedTargetColor = clippedRead<CLIP_SIDES>(pixelDataUpper, pixelDataLower, vis0, vis1, vis2, vis3);
+				Rgba_F32<U32x4, F32x4> planarTargetColor(packedTargetColor, targetPackingOrder);
+				planarSourceColor = planarSourceColor + (planarTargetColor * targetRatio);
 			}
 			// Apply channel swapping while packing to bytes
 			packedColor = planarSourceColor.toSaturatedByte(targetPackingOrder);
@@ -192,6 +198,7 @@ inline void fillQuadSuper(void *data, PixelShadingCallback pixelShaderFunction,
 // DEPTH_READ can be disabled to draw without caring if there is something already closer in the depth buffer.
 // DEPTH_WRITE can be disabled to skip writing to the depth buffer so that it does not occlude following draw calls.
 // FILTER can be set to Filter::Alpha to use the output alpha as the opacity.
+//   Filter::AlphaPremultiplied also uses the output alpha as the opacity, but expects the output colors to already be multiplied by it.
 template<bool CLIP_SIDES, bool COLOR_WRITE, bool DEPTH_READ, bool DEPTH_WRITE, Filter FILTER, bool AFFINE>
 inline void fillRowSuper(void *data, PixelShadingCallback pixelShaderFunction, SafePointer<uint32_t> pixelDataUpper, SafePointer<uint32_t> pixelDataLower, SafePointer<float> depthDataUpper, SafePointer<float> depthDataLower, FVector3D pWeightUpper, FVector3D pWeightLower, const FVector3D &pWeightDx, int32_t startX, int32_t endX, const RowInterval &upperRow, const RowInterval &lowerRow, const PackOrder &targetPackingOrder) {
 	if (AFFINE) {
@@ -390,7 +397,10 @@ static inline void fillShape(void *data, PixelShadingCallback pixelShaderFunctio
 	if (projection.affine) {
 		if (hasDepthBuffer) {
 			if (hasColorBuffer) {
-				if (filter != Filter::Solid) {
+				if (filter == Filter::AlphaPremultiplied) {
+					// Premultiplied alpha filtering with read only depth buffer
+					fillShapeSuper<true, true, false, Filter::AlphaPremultiplied, true>(data, pixelShaderFunction, colorBuffer, depthBuffer, triangle, projection, shape);
+				} else if (filter != Filter::Solid) {
 					// Alpha filtering with read only depth buffer
 					fillShapeSuper<true, true, false, Filter::Alpha, true>(data, pixelShaderFunction, colorBuffer, depthBuffer, triangle, projection, shape);
 				} else {
@@ -403,7 +413,10 @@ static inline void fillShape(void *data, PixelShadingCallback pixelShaderFunctio
 			}
 		} else {
 			if (hasColorBuffer) {
-				if (filter != Filter::Solid) {
+				if (filter == Filter::AlphaPremultiplied) {
+					// Premultiplied alpha filtering without depth buffer
+					fillShapeSuper<true, false, false, Filter::AlphaPremultiplied, true>(data, pixelShaderFunction, colorBuffer, ImageF32(), triangle, projection, shape);
+				} else if (filter != Filter::Solid) {
 					// Alpha filtering without depth buffer
 					fillShapeSuper<true, false, false, Filter::Alpha, true>(data, pixelShaderFunction, colorBuffer, ImageF32(), triangle, projection, shape);
 				} else {
@@ -415,7 +428,10 @@ static inline void fillShape(void *data, PixelShadingCallback pixelShaderFunctio
 	} else {
 		if (hasDepthBuffer) {
 			if (hasColorBuffer) {
-				if (filter != Filter::Solid) {
+				if (filter == Filter::AlphaPremultiplied) {
+					// Premultiplied alpha filtering with read only depth buffer
+					fillShapeSuper<true, true, false, Filter::AlphaPremultiplied, false>(data, pixelShaderFunction, colorBuffer, depthBuffer, triangle, projection, shape);
+				} else if (filter != Filter::Solid) {
 					// Alpha filtering with read only depth buffer
 					fillShapeSuper<true, true, false, Filter::Alpha, false>(data, pixelShaderFunction, colorBuffer, depthBuffer, triangle, projection, shape);
 				} else {
@@ -428,7 +444,10 @@ static inline void fillShape(void *data, PixelShadingCallback pixelShaderFunctio
 			}
 		} else {
 			if (hasColorBuffer) {
-				if (filter != Filter::Solid) {
+				if (filter == Filter::AlphaPremultiplied) {
+					// Premultiplied alpha filtering without depth buffer
+					fillShapeSuper<true, false, false, Filter::AlphaPremultiplied, false>(data, pixelShaderFunction, colorBuffer, ImageF32(), triangle, projection, shape);
+				} else if (filter != Filter::Solid) {
 					// Alpha filtering without depth buffer
 					fillShapeSuper<true, false, false, Filter::Alpha, false>(data, pixelShaderFunction, colorBuffer, ImageF32(), triangle, projection, shape);
 				} else {
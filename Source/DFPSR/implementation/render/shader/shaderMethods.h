@@ -58,31 +58,51 @@ namespace shaderMethods {
 	//       For the majority of textures that are square, SQUARE can be true.
 	template<
 	  Interpolation INTERPOLATION,
-	  bool SQUARE = false,
-	  bool SINGLE_LAYER = false,
-	  bool XY_INSIDE = false,
-	  bool HIGHEST_RESOLUTION = false
+	  bool SQUARE,
+	  bool SINGLE_LAYER,
+	  bool HIGHEST_RESOLUTION,
+	  bool TILED,
+	  bool COMPRESSED
 	>
-	inline U32x4 sample_U32(const TextureRgbaU8 &source, const F32x4 &u, const F32x4 &v) {
+	inline U32x4 sample_U32_layout(const TextureRgbaU8 &source, const F32x4 &u, const F32x4 &v) {
 		// Because constant level 0 and the result of texture_getMipLevelIndex will be within bound, we can assume that the MIP level is inside and set MIP_INSIDE to true.
 		if (INTERPOLATION == Interpolation::NN) {
 			if (HIGHEST_RESOLUTION) {
-				return texture_sample_nearest<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION>(source, u, v, 0u);
+				return texture_sample_nearest<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION, TILED, COMPRESSED>(source, u, v, 0u);
 			} else {
 				// TODO: Calculate MIP levels using a separate rendering stage with sparse resolution writing results into thread-local memory.
 				uint32_t mipLevel = texture_getMipLevelIndex<F32x4>(source, u, v);
-				return texture_sample_nearest<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION>(source, u, v, mipLevel);
+				return texture_sample_nearest<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION, TILED, COMPRESSED>(source, u, v, mipLevel);
 			}
 		} else {
 			if (HIGHEST_RESOLUTION) {
-				return texture_sample_bilinear<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION>(source, u, v, 0u);
+				return texture_sample_bilinear<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION, TILED, COMPRESSED>(source, u, v, 0u);
 			} else {
 				uint32_t mipLevel = texture_getMipLevelIndex<F32x4>(source, u, v);
-				return texture_sample_bilinear<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION>(source, u, v, mipLevel);
+				return texture_sample_bilinear<SQUARE, SINGLE_LAYER, true, HIGHEST_RESOLUTION, TILED, COMPRESSED>(source, u, v, mipLevel);
 			}
 		}
 	}
 
+	template<
+	  Interpolation INTERPOLATION,
+	  bool SQUARE = false,
+	  bool SINGLE_LAYER = false,
+	  bool XY_INSIDE = false,
+	  bool HIGHEST_RESOLUTION = false
+	>
+	inline U32x4 sample_U32(const TextureRgbaU8 &source, const F32x4 &u, const F32x4 &v) {
+		// The layout is selected in runtime instead of generating more shaders, because the branch will go the same way for the whole triangle.
+		//   Compressed textures are decoded while sampling, so that they can be used directly by shaders without being expanded in memory.
+		if (texture_isCompressed(source)) {
+			return sample_U32_layout<INTERPOLATION, SQUARE, SINGLE_LAYER, HIGHEST_RESOLUTION, true, true>(source, u, v);
+		} else if (texture_isTiled(source)) {
+			return sample_U32_layout<INTERPOLATION, SQUARE, SINGLE_LAYER, HIGHEST_RESOLUTION, true, false>(source, u, v);
+		} else {
+			return sample_U32_layout<INTERPOLATION, SQUARE, SINGLE_LAYER, HIGHEST_RESOLUTION, false, false>(source, u, v);
+		}
+	}
+
 	template<Interpolation INTERPOLATION,
 	  bool SQUARE = false,
 	  bool SINGLE_LAYER = false,
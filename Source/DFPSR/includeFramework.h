@@ -15,8 +15,11 @@
 	#include "api/textureAPI.h" // Creating textures and sampling pixels
 	#include "api/drawAPI.h" // Efficient drawing on images
 	#include "api/filterAPI.h" // Efficient image generation, resizing and filtering
+	#include "api/imageExpressionAPI.h" // Fusing chains of image operations into a single pass
+	#include "api/tiledImageAPI.h" // Processing images larger than memory as tiles stored in a file
 	// 3D API
 	#include "api/modelAPI.h" // Polygon models for 3D rendering
+	#include "api/sceneAPI.h" // Culling large worlds of model instances using a bounding volume hierarchy
 	// GUI API
 	#include "api/guiAPI.h" // Handling windows, interfaces and components
 	#include "api/mediaMachineAPI.h" // A machine for running image functions
@@ -92,6 +92,9 @@
 					#ifdef __AVX2__
 						#define USE_AVX2 // Comment out this line to test without AVX2
 					#endif
+					#ifdef __F16C__
+						#define USE_F16C // Comment out this line to test without F16C
+					#endif
 				#endif
 			#endif
 		#endif
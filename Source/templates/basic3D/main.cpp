@@ -105,10 +105,6 @@ void dsrMain(List<String> args) {
 		int targetWidth = image_getWidth(colorBuffer);
 		int targetHeight = image_getHeight(colorBuffer);
 
-		// Paint the background color
-		image_fill(colorBuffer, ColorRgbaI32(0, 0, 0, 0));
-		image_fill(depthBuffer, 0.0f); // Infinite reciprocal depth using zero
-
 		// Create a camera
 		const float distance = 1.3f;
 		const float height = 1.0f;
@@ -119,7 +115,8 @@ void dsrMain(List<String> args) {
 		Camera camera = Camera::createPerspective(Transform3D(cameraPosition, cameraRotation), targetWidth, targetHeight);
 
 		// Render
-		renderer_begin(worker, colorBuffer, depthBuffer);
+		// Clear the background color and use infinite reciprocal depth using zero, one tile at a time while rendering
+		renderer_begin(worker, colorBuffer, depthBuffer, ColorRgbaI32(0, 0, 0, 0), 0.0f);
 		renderer_giveTask(worker, cubeModel, Transform3D(), camera);
 		renderer_end(worker);
 
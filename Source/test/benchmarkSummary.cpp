@@ -0,0 +1,33 @@
+﻿
+// Called after the benchmarks have been built and executed, to show which settings the numbers were measured with.
+
+#include "../DFPSR/includeEssentials.h"
+#include "../DFPSR/base/threading.h"
+#include "../DFPSR/settings.h"
+
+using namespace dsr;
+
+DSR_MAIN_CALLER(dsrMain)
+void dsrMain(List<String> args) {
+	String extensions;
+	#ifdef USE_SSE2
+		string_append(extensions, U" SSE2");
+	#endif
+	#ifdef USE_SSSE3
+		string_append(extensions, U" SSSE3");
+	#endif
+	#ifdef USE_AVX
+		string_append(extensions, U" AVX");
+	#endif
+	#ifdef USE_AVX2
+		string_append(extensions, U" AVX2");
+	#endif
+	#ifdef USE_NEON
+		string_append(extensions, U" NEON");
+	#endif
+	if (string_length(extensions) == 0) {
+		string_append(extensions, U" none");
+	}
+	printText(U"Benchmarks were measured using the SIMD extensions:", extensions, U"\n");
+	printText(U"Benchmarks were measured using ", getThreadCount(), U" threads.\n");
+}
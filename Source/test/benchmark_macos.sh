@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# This script can be called from any path, as long as the first argument sais where this script is located.
+
+TEST_FOLDER=`dirname "$(realpath $0)"`
+echo TEST_FOLDER = "${TEST_FOLDER}"
+
+PROJECT_BUILD_SCRIPT="${TEST_FOLDER}/../tools/builder/buildProject.sh"
+echo PROJECT_BUILD_SCRIPT = "${PROJECT_BUILD_SCRIPT}"
+
+PROJECT_FILE="${TEST_FOLDER}/Benchmarks.DsrProj"
+echo PROJECT_FILE = "${PROJECT_FILE}"
+
+# Give execution rights.
+chmod +x "${PROJECT_BUILD_SCRIPT}";
+
+# Build and run all benchmarks.
+"${PROJECT_BUILD_SCRIPT}" "${PROJECT_FILE}" MacOS $@;
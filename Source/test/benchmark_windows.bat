@@ -0,0 +1,18 @@
+@echo off
+
+rem This script can be called from any path, as long as the first argument sais where this script is located.
+
+echo Starting benchmarks on MS-Windows.
+
+rem Get the test folder's path from the called path.
+set TEST_FOLDER=%~dp0
+echo TEST_FOLDER = %TEST_FOLDER%
+
+set PROJECT_BUILD_SCRIPT=%TEST_FOLDER%..\tools\builder\buildProject.bat
+echo PROJECT_BUILD_SCRIPT = %PROJECT_BUILD_SCRIPT%
+
+set PROJECT_FILE=%TEST_FOLDER%Benchmarks.DsrProj
+echo PROJECT_FILE = %PROJECT_FILE%
+
+rem Build and run all benchmarks.
+call "%PROJECT_BUILD_SCRIPT%" "%PROJECT_FILE%" Windows %@%
@@ -0,0 +1,77 @@
+﻿
+// Comparing the speed of converting between pack orders in draw_copy with repacking one pixel at a time.
+//   Converting to the window's native pack order happens for every frame, and images are converted after loading.
+
+#include "../../DFPSR/includeEssentials.h"
+#include "../../DFPSR/api/timeAPI.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/drawAPI.h"
+#include "../../DFPSR/api/randomAPI.h"
+#include "../../DFPSR/implementation/image/PackOrder.h"
+
+using namespace dsr;
+
+static const int32_t width = 1920;
+static const int32_t height = 1080;
+static const int32_t repetitions = 16;
+
+// The reference implementation, moving each channel by itself with indices looked up from the pack orders.
+static void repackPixels(const ImageRgbaU8 &target, const ImageRgbaU8 &source) {
+	PackOrder targetPackOrder = image_getPackOrder(target);
+	PackOrder sourcePackOrder = image_getPackOrder(source);
+	for (int32_t y = 0; y < height; y++) {
+		SafePointer<uint8_t> targetRow = image_getSafePointer<uint8_t>(target, y);
+		SafePointer<const uint8_t> sourceRow = image_getSafePointer<uint8_t>(source, y);
+		uint8_t *targetPixel = targetRow.getUnsafe();
+		const uint8_t *sourcePixel = sourceRow.getUnsafe();
+		for (int32_t x = 0; x < width; x++) {
+			targetPixel[targetPackOrder.redIndex]   = sourcePixel[sourcePackOrder.redIndex];
+			targetPixel[targetPackOrder.greenIndex] = sourcePixel[sourcePackOrder.greenIndex];
+			targetPixel[targetPackOrder.blueIndex]  = sourcePixel[sourcePackOrder.blueIndex];
+			targetPixel[targetPackOrder.alphaIndex] = sourcePixel[sourcePackOrder.alphaIndex];
+			targetPixel += 4;
+			sourcePixel += 4;
+		}
+	}
+}
+
+static void compareConversions(const ImageRgbaU8 &source, PackOrderIndex targetPackOrderIndex) {
+	ImageRgbaU8 referenceTarget = image_create_RgbaU8_native(width, height, targetPackOrderIndex);
+	ImageRgbaU8 singleTarget = image_create_RgbaU8_native(width, height, targetPackOrderIndex);
+	ImageRgbaU8 threadedTarget = image_create_RgbaU8_native(width, height, targetPackOrderIndex);
+	double referenceTime = 0.0, singleTime = 0.0, threadedTime = 0.0;
+	for (int32_t r = 0; r < repetitions; r++) {
+		double startTime = time_getSeconds();
+		repackPixels(referenceTarget, source);
+		double referenceEndTime = time_getSeconds();
+		draw_copy_singleThreaded(singleTarget, source);
+		double singleEndTime = time_getSeconds();
+		draw_copy(threadedTarget, source);
+		double threadedEndTime = time_getSeconds();
+		referenceTime += referenceEndTime - startTime;
+		singleTime += singleEndTime - referenceEndTime;
+		threadedTime += threadedEndTime - singleEndTime;
+	}
+	printText(image_getPackOrderIndex(source), U" to ", targetPackOrderIndex, U":\n");
+	printText(U"  One pixel at a time:          ", referenceTime * 1000.0 / repetitions, U" ms\n");
+	printText(U"  draw_copy on a single thread: ", singleTime * 1000.0 / repetitions, U" ms (", referenceTime / singleTime, U" times as fast)\n");
+	printText(U"  draw_copy on multiple threads: ", threadedTime * 1000.0 / repetitions, U" ms (", referenceTime / threadedTime, U" times as fast)\n");
+	if (image_maxDifference(referenceTarget, singleTarget) != 0 || image_maxDifference(referenceTarget, threadedTarget) != 0) {
+		printText(U"  The conversions gave different results!\n");
+	}
+}
+
+DSR_MAIN_CALLER(dsrMain)
+void dsrMain(List<String> args) {
+	RandomGenerator generator = random_createGenerator(4321);
+	ImageRgbaU8 source = image_create_RgbaU8(width, height);
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			image_writePixel(source, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255)));
+		}
+	}
+	printText(U"Converting ", width, U"x", height, U" pixels between pack orders.\n");
+	compareConversions(source, PackOrderIndex::BGRA);
+	compareConversions(source, PackOrderIndex::ARGB);
+	compareConversions(source, PackOrderIndex::ABGR);
+}
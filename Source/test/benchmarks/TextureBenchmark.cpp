@@ -0,0 +1,131 @@
+﻿
+// Comparing the speed of sampling textures with pixels stored in rows and in tiles.
+//   Textures stored in rows are fast to sample along rows, but a rotated or minified surface touches a new cache line for almost every sample.
+//   Tiled textures keep 4x4 pixels in each cache line, so that neighbor samples in any direction are likely to share cache lines.
+
+#include "../../DFPSR/includeEssentials.h"
+#include "../../DFPSR/api/timeAPI.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/textureAPI.h"
+#include "../../DFPSR/api/randomAPI.h"
+#include "../../DFPSR/base/simd.h"
+#include <cmath>
+
+using namespace dsr;
+
+static const int32_t textureSize = 2048;
+static const int32_t targetSize = 1024;
+static const int32_t repetitions = 4;
+
+// Samples a square of targetSize x targetSize pixels from texture, rotated by angle and scaled by scale texture widths per pixel.
+template <bool TILED, bool COMPRESSED = false>
+static uint32_t sampleRotated(const TextureRgbaU8 &texture, float angle, float scale, uint32_t mipLevel) {
+	float dUdX = cos(angle) * scale;
+	float dVdX = sin(angle) * scale;
+	float dUdY = -dVdX;
+	float dVdY = dUdX;
+	U32x4 checksum = U32x4(0u);
+	for (int32_t y = 0; y < targetSize; y++) {
+		F32x4 u = F32x4(0.0f, dUdX, dUdX * 2.0f, dUdX * 3.0f) + dUdY * float(y) + 0.5f;
+		F32x4 v = F32x4(0.0f, dVdX, dVdX * 2.0f, dVdX * 3.0f) + dVdY * float(y) + 0.5f;
+		for (int32_t x = 0; x < targetSize; x += 4) {
+			checksum = checksum ^ texture_sample_bilinear<true, false, true, false, TILED, COMPRESSED>(texture, u, v, mipLevel);
+			u = u + dUdX * 4.0f;
+			v = v + dVdX * 4.0f;
+		}
+	}
+	UVector4D lanes = checksum.get();
+	return lanes.x ^ lanes.y ^ lanes.z ^ lanes.w;
+}
+
+static void compareLayouts(const TextureRgbaU8 &rowTexture, const TextureRgbaU8 &tiledTexture, const ReadableString &name, float angle, float scale, uint32_t mipLevel) {
+	uint32_t rowChecksum = 0u, tiledChecksum = 0u;
+	double rowTime = 0.0, tiledTime = 0.0;
+	for (int32_t r = 0; r < repetitions; r++) {
+		double startTime = time_getSeconds();
+		rowChecksum = sampleRotated<false>(rowTexture, angle, scale, mipLevel);
+		double middleTime = time_getSeconds();
+		tiledChecksum = sampleRotated<true>(tiledTexture, angle, scale, mipLevel);
+		double endTime = time_getSeconds();
+		rowTime += middleTime - startTime;
+		tiledTime += endTime - middleTime;
+	}
+	printText(name, U":\n");
+	printText(U"  Rows:  ", rowTime * 1000.0 / repetitions, U" ms\n");
+	printText(U"  Tiles: ", tiledTime * 1000.0 / repetitions, U" ms (", rowTime / tiledTime, U" times as fast)\n");
+	if (rowChecksum != tiledChecksum) {
+		printText(U"  The layouts gave different results!\n");
+	}
+}
+
+// Compressed textures need three memory reads per pixel instead of one, but use 5.33 times less memory.
+static void compareCompression(const TextureRgbaU8 &tiledTexture, const TextureRgbaU8 &compressedTexture, const ReadableString &name, float angle, float scale, uint32_t mipLevel) {
+	uint32_t tiledChecksum = 0u, compressedChecksum = 0u;
+	double tiledTime = 0.0, compressedTime = 0.0;
+	for (int32_t r = 0; r < repetitions; r++) {
+		double startTime = time_getSeconds();
+		tiledChecksum = sampleRotated<true>(tiledTexture, angle, scale, mipLevel);
+		double middleTime = time_getSeconds();
+		compressedChecksum = sampleRotated<true, true>(compressedTexture, angle, scale, mipLevel);
+		double endTime = time_getSeconds();
+		tiledTime += middleTime - startTime;
+		compressedTime += endTime - middleTime;
+	}
+	printText(name, U":\n");
+	printText(U"  Tiles:      ", tiledTime * 1000.0 / repetitions, U" ms using ", buffer_getSize(tiledTexture.impl_buffer), U" bytes\n");
+	printText(U"  Compressed: ", compressedTime * 1000.0 / repetitions, U" ms using ", buffer_getSize(compressedTexture.impl_buffer), U" bytes (", tiledTime / compressedTime, U" times as fast)\n");
+	if (tiledChecksum == compressedChecksum) {
+		printText(U"  The compression was lossless for this texture.\n");
+	}
+}
+
+// Measures the time to generate all lower resolutions from the highest resolution.
+static void measurePyramids(const TextureRgbaU8 &rowTexture, const TextureRgbaU8 &tiledTexture, const List<TextureRgbaU8> &smallTextures) {
+	double rowTime = 0.0, tiledTime = 0.0, batchTime = 0.0;
+	for (int32_t r = 0; r < repetitions; r++) {
+		double startTime = time_getSeconds();
+		texture_generatePyramid(rowTexture);
+		double rowEndTime = time_getSeconds();
+		texture_generatePyramid(tiledTexture);
+		double tiledEndTime = time_getSeconds();
+		texture_generatePyramids(smallTextures);
+		double batchEndTime = time_getSeconds();
+		rowTime += rowEndTime - startTime;
+		tiledTime += tiledEndTime - rowEndTime;
+		batchTime += batchEndTime - tiledEndTime;
+	}
+	printText(U"Generating mip levels:\n");
+	printText(U"  ", textureSize, U"x", textureSize, U" texture with rows:  ", rowTime * 1000.0 / repetitions, U" ms\n");
+	printText(U"  ", textureSize, U"x", textureSize, U" texture with tiles: ", tiledTime * 1000.0 / repetitions, U" ms\n");
+	printText(U"  ", smallTextures.length(), U" textures of 256x256 pixels: ", batchTime * 1000.0 / repetitions, U" ms\n");
+}
+
+DSR_MAIN_CALLER(dsrMain)
+void dsrMain(List<String> args) {
+	// Random noise, so that neither layout can benefit from compression or similar pixels.
+	RandomGenerator generator = random_createGenerator(1234);
+	ImageRgbaU8 image = image_create_RgbaU8(textureSize, textureSize);
+	for (int32_t y = 0; y < textureSize; y++) {
+		for (int32_t x = 0; x < textureSize; x++) {
+			image_writePixel(image, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), 255));
+		}
+	}
+	TextureRgbaU8 rowTexture = texture_create_RgbaU8(image, 16);
+	TextureRgbaU8 tiledTexture = texture_create_RgbaU8(image, 16, true);
+	printText(U"Sampling ", targetSize, U"x", targetSize, U" pixels bi-linearly from a ", textureSize, U"x", textureSize, U" texture.\n");
+	float pixel = 1.0f / textureSize;
+	compareLayouts(rowTexture, tiledTexture, U"Aligned with rows at full resolution", 0.0f, pixel, 0u);
+	compareLayouts(rowTexture, tiledTexture, U"Rotated 90 degrees at full resolution", 1.5707963f, pixel, 0u);
+	compareLayouts(rowTexture, tiledTexture, U"Rotated 37 degrees at full resolution", 0.6457718f, pixel, 0u);
+	compareLayouts(rowTexture, tiledTexture, U"Rotated 37 degrees and magnified four times", 0.6457718f, pixel * 0.25f, 0u);
+	compareLayouts(rowTexture, tiledTexture, U"Rotated 37 degrees and minified to half without mip-mapping", 0.6457718f, pixel * 2.0f, 0u);
+	compareLayouts(rowTexture, tiledTexture, U"Rotated 37 degrees and minified to half with mip-mapping", 0.6457718f, pixel * 2.0f, 1u);
+	TextureRgbaU8 compressedTexture = texture_compress(tiledTexture);
+	compareCompression(tiledTexture, compressedTexture, U"Compressed and rotated 37 degrees at full resolution", 0.6457718f, pixel, 0u);
+	compareCompression(tiledTexture, compressedTexture, U"Compressed and rotated 37 degrees and minified to half with mip-mapping", 0.6457718f, pixel * 2.0f, 1u);
+	List<TextureRgbaU8> smallTextures;
+	for (int32_t t = 0; t < 256; t++) {
+		smallTextures.push(texture_create_RgbaU8(256, 256, 16));
+	}
+	measurePyramids(rowTexture, tiledTexture, smallTextures);
+}
@@ -194,6 +194,9 @@ START_TEST(BruteSimd)
 	#ifdef USE_AVX2
 		printText(U"	* AVX2\n");
 	#endif
+	#ifdef USE_F16C
+		printText(U"	* F16C\n");
+	#endif
 	#ifdef USE_NEON
 		printText(U"	* NEON\n");
 	#endif
@@ -2,6 +2,8 @@
 #include "../testTools.h"
 #include "../../DFPSR/api/imageAPI.h"
 #include "../../DFPSR/api/drawAPI.h"
+#include "../../DFPSR/api/filterAPI.h"
+#include "../../DFPSR/api/randomAPI.h"
 
 START_TEST(Draw)
 	// Resources
@@ -293,5 +295,370 @@ START_TEST(Draw)
 		)), 2);
 	}
 
+	{ // Multi-threaded drawing gives the same result as single-threaded drawing.
+		// Lowering the threshold makes sure that images are split into multiple jobs.
+		//   Each job gets at least 16384 / width rows, so each overlap is more than twice as tall to give at least two jobs.
+		int64_t oldThreshold = draw_getThreadingThreshold();
+		draw_setThreadingThreshold(0);
+		RandomGenerator generator = random_createGenerator(917);
+		ImageRgbaU8 background = image_create_RgbaU8(300, 600);
+		ImageRgbaU8 sprite = image_create_RgbaU8(270, 580);
+		ImageU8 mask = image_create_U8(270, 580);
+		ImageU16 backgroundHeight = image_create_U16(300, 600);
+		ImageU16 spriteHeight = image_create_U16(270, 580);
+		for (int32_t y = 0; y < 600; y++) {
+			for (int32_t x = 0; x < 300; x++) {
+				image_writePixel(background, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255)));
+				image_writePixel(backgroundHeight, x, y, random_generate_range(generator, 0, 1000));
+			}
+		}
+		for (int32_t y = 0; y < 580; y++) {
+			for (int32_t x = 0; x < 270; x++) {
+				image_writePixel(sprite, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255)));
+				image_writePixel(mask, x, y, random_generate_range(generator, 0, 255));
+				image_writePixel(spriteHeight, x, y, random_generate_range(generator, 0, 1000));
+			}
+		}
+		// Clipped at the right and bottom sides.
+		int32_t left = 40, top = 30;
+		ImageRgbaU8 threaded = image_clone(background);
+		ImageRgbaU8 single = image_clone(background);
+		draw_copy(threaded, sprite, left, top);
+		draw_copy_singleThreaded(single, sprite, left, top);
+		ASSERT_EQUAL(image_maxDifference(threaded, single), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(threaded, 100, 100), image_readPixel_clamp(sprite, 100 - left, 100 - top));
+		draw_alphaFilter(threaded, sprite, -left, -top);
+		draw_alphaFilter_singleThreaded(single, sprite, -left, -top);
+		ASSERT_EQUAL(image_maxDifference(threaded, single), 0);
+		draw_maxAlpha(threaded, sprite, left, -top, 12);
+		draw_maxAlpha_singleThreaded(single, sprite, left, -top, 12);
+		ASSERT_EQUAL(image_maxDifference(threaded, single), 0);
+		draw_alphaClip(threaded, sprite, -left, top, 100);
+		draw_alphaClip_singleThreaded(single, sprite, -left, top, 100);
+		ASSERT_EQUAL(image_maxDifference(threaded, single), 0);
+		draw_silhouette(threaded, mask, ColorRgbaI32(20, 200, 80, 180), left, top);
+		draw_silhouette_singleThreaded(single, mask, ColorRgbaI32(20, 200, 80, 180), left, top);
+		ASSERT_EQUAL(image_maxDifference(threaded, single), 0);
+		ImageU16 threadedHeight = image_clone(backgroundHeight);
+		ImageU16 singleHeight = image_clone(backgroundHeight);
+		draw_higher(threadedHeight, spriteHeight, threaded, sprite, left, top, 100);
+		draw_higher_singleThreaded(singleHeight, spriteHeight, single, sprite, left, top, 100);
+		ASSERT_EQUAL(image_maxDifference(threadedHeight, singleHeight), 0);
+		ASSERT_EQUAL(image_maxDifference(threaded, single), 0);
+		// The same result is given when the threshold is too high for threading.
+		draw_setThreadingThreshold(1000000);
+		ImageU8 copiedMask = image_create_U8(270, 580);
+		draw_copy(copiedMask, mask);
+		ASSERT_EQUAL(image_maxDifference(copiedMask, mask), 0);
+		draw_setThreadingThreshold(oldThreshold);
+		ASSERT_EQUAL(draw_getThreadingThreshold(), oldThreshold);
+	}
+
+	{ // Copying between all combinations of pack orders keeps the colors.
+		RandomGenerator generator = random_createGenerator(2468);
+		PackOrderIndex packOrders[4] = {PackOrderIndex::RGBA, PackOrderIndex::BGRA, PackOrderIndex::ARGB, PackOrderIndex::ABGR};
+		for (int32_t s = 0; s < 4; s++) {
+			// Odd widths to also repack pixels after the last whole SIMD vector in each row.
+			ImageRgbaU8 source = image_create_RgbaU8_native(53, 7, packOrders[s]);
+			for (int32_t y = 0; y < 7; y++) {
+				for (int32_t x = 0; x < 53; x++) {
+					image_writePixel(source, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255)));
+				}
+			}
+			for (int32_t t = 0; t < 4; t++) {
+				ImageRgbaU8 target = image_create_RgbaU8_native(53, 7, packOrders[t]);
+				draw_copy(target, source);
+				// Sub-images that do not start at aligned addresses.
+				ImageRgbaU8 shiftedTarget = image_create_RgbaU8_native(60, 9, packOrders[t]);
+				draw_copy(shiftedTarget, image_getSubImage(source, IRect(1, 1, 52, 6)), 3, 2);
+				ImageRgbaU8 sameShiftTarget = image_create_RgbaU8_native(60, 9, packOrders[t]);
+				draw_copy(image_getSubImage(sameShiftTarget, IRect(1, 0, 59, 9)), image_getSubImage(source, IRect(1, 0, 52, 7)));
+				for (int32_t y = 0; y < 7; y++) {
+					for (int32_t x = 0; x < 53; x++) {
+						ColorRgbaI32 expected = image_readPixel_clamp(source, x, y);
+						ASSERT_EQUAL(image_readPixel_clamp(target, x, y), expected);
+						if (x >= 1 && y >= 1) {
+							ASSERT_EQUAL(image_readPixel_clamp(shiftedTarget, x + 2, y + 1), expected);
+						}
+						if (x >= 1) {
+							ASSERT_EQUAL(image_readPixel_clamp(sameShiftTarget, x, y), expected);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	{ // Blending images with the same pack order gives the same result as blending between different pack orders.
+		RandomGenerator generator = random_createGenerator(4321);
+		// Odd sizes to also blend pixels after the last whole SIMD vector in each row.
+		ImageRgbaU8 source = image_create_RgbaU8(61, 37);
+		ImageRgbaU8 sameOrder = image_create_RgbaU8_native(67, 41, image_getPackOrderIndex(source));
+		ImageRgbaU8 otherOrder = image_create_RgbaU8_native(67, 41, image_getPackOrderIndex(source) == PackOrderIndex::BGRA ? PackOrderIndex::RGBA : PackOrderIndex::BGRA);
+		for (int32_t y = 0; y < 41; y++) {
+			for (int32_t x = 0; x < 67; x++) {
+				ColorRgbaI32 color = ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255));
+				image_writePixel(sameOrder, x, y, color);
+				image_writePixel(otherOrder, x, y, color);
+			}
+		}
+		for (int32_t y = 0; y < 37; y++) {
+			for (int32_t x = 0; x < 61; x++) {
+				// Rows of fully transparent and fully opaque pixels to test both blending and skipping.
+				int32_t alpha = random_generate_range(generator, 0, 255);
+				if (y % 4 == 1) { alpha = 0; }
+				if (y % 4 == 2) { alpha = 255; }
+				image_writePixel(source, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), alpha));
+			}
+		}
+		draw_alphaFilter(sameOrder, source, 3, 2);
+		draw_alphaFilter(otherOrder, source, 3, 2);
+		draw_maxAlpha(sameOrder, source, -5, 7);
+		draw_maxAlpha(otherOrder, source, -5, 7);
+		for (int32_t y = 0; y < 41; y++) {
+			for (int32_t x = 0; x < 67; x++) {
+				ASSERT_EQUAL(image_readPixel_clamp(sameOrder, x, y), image_readPixel_clamp(otherOrder, x, y));
+			}
+		}
+		// Blending half transparent pixels is bit-exact with the scalar reference.
+		ImageRgbaU8 target = image_create_RgbaU8(8, 1);
+		ImageRgbaU8 halfTransparent = image_create_RgbaU8(8, 1);
+		image_fill(target, ColorRgbaI32(200, 100, 50, 150));
+		image_fill(halfTransparent, ColorRgbaI32(10, 20, 255, 127));
+		draw_alphaFilter(target, halfTransparent);
+		ASSERT_EQUAL(image_readPixel_clamp(target, 7, 0), ColorRgbaI32(105, 60, 152, 202));
+	}
+	{ // Premultiplied alpha.
+		RandomGenerator generator = random_createGenerator(2468);
+		// Odd sizes to also blend pixels after the last whole SIMD vector in each row.
+		ImageRgbaU8 straight = image_create_RgbaU8(61, 37);
+		ImageRgbaU8 background = image_create_RgbaU8(67, 41);
+		for (int32_t y = 0; y < 41; y++) {
+			for (int32_t x = 0; x < 67; x++) {
+				image_writePixel(background, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), 255));
+			}
+		}
+		for (int32_t y = 0; y < 37; y++) {
+			for (int32_t x = 0; x < 61; x++) {
+				int32_t alpha = random_generate_range(generator, 0, 255);
+				if (y % 4 == 1) { alpha = 0; }
+				if (y % 4 == 2) { alpha = 255; }
+				image_writePixel(straight, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), alpha));
+			}
+		}
+		ASSERT(!image_isPremultiplied(straight));
+		AlignedImageRgbaU8 premultiplied = filter_premultiplyAlpha(straight);
+		ASSERT(image_isPremultiplied(premultiplied));
+		ASSERT(image_isPremultiplied(image_getSubImage(premultiplied, IRect(1, 2, 3, 4))));
+		ASSERT(!image_isPremultiplied(image_setPremultiplied(premultiplied, false)));
+		AlignedImageRgbaU8 straightened = filter_straightenAlpha(premultiplied);
+		ASSERT(!image_isPremultiplied(straightened));
+		for (int32_t y = 0; y < 37; y++) {
+			for (int32_t x = 0; x < 61; x++) {
+				ColorRgbaI32 original = image_readPixel_clamp(straight, x, y);
+				ColorRgbaI32 multiplied = image_readPixel_clamp(premultiplied, x, y);
+				ASSERT_EQUAL(multiplied.red, (original.red * original.alpha + 127) / 255);
+				ASSERT_EQUAL(multiplied.blue, (original.blue * original.alpha + 127) / 255);
+				ASSERT_EQUAL(multiplied.alpha, original.alpha);
+				// Only opaque enough pixels keep enough precision to restore the colors within one unit.
+				ColorRgbaI32 restored = image_readPixel_clamp(straightened, x, y);
+				if (original.alpha == 0) {
+					ASSERT_EQUAL(restored, ColorRgbaI32(0, 0, 0, 0));
+				} else if (original.alpha >= 128) {
+					ASSERT_LESSER_OR_EQUAL(abs(restored.green - original.green), 1);
+				}
+			}
+		}
+		// Blending premultiplied colors gives the same result as blending straight colors, except for rounding.
+		ImageRgbaU8 straightResult = image_clone(background);
+		ImageRgbaU8 premultipliedResult = image_clone(background);
+		ImageRgbaU8 dispatchedResult = image_clone(background);
+		ImageRgbaU8 otherOrderResult = image_create_RgbaU8_native(67, 41, image_getPackOrderIndex(background) == PackOrderIndex::BGRA ? PackOrderIndex::RGBA : PackOrderIndex::BGRA);
+		draw_copy(otherOrderResult, background);
+		ImageRgbaU8 singleThreadedResult = image_clone(background);
+		draw_alphaFilter(straightResult, straight, 3, 2);
+		draw_alphaFilter_premultiplied(premultipliedResult, premultiplied, 3, 2);
+		draw_alphaFilter(dispatchedResult, premultiplied, 3, 2);
+		draw_alphaFilter_premultiplied(otherOrderResult, premultiplied, 3, 2);
+		draw_alphaFilter_premultiplied_singleThreaded(singleThreadedResult, premultiplied, 3, 2);
+		ASSERT_LESSER_OR_EQUAL(image_maxDifference(straightResult, premultipliedResult), 1);
+		ASSERT_EQUAL(image_maxDifference(premultipliedResult, dispatchedResult), 0);
+		ASSERT_EQUAL(image_maxDifference(premultipliedResult, singleThreadedResult), 0);
+		// Copies and filtered images keep the premultiplied flag, so that draw_alphaFilter still blends them as premultiplied.
+		ASSERT(image_isPremultiplied(image_clone(premultiplied)));
+		ASSERT(image_isPremultiplied(image_removePadding(premultiplied)));
+		ASSERT(image_isPremultiplied(filter_resize(premultiplied, Sampler::Linear, 30, 20)));
+		ASSERT(image_isPremultiplied(filter_boxBlur(premultiplied, 1)));
+		ASSERT(!image_isPremultiplied(filter_boxBlur(straight, 1)));
+		ImageRgbaU8 clonedResult = image_clone(background);
+		draw_alphaFilter(clonedResult, image_clone(premultiplied), 3, 2);
+		ASSERT_EQUAL(image_maxDifference(clonedResult, premultipliedResult), 0);
+		AlignedImageRgbaU8 blurred = filter_gaussianBlur(premultiplied, 1.5f);
+		ImageRgbaU8 blurredResult = image_clone(background);
+		ImageRgbaU8 expectedBlurredResult = image_clone(background);
+		draw_alphaFilter(blurredResult, blurred, 3, 2);
+		draw_alphaFilter_premultiplied(expectedBlurredResult, blurred, 3, 2);
+		ASSERT_EQUAL(image_maxDifference(blurredResult, expectedBlurredResult), 0);
+		for (int32_t y = 0; y < 41; y++) {
+			for (int32_t x = 0; x < 67; x++) {
+				ASSERT_EQUAL(image_readPixel_clamp(premultipliedResult, x, y), image_readPixel_clamp(otherOrderResult, x, y));
+			}
+		}
+		// Transparent layers can be composed and then drawn to an opaque image.
+		ImageRgbaU8 layer = image_setPremultiplied(image_create_RgbaU8(8, 1), true);
+		ImageRgbaU8 halfTransparent = image_setPremultiplied(image_create_RgbaU8(8, 1), true);
+		image_fill(halfTransparent, ColorRgbaI32(100, 0, 50, 128));
+		draw_alphaFilter(layer, halfTransparent);
+		draw_alphaFilter(layer, halfTransparent);
+		ASSERT_EQUAL(image_readPixel_clamp(layer, 7, 0), ColorRgbaI32(150, 0, 75, 192));
+		ImageRgbaU8 opaque = image_create_RgbaU8(8, 1);
+		image_fill(opaque, ColorRgbaI32(0, 200, 0, 255));
+		draw_alphaFilter(opaque, layer);
+		ASSERT_EQUAL(image_readPixel_clamp(opaque, 7, 0), ColorRgbaI32(150, 49, 75, 255));
+	}
+	{ // Half precision conversions
+		// Odd widths and unaligned sub-images convert the remaining pixels without SIMD.
+		AlignedImageF32 floats = image_create_F32(45, 9);
+		for (int32_t y = 0; y < 9; y++) {
+			for (int32_t x = 0; x < 45; x++) {
+				image_writePixel(floats, x, y, (float(x) - 20.0f) * 7.3f + float(y) * 0.001f + float(x * y * y * 3));
+			}
+		}
+		ImageF32 floatRegion = image_getSubImage(floats, IRect(3, 1, 39, 7));
+		AlignedImageF16 halves = image_create_F16(41, 8);
+		ImageF16 halfRegion = image_getSubImage(halves, IRect(1, 1, 39, 7));
+		draw_copy(halfRegion, floatRegion);
+		bool allRounded = true;
+		for (int32_t y = 0; y < 7; y++) {
+			for (int32_t x = 0; x < 39; x++) {
+				if (image_accessPixel(halfRegion, x, y) != roundToF16(image_readPixel_clamp(floatRegion, x, y))) { allRounded = false; }
+			}
+		}
+		ASSERT(allRounded);
+		// Pixels outside of the sub-image are not touched.
+		ASSERT_EQUAL(image_readPixel_clamp(halves, 0, 3), 0.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(halves, 40, 3), 0.0f);
+		AlignedImageF32 restored = image_create_F32(39, 7);
+		draw_copy(restored, halfRegion);
+		bool allRestored = true;
+		for (int32_t y = 0; y < 7; y++) {
+			for (int32_t x = 0; x < 39; x++) {
+				if (image_readPixel_clamp(restored, x, y) != floatFromF16(image_accessPixel(halfRegion, x, y))) { allRestored = false; }
+			}
+		}
+		ASSERT(allRestored);
+		// Rounding to half precision again gives the same bits.
+		AlignedImageF16 halvesAgain = image_create_F16(39, 7);
+		draw_copy_singleThreaded(halvesAgain, restored);
+		ASSERT_EQUAL(image_maxDifference(halvesAgain, halfRegion), 0.0f);
+		// Bytes are exactly represented in half precision and saturated when converted back.
+		AlignedImageU8 bytes = image_create_U8(3, 1);
+		image_writePixel(bytes, 0, 0, 0);
+		image_writePixel(bytes, 1, 0, 127);
+		image_writePixel(bytes, 2, 0, 255);
+		AlignedImageF16 byteHalves = image_create_F16(3, 1);
+		draw_copy(byteHalves, bytes);
+		ASSERT_EQUAL(image_readPixel_clamp(byteHalves, 1, 0), 127.0f);
+		image_writePixel(byteHalves, 0, 0, -4.0f);
+		image_writePixel(byteHalves, 2, 0, 300.0f);
+		draw_copy(bytes, byteHalves);
+		ASSERT_EQUAL(image_readPixel_clamp(bytes, 0, 0), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(bytes, 1, 0), 127);
+		ASSERT_EQUAL(image_readPixel_clamp(bytes, 2, 0), 255);
+		AlignedImageRgbaU8 colors = image_create_RgbaU8(3, 1);
+		draw_copy(colors, byteHalves);
+		ASSERT_EQUAL(image_readPixel_clamp(colors, 1, 0), ColorRgbaI32(127, 127, 127, 255));
+		// Rectangles are rounded to half precision.
+		draw_rectangle(halves, IRect(-5, 2, 10, 3), 0.1f);
+		ASSERT_EQUAL(image_accessPixel(halves, 4, 4), roundToF16(0.1f));
+		ASSERT_EQUAL(image_readPixel_clamp(halves, 5, 4), image_readPixel_clamp(restored, 4, 3));
+	}
+	{ // Anti-aliased polygons
+		AlignedImageU8 mask = image_create_U8(10, 10);
+		// Pixel (x, y) covers the area from (x, y) to (x + 1, y + 1).
+		draw_polygon(mask, List<FVector2D>(FVector2D(1.0f, 1.0f), FVector2D(4.0f, 1.0f), FVector2D(4.0f, 3.0f), FVector2D(1.0f, 3.0f)), 200);
+		AlignedImageU8 expected = image_create_U8(10, 10);
+		draw_rectangle(expected, IRect(1, 1, 3, 2), 200);
+		ASSERT_EQUAL(image_maxDifference(mask, expected), 0);
+		// Half covered pixels are blended half way.
+		image_fill(mask, 0);
+		draw_polygon(mask, List<FVector2D>(FVector2D(0.0f, 0.0f), FVector2D(2.5f, 0.0f), FVector2D(2.5f, 1.0f), FVector2D(0.0f, 1.0f)), 200);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 1, 0), 200);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 2, 0), 100);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 3, 0), 0);
+		// The direction of the points does not matter for a single contour.
+		List<FVector2D> triangle = List<FVector2D>(FVector2D(0.5f, 0.2f), FVector2D(9.3f, 4.1f), FVector2D(2.2f, 8.7f));
+		image_fill(mask, 0);
+		draw_polygon(mask, triangle, 255);
+		image_fill(expected, 0);
+		draw_polygon(expected, List<FVector2D>(triangle[2], triangle[1], triangle[0]), 255);
+		ASSERT_EQUAL(image_maxDifference(mask, expected), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 3, 4), 255);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 9, 9), 0);
+		ASSERT(image_readPixel_clamp(mask, 0, 0) > 0 && image_readPixel_clamp(mask, 0, 0) < 255);
+		// Polygons outside of the image are clipped.
+		image_fill(mask, 0);
+		draw_polygon(mask, List<FVector2D>(FVector2D(-50.0f, -5.0f), FVector2D(15.0f, -5.0f), FVector2D(15.0f, 3000.0f), FVector2D(-50.0f, 15.0f)), 77);
+		image_fill(expected, 77);
+		ASSERT_EQUAL(image_maxDifference(mask, expected), 0);
+		draw_polygon(mask, List<FVector2D>(FVector2D(-5.0f, -5.0f), FVector2D(-1.0f, 2.0f), FVector2D(-3.0f, 20.0f)), 0);
+		draw_polygon(mask, List<FVector2D>(FVector2D(11.0f, -5.0f), FVector2D(15.0f, 2.0f), FVector2D(13.0f, 20.0f)), 0);
+		ASSERT_EQUAL(image_maxDifference(mask, expected), 0);
+		// Fill rules decide if overlapping contours in the same direction make a hole.
+		List<List<FVector2D>> frame = List<List<FVector2D>>(
+		  List<FVector2D>(FVector2D(0.0f, 0.0f), FVector2D(8.0f, 0.0f), FVector2D(8.0f, 8.0f), FVector2D(0.0f, 8.0f)),
+		  List<FVector2D>(FVector2D(2.0f, 2.0f), FVector2D(6.0f, 2.0f), FVector2D(6.0f, 6.0f), FVector2D(2.0f, 6.0f))
+		);
+		image_fill(mask, 0);
+		draw_polygons(mask, frame, 255, FillRule::NonZero);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 1, 1), 255);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 4, 4), 255);
+		image_fill(mask, 0);
+		draw_polygons(mask, frame, 255, FillRule::EvenOdd);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 1, 1), 255);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 4, 4), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 8, 8), 0);
+		// Opaque colors give the same result as draw_rectangle in any pack order.
+		AlignedImageRgbaU8 colors = image_create_RgbaU8_native(67, 5, PackOrderIndex::ARGB);
+		AlignedImageRgbaU8 expectedColors = image_create_RgbaU8_native(67, 5, PackOrderIndex::ARGB);
+		draw_polygon(image_getSubImage(colors, IRect(1, 1, 66, 3)), List<FVector2D>(FVector2D(2.0f, 0.0f), FVector2D(64.0f, 0.0f), FVector2D(64.0f, 2.0f), FVector2D(2.0f, 2.0f)), ColorRgbaI32(10, 20, 30, 255));
+		draw_rectangle(expectedColors, IRect(3, 1, 62, 2), ColorRgbaI32(10, 20, 30, 255));
+		ASSERT_EQUAL(image_maxDifference(colors, expectedColors), 0);
+		// Vectorized spans of partial coverage blend the same way as draw_alphaFilter.
+		for (int32_t y = 0; y < 5; y++) {
+			for (int32_t x = 0; x < 67; x++) {
+				ColorRgbaI32 background = ColorRgbaI32(x * 3, y * 50, 255 - x, (x * 7) % 256);
+				image_writePixel(colors, x, y, background);
+				image_writePixel(expectedColors, x, y, background);
+			}
+		}
+		draw_polygon(colors, List<FVector2D>(FVector2D(-1.0f, -1.0f), FVector2D(70.0f, -1.0f), FVector2D(70.0f, 7.0f), FVector2D(-1.0f, 7.0f)), ColorRgbaI32(200, 100, 50, 93));
+		AlignedImageRgbaU8 layer = image_create_RgbaU8_native(67, 5, PackOrderIndex::ARGB);
+		image_fill(layer, ColorRgbaI32(200, 100, 50, 93));
+		draw_alphaFilter(expectedColors, layer);
+		ASSERT_EQUAL(image_maxDifference(colors, expectedColors), 0);
+		// Lines crossing themselves are only drawn once.
+		AlignedImageRgbaU8 canvas = image_create_RgbaU8(12, 12);
+		draw_polyline(canvas, List<FVector2D>(FVector2D(1.0f, 5.0f), FVector2D(9.0f, 5.0f), FVector2D(9.0f, 9.0f), FVector2D(5.0f, 9.0f), FVector2D(5.0f, 1.0f)), 2.0f, ColorRgbaI32(255, 0, 0, 128));
+		ASSERT_EQUAL(image_readPixel_clamp(canvas, 3, 5), ColorRgbaI32(128, 0, 0, 128));
+		ASSERT_EQUAL(image_readPixel_clamp(canvas, 5, 5), ColorRgbaI32(128, 0, 0, 128));
+		ASSERT_EQUAL(image_readPixel_clamp(canvas, 5, 3), ColorRgbaI32(128, 0, 0, 128));
+		ASSERT_EQUAL(image_readPixel_clamp(canvas, 3, 3), ColorRgbaI32(0, 0, 0, 0));
+		ASSERT_EQUAL(image_readPixel_clamp(canvas, 11, 11), ColorRgbaI32(0, 0, 0, 0));
+		// Round ends reach thickness / 2 beyond the end points.
+		ASSERT(image_readPixel_clamp(canvas, 0, 5).alpha > 0);
+		// A single point is drawn as a dot, and a closed line connects back to the first point.
+		image_fill(mask, 0);
+		draw_polyline(mask, List<FVector2D>(FVector2D(5.0f, 5.0f)), 4.0f, 255);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 5, 5), 255);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 8, 5), 0);
+		List<FVector2D> corner = List<FVector2D>(FVector2D(1.0f, 1.0f), FVector2D(8.0f, 1.0f), FVector2D(8.0f, 8.0f));
+		image_fill(mask, 0);
+		draw_polyline(mask, corner, 1.0f, 255);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 4, 4), 0);
+		draw_polyline(mask, corner, 1.0f, 255, true);
+		ASSERT(image_readPixel_clamp(mask, 4, 4) > 200);
+		ASSERT_EQUAL(image_readPixel_clamp(mask, 6, 3), 0);
+	}
 END_TEST
 
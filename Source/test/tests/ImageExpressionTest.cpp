@@ -0,0 +1,118 @@
+﻿
+#include "../testTools.h"
+#include "../../DFPSR/api/imageExpressionAPI.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/drawAPI.h"
+#include "../../DFPSR/api/randomAPI.h"
+
+static OrderedImageRgbaU8 createNoise(int32_t width, int32_t height, int32_t seed) {
+	RandomGenerator generator = random_createGenerator(seed);
+	OrderedImageRgbaU8 result = image_create_RgbaU8(width, height);
+	for (int32_t y = 0; y < height; y++) {
+		for (int32_t x = 0; x < width; x++) {
+			image_writePixel(result, x, y, ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255)));
+		}
+	}
+	return result;
+}
+
+static bool imagesMatch(const ImageRgbaU8 &a, const ImageRgbaU8 &b) {
+	if (image_getWidth(a) != image_getWidth(b) || image_getHeight(a) != image_getHeight(b)) {
+		return false;
+	}
+	for (int32_t y = 0; y < image_getHeight(a); y++) {
+		for (int32_t x = 0; x < image_getWidth(a); x++) {
+			if (image_readPixel_clamp(a, x, y) != image_readPixel_clamp(b, x, y)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static ColorRgbaI32 subtractColors(const ColorRgbaI32 &a, const ColorRgbaI32 &b) {
+	return ColorRgbaI32(a.red - b.red, a.green - b.green, a.blue - b.blue, a.alpha - b.alpha).saturate();
+}
+
+START_TEST(ImageExpression)
+	// Wider than one span and not a multiple of the vector length, to test the borders.
+	int32_t width = 301;
+	int32_t height = 37;
+	OrderedImageRgbaU8 imageA = createNoise(width, height, 12);
+	OrderedImageRgbaU8 imageB = createNoise(width, height, 34);
+	ImageExpression a = expression_image(imageA);
+	ImageExpression b = expression_image(imageB);
+	ASSERT(expression_exists(a));
+	ASSERT(expression_hasDimensions(a));
+	ASSERT(!expression_hasDimensions(expression_color(ColorRgbaI32(1, 2, 3, 4))));
+	ASSERT_EQUAL(expression_getWidth(expression_add(a, expression_color(ColorRgbaI32(1, 2, 3, 4)))), width);
+	ASSERT_EQUAL(expression_getHeight(expression_add(expression_color(ColorRgbaI32(1, 2, 3, 4)), b)), height);
+	{ // Per-pixel operations give the same result as calculating each pixel by itself.
+		ImageExpression sum = expression_add(a, b);
+		ImageExpression difference = expression_subtract(a, b);
+		ImageExpression product = expression_multiply(a, b);
+		ImageExpression scaled = expression_scale(a, 0.5f);
+		ImageExpression filtered = expression_alphaFilter(a, b);
+		OrderedImageRgbaU8 sumImage = expression_evaluate(sum);
+		OrderedImageRgbaU8 differenceImage = expression_evaluate(difference);
+		OrderedImageRgbaU8 productImage = expression_evaluate(product);
+		OrderedImageRgbaU8 scaledImage = expression_evaluate(scaled);
+		OrderedImageRgbaU8 filteredImage = expression_evaluate(filtered);
+		for (int32_t y = 0; y < height; y++) {
+			for (int32_t x = 0; x < width; x++) {
+				ColorRgbaI32 colorA = image_readPixel_clamp(imageA, x, y);
+				ColorRgbaI32 colorB = image_readPixel_clamp(imageB, x, y);
+				ASSERT_EQUAL(image_readPixel_clamp(sumImage, x, y), (colorA + colorB).saturate());
+				ASSERT_EQUAL(image_readPixel_clamp(differenceImage, x, y), subtractColors(colorA, colorB));
+				ColorRgbaI32 product = image_readPixel_clamp(productImage, x, y);
+				ASSERT_EQUAL(product.red, (colorA.red * colorB.red + 127) / 255);
+				ASSERT_EQUAL(product.alpha, (colorA.alpha * colorB.alpha + 127) / 255);
+				ASSERT_EQUAL(image_readPixel_clamp(scaledImage, x, y).green, (colorA.green + 1) / 2);
+				ColorRgbaI32 filteredColor = image_readPixel_clamp(filteredImage, x, y);
+				int32_t expectedBlue = (colorA.blue * (255 - colorB.alpha) + colorB.blue * colorB.alpha + 127) / 255;
+				int32_t expectedAlpha = colorB.alpha + (colorA.alpha * (255 - colorB.alpha) + 127) / 255;
+				ASSERT_LESSER_OR_EQUAL(std::abs(filteredColor.blue - expectedBlue), 1);
+				ASSERT_LESSER_OR_EQUAL(std::abs(filteredColor.alpha - expectedAlpha), 1);
+			}
+		}
+	}
+	{ // Long chains with shared expressions are fused into one pass, which gives the same result with any number of threads.
+		ImageExpression tinted = expression_multiply(a, expression_color(ColorRgbaI32(255, 128, 64, 255)));
+		ImageExpression chain = expression_alphaFilter(expression_add(tinted, expression_scale(tinted, 0.25f)), b);
+		OrderedImageRgbaU8 threaded = expression_evaluate(chain);
+		OrderedImageRgbaU8 singleThreaded = image_create_RgbaU8(width, height);
+		expression_evaluate(singleThreaded, chain, 1);
+		ASSERT(imagesMatch(threaded, singleThreaded));
+		// Evaluating to another pack order.
+		ImageRgbaU8 reordered = image_create_RgbaU8_native(width, height, PackOrderIndex::ARGB);
+		expression_evaluate(reordered, chain);
+		ASSERT(imagesMatch(threaded, reordered));
+	}
+	{ // Colors without dimensions can fill an existing image.
+		OrderedImageRgbaU8 target = image_create_RgbaU8(13, 5);
+		expression_evaluate(target, expression_scale(expression_color(ColorRgbaI32(100, 200, 50, 255)), 2.0f));
+		ASSERT_EQUAL(image_readPixel_clamp(target, 12, 4), ColorRgbaI32(200, 255, 100, 255));
+		ASSERT_CRASH(expression_evaluate(expression_color(ColorRgbaI32(0, 0, 0, 0))), U"expression_evaluate can not create an image from an expression without dimensions!");
+	}
+	{ // The target may also be one of the inputs.
+		OrderedImageRgbaU8 target = image_clone(imageA);
+		expression_evaluate(target, expression_add(expression_image(target), b));
+		ASSERT(imagesMatch(target, expression_evaluate(expression_add(a, b))));
+	}
+	{ // Resizing materializes its input, which can then be combined with images of the new size.
+		ImageExpression sum = expression_add(a, b);
+		ImageExpression resized = expression_resize(sum, Sampler::Box, 100, 20);
+		ASSERT_EQUAL(expression_getWidth(resized), 100);
+		ASSERT_EQUAL(expression_getHeight(resized), 20);
+		OrderedImageRgbaU8 expected = filter_resize(expression_evaluate(sum), Sampler::Box, 100, 20);
+		ASSERT(imagesMatch(expression_evaluate(resized), expected));
+		OrderedImageRgbaU8 small = createNoise(100, 20, 56);
+		OrderedImageRgbaU8 combined = expression_evaluate(expression_subtract(resized, expression_image(small)));
+		ASSERT_EQUAL(image_readPixel_clamp(combined, 42, 7), subtractColors(image_readPixel_clamp(expected, 42, 7), image_readPixel_clamp(small, 42, 7)));
+		// Changing the input's pixels after an evaluation is visible when evaluating again.
+		draw_copy(imageA, createNoise(width, height, 78));
+		ASSERT(imagesMatch(expression_evaluate(resized), filter_resize(expression_evaluate(sum), Sampler::Box, 100, 20)));
+		ASSERT(!imagesMatch(expression_evaluate(resized), expected));
+	}
+	ASSERT_CRASH(expression_add(a, expression_image(image_create_RgbaU8(3, 3))), U"The expressions given to expression_add have different dimensions");
+END_TEST
@@ -2,7 +2,9 @@
 #include "../testTools.h"
 #include "../../DFPSR/api/imageAPI.h"
 #include "../../DFPSR/api/filterAPI.h"
+#include "../../DFPSR/api/drawAPI.h"
 #include "../../DFPSR/base/simd.h"
+#include "../../DFPSR/implementation/render/shader/shaderTypes.h"
 
 AlignedImageU8 addImages_generate(ImageU8 imageA, ImageU8 imageB) {
 	int width = image_getWidth(imageA);
@@ -167,4 +169,261 @@ START_TEST(ImageProcessing)
 		//printText("\nSIMD result:\n", image_toAscii(imageResult));
 		ASSERT_EQUAL(image_maxDifference(imageResult, imageExpected), 0);
 	}
+	{ // Generating images from vectorized lambdas gives the same result as generating one pixel at a time.
+		// Odd sizes to test the pixels after the last whole vector, and offsets to also get negative values.
+		AlignedImageU8 expectedU8 = filter_generateU8(29, 17, [](int32_t x, int32_t y) -> int32_t {
+			return x * 7 + y * 3;
+		}, -10, 2);
+		AlignedImageU8 resultU8 = filter_generateU8_simd(29, 17, [](const F32x8 &x, const F32x8 &y) -> F32x8 {
+			return x * 7.0f + y * 3.0f;
+		}, -10, 2);
+		ASSERT_EQUAL(image_maxDifference(resultU8, expectedU8), 0);
+		AlignedImageU16 expectedU16 = filter_generateU16(13, 5, [](int32_t x, int32_t y) -> int32_t {
+			return x * 1000 - y * 20000;
+		}, 3, -1);
+		AlignedImageU16 resultU16 = filter_generateU16_simd(13, 5, [](const F32x8 &x, const F32x8 &y) -> F32x8 {
+			return x * 1000.0f - y * 20000.0f;
+		}, 3, -1);
+		ASSERT_EQUAL(image_maxDifference(resultU16, expectedU16), 0);
+		AlignedImageF32 expectedF32 = filter_generateF32(11, 9, [](int32_t x, int32_t y) -> float {
+			return float(x) * 0.5f - float(y);
+		});
+		AlignedImageF32 resultF32 = filter_generateF32_simd(11, 9, [](const F32x8 &x, const F32x8 &y) -> F32x8 {
+			return x * 0.5f - y;
+		});
+		ASSERT_EQUAL(image_maxDifference(resultF32, expectedF32), 0.0f);
+		OrderedImageRgbaU8 expectedRgba = filter_generateRgbaU8(35, 20, [](int32_t x, int32_t y) -> ColorRgbaI32 {
+			return ColorRgbaI32(x * 8, y * 16, 255 - x, 300);
+		});
+		ImageRgbaU8 resultRgba = image_create_RgbaU8_native(35, 20, PackOrderIndex::ARGB);
+		filter_mapRgbaU8_simd(resultRgba, [](const F32x8 &x, const F32x8 &y) -> Rgba_F32x8 {
+			return Rgba_F32x8(x * 8.0f, y * 16.0f, 255.0f - x, F32x8(300.0f));
+		});
+		for (int32_t y = 0; y < 20; y++) {
+			for (int32_t x = 0; x < 35; x++) {
+				ASSERT_EQUAL(image_readPixel_clamp(resultRgba, x, y), image_readPixel_clamp(expectedRgba, x, y));
+			}
+		}
+	}
+	{ // Resampling with filter kernels.
+		// Box filtering to half the size takes the average of each 2x2 block.
+		AlignedImageU8 gradient = filter_generateU8(40, 30, [](int32_t x, int32_t y) -> int32_t {
+			return (x * 37 + y * 91 + x * y) % 256;
+		});
+		AlignedImageU8 half = filter_resize(gradient, Sampler::Box, 20, 15);
+		ASSERT_EQUAL(image_getWidth(half), 20);
+		ASSERT_EQUAL(image_getHeight(half), 15);
+		for (int32_t y = 0; y < 15; y++) {
+			for (int32_t x = 0; x < 20; x++) {
+				int32_t sum = image_readPixel_clamp(gradient, x * 2, y * 2) + image_readPixel_clamp(gradient, x * 2 + 1, y * 2)
+				            + image_readPixel_clamp(gradient, x * 2, y * 2 + 1) + image_readPixel_clamp(gradient, x * 2 + 1, y * 2 + 1);
+				ASSERT_EQUAL(image_readPixel_clamp(half, x, y), (sum + 2) / 4);
+			}
+		}
+		// Gray images resized to widths that are not a multiple of four match the colors of the same image in RGBA.
+		AlignedImageRgbaU8 colorGradient = image_create_RgbaU8(40, 30);
+		draw_copy(colorGradient, gradient);
+		AlignedImageU8 narrowed = filter_resize(gradient, Sampler::Lanczos, 13, 7);
+		OrderedImageRgbaU8 colorNarrowed = filter_resize(colorGradient, Sampler::Lanczos, 13, 7);
+		for (int32_t y = 0; y < 7; y++) {
+			for (int32_t x = 0; x < 13; x++) {
+				ASSERT_LESSER_OR_EQUAL(abs(image_readPixel_clamp(narrowed, x, y) - image_readPixel_clamp(colorNarrowed, x, y).red), 1);
+			}
+		}
+		// Uniform colors are preserved by all kernels, even when the pack order changes.
+		ImageRgbaU8 uniform = image_create_RgbaU8_native(37, 23, PackOrderIndex::BGRA);
+		image_fill(uniform, ColorRgbaI32(10, 200, 30, 255));
+		for (int32_t s = 0; s < 3; s++) {
+			Sampler sampler = s == 0 ? Sampler::Box : (s == 1 ? Sampler::Triangle : Sampler::Lanczos);
+			OrderedImageRgbaU8 smaller = filter_resize(uniform, sampler, 11, 5);
+			OrderedImageRgbaU8 larger = filter_resize(uniform, sampler, 75, 52);
+			ASSERT_EQUAL(image_readPixel_clamp(smaller, 0, 0), ColorRgbaI32(10, 200, 30, 255));
+			ASSERT_EQUAL(image_readPixel_clamp(smaller, 10, 4), ColorRgbaI32(10, 200, 30, 255));
+			ASSERT_EQUAL(image_readPixel_clamp(larger, 40, 30), ColorRgbaI32(10, 200, 30, 255));
+			ASSERT_EQUAL(image_readPixel_clamp(larger, 74, 51), ColorRgbaI32(10, 200, 30, 255));
+		}
+		// Downscaling a checkerboard gives gray instead of aliasing.
+		AlignedImageU8 checkerboard = filter_generateU8(64, 64, [](int32_t x, int32_t y) -> int32_t {
+			return ((x + y) & 1) ? 255 : 0;
+		});
+		AlignedImageU8 nearest = filter_resize(checkerboard, Sampler::Nearest, 16, 16);
+		AlignedImageU8 lanczos = filter_resize(checkerboard, Sampler::Lanczos, 16, 16);
+		AlignedImageU8 triangle = filter_resize(checkerboard, Sampler::Triangle, 16, 16);
+		ASSERT_EQUAL(image_readPixel_clamp(nearest, 5, 5) % 255, 0);
+		for (int32_t y = 0; y < 16; y++) {
+			for (int32_t x = 0; x < 16; x++) {
+				ASSERT_LESSER_OR_EQUAL(abs(image_readPixel_clamp(lanczos, x, y) - 127), 8);
+				ASSERT_LESSER_OR_EQUAL(abs(image_readPixel_clamp(triangle, x, y) - 127), 8);
+			}
+		}
+	}
+	{ // Blurring.
+		// Box blur gives the average of the pixels around, using the closest edge for pixels outside.
+		AlignedImageU8 noise = filter_generateU8(53, 31, [](int32_t x, int32_t y) -> int32_t {
+			return (x * 37 + y * 91 + x * y * 13) % 256;
+		});
+		for (int32_t radius = 0; radius <= 4; radius += 2) {
+			AlignedImageU8 blurred = filter_boxBlur(noise, radius);
+			AlignedImageF32 noiseF32 = image_create_F32(53, 31);
+			draw_copy(noiseF32, noise);
+			AlignedImageF32 blurredF32 = filter_boxBlur(noiseF32, radius);
+			int32_t size = radius * 2 + 1;
+			for (int32_t y = 0; y < 31; y++) {
+				for (int32_t x = 0; x < 53; x++) {
+					int32_t sum = 0;
+					for (int32_t dy = -radius; dy <= radius; dy++) {
+						for (int32_t dx = -radius; dx <= radius; dx++) {
+							sum += image_readPixel_clamp(noise, x + dx, y + dy);
+						}
+					}
+					// Allowing a difference of one in case that the average is close to a half.
+					ASSERT_LESSER_OR_EQUAL(abs(image_readPixel_clamp(blurred, x, y) - (sum * 2 + size * size) / (size * size * 2)), 1);
+					ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(blurredF32, x, y) - float(sum) / float(size * size)), 0.01f);
+				}
+			}
+		}
+		// Sub-images are blurred with their own edges.
+		IRect region = IRect(7, 5, 21, 17);
+		AlignedImageU8 blurredRegion = filter_boxBlur(image_getSubImage(noise, region), 3);
+		AlignedImageU8 blurredClone = filter_boxBlur(image_clone(image_getSubImage(noise, region)), 3);
+		for (int32_t y = 0; y < region.height(); y++) {
+			for (int32_t x = 0; x < region.width(); x++) {
+				ASSERT_EQUAL(image_readPixel_clamp(blurredRegion, x, y), image_readPixel_clamp(blurredClone, x, y));
+			}
+		}
+		// Large values at the top of tall columns do not leave rounding errors in the sums further down.
+		AlignedImageF32 tall = filter_generateF32(3, 2000, [](int32_t x, int32_t y) -> float {
+			return y < 10 ? 1000000.0f : float((y * 7) % 10) * 0.1f;
+		});
+		AlignedImageF32 blurredTall = filter_boxBlur(tall, 2);
+		for (int32_t y = 20; y < 2000; y += 97) {
+			float sum = 0.0f;
+			for (int32_t dy = -2; dy <= 2; dy++) {
+				sum += image_readPixel_clamp(tall, 1, y + dy);
+			}
+			ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(blurredTall, 1, y) - sum / 5.0f), 0.001f);
+		}
+		// Radii much larger than the image give the average of the edges on both sides, without iterating over the radius.
+		AlignedImageU8 leftToRight = filter_generateU8(5, 4, [](int32_t x, int32_t y) -> int32_t {
+			return x == 0 ? 0 : (x == 4 ? 200 : 77);
+		});
+		AlignedImageU8 hugeBlur = filter_boxBlur(leftToRight, 2147483647);
+		for (int32_t y = 0; y < 4; y++) {
+			for (int32_t x = 0; x < 5; x++) {
+				ASSERT_EQUAL(image_readPixel_clamp(hugeBlur, x, y), 100);
+			}
+		}
+		// RGBA images keep their pack order and blur each channel by itself.
+		ImageRgbaU8 uniform = image_create_RgbaU8_native(37, 23, PackOrderIndex::ARGB);
+		image_fill(uniform, ColorRgbaI32(10, 200, 30, 255));
+		image_writePixel(uniform, 18, 11, ColorRgbaI32(10 + 81, 200 - 81, 30, 174));
+		AlignedImageRgbaU8 boxRgba = filter_boxBlur(uniform, 4);
+		ASSERT_EQUAL(image_getPackOrderIndex(boxRgba), PackOrderIndex::ARGB);
+		ASSERT_EQUAL(image_readPixel_clamp(boxRgba, 18, 11), ColorRgbaI32(11, 199, 30, 254));
+		ASSERT_EQUAL(image_readPixel_clamp(boxRgba, 0, 0), ColorRgbaI32(10, 200, 30, 255));
+		// Gaussian blur spreads a single point into a symmetric bell shape without changing the total brightness.
+		AlignedImageF32 point = image_create_F32(41, 41);
+		image_writePixel(point, 20, 20, 1000.0f);
+		AlignedImageF32 bell = filter_gaussianBlur(point, 3.0f);
+		float total = 0.0f;
+		float variance = 0.0f;
+		for (int32_t y = 0; y < 41; y++) {
+			for (int32_t x = 0; x < 41; x++) {
+				float value = image_readPixel_clamp(bell, x, y);
+				total += value;
+				variance += value * float((x - 20) * (x - 20));
+				ASSERT_LESSER_OR_EQUAL(fabs(value - image_readPixel_clamp(bell, 40 - x, y)), 0.001f);
+				ASSERT_LESSER_OR_EQUAL(fabs(value - image_readPixel_clamp(bell, y, x)), 0.001f);
+			}
+		}
+		ASSERT_LESSER_OR_EQUAL(fabs(total - 1000.0f), 0.1f);
+		// Box sizes are odd integers, so the variance of 3² can only be approximated.
+		ASSERT_LESSER_OR_EQUAL(fabs(variance / total - 9.0f), 1.01f);
+		ASSERT_GREATER(image_readPixel_clamp(bell, 20, 20), image_readPixel_clamp(bell, 21, 20));
+		ASSERT_GREATER(image_readPixel_clamp(bell, 21, 20), image_readPixel_clamp(bell, 24, 20));
+		// Half precision images are blurred like floats and rounded back to half precision.
+		AlignedImageF16 halfPoint = image_create_F16(41, 41);
+		draw_copy(halfPoint, point);
+		AlignedImageF16 halfBell = filter_gaussianBlur(halfPoint, 3.0f);
+		ASSERT_EQUAL(image_accessPixel(halfBell, 20, 20), roundToF16(image_readPixel_clamp(bell, 20, 20)));
+		ASSERT_EQUAL(image_accessPixel(halfBell, 23, 18), roundToF16(image_readPixel_clamp(bell, 23, 18)));
+		AlignedImageF16 halfBox = filter_boxBlur(halfPoint, 2);
+		ASSERT_EQUAL(image_readPixel_clamp(halfBox, 22, 18), 40.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(halfBox, 23, 18), 0.0f);
+		AlignedImageRgbaU8 gaussianRgba = filter_gaussianBlur(uniform, 2.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(gaussianRgba, 0, 0), ColorRgbaI32(10, 200, 30, 255));
+		AlignedImageU8 sharp = filter_gaussianBlur(noise, 0.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(sharp, 17, 9), image_readPixel_clamp(noise, 17, 9));
+		ASSERT_CRASH(filter_boxBlur(noise, -1), U"filter_boxBlur got the negative radius -1!");
+	}
+	{ // Summed-area tables.
+		AlignedImageU8 noise = filter_generateU8(47, 29, [](int32_t x, int32_t y) -> int32_t {
+			return (x * 53 + y * 17 + x * y * 7) % 256;
+		});
+		AlignedImageU16 noiseU16 = filter_generateU16(47, 29, [](int32_t x, int32_t y) -> int32_t {
+			return (x * 5311 + y * 1733 + x * y * 701) % 65536;
+		});
+		AlignedImageF32 noiseF32 = image_create_F32(47, 29);
+		draw_copy(noiseF32, noise);
+		IntegralImage table = filter_createIntegralImage(noise);
+		IntegralImage tableU16 = filter_createIntegralImage(noiseU16);
+		IntegralImage tableF32 = filter_createIntegralImage(noiseF32);
+		ASSERT_EQUAL(integral_getWidth(table), 47);
+		ASSERT_EQUAL(integral_getHeight(table), 29);
+		IRect regions[4] = {IRect(0, 0, 47, 29), IRect(3, 5, 11, 7), IRect(40, -3, 20, 9), IRect(46, 28, 1, 1)};
+		for (int32_t r = 0; r < 4; r++) {
+			IRect cut = IRect::cut(IRect(0, 0, 47, 29), regions[r]);
+			double sum = 0.0;
+			double sumU16 = 0.0;
+			double squareSum = 0.0;
+			for (int32_t y = cut.top(); y < cut.bottom(); y++) {
+				for (int32_t x = cut.left(); x < cut.right(); x++) {
+					double value = image_readPixel_clamp(noise, x, y);
+					sum += value;
+					squareSum += value * value;
+					sumU16 += image_readPixel_clamp(noiseU16, x, y);
+				}
+			}
+			double mean = sum / cut.area();
+			ASSERT_EQUAL(integral_getSum(table, regions[r]), sum);
+			ASSERT_EQUAL(integral_getSum(tableU16, regions[r]), sumU16);
+			ASSERT_EQUAL(integral_getSum(tableF32, regions[r]), sum);
+			ASSERT_LESSER_OR_EQUAL(fabs(integral_getMean(table, regions[r]) - mean), 0.000001);
+			ASSERT_LESSER_OR_EQUAL(fabs(integral_getVariance(table, regions[r]) - (squareSum / cut.area() - mean * mean)), 0.0001);
+		}
+		// Regions outside of the image have no pixels.
+		ASSERT_EQUAL(integral_getSum(table, IRect(50, 0, 10, 10)), 0.0);
+		ASSERT_EQUAL(integral_getMean(table, IRect(-20, 0, 10, 10)), 0.0);
+		ASSERT_EQUAL(integral_getVariance(table, IRect(0, 0, 0, 10)), 0.0);
+		ASSERT_EQUAL(integral_getSum(IntegralImage(), IRect(0, 0, 10, 10)), 0.0);
+		ASSERT(!filter_createIntegralImage(AlignedImageU8()).isNotNull());
+		// Box filters of the table only count pixels inside of the image.
+		int32_t radius = 6;
+		AlignedImageF32 means = filter_boxMean(table, radius);
+		AlignedImageF32 variances = filter_boxVariance(table, radius);
+		for (int32_t y = 0; y < 29; y++) {
+			for (int32_t x = 0; x < 47; x++) {
+				IRect box = IRect(x - radius, y - radius, radius * 2 + 1, radius * 2 + 1);
+				ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(means, x, y) - integral_getMean(table, box)), 0.001);
+				ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(variances, x, y) - integral_getVariance(table, box)), 0.01);
+			}
+		}
+		// Away from the edges, the mean is the same as a box blur.
+		AlignedImageF32 blurred = filter_boxBlur(noiseF32, radius);
+		ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(means, 20, 14) - image_readPixel_clamp(blurred, 20, 14)), 0.01f);
+		// Uniform regions have no variance.
+		AlignedImageU8 uniform = image_create_U8(16, 16);
+		image_fill(uniform, 77);
+		AlignedImageF32 uniformVariances = filter_boxVariance(filter_createIntegralImage(uniform), 3);
+		ASSERT_EQUAL(image_readPixel_clamp(uniformVariances, 0, 0), 0.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(uniformVariances, 8, 8), 0.0f);
+		// Radii larger than the image cover the whole image from every pixel.
+		AlignedImageF32 wholeMeans = filter_boxMean(table, 2147483647);
+		AlignedImageF32 wholeVariances = filter_boxVariance(table, 2147483647);
+		IRect whole = IRect(0, 0, 47, 29);
+		ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(wholeMeans, 0, 0) - integral_getMean(table, whole)), 0.001);
+		ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(wholeMeans, 46, 28) - integral_getMean(table, whole)), 0.001);
+		ASSERT_LESSER_OR_EQUAL(fabs(image_readPixel_clamp(wholeVariances, 23, 14) - integral_getVariance(table, whole)), 0.01);
+		ASSERT_CRASH(filter_boxMean(table, -1), U"filter_boxMean got the negative radius -1!");
+	}
 END_TEST
@@ -1,6 +1,10 @@
 ﻿
 #include "../testTools.h"
 #include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/randomAPI.h"
+#include "../../DFPSR/api/fileAPI.h"
+#include "../../DFPSR/api/drawAPI.h"
+#include "../../DFPSR/api/tiledImageAPI.h"
 
 START_TEST(Image)
 	{ // ImageU8
@@ -34,6 +38,38 @@ START_TEST(Image)
 		ASSERT_EQUAL(image_getStride(image), heap_getHeapAlignment());
 		ASSERT_EQUAL(image_getBound(image), IRect(0, 0, 3, 48));
 	}
+	{ // ImageF16
+		ImageF16 image;
+		ASSERT_EQUAL(image_exists(image), false);
+		image = image_create_F16(5, 7);
+		ASSERT_EQUAL(image_exists(image), true);
+		ASSERT_EQUAL(image_getWidth(image), 5);
+		ASSERT_EQUAL(image_getHeight(image), 7);
+		ASSERT_EQUAL(image_getPixelSize(image), 2);
+		ASSERT_EQUAL(image_getStride(image), heap_getHeapAlignment());
+		ASSERT_EQUAL(image_readPixel_clamp(image, 2, 3), 0.0f);
+		// Pixels are rounded to half precision when written and converted back to float when read.
+		image_writePixel(image, 2, 3, 1.0f / 3.0f);
+		image_writePixel(image, 4, 6, 100000.0f);
+		ASSERT_EQUAL(image_accessPixel(image, 2, 3), (uint16_t)0x3555);
+		ASSERT_EQUAL(image_readPixel_clamp(image, 2, 3), 0.333251953125f);
+		ASSERT_EQUAL(image_readPixel_border(image, 4, 6), DSR_FLOAT_INF);
+		ASSERT_EQUAL(image_readPixel_border(image, 5, 6, -1.0f), -1.0f);
+		ASSERT_EQUAL(image_readPixel_tile(image, -3, 10), 0.333251953125f);
+		image_fill(image, -2.5f);
+		ASSERT_EQUAL(image_readPixel_clamp(image, 4, 6), -2.5f);
+		// Sub-images and clones keep the pixel format.
+		ImageF16 subImage = image_getSubImage(image, IRect(1, 2, 3, 4));
+		image_writePixel(subImage, 0, 0, 65504.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(image, 1, 2), 65504.0f);
+		AlignedImageF16 clone = image_clone(subImage);
+		ASSERT_EQUAL(image_getBound(clone), IRect(0, 0, 3, 4));
+		ASSERT_EQUAL(image_maxDifference(clone, subImage), 0.0f);
+		image_writePixel(clone, 2, 3, 0.5f);
+		ASSERT_EQUAL(image_maxDifference(clone, subImage), 3.0f);
+		ASSERT_EQUAL(image_findChangedRegions(subImage, clone, 2).length(), 1);
+		ASSERT_EQUAL(image_findChangedRegions(subImage, clone, 2)[0], IRect(2, 2, 1, 2));
+	}
 	{ // ImageRgbaU8
 		ImageRgbaU8 image;
 		ASSERT_EQUAL(image_exists(image), false);
@@ -109,5 +145,307 @@ START_TEST(Image)
 			"< ..  .. >"
 		)), 0);
 	}
+	{ // QOI encoding
+		// Flat areas, gradients and noise, to use all kinds of chunks.
+		RandomGenerator generator = random_createGenerator(1357);
+		OrderedImageRgbaU8 image = image_create_RgbaU8(300, 500);
+		for (int32_t y = 0; y < 500; y++) {
+			for (int32_t x = 0; x < 300; x++) {
+				ColorRgbaI32 color;
+				if (x < 100) {
+					color = ColorRgbaI32(0, 0, 0, 0);
+				} else if (x < 200) {
+					color = ColorRgbaI32(x, y / 2, x + y / 4, 255);
+				} else if (x < 250) {
+					color = ColorRgbaI32(random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255), random_generate_range(generator, 0, 255));
+				} else {
+					color = ColorRgbaI32((y / 10) % 2 * 255, 128, 64, 255 - (y / 50));
+				}
+				image_writePixel(image, x, y, color);
+			}
+		}
+		Buffer encoded = image_encode(image, ImageFileFormat::QOI);
+		ASSERT(buffer_exists(encoded));
+		SafePointer<const uint8_t> data = buffer_getSafeData<const uint8_t>(encoded, "QOI test data");
+		int32_t size = buffer_getSize(encoded);
+		ASSERT_EQUAL(data[0], 'q');
+		ASSERT_EQUAL(data[3], 'f');
+		ASSERT_LESSER(size, 300 * 500 * 4);
+		OrderedImageRgbaU8 decoded = image_decode_RgbaU8(encoded);
+		ASSERT_EQUAL(image_getWidth(decoded), 300);
+		ASSERT_EQUAL(image_getHeight(decoded), 500);
+		ASSERT_EQUAL(image_maxDifference(decoded, image), 0);
+		// Without the strip table at the end, the same data is decoded as a single strip like any other QOI file.
+		int32_t stripCount = (data[size - 8] << 24) | (data[size - 7] << 16) | (data[size - 6] << 8) | data[size - 5];
+		ASSERT_GREATER(stripCount, 1);
+		OrderedImageRgbaU8 decodedWithoutStrips = image_decode_RgbaU8(data, size - (12 + stripCount * 4));
+		ASSERT_EQUAL(image_maxDifference(decodedWithoutStrips, image), 0);
+		// Truncated data fails.
+		ASSERT(!image_exists(image_decode_RgbaU8(data, size / 2)));
+		// Padded sub-images and other pack orders are encoded with the same colors.
+		AlignedImageRgbaU8 native = image_create_RgbaU8_native(300, 500, PackOrderIndex::ARGB);
+		for (int32_t y = 0; y < 500; y++) {
+			for (int32_t x = 0; x < 300; x++) {
+				image_writePixel(native, x, y, image_readPixel_clamp(image, x, y));
+			}
+		}
+		ImageRgbaU8 subImage = image_getSubImage(native, IRect(37, 11, 201, 470));
+		OrderedImageRgbaU8 decodedSubImage = image_decode_RgbaU8(image_encode(subImage, ImageFileFormat::QOI));
+		ASSERT_EQUAL(image_getWidth(decodedSubImage), 201);
+		ASSERT_EQUAL(image_getHeight(decodedSubImage), 470);
+		for (int32_t y = 0; y < 470; y++) {
+			for (int32_t x = 0; x < 201; x++) {
+				ASSERT_EQUAL(image_readPixel_clamp(decodedSubImage, x, y), image_readPixel_clamp(image, x + 37, y + 11));
+			}
+		}
+	}
+	{ // QOI decoding of a file from another encoder
+		const uint8_t file[] = {
+			'q', 'o', 'i', 'f', 0, 0, 0, 2, 0, 0, 0, 2, 4, 0,
+			0xFF, 10, 20, 30, 255, // The whole color (10, 20, 30, 255)
+			0xC0, // Repeat once
+			0x40 | (3 << 4) | (2 << 2) | 1, // Difference (+1, 0, -1)
+			0x09, // The first color from the index
+			0, 0, 0, 0, 0, 0, 0, 1
+		};
+		OrderedImageRgbaU8 decoded = image_decode_RgbaU8(SafePointer<const uint8_t>("QOI file", file, sizeof(file)), sizeof(file));
+		ASSERT_EQUAL(image_getWidth(decoded), 2);
+		ASSERT_EQUAL(image_getHeight(decoded), 2);
+		ASSERT_EQUAL(image_readPixel_clamp(decoded, 0, 0), ColorRgbaI32(10, 20, 30, 255));
+		ASSERT_EQUAL(image_readPixel_clamp(decoded, 1, 0), ColorRgbaI32(10, 20, 30, 255));
+		ASSERT_EQUAL(image_readPixel_clamp(decoded, 0, 1), ColorRgbaI32(11, 20, 29, 255));
+		ASSERT_EQUAL(image_readPixel_clamp(decoded, 1, 1), ColorRgbaI32(10, 20, 30, 255));
+	}
+	{ // Raw images
+		String folderPath = file_combinePaths(U".", U"resources");
+		ASSERT_EQUAL(file_getEntryType(folderPath), EntryType::Folder);
+		String heightPath = file_combinePaths(folderPath, U"TemporaryHeight.raw");
+		String colorPath = file_combinePaths(folderPath, U"TemporaryColor.raw");
+		AlignedImageF32 heights = image_create_F32(37, 23);
+		for (int32_t y = 0; y < 23; y++) {
+			for (int32_t x = 0; x < 37; x++) {
+				image_writePixel(heights, x, y, float(x) * 0.25f - float(y) * 100.0f);
+			}
+		}
+		ASSERT(image_saveRaw(heights, heightPath));
+		AlignedImageF32 loadedHeights = image_loadRaw_F32(heightPath);
+		ASSERT_EQUAL(image_getWidth(loadedHeights), 37);
+		ASSERT_EQUAL(image_getHeight(loadedHeights), 23);
+		ASSERT_EQUAL(image_maxDifference(loadedHeights, heights), 0.0f);
+		// Writing to a loaded image does not modify the file.
+		image_writePixel(loadedHeights, 5, 6, 1234.0f);
+		ASSERT_EQUAL(image_readPixel_clamp(image_loadRaw_F32(heightPath), 5, 6), image_readPixel_clamp(heights, 5, 6));
+		// Sub-images are saved without the pixels outside.
+		ImageU16 depth = image_create_U16(40, 30);
+		for (int32_t y = 0; y < 30; y++) {
+			for (int32_t x = 0; x < 40; x++) {
+				image_writePixel(depth, x, y, x * 1000 + y);
+			}
+		}
+		ImageU16 depthRegion = image_getSubImage(depth, IRect(3, 4, 20, 10));
+		ASSERT(image_saveRaw(depthRegion, heightPath));
+		ASSERT_EQUAL(image_maxDifference(image_loadRaw_U16(heightPath), depthRegion), 0);
+		// Half precision images are stored as their own pixel format.
+		AlignedImageF16 halfHeights = image_create_F16(37, 23);
+		draw_copy(halfHeights, heights);
+		ASSERT(image_saveRaw(halfHeights, heightPath));
+		ASSERT_EQUAL(image_maxDifference(image_loadRaw_F16(heightPath), halfHeights), 0.0f);
+		ASSERT(!image_exists(image_loadRaw_U16(heightPath, false)));
+		// Colors keep their pack order.
+		AlignedImageRgbaU8 colors = image_create_RgbaU8_native(13, 7, PackOrderIndex::ARGB);
+		image_fill(colors, ColorRgbaI32(10, 20, 30, 40));
+		ASSERT(image_saveRaw(colors, colorPath));
+		AlignedImageRgbaU8 loadedColors = image_loadRaw_RgbaU8(colorPath);
+		ASSERT_EQUAL(image_getPackOrderIndex(loadedColors), PackOrderIndex::ARGB);
+		ASSERT_EQUAL(image_readPixel_clamp(loadedColors, 12, 6), ColorRgbaI32(10, 20, 30, 40));
+		// Loading another pixel format fails.
+		ASSERT(!image_exists(image_loadRaw_U8(colorPath, false)));
+		ASSERT_CRASH(image_loadRaw_F32(colorPath), U"image_loadRaw: ");
+		// Images can outlive their files.
+		ASSERT(file_removeFile(heightPath));
+		ASSERT(file_removeFile(colorPath));
+		ASSERT_EQUAL(image_readPixel_clamp(loadedColors, 0, 0), ColorRgbaI32(10, 20, 30, 40));
+	}
+	{ // Tiled images
+		String tilePath = file_combinePaths(file_combinePaths(U".", U"resources"), U"TemporaryTiles.dsr");
+		// 70x50 pixels in 16x16 tiles gives 5x4 tiles, with partial tiles at the right and bottom.
+		TiledImage tiles = tiledImage_create(tilePath, PixelFormat::MonoU16, 70, 50, 16, 4);
+		ASSERT(tiledImage_exists(tiles));
+		ASSERT_EQUAL(tiledImage_getWidth(tiles), 70);
+		ASSERT_EQUAL(tiledImage_getHeight(tiles), 50);
+		ASSERT_EQUAL(tiledImage_getTileSize(tiles), 16);
+		ASSERT(tiledImage_getPixelFormat(tiles) == PixelFormat::MonoU16);
+		ASSERT_EQUAL(tiledImage_getCachedTileCount(tiles), 0);
+		// Tiles that were never written are zero.
+		AlignedImageU16 result = image_create_U16(70, 50);
+		image_fill(result, 123);
+		draw_copy(result, tiles);
+		ASSERT_EQUAL(image_readPixel_clamp(result, 69, 49), 0);
+		// No more than four unreferenced tiles are kept in memory.
+		ASSERT_EQUAL(tiledImage_getCachedTileCount(tiles), 4);
+		AlignedImageU16 original = image_create_U16(70, 50);
+		for (int32_t y = 0; y < 50; y++) {
+			for (int32_t x = 0; x < 70; x++) {
+				image_writePixel(original, x, y, x + y * 100);
+			}
+		}
+		draw_copy(tiles, original);
+		image_fill(result, 0);
+		draw_copy(result, tiles);
+		ASSERT_EQUAL(image_maxDifference(result, original), 0);
+		// Sub-images read and write the same tiles.
+		TiledImage region = tiledImage_getSubImage(tiles, IRect(10, 20, 30, 40));
+		ASSERT_EQUAL(tiledImage_getBound(region), IRect(0, 0, 30, 30));
+		AlignedImageU16 regionResult = image_create_U16(30, 30);
+		draw_copy(regionResult, region);
+		ASSERT_EQUAL(image_maxDifference(regionResult, image_getSubImage(original, IRect(10, 20, 30, 30))), 0);
+		draw_copy(region, image_create_U16(2, 2), 29, 29);
+		draw_copy(result, tiles, -39, -49);
+		ASSERT_EQUAL(image_readPixel_clamp(result, 0, 0), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(result, 1, 0), 40 + 49 * 100);
+		ASSERT(!tiledImage_exists(tiledImage_getSubImage(tiles, IRect(70, 0, 10, 10))));
+		// Filters are applied to each tile on multiple threads, with coordinates relative to the filtered region.
+		tiledImage_filterU16(region, [](const ImageU16 &tile, int32_t left, int32_t top) {
+			for (int32_t y = 0; y < image_getHeight(tile); y++) {
+				for (int32_t x = 0; x < image_getWidth(tile); x++) {
+					image_writePixel(tile, x, y, left + x + (top + y) * 1000);
+				}
+			}
+		});
+		draw_copy(regionResult, region);
+		ASSERT_EQUAL(image_readPixel_clamp(regionResult, 0, 0), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(regionResult, 17, 23), 23017);
+		ASSERT_EQUAL(image_readPixel_clamp(regionResult, 29, 29), 29029);
+		draw_copy(result, tiles);
+		ASSERT_EQUAL(image_readPixel_clamp(result, 9, 20), 9 + 20 * 100);
+		ASSERT_EQUAL(image_readPixel_clamp(result, 40, 49), 40 + 49 * 100);
+		ASSERT_EQUAL(tiledImage_getCachedTileCount(tiles), 4);
+		// Each tile is released after its filter returns, so that it can be evicted.
+		tiledImage_filterU16(tiles, [](const ImageU16 &tile, int32_t left, int32_t top) {}, 1);
+		ASSERT_EQUAL(tiledImage_getCachedTileCount(tiles), 4);
+		// Pixel formats must match.
+		ASSERT_CRASH(draw_copy(image_create_F32(4, 4), tiles), U"draw_copy: Expected a tiled image of F32 pixels");
+		// Modified tiles are saved to the file.
+		tiledImage_flush(tiles);
+		TiledImage reopened = tiledImage_open(tilePath, 2);
+		ASSERT_EQUAL(tiledImage_getBound(reopened), IRect(0, 0, 70, 50));
+		AlignedImageU16 reopenedResult = image_create_U16(70, 50);
+		draw_copy(reopenedResult, reopened);
+		ASSERT_EQUAL(image_maxDifference(reopenedResult, result), 0);
+		reopened = TiledImage();
+		// Tiles still in memory are saved when the last handle is released.
+		draw_copy(tiles, image_create_U16(1, 1), 69, 49);
+		region = TiledImage();
+		tiles = TiledImage();
+		draw_copy(reopenedResult, tiledImage_open(tilePath));
+		ASSERT_EQUAL(image_readPixel_clamp(reopenedResult, 69, 49), 0);
+		ASSERT_EQUAL(image_readPixel_clamp(reopenedResult, 68, 49), 68 + 49 * 100);
+		ASSERT(!tiledImage_exists(tiledImage_open(file_combinePaths(file_combinePaths(U".", U"resources"), U"TemporaryMissing.dsr"), 4, false)));
+		ASSERT(file_removeFile(tilePath));
+	}
+	{ // Batch loading
+		String folderPath = file_combinePaths(U".", U"resources");
+		List<String> filenames;
+		List<OrderedImageRgbaU8> originals;
+		// Reserved, because growing a list of images would copy them without releasing the old copies.
+		originals.reserve(5);
+		for (int32_t i = 0; i < 5; i++) {
+			OrderedImageRgbaU8 original = image_create_RgbaU8(20 + i, 10 + i * 3);
+			for (int32_t y = 0; y < image_getHeight(original); y++) {
+				for (int32_t x = 0; x < image_getWidth(original); x++) {
+					image_writePixel(original, x, y, ColorRgbaI32(x * 10, y * 5, i * 50, 255));
+				}
+			}
+			String filename = file_combinePaths(folderPath, string_combine(U"TemporaryBatch", i, (i % 2) ? U".png" : U".qoi"));
+			ASSERT(image_save(original, filename));
+			filenames.push(filename);
+			originals.push(original);
+		}
+		filenames.push(file_combinePaths(folderPath, U"MissingBatchImage.png"));
+		ImageBatch batch = image_loadBatch(filenames, 2);
+		ASSERT_EQUAL(image_batch_getCount(batch), 6);
+		for (int32_t i = 0; i < 5; i++) {
+			OrderedImageRgbaU8 loaded = image_batch_getImage(batch, i);
+			ASSERT(image_batch_isReady(batch, i));
+			ASSERT_EQUAL(image_getWidth(loaded), image_getWidth(originals[i]));
+			ASSERT_EQUAL(image_getHeight(loaded), image_getHeight(originals[i]));
+			ASSERT_EQUAL(image_maxDifference(loaded, originals[i]), 0);
+		}
+		ASSERT(!image_exists(image_batch_getImage(batch, 5, false)));
+		ASSERT_CRASH(image_batch_getImage(batch, 5), U"image_batch_getImage: Failed to load the image at ");
+		ASSERT_CRASH(image_batch_isReady(batch, 6), U"image_batch_isReady got the index 6, which is outside of the batch's 6 images!");
+		for (int32_t i = 0; i < 5; i++) {
+			ASSERT(file_removeFile(filenames[i]));
+		}
+	}
+	{ // Changed regions
+		OrderedImageRgbaU8 previous = image_create_RgbaU8(100, 70);
+		image_fill(previous, ColorRgbaI32(20, 40, 60, 255));
+		OrderedImageRgbaU8 current = image_clone(previous);
+		ASSERT_EQUAL(image_findChangedRegions(previous, current, 16).length(), 0);
+		// Separate blocks on the same row.
+		image_writePixel(current, 5, 5, ColorRgbaI32(21, 40, 60, 255));
+		image_writePixel(current, 45, 5, ColorRgbaI32(20, 40, 60, 254));
+		List<IRect> changes = image_findChangedRegions(previous, current, 16);
+		ASSERT_EQUAL(changes.length(), 2);
+		ASSERT_EQUAL(changes[0], IRect(0, 0, 16, 16));
+		ASSERT_EQUAL(changes[1], IRect(32, 0, 16, 16));
+		// Neighboring blocks are merged, and blocks along the edges are clipped to the image.
+		draw_rectangle(current, IRect(70, 40, 20, 10), ColorRgbaI32(255, 0, 0, 255));
+		image_writePixel(current, 99, 69, ColorRgbaI32(0, 0, 0, 0));
+		changes = image_findChangedRegions(previous, current, 16);
+		ASSERT_EQUAL(changes.length(), 4);
+		ASSERT_EQUAL(changes[0], IRect(0, 0, 16, 16));
+		ASSERT_EQUAL(changes[1], IRect(32, 0, 16, 16));
+		ASSERT_EQUAL(changes[2], IRect(64, 32, 32, 32));
+		ASSERT_EQUAL(changes[3], IRect(96, 64, 4, 6));
+		// Sub-images are compared with their own coordinates, even if the rows are not aligned.
+		changes = image_findChangedRegions(image_getSubImage(previous, IRect(3, 1, 50, 40)), image_getSubImage(current, IRect(3, 1, 50, 40)), 8);
+		ASSERT_EQUAL(changes.length(), 2);
+		ASSERT_EQUAL(changes[0], IRect(0, 0, 8, 8));
+		ASSERT_EQUAL(changes[1], IRect(40, 0, 8, 8));
+		// Every changed pixel is covered by exactly one rectangle, and every rectangle only covers blocks with changes.
+		RandomGenerator generator = random_createGenerator(9876);
+		AlignedImageU8 previousU8 = image_create_U8(77, 53);
+		AlignedImageU8 currentU8 = image_create_U8(77, 53);
+		for (int32_t i = 0; i < 12; i++) {
+			image_writePixel(currentU8, random_generate_range(generator, 0, 76), random_generate_range(generator, 0, 52), random_generate_range(generator, 1, 255));
+		}
+		int32_t blockSize = 5;
+		List<IRect> changesU8 = image_findChangedRegions(previousU8, currentU8, blockSize);
+		for (int32_t y = 0; y < 53; y++) {
+			for (int32_t x = 0; x < 77; x++) {
+				int32_t coverCount = 0;
+				for (int32_t r = 0; r < changesU8.length(); r++) {
+					if (x >= changesU8[r].left() && x < changesU8[r].right() && y >= changesU8[r].top() && y < changesU8[r].bottom()) {
+						coverCount++;
+					}
+				}
+				IRect block = IRect((x / blockSize) * blockSize, (y / blockSize) * blockSize, blockSize, blockSize);
+				bool blockChanged = image_maxDifference(image_getSubImage(previousU8, block), image_getSubImage(currentU8, block)) > 0;
+				ASSERT_EQUAL(coverCount, blockChanged ? 1 : 0);
+			}
+		}
+		// Other pixel formats.
+		AlignedImageU16 previousU16 = image_create_U16(30, 30);
+		AlignedImageU16 currentU16 = image_clone(previousU16);
+		image_writePixel(currentU16, 29, 0, 1000);
+		ASSERT_EQUAL(image_findChangedRegions(previousU16, currentU16, 10).length(), 1);
+		ASSERT_EQUAL(image_findChangedRegions(previousU16, currentU16, 10)[0], IRect(20, 0, 10, 10));
+		AlignedImageF32 previousF32 = image_create_F32(30, 30);
+		AlignedImageF32 currentF32 = image_clone(previousF32);
+		image_writePixel(currentF32, 0, 29, 0.5f);
+		ASSERT_EQUAL(image_findChangedRegions(previousF32, currentF32, 64)[0], IRect(0, 0, 30, 30));
+		// Huge block sizes are limited to the image's size.
+		ASSERT_EQUAL(image_findChangedRegions(previousF32, currentF32, 2147483647).length(), 1);
+		ASSERT_EQUAL(image_findChangedRegions(previousF32, currentF32, 2147483647)[0], IRect(0, 0, 30, 30));
+		// Different dimensions invalidate the whole image.
+		changesU8 = image_findChangedRegions(previousU8, image_create_U8(20, 10), 4);
+		ASSERT_EQUAL(changesU8.length(), 1);
+		ASSERT_EQUAL(changesU8[0], IRect(0, 0, 20, 10));
+		ASSERT_EQUAL(image_findChangedRegions(AlignedImageU8(), currentU8, 4)[0], IRect(0, 0, 77, 53));
+		ASSERT_EQUAL(image_findChangedRegions(previousU8, AlignedImageU8(), 4).length(), 0);
+		ASSERT_CRASH(image_findChangedRegions(previousU8, currentU8, 0), U"image_findChangedRegions got the block size 0, which must be at least 1!");
+	}
 END_TEST
 
@@ -0,0 +1,125 @@
+﻿
+#include "../testTools.h"
+#include "../../DFPSR/api/modelAPI.h"
+#include "../../DFPSR/api/imageAPI.h"
+
+static const int32_t gridSize = 16;
+
+// A square of gridSize x gridSize quads with a hill in the middle.
+//   If continuous is true, texture coordinates and colors are given from the location, so that neighbor quads share them.
+//   Otherwise each quad gets the default texture coordinates of a whole texture, making all edges into seams.
+static Model createTerrain(bool continuous) {
+	Model model = model_create();
+	int32_t part = model_addEmptyPart(model, U"terrain");
+	int32_t points[gridSize + 1][gridSize + 1];
+	for (int32_t z = 0; z <= gridSize; z++) {
+		for (int32_t x = 0; x <= gridSize; x++) {
+			float distance = std::max(std::abs(float(x - gridSize / 2)), std::abs(float(z - gridSize / 2)));
+			float height = std::max(0.0f, 3.0f - distance);
+			points[z][x] = model_addPoint(model, FVector3D(float(x), height, float(z)));
+		}
+	}
+	for (int32_t z = 0; z < gridSize; z++) {
+		for (int32_t x = 0; x < gridSize; x++) {
+			int32_t polygon = model_addQuad(model, part, points[z][x], points[z + 1][x], points[z + 1][x + 1], points[z][x + 1]);
+			if (continuous) {
+				for (int32_t v = 0; v < 4; v++) {
+					FVector3D position = model_getVertexPosition(model, part, polygon, v);
+					model_setTexCoord(model, part, polygon, v, FVector4D(position.x / gridSize, position.z / gridSize, 0.0f, 0.0f));
+					model_setVertexColor(model, part, polygon, v, FVector4D(position.y / 3.0f, 1.0f, 1.0f, 1.0f));
+				}
+			}
+		}
+	}
+	return model;
+}
+
+START_TEST(Model)
+	{ // Simplifying a model with continuous texture coordinates.
+		Model terrain = createTerrain(true);
+		ASSERT_EQUAL(model_getNumberOfTriangles(terrain), gridSize * gridSize * 2);
+		List<Model> levels = model_generateLevelsOfDetail(terrain, 4, 0.25f);
+		ASSERT_EQUAL(levels.length(), 4);
+		ASSERT(levels[0].getUnsafe() == terrain.getUnsafe());
+		FVector3D originalMinimum, originalMaximum;
+		model_getBoundingBox(terrain, originalMinimum, originalMaximum);
+		for (int32_t level = 1; level < levels.length(); level++) {
+			const Model &model = levels[level];
+			int32_t previousCount = model_getNumberOfTriangles(levels[level - 1]);
+			int32_t triangleCount = model_getNumberOfTriangles(model);
+			ASSERT_LESSER(triangleCount, previousCount);
+			ASSERT_GREATER(triangleCount, 0);
+			// The bounding box is kept.
+			FVector3D minimum, maximum;
+			model_getBoundingBox(model, minimum, maximum);
+			ASSERT_EQUAL(minimum, originalMinimum);
+			ASSERT_EQUAL(maximum, originalMaximum);
+			// The corners of the open border are kept, and each vertex keeps the attributes belonging to its position.
+			FVector3D usedMinimum = FVector3D(1000.0f, 1000.0f, 1000.0f);
+			FVector3D usedMaximum = FVector3D(-1000.0f, -1000.0f, -1000.0f);
+			ASSERT_EQUAL(model_getNumberOfParts(model), 1);
+			for (int32_t polygon = 0; polygon < model_getNumberOfPolygons(model, 0); polygon++) {
+				ASSERT_EQUAL(model_getPolygonVertexCount(model, 0, polygon), 3);
+				for (int32_t v = 0; v < 3; v++) {
+					FVector3D position = model_getVertexPosition(model, 0, polygon, v);
+					ASSERT_EQUAL(model_getTexCoord(model, 0, polygon, v), FVector4D(position.x / gridSize, position.z / gridSize, 0.0f, 0.0f));
+					ASSERT_EQUAL(model_getVertexColor(model, 0, polygon, v), FVector4D(position.y / 3.0f, 1.0f, 1.0f, 1.0f));
+					usedMinimum = FVector3D(std::min(usedMinimum.x, position.x), std::min(usedMinimum.y, position.y), std::min(usedMinimum.z, position.z));
+					usedMaximum = FVector3D(std::max(usedMaximum.x, position.x), std::max(usedMaximum.y, position.y), std::max(usedMaximum.z, position.z));
+				}
+			}
+			ASSERT_EQUAL(usedMinimum, originalMinimum);
+			ASSERT_EQUAL(usedMaximum, originalMaximum);
+		}
+		// The flat parts can be reduced a lot without changing the shape.
+		ASSERT_LESSER(model_getNumberOfTriangles(levels[1]), gridSize * gridSize);
+		// Selecting levels from the projected size.
+		Camera camera = Camera::createPerspective(Transform3D(), 320, 240);
+		List<int32_t> triangleCounts = model_getNumberOfTriangles(levels);
+		ASSERT_EQUAL(triangleCounts.length(), levels.length());
+		ASSERT_EQUAL(triangleCounts[0], gridSize * gridSize * 2);
+		ASSERT_EQUAL(model_selectLevelOfDetail(levels, triangleCounts, Transform3D(FVector3D(-8.0f, -1.0f, 0.0f), FMatrix3x3()), camera, 16.0f), 0);
+		ASSERT_EQUAL(model_selectLevelOfDetail(levels, triangleCounts, Transform3D(FVector3D(-8.0f, -1.0f, 30.0f), FMatrix3x3()), camera, 16.0f), 0);
+		ASSERT_GREATER(model_selectLevelOfDetail(levels, triangleCounts, Transform3D(FVector3D(-8.0f, -1.0f, 100.0f), FMatrix3x3()), camera, 16.0f), 0);
+		ASSERT_EQUAL(model_selectLevelOfDetail(levels, triangleCounts, Transform3D(FVector3D(-8.0f, -1.0f, 900.0f), FMatrix3x3()), camera, 16.0f), 3);
+	}
+	{ // Seams are not torn apart by simplification.
+		Model terrain = createTerrain(false);
+		List<Model> levels = model_generateLevelsOfDetail(terrain, 2, 0.25f);
+		ASSERT_EQUAL(levels.length(), 2);
+		// Only the corners of the square can move without tearing a seam, because their quads have no neighbors to tear from.
+		ASSERT_EQUAL(model_getNumberOfTriangles(levels[1]), gridSize * gridSize * 2 - 4);
+		for (int32_t polygon = 0; polygon < model_getNumberOfPolygons(levels[1], 0); polygon++) {
+			for (int32_t v = 0; v < 3; v++) {
+				FVector4D texCoord = model_getTexCoord(levels[1], 0, polygon, v);
+				ASSERT(texCoord.x == 0.0f || texCoord.x == 1.0f);
+				ASSERT(texCoord.y == 0.0f || texCoord.y == 1.0f);
+			}
+		}
+	}
+	ASSERT_CRASH(model_generateLevelsOfDetail(createTerrain(true), 2, 1.0f), U"model_generateLevelsOfDetail got the triangle ratio 1.0, which is not between 0 and 1!");
+	ASSERT_CRASH(model_selectLevelOfDetail(List<Model>(createTerrain(true)), List<int32_t>(), Transform3D(), Camera::createPerspective(Transform3D(), 320, 240), 16.0f), U"model_selectLevelOfDetail got 0 triangle counts for 1 levels!");
+	{ // Using images from a texture atlas.
+		List<ImageRgbaU8> images;
+		images.push(image_create_RgbaU8(20, 10));
+		images.push(image_create_RgbaU8(6, 12));
+		TextureAtlas atlas = texture_createAtlas(images, 2);
+		Model terrain = createTerrain(true);
+		model_setDiffuseMapFromAtlas(terrain, 0, atlas, 1);
+		ASSERT(model_getDiffuseMap(terrain, 0).impl_buffer.getUnsafe() == atlas.texture.impl_buffer.getUnsafe());
+		// The texture coordinates are mapped from 0..1 in the image to the image's region in the atlas.
+		float width = float(texture_getMaxWidth(atlas.texture));
+		float height = float(texture_getMaxHeight(atlas.texture));
+		IRect region = atlas.regions[1];
+		for (int32_t polygon = 0; polygon < model_getNumberOfPolygons(terrain, 0); polygon++) {
+			for (int32_t v = 0; v < 4; v++) {
+				FVector3D position = model_getVertexPosition(terrain, 0, polygon, v);
+				FVector4D texCoord = model_getTexCoord(terrain, 0, polygon, v);
+				ASSERT_NEAR(texCoord.x, (float(region.left()) + position.x / gridSize * float(region.width())) / width);
+				ASSERT_NEAR(texCoord.y, (float(region.top()) + position.z / gridSize * float(region.height())) / height);
+				ASSERT_EQUAL(texCoord.z, 0.0f);
+			}
+		}
+		ASSERT_CRASH(model_setDiffuseMapFromAtlas(terrain, 0, atlas, 2), U"model_setDiffuseMapFromAtlas got the image index 2");
+	}
+END_TEST
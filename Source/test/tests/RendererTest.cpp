@@ -0,0 +1,109 @@
+﻿
+#include "../testTools.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/rendererAPI.h"
+
+// Draws both sides of a triangle, so that the result does not depend on the triangle's direction.
+static void drawTestTriangle(Renderer &renderer, const Camera &camera, const FVector3D &a, const FVector3D &b, const FVector3D &c, const FVector4D &color) {
+	ProjectedPoint posA = camera.worldToScreen(a);
+	ProjectedPoint posB = camera.worldToScreen(b);
+	ProjectedPoint posC = camera.worldToScreen(c);
+	FVector4D texCoord = FVector4D(0.0f, 0.0f, 0.0f, 0.0f);
+	renderer_giveTask_triangle(renderer, posA, posB, posC, color, color, color, texCoord, texCoord, texCoord, TextureRgbaU8(), TextureRgbaU8(), Filter::Solid, camera);
+	renderer_giveTask_triangle(renderer, posA, posC, posB, color, color, color, texCoord, texCoord, texCoord, TextureRgbaU8(), TextureRgbaU8(), Filter::Solid, camera);
+}
+
+static void drawTestScene(Renderer &renderer, const Camera &camera) {
+	drawTestTriangle(renderer, camera, FVector3D(-1.0f, -1.0f, 4.0f), FVector3D(1.5f, -0.5f, 5.0f), FVector3D(0.0f, 1.0f, 3.0f), FVector4D(1.0f, 0.5f, 0.0f, 1.0f));
+	drawTestTriangle(renderer, camera, FVector3D(-3.0f, 0.5f, 6.0f), FVector3D(0.5f, 0.0f, 2.0f), FVector3D(-0.2f, 2.0f, 4.0f), FVector4D(0.0f, 0.5f, 1.0f, 1.0f));
+}
+
+START_TEST(Renderer)
+	{ // Clearing tiles while rendering must give the same result as filling the images before rendering.
+		const int32_t width = 203;
+		const int32_t height = 117;
+		const ColorRgbaI32 clearColor = ColorRgbaI32(12, 34, 56, 255);
+		Camera camera = Camera::createPerspective(Transform3D(), width, height);
+		Renderer renderer = renderer_create();
+		// Reference using image_fill.
+		ImageRgbaU8 expectedColor = image_create_RgbaU8(width, height);
+		ImageF32 expectedDepth = image_create_F32(width, height);
+		image_fill(expectedColor, clearColor);
+		image_fill(expectedDepth, 0.0f);
+		renderer_begin(renderer, expectedColor, expectedDepth);
+		drawTestScene(renderer, camera);
+		renderer_end(renderer);
+		// Starting with garbage that must be cleared.
+		ImageRgbaU8 resultColor = image_create_RgbaU8(width, height);
+		ImageF32 resultDepth = image_create_F32(width, height);
+		image_fill(resultColor, ColorRgbaI32(255, 0, 255, 0));
+		image_fill(resultDepth, 123.0f);
+		renderer_begin(renderer, resultColor, resultDepth, clearColor, 0.0f);
+		drawTestScene(renderer, camera);
+		renderer_end(renderer);
+		ASSERT_EQUAL(image_maxDifference(resultColor, expectedColor), 0);
+		ASSERT_EQUAL(image_maxDifference(resultDepth, expectedDepth), 0.0f);
+		// Make sure that the scene covered some but not all of the pixels.
+		ASSERT_EQUAL(image_readPixel_clamp(resultColor, 0, 0), clearColor);
+		ASSERT_NOT_EQUAL(image_readPixel_clamp(resultColor, width / 2, height / 2), clearColor);
+		// Tiles without any triangles are also cleared.
+		image_fill(resultColor, ColorRgbaI32(255, 0, 255, 0));
+		image_fill(resultDepth, 123.0f);
+		renderer_begin(renderer, resultColor, resultDepth, clearColor, 0.0f);
+		renderer_end(renderer);
+		ImageRgbaU8 clearedColor = image_create_RgbaU8(width, height);
+		ImageF32 clearedDepth = image_create_F32(width, height);
+		image_fill(clearedColor, clearColor);
+		ASSERT_EQUAL(image_maxDifference(resultColor, clearedColor), 0);
+		ASSERT_EQUAL(image_maxDifference(resultDepth, clearedDepth), 0.0f);
+	}
+	{ // Testing the visibility of many boxes at once must agree with testing one box at a time.
+		const int32_t width = 320;
+		const int32_t height = 240;
+		ImageRgbaU8 colorBuffer = image_create_RgbaU8(width, height);
+		ImageF32 depthBuffer = image_create_F32(width, height);
+		Camera camera = Camera::createPerspective(Transform3D(), width, height);
+		Renderer renderer = renderer_create();
+		renderer_begin(renderer, colorBuffer, depthBuffer);
+		// A wall in front of the camera, covering the center of the view.
+		renderer_occludeFromBox(renderer, FVector3D(-2.0f, -2.0f, 0.0f), FVector3D(2.0f, 2.0f, 1.0f), Transform3D(FVector3D(0.0f, 0.0f, 5.0f), FMatrix3x3()), camera);
+		ASSERT(renderer_hasOccluders(renderer));
+		const int32_t boxCount = 77;
+		FVector3D minimums[boxCount];
+		FVector3D maximums[boxCount];
+		Transform3D transforms[boxCount];
+		for (int32_t b = 0; b < boxCount; b++) {
+			float x = float((b % 7) - 3) * 1.5f;
+			float y = float(((b / 7) % 3) - 1) * 1.2f;
+			float z = float((b / 21) * 4 - 3);
+			minimums[b] = FVector3D(-0.25f, -0.25f, -0.25f);
+			maximums[b] = FVector3D(0.25f, 0.25f, 0.25f);
+			transforms[b] = Transform3D(FVector3D(x, y, z), FMatrix3x3());
+		}
+		uint32_t visibilityMask[(boxCount + 31) / 32];
+		renderer_getBoxVisibility(renderer,
+		  SafePointer<const FVector3D>("minimums", minimums, sizeof(minimums)),
+		  SafePointer<const FVector3D>("maximums", maximums, sizeof(maximums)),
+		  SafePointer<const Transform3D>("transforms", transforms, sizeof(transforms)),
+		  boxCount, camera, SafePointer<uint32_t>("visibilityMask", visibilityMask, sizeof(visibilityMask)));
+		int32_t visibleCount = 0;
+		for (int32_t b = 0; b < boxCount; b++) {
+			bool batchVisible = (visibilityMask[b / 32] >> (b % 32)) & 1u;
+			bool singleVisible = renderer_isBoxVisible(renderer, minimums[b], maximums[b], transforms[b], camera);
+			// The batch test may only be more conservative.
+			ASSERT(batchVisible || !singleVisible);
+			if (batchVisible) { visibleCount++; }
+		}
+		// Boxes behind the camera are culled.
+		ASSERT_EQUAL((visibilityMask[0] >> 10) & 1u, 0u);
+		// Boxes between the camera and the wall are visible.
+		ASSERT_EQUAL((visibilityMask[0] >> 31) & 1u, 1u);
+		// Boxes right behind the wall are occluded.
+		ASSERT_EQUAL((visibilityMask[2] >> (73 - 64)) & 1u, 0u);
+		ASSERT_GREATER(visibleCount, 0);
+		ASSERT_LESSER(visibleCount, boxCount);
+		// Unused bits are cleared.
+		ASSERT_EQUAL(visibilityMask[2] >> (boxCount - 64), 0u);
+		renderer_end(renderer);
+	}
+END_TEST
@@ -0,0 +1,109 @@
+﻿
+#include "../testTools.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/modelAPI.h"
+#include "../../DFPSR/api/textureAPI.h"
+
+static Model createCube(float radius) {
+	Model model = model_create();
+	int32_t part = model_addEmptyPart(model, U"cube");
+	int32_t points[8];
+	for (int32_t corner = 0; corner < 8; corner++) {
+		points[corner] = model_addPoint(model, FVector3D((corner & 4) ? radius : -radius, (corner & 2) ? radius : -radius, (corner & 1) ? radius : -radius));
+	}
+	model_addQuad(model, part, points[0], points[1], points[3], points[2]);
+	model_addQuad(model, part, points[4], points[6], points[7], points[5]);
+	model_addQuad(model, part, points[0], points[4], points[5], points[1]);
+	model_addQuad(model, part, points[2], points[3], points[7], points[6]);
+	model_addQuad(model, part, points[0], points[2], points[6], points[4]);
+	model_addQuad(model, part, points[1], points[5], points[7], points[3]);
+	return model;
+}
+
+// Returns the number of bytes used by the pixels of width x height texture with levelCount mip levels.
+static intptr_t textureSize(int32_t width, int32_t height, int32_t levelCount) {
+	intptr_t result = 0;
+	for (int32_t level = 0; level < levelCount; level++) {
+		result += intptr_t(width >> level) * intptr_t(height >> level) * 4;
+	}
+	return result;
+}
+
+START_TEST(ResourcePool)
+	String folderPath = file_combinePaths(U".", U"resources");
+	// Check that we have a valid folder path to the resources.
+	ASSERT_EQUAL(file_getEntryType(folderPath), EntryType::Folder);
+	// Save a temporary image to load textures from.
+	ImageRgbaU8 image = image_create_RgbaU8(64, 64);
+	for (int32_t y = 0; y < 64; y++) {
+		for (int32_t x = 0; x < 64; x++) {
+			image_writePixel(image, x, y, ColorRgbaI32(x * 4, y * 4, 128, 255));
+		}
+	}
+	String imagePath = file_combinePaths(folderPath, U"StreamedTexture.png");
+	ASSERT(image_save(image, imagePath));
+	{ // Loading textures directly
+		BasicResourcePool pool(folderPath);
+		Model model = createCube(1.0f);
+		model_setDiffuseMapByName(model, 0, pool, U"StreamedTexture");
+		TextureRgbaU8 texture = model_getDiffuseMap(model, 0);
+		ASSERT(texture_exists(texture));
+		ASSERT_EQUAL(texture_getMaxWidth(texture), 64);
+		ASSERT_EQUAL(texture_getMipLevelCount(texture), 5);
+	}
+	{ // Streaming textures
+		BasicResourcePool pool(folderPath, true);
+		Model model = createCube(1.0f);
+		model_setDiffuseMapByName(model, 0, pool, U"StreamedTexture");
+		// The texture is not placed in the slot until update is called.
+		ASSERT(!texture_exists(model_getDiffuseMap(model, 0)));
+		// Other models using the same texture get the same slot.
+		Model otherModel = createCube(2.0f);
+		model_setDiffuseMapByName(otherModel, 0, pool, U"StreamedTexture");
+		pool.finishStreaming();
+		TextureRgbaU8 texture = model_getDiffuseMap(model, 0);
+		ASSERT(texture_exists(texture));
+		ASSERT_EQUAL(texture_getMaxWidth(texture), 64);
+		ASSERT_EQUAL(texture_getMaxHeight(texture), 64);
+		ASSERT_EQUAL(texture_getMipLevelCount(texture), 5);
+		ASSERT_EQUAL(texture_readPixel(texture, 10u, 20u, 0u), image_readPixel_border_packed(image, 10, 20));
+		ASSERT(model_getDiffuseMap(otherModel, 0).impl_buffer.getUnsafe() == texture.impl_buffer.getUnsafe());
+		ASSERT_EQUAL(pool.getTextureMemoryUsage(), textureSize(64, 64, 5));
+		// Reducing the budget evicts the highest resolutions, but keeps the lowest resolutions.
+		pool.setTextureMemoryBudget(textureSize(16, 16, 3));
+		pool.update();
+		texture = model_getDiffuseMap(model, 0);
+		ASSERT_EQUAL(texture_getMaxWidth(texture), 16);
+		ASSERT_EQUAL(texture_getMipLevelCount(texture), 3);
+		ASSERT_EQUAL(texture_readPixel(texture, 1u, 2u, 2u), texture_readPixel(model_getDiffuseMap(otherModel, 0), 1u, 2u, 2u));
+		ASSERT_EQUAL(pool.getTextureMemoryUsage(), textureSize(16, 16, 3));
+		// Removing the budget does not load the texture again until it is used.
+		pool.setTextureMemoryBudget(0);
+		pool.finishStreaming();
+		ASSERT_EQUAL(texture_getMaxWidth(model_getDiffuseMap(model, 0)), 16);
+		// Rendering the model marks the texture as used, so that the next update starts loading the highest resolutions again.
+		ImageRgbaU8 colorBuffer = image_create_RgbaU8(64, 64);
+		ImageF32 depthBuffer = image_create_F32(64, 64);
+		Camera camera = Camera::createPerspective(Transform3D(), 64, 64);
+		model_render(model, Transform3D(FVector3D(0.0f, 0.0f, 5.0f), FMatrix3x3()), colorBuffer, depthBuffer, camera);
+		pool.update();
+		pool.finishStreaming();
+		texture = model_getDiffuseMap(model, 0);
+		ASSERT_EQUAL(texture_getMaxWidth(texture), 64);
+		ASSERT_EQUAL(texture_getMipLevelCount(texture), 5);
+		// Textures that do not exist give no slot, so that the previous texture is kept.
+		model_setDiffuseMapByName(model, 0, pool, U"MissingTexture");
+		ASSERT(texture_exists(model_getDiffuseMap(model, 0)));
+	}
+	// Textures without some of the highest resolutions.
+	TextureRgbaU8 texture = texture_create_RgbaU8(image, 5, true);
+	TextureRgbaU8 lower = texture_getLowerResolutions(texture, 2);
+	ASSERT(texture_isTiled(lower));
+	ASSERT_EQUAL(texture_getMaxWidth(lower), 16);
+	ASSERT_EQUAL(texture_getMipLevelCount(lower), 3);
+	for (uint32_t level = 0; level < 3; level++) {
+		ASSERT_EQUAL((texture_readPixel<false, false, false, false, false, true>(lower, 3u, 1u, level)), (texture_readPixel<false, false, false, false, false, true>(texture, 3u, 1u, level + 2)));
+	}
+	ASSERT_CRASH(texture_getLowerResolutions(texture, 5), U"Can not get lower resolutions from the non-existing mip level at index 5");
+	file_removeFile(imagePath);
+END_TEST
@@ -0,0 +1,96 @@
+﻿
+#include "../testTools.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/sceneAPI.h"
+
+static Model createCube(float radius) {
+	Model model = model_create();
+	int32_t part = model_addEmptyPart(model, U"cube");
+	int32_t points[8];
+	for (int32_t corner = 0; corner < 8; corner++) {
+		points[corner] = model_addPoint(model, FVector3D((corner & 4) ? radius : -radius, (corner & 2) ? radius : -radius, (corner & 1) ? radius : -radius));
+	}
+	model_addQuad(model, part, points[0], points[1], points[3], points[2]);
+	model_addQuad(model, part, points[4], points[6], points[7], points[5]);
+	model_addQuad(model, part, points[0], points[4], points[5], points[1]);
+	model_addQuad(model, part, points[2], points[3], points[7], points[6]);
+	model_addQuad(model, part, points[0], points[2], points[6], points[4]);
+	model_addQuad(model, part, points[1], points[5], points[7], points[3]);
+	return model;
+}
+
+static bool contains(const List<int32_t> &list, int32_t value) {
+	for (int32_t i = 0; i < list.length(); i++) {
+		if (list[i] == value) {
+			return true;
+		}
+	}
+	return false;
+}
+
+START_TEST(Scene)
+	Model cube = createCube(0.5f);
+	Scene scene = scene_create();
+	ASSERT(scene_exists(scene));
+	// A grid of instances around the camera.
+	const int32_t sideCount = 20;
+	for (int32_t z = 0; z < sideCount; z++) {
+		for (int32_t x = 0; x < sideCount; x++) {
+			scene_addInstance(scene, cube, Transform3D(FVector3D(float(x - sideCount / 2) * 3.0f, 0.0f, float(z - sideCount / 2) * 3.0f), FMatrix3x3()));
+		}
+	}
+	ASSERT_EQUAL(scene_getInstanceCount(scene), sideCount * sideCount);
+	// Looking along the positive z axis from the center of the grid.
+	Camera camera = Camera::createPerspective(Transform3D(), 320, 240);
+	{ // Hierarchical culling never skips an instance that is seen individually.
+		List<int32_t> visibleInstances;
+		scene_findVisibleInstances(scene, Renderer(), camera, visibleInstances);
+		int32_t seenCount = 0;
+		for (int32_t i = 0; i < sideCount * sideCount; i++) {
+			FVector3D minimum, maximum;
+			model_getBoundingBox(scene_getModel(scene, i), minimum, maximum);
+			if (camera.isBoxSeen(minimum, maximum, scene_getTransform(scene, i))) {
+				ASSERT(contains(visibleInstances, i));
+				seenCount++;
+			}
+		}
+		ASSERT_GREATER(seenCount, 0);
+		ASSERT_GREATER_OR_EQUAL(visibleInstances.length(), seenCount);
+		// Instances behind the camera are culled.
+		ASSERT_LESSER(visibleInstances.length(), sideCount * sideCount / 2);
+	}
+	{ // Moving an instance refits the hierarchy.
+		int32_t behindIndex = 0; // At x = -30, z = -30 behind the camera.
+		List<int32_t> visibleInstances;
+		scene_findVisibleInstances(scene, Renderer(), camera, visibleInstances);
+		ASSERT(!contains(visibleInstances, behindIndex));
+		scene_setTransform(scene, behindIndex, Transform3D(FVector3D(0.0f, 0.0f, 2.0f), FMatrix3x3()));
+		visibleInstances.clear();
+		scene_findVisibleInstances(scene, Renderer(), camera, visibleInstances);
+		ASSERT(contains(visibleInstances, behindIndex));
+		// Removing the instance makes it disappear.
+		scene_removeInstance(scene, behindIndex);
+		ASSERT(!scene_hasInstance(scene, behindIndex));
+		ASSERT_EQUAL(scene_getInstanceCount(scene), sideCount * sideCount - 1);
+		visibleInstances.clear();
+		scene_findVisibleInstances(scene, Renderer(), camera, visibleInstances);
+		ASSERT(!contains(visibleInstances, behindIndex));
+		// The index is reused by the next instance.
+		ASSERT_EQUAL(scene_addInstance(scene, cube, Transform3D()), behindIndex);
+	}
+	{ // Occluders hide whole branches.
+		ImageRgbaU8 colorBuffer = image_create_RgbaU8(320, 240);
+		ImageF32 depthBuffer = image_create_F32(320, 240);
+		Renderer renderer = renderer_create();
+		renderer_begin(renderer, colorBuffer, depthBuffer, ColorRgbaI32(0, 0, 0, 255), 0.0f);
+		List<int32_t> unoccluded;
+		scene_findVisibleInstances(scene, renderer, camera, unoccluded);
+		// A wall right in front of the camera.
+		renderer_occludeFromBox(renderer, FVector3D(-7.0f, -5.0f, 0.0f), FVector3D(7.0f, 5.0f, 0.1f), Transform3D(FVector3D(0.0f, 0.0f, 4.0f), FMatrix3x3()), camera);
+		List<int32_t> occluded;
+		scene_findVisibleInstances(scene, renderer, camera, occluded);
+		ASSERT_LESSER(occluded.length(), unoccluded.length());
+		scene_render_threaded(scene, renderer, camera);
+		renderer_end(renderer);
+	}
+END_TEST
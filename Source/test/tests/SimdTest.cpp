@@ -1034,6 +1034,41 @@ static void testGather() {
 	}
 }
 
+static void testShuffleBytes() {
+	ASSERT_EQUAL_SIMD(
+	  shuffleBytes(U8x16(10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25), U8x16(3, 2, 1, 0, 7, 6, 5, 4, 15, 15, 0, 0, 8, 9, 10, 11)),
+	  U8x16(13, 12, 11, 10, 17, 16, 15, 14, 25, 25, 10, 10, 18, 19, 20, 21)
+	);
+	// The 256-bit version selects lanes from the same 16-byte half, like the AVX2 instruction.
+	ASSERT_EQUAL_SIMD(
+	  shuffleBytes(
+	    U8x32(10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45),
+	    U8x32(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12, 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 15, 15, 15, 0)
+	  ),
+	  U8x32(11, 12, 13, 10, 15, 16, 17, 14, 19, 20, 21, 18, 23, 24, 25, 22, 31, 32, 33, 30, 35, 36, 37, 34, 39, 40, 41, 38, 45, 45, 45, 30)
+	);
+}
+
+static void testHalfFloats() {
+	// Exact conversions from half precision, including the largest finite value, the smallest subnormal and infinity.
+	U16x8 halves = U16x8(0x3c00, 0xc000, 0x3800, 0x7bff, 0x0001, 0x7c00, 0x3555, 0x0000);
+	ASSERT_EQUAL_SIMD(lowerFloatFromF16(halves), F32x4(1.0f, -2.0f, 0.5f, 65504.0f));
+	ASSERT_EQUAL_SIMD(higherFloatFromF16(halves), F32x4(1.0f / 16777216.0f, DSR_FLOAT_INF, 0.333251953125f, 0.0f));
+	ASSERT_EQUAL_SIMD(roundToF16(lowerFloatFromF16(halves), higherFloatFromF16(halves)), halves);
+	// Rounding to the nearest half precision float, with ties to even and overflow to infinity.
+	ASSERT_EQUAL_SIMD(
+	  roundToF16(F32x4(1.0f / 3.0f, 1.0009765625f, 1.00048828125f, 1.00146484375f), F32x4(65519.0f, 65520.0f, -65520.0f, 1.0f / 33554432.0f)),
+	  U16x8(0x3555, 0x3c01, 0x3c00, 0x3c02, 0x7bff, 0x7c00, 0xfc00, 0x0000)
+	);
+	ASSERT_EQUAL(floatFromF16(0x3555), 0.333251953125f);
+	ASSERT_EQUAL(roundToF16(1.0f / 3.0f), (uint16_t)0x3555);
+	// The 256-bit version converts the lower and upper eight lanes.
+	U16x16 longHalves = U16x16(0x3c00, 0xc000, 0x3800, 0x7bff, 0x0001, 0x7c00, 0x3555, 0x0000, 0x4000, 0x4200, 0x4400, 0x4500, 0x4600, 0x4700, 0x4800, 0x4880);
+	ASSERT_EQUAL_SIMD(lowerFloatFromF16(longHalves), F32x8(1.0f, -2.0f, 0.5f, 65504.0f, 1.0f / 16777216.0f, DSR_FLOAT_INF, 0.333251953125f, 0.0f));
+	ASSERT_EQUAL_SIMD(higherFloatFromF16(longHalves), F32x8(2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f));
+	ASSERT_EQUAL_SIMD(roundToF16(lowerFloatFromF16(longHalves), higherFloatFromF16(longHalves)), longHalves);
+}
+
 START_TEST(Simd)
 	printText(U"\nThe SIMD test is compiled using:\n");
 	#ifdef USE_SSE2
@@ -1048,6 +1083,9 @@ START_TEST(Simd)
 	#ifdef USE_AVX2
 		printText(U"	* AVX2\n");
 	#endif
+	#ifdef USE_F16C
+		printText(U"	* F16C\n");
+	#endif
 	#ifdef USE_NEON
 		printText(U"	* NEON\n");
 	#endif
@@ -1245,6 +1283,13 @@ START_TEST(Simd)
 	ASSERT_EQUAL_SIMD(lowerToU16(U8x32(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,255,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,255)), U16x16(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,255));
 	ASSERT_EQUAL_SIMD(higherToU16(U8x32(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,255,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,255)), U16x16(17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,255));
 
+	// Unsigned integer packing
+	ASSERT_EQUAL_SIMD(truncateToU8(U16x8(1,2,3,4,5,6,7,255), U16x8(9,10,256,12,13,14,1000,65535)), U8x16(1,2,3,4,5,6,7,255,9,10,0,12,13,14,232,255));
+	ASSERT_EQUAL_SIMD(
+	  truncateToU8(U16x16(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,255), U16x16(17,18,19,20,21,22,23,24,25,26,27,28,29,30,256,65535)),
+	  U8x32(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,255,17,18,19,20,21,22,23,24,25,26,27,28,29,30,0,255)
+	);
+
 	testBitMasks();
 
 	testBitShift();
@@ -1345,4 +1390,7 @@ START_TEST(Simd)
 
 	testGather();
 
+	testShuffleBytes();
+	testHalfFloats();
+
 END_TEST
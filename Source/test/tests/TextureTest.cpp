@@ -3,6 +3,8 @@
 #include "../../DFPSR/base/simd.h"
 #include "../../DFPSR/implementation/image/PackOrder.h"
 #include "../../DFPSR/api/textureAPI.h"
+#include "../../DFPSR/api/imageAPI.h"
+#include "../../DFPSR/api/modelAPI.h"
 
 #define ASSERT_EQUAL_SIMD(A, B) ASSERT_COMP(A, B, allLanesEqual, U"==")
 #define ASSERT_NOTEQUAL_SIMD(A, B) ASSERT_COMP(A, B, !allLanesEqual, U"!=")
@@ -510,6 +512,341 @@ START_TEST(Texture)
 		ASSERT_EQUAL(texture_sample_nearest(texture, -100.7f, -64.7f, 0u), 1112u);
 		ASSERT_EQUAL(texture_sample_nearest(texture, -84.7f, 0.3f, 0u), 1112u);
 		// TODO: Test the optimization template flags.
+	}
+	{ // Tiled textures
+		ImageRgbaU8 image = image_create_RgbaU8(32, 16);
+		for (int32_t y = 0; y < 16; y++) {
+			for (int32_t x = 0; x < 32; x++) {
+				image_writePixel(image, x, y, ColorRgbaI32(x * 8, y * 16, (x * y * 7) % 256, 255 - x));
+			}
+		}
+		TextureRgbaU8 rowTexture = texture_create_RgbaU8(image, 16);
+		TextureRgbaU8 tiledTexture = texture_create_RgbaU8(image, 16, true);
+		ASSERT(!texture_isTiled(rowTexture));
+		ASSERT(texture_isTiled(tiledTexture));
+		// 2x1, 4x2, 8x4, 16x8, 32x16 for rows, but only 8x4, 16x8, 32x16 for tiles.
+		ASSERT_EQUAL(texture_getSmallestMipLevel(rowTexture), 4);
+		ASSERT_EQUAL(texture_getSmallestMipLevel(tiledTexture), 2);
+		auto tiledOffset = [&tiledTexture](uint32_t x, uint32_t y, uint32_t mipLevel) {
+			return texture_getPixelOffset<false, false, false, false, false, true>(tiledTexture, x, y, mipLevel);
+		};
+		// The 8x4 and 16x8 layers take 32 + 128 pixels before the highest resolution.
+		ASSERT_EQUAL(tiledOffset(0u, 0u, 0u), 160u);
+		ASSERT_EQUAL(tiledOffset(1u, 0u, 0u), 161u);
+		ASSERT_EQUAL(tiledOffset(0u, 1u, 0u), 164u);
+		ASSERT_EQUAL(tiledOffset(3u, 3u, 0u), 175u);
+		ASSERT_EQUAL(tiledOffset(4u, 0u, 0u), 176u);
+		ASSERT_EQUAL(tiledOffset(0u, 4u, 0u), 288u);
+		ASSERT_EQUAL(tiledOffset(5u, 6u, 0u), 313u);
+		ASSERT_EQUAL(tiledOffset(32u + 5u, 16u + 6u, 0u), 313u);
+		ASSERT_EQUAL(tiledOffset(0u, 0u, 2u), 0u);
+		ASSERT_EQUAL(tiledOffset(7u, 3u, 2u), 31u);
+		// Mip levels beyond the smallest are clamped to the smallest.
+		ASSERT_EQUAL(tiledOffset(7u, 3u, 5u), 31u);
+		// The same pixels are stored in both layouts.
+		for (int32_t level = 0; level <= texture_getSmallestMipLevel(tiledTexture); level++) {
+			for (uint32_t y = 0; y < uint32_t(texture_getHeight(tiledTexture, level)); y++) {
+				for (uint32_t x = 0; x < uint32_t(texture_getWidth(tiledTexture, level)); x++) {
+					ASSERT_EQUAL((texture_readPixel<false, false, false, false, false, true>(tiledTexture, x, y, uint32_t(level))), texture_readPixel(rowTexture, x, y, uint32_t(level)));
+				}
+			}
+		}
+		// Sampling gives the same colors.
+		for (int32_t i = 0; i < 64; i++) {
+			F32x4 u = F32x4(-1.3f, 0.2f, 0.77f, 3.1f) + float(i) * 0.0371f;
+			F32x4 v = F32x4(0.1f, -2.45f, 0.5f, 0.96f) + float(i) * 0.0213f;
+			for (uint32_t level = 0; level <= 2; level++) {
+				ASSERT_EQUAL_SIMD((texture_sample_bilinear<false, false, true, false, true>(tiledTexture, u, v, level)), (texture_sample_bilinear<false, false, true, false, false>(rowTexture, u, v, level)));
+				ASSERT_EQUAL_SIMD((texture_sample_nearest<false, false, true, false, true>(tiledTexture, u, v, level)), (texture_sample_nearest<false, false, true, false, false>(rowTexture, u, v, level)));
+			}
+		}
+		// Tiled textures are at least one tile large.
+		TextureRgbaU8 smallTexture = texture_create_RgbaU8(1, 2, 4, true);
+		ASSERT_EQUAL(texture_getMaxWidth(smallTexture), 4);
+		ASSERT_EQUAL(texture_getMaxHeight(smallTexture), 4);
+		ASSERT_EQUAL(texture_getMipLevelCount(smallTexture), 1);
+		// Rows of pixels can not be accessed in tiled textures.
+		ASSERT_CRASH(texture_getMipLevelImage(tiledTexture, 0), U"Can not get a mip level as an image from a tiled texture");
+	}
+	{ // Mip pyramids
+		// Compares every mip level with a reference average of the level above.
+		auto assertPyramid = [](const TextureRgbaU8 &texture) -> bool {
+			bool tiled = texture_isTiled(texture);
+			auto readPixel = [&texture, tiled](uint32_t x, uint32_t y, uint32_t mipLevel) -> uint32_t {
+				return tiled ? texture_readPixel<false, false, false, false, false, true>(texture, x, y, mipLevel) : texture_readPixel(texture, x, y, mipLevel);
+			};
+			for (int32_t level = 1; level <= texture_getSmallestMipLevel(texture); level++) {
+				for (uint32_t y = 0; y < uint32_t(texture_getHeight(texture, level)); y++) {
+					for (uint32_t x = 0; x < uint32_t(texture_getWidth(texture, level)); x++) {
+						uint32_t expected = 0u;
+						for (uint32_t channel = 0; channel < 32; channel += 8) {
+							uint32_t sum = ((readPixel(x * 2, y * 2, level - 1) >> channel) & 255u)
+							             + ((readPixel(x * 2 + 1, y * 2, level - 1) >> channel) & 255u)
+							             + ((readPixel(x * 2, y * 2 + 1, level - 1) >> channel) & 255u)
+							             + ((readPixel(x * 2 + 1, y * 2 + 1, level - 1) >> channel) & 255u);
+							expected |= (sum / 4) << channel;
+						}
+						if (readPixel(x, y, level) != expected) return false;
+					}
+				}
+			}
+			return true;
+		};
+		auto createImage = [](int32_t width, int32_t height, int32_t seed) -> ImageRgbaU8 {
+			ImageRgbaU8 image = image_create_RgbaU8(width, height);
+			for (int32_t y = 0; y < height; y++) {
+				for (int32_t x = 0; x < width; x++) {
+					// Values close to 255 would overflow if the sums were not computed with more than 8 bits.
+					image_writePixel(image, x, y, ColorRgbaI32((x * 37 + y * 11 + seed) % 256, 255 - ((x * y + seed) % 3), (x * 5 + y * 101 + seed) % 256, (x ^ y ^ seed) % 256));
+				}
+			}
+			return image;
+		};
+		ImageRgbaU8 image = createImage(64, 32, 0);
+		TextureRgbaU8 rowTexture = texture_create_RgbaU8(image, 16);
+		TextureRgbaU8 tiledTexture = texture_create_RgbaU8(image, 16, true);
+		// Down to 2x1 pixels, where the narrowest levels can not fit four pixels in a row.
+		ASSERT_EQUAL(texture_getSmallestMipLevel(rowTexture), 5);
+		ASSERT(assertPyramid(rowTexture));
+		ASSERT(assertPyramid(tiledTexture));
+		// The highest resolution is copied without resampling when the image has power of two dimensions.
+		for (int32_t y = 0; y < 32; y++) {
+			for (int32_t x = 0; x < 64; x++) {
+				ASSERT_EQUAL(texture_readPixel(rowTexture, uint32_t(x), uint32_t(y), 0u), image_readPixel_border_packed(image, x, y));
+			}
+		}
+		// Creating many textures at once gives the same result as creating one at a time.
+		// Reserved, because growing a list of images would copy them without releasing the old copies.
+		List<ImageRgbaU8> images;
+		images.reserve(4);
+		images.push(createImage(64, 32, 1));
+		images.push(ImageRgbaU8());
+		images.push(createImage(16, 128, 2));
+		images.push(createImage(50, 7, 3));
+		for (int32_t tiled = 0; tiled < 2; tiled++) {
+			List<TextureRgbaU8> textures = texture_create_RgbaU8(images, 16, tiled == 1);
+			ASSERT_EQUAL(textures.length(), images.length());
+			ASSERT(!texture_exists(textures[1]));
+			for (int32_t t = 0; t < textures.length(); t++) {
+				TextureRgbaU8 expected = texture_create_RgbaU8(images[t], 16, tiled == 1);
+				ASSERT_EQUAL(texture_exists(textures[t]), texture_exists(expected));
+				if (texture_exists(expected)) {
+					ASSERT(assertPyramid(textures[t]));
+					ASSERT_EQUAL(buffer_getSize(textures[t].impl_buffer), buffer_getSize(expected.impl_buffer));
+					SafePointer<uint32_t> resultPixels = buffer_getSafeData<uint32_t>(textures[t].impl_buffer, "result pixels");
+					SafePointer<uint32_t> expectedPixels = buffer_getSafeData<uint32_t>(expected.impl_buffer, "expected pixels");
+					for (intptr_t i = 0; i < buffer_getSize(expected.impl_buffer) / intptr_t(sizeof(uint32_t)); i++) {
+						ASSERT_EQUAL(resultPixels[i], expectedPixels[i]);
+					}
+				}
+			}
+			// Regenerating the pyramids after clearing the lower resolutions.
+			for (int32_t t = 0; t < textures.length(); t++) {
+				for (int32_t level = 1; level <= texture_getSmallestMipLevel(textures[t]); level++) {
+					for (uint32_t y = 0; y < uint32_t(texture_getHeight(textures[t], level)); y++) {
+						for (uint32_t x = 0; x < uint32_t(texture_getWidth(textures[t], level)); x++) {
+							texture_writePixel(textures[t], x, y, uint32_t(level), 0u);
+						}
+					}
+				}
+			}
+			texture_generatePyramids(textures);
+			ASSERT(assertPyramid(textures[0]));
+			ASSERT(assertPyramid(textures[2]));
+			ASSERT(assertPyramid(textures[3]));
+		}
+	}
+	{ // Compressed textures
+		auto readPixel = [](const TextureRgbaU8 &texture, uint32_t x, uint32_t y, uint32_t mipLevel) -> uint32_t {
+			if (texture_isCompressed(texture)) {
+				return texture_readPixel<false, false, false, false, false, true, true>(texture, x, y, mipLevel);
+			} else {
+				return texture_readPixel<false, false, false, false, false, true>(texture, x, y, mipLevel);
+			}
+		};
+		// Returns the largest difference in any channel between two textures with the same dimensions, within the mip levels firstLevel..lastLevel.
+		auto getMaxError = [&readPixel](const TextureRgbaU8 &textureA, const TextureRgbaU8 &textureB, int32_t firstLevel, int32_t lastLevel) -> uint32_t {
+			uint32_t maxError = 0u;
+			for (int32_t level = firstLevel; level <= lastLevel; level++) {
+				for (uint32_t y = 0; y < uint32_t(texture_getHeight(textureA, level)); y++) {
+					for (uint32_t x = 0; x < uint32_t(texture_getWidth(textureA, level)); x++) {
+						uint32_t colorA = readPixel(textureA, x, y, uint32_t(level));
+						uint32_t colorB = readPixel(textureB, x, y, uint32_t(level));
+						for (uint32_t channel = 0; channel < 32; channel += 8) {
+							int32_t difference = int32_t((colorA >> channel) & 255u) - int32_t((colorB >> channel) & 255u);
+							maxError = max(maxError, uint32_t(difference < 0 ? -difference : difference));
+						}
+					}
+				}
+			}
+			return maxError;
+		};
+		// A smooth gradient, where all channels change in the same direction so that each block's colors are close to a line.
+		ImageRgbaU8 gradientImage = image_create_RgbaU8(64, 32);
+		for (int32_t y = 0; y < 32; y++) {
+			for (int32_t x = 0; x < 64; x++) {
+				int32_t t = x * 2 + y;
+				image_writePixel(gradientImage, x, y, ColorRgbaI32(t, 255 - t, 64 + t / 2, 255 - t / 4));
+			}
+		}
+		TextureRgbaU8 gradientTexture = texture_create_RgbaU8(gradientImage, 16, true);
+		TextureRgbaU8 compressedTexture = texture_compress(gradientTexture);
+		ASSERT(texture_isCompressed(compressedTexture));
+		ASSERT(texture_isTiled(compressedTexture));
+		ASSERT(!texture_isCompressed(gradientTexture));
+		ASSERT_EQUAL(texture_getMaxWidth(compressedTexture), 64);
+		ASSERT_EQUAL(texture_getMaxHeight(compressedTexture), 32);
+		// 64x32, 32x16, 16x8 and 8x4 pixels.
+		ASSERT_EQUAL(texture_getSmallestMipLevel(compressedTexture), 3);
+		ASSERT_EQUAL(texture_getSmallestMipLevel(gradientTexture), 3);
+		// 12 bytes for each tile of 16 pixels, instead of 64 bytes.
+		ASSERT_EQUAL(buffer_getSize(compressedTexture.impl_buffer) * 16 / 3, buffer_getSize(gradientTexture.impl_buffer));
+		// Each block of the highest resolution has at most 10 different values per channel, which are rounded to four steps.
+		ASSERT_LESSER(getMaxError(compressedTexture, gradientTexture, 0, 0), 3u);
+		// Lower resolutions have steeper gradients with 16 different values per block, but all 16 pixels are still on a line.
+		ASSERT_LESSER(getMaxError(compressedTexture, gradientTexture, 1, 3), 16u);
+		// Compressing from rows gives the same result as compressing from tiles.
+		TextureRgbaU8 compressedFromRows = texture_compress(texture_create_RgbaU8(gradientImage, 16));
+		ASSERT_EQUAL(texture_getSmallestMipLevel(compressedFromRows), texture_getSmallestMipLevel(compressedTexture));
+		ASSERT_EQUAL(getMaxError(compressedFromRows, compressedTexture, 0, 3), 0u);
+		// Blocks with no more than two colors are stored without loss.
+		ImageRgbaU8 patternImage = image_create_RgbaU8(16, 16);
+		for (int32_t y = 0; y < 16; y++) {
+			for (int32_t x = 0; x < 16; x++) {
+				int32_t block = (x / 4) + (y / 4) * 4;
+				image_writePixel(patternImage, x, y, ((x * 7 + y * 3) % 5 < 2) ? ColorRgbaI32(block * 16, 255, 0, 255) : ColorRgbaI32(13, 255 - block * 9, block * 3, 100));
+			}
+		}
+		TextureRgbaU8 patternTexture = texture_create_RgbaU8(patternImage, 1, true);
+		ASSERT_EQUAL(getMaxError(texture_compress(patternTexture), patternTexture, 0, 0), 0u);
+		// Sampling compressed textures gives the same result as sampling the decoded pixels in an uncompressed texture.
+		TextureRgbaU8 decodedTexture = texture_create_RgbaU8(64, 32, 16, true);
+		for (int32_t level = 0; level <= texture_getSmallestMipLevel(compressedTexture); level++) {
+			for (uint32_t y = 0; y < uint32_t(texture_getHeight(compressedTexture, level)); y++) {
+				for (uint32_t x = 0; x < uint32_t(texture_getWidth(compressedTexture, level)); x++) {
+					texture_writePixel(decodedTexture, x, y, uint32_t(level), readPixel(compressedTexture, x, y, uint32_t(level)));
+				}
+			}
+		}
+		for (int32_t i = 0; i < 64; i++) {
+			F32x4 u = F32x4(-1.3f, 0.2f, 0.77f, 3.1f) + float(i) * 0.0371f;
+			F32x4 v = F32x4(0.1f, -2.45f, 0.5f, 0.96f) + float(i) * 0.0213f;
+			for (uint32_t level = 0; level <= 2; level++) {
+				ASSERT_EQUAL_SIMD((texture_sample_bilinear<false, false, true, false, true, true>(compressedTexture, u, v, level)), (texture_sample_bilinear<false, false, true, false, true>(decodedTexture, u, v, level)));
+				ASSERT_EQUAL_SIMD((texture_sample_nearest<false, false, true, false, true, true>(compressedTexture, u, v, level)), (texture_sample_nearest<false, false, true, false, true>(decodedTexture, u, v, level)));
+			}
+		}
+		// The RgbaMultiply shader samples compressed textures directly.
+		auto renderQuad = [](const TextureRgbaU8 &texture) -> ImageRgbaU8 {
+			Model model = model_create();
+			int32_t part = model_addEmptyPart(model, U"quad");
+			model_addQuad(model, part,
+			  model_addPoint(model, FVector3D(-1.0f, 1.0f, 0.0f)),
+			  model_addPoint(model, FVector3D(1.0f, 1.0f, 0.0f)),
+			  model_addPoint(model, FVector3D(1.0f, -1.0f, 0.0f)),
+			  model_addPoint(model, FVector3D(-1.0f, -1.0f, 0.0f))
+			);
+			model_setDiffuseMap(model, part, texture);
+			ImageRgbaU8 colorBuffer = image_create_RgbaU8(64, 64);
+			ImageF32 depthBuffer = image_create_F32(64, 64);
+			Camera camera = Camera::createPerspective(Transform3D(), 64, 64);
+			model_render(model, Transform3D(FVector3D(0.3f, -0.2f, 2.5f), FMatrix3x3::makeAxisSystem(FVector3D(0.2f, 0.1f, 1.0f), FVector3D(0.3f, 1.0f, 0.0f))), colorBuffer, depthBuffer, camera);
+			return colorBuffer;
+		};
+		ImageRgbaU8 compressedResult = renderQuad(compressedTexture);
+		ImageRgbaU8 decodedResult = renderQuad(decodedTexture);
+		ASSERT_GREATER(image_maxDifference(compressedResult, image_create_RgbaU8(64, 64)), 0);
+		ASSERT_EQUAL(image_maxDifference(compressedResult, decodedResult), 0);
+		// Removing the highest resolution from a compressed texture.
+		TextureRgbaU8 lowerTexture = texture_getLowerResolutions(compressedTexture, 1);
+		ASSERT(texture_isCompressed(lowerTexture));
+		ASSERT_EQUAL(texture_getMaxWidth(lowerTexture), 32);
+		ASSERT_EQUAL(readPixel(lowerTexture, 5u, 6u, 0u), readPixel(compressedTexture, 5u, 6u, 1u));
+		// Compressed textures can only be created from textures of at least 4x4 pixels and can not be modified.
+		ASSERT_CRASH(texture_compress(texture_create_RgbaU8(2, 8, 1)), U"Can not compress a texture of 2x8 pixels");
+		ASSERT_CRASH(texture_generatePyramid(compressedTexture), U"Can not generate lower resolutions in a compressed texture");
+		List<TextureRgbaU8> compressedTextures;
+		compressedTextures.reserve(2);
+		compressedTextures.push(lowerTexture);
+		compressedTextures.push(compressedTexture);
+		ASSERT_CRASH(texture_generatePyramids(compressedTextures), U"texture_generatePyramids got a compressed texture at index 0");
+		ASSERT_CRASH(texture_writePixel(compressedTexture, 0u, 0u, 0u, 0u), U"Tried to write a pixel to a compressed texture");
+	}
+	{ // Texture atlas
+		// Images of solid colors, so that blending between images can be detected in any resolution.
+		// Reserved, because growing a list of images would copy them without releasing the old copies.
+		List<ImageRgbaU8> images;
+		images.reserve(14);
+		List<ColorRgbaI32> colors;
+		for (int32_t i = 0; i < 12; i++) {
+			ColorRgbaI32 color = ColorRgbaI32(i * 20, 255 - i * 20, (i * 73) % 256, 255);
+			ImageRgbaU8 image = image_create_RgbaU8(3 + (i * 5) % 17, 2 + (i * 11) % 13);
+			image_fill(image, color);
+			images.push(image);
+			colors.push(color);
+		}
+		images.push(ImageRgbaU8());
+		colors.push(ColorRgbaI32());
+		// A gradient to check that pixels are copied.
+		ImageRgbaU8 gradientImage = image_create_RgbaU8(9, 5);
+		for (int32_t y = 0; y < 5; y++) {
+			for (int32_t x = 0; x < 9; x++) {
+				image_writePixel(gradientImage, x, y, ColorRgbaI32(x * 20, y * 40, 7, 200));
+			}
+		}
+		images.push(gradientImage);
+		colors.push(ColorRgbaI32());
+		for (int32_t tiled = 0; tiled < 2; tiled++) {
+			TextureAtlas atlas = texture_createAtlas(images, 3, tiled == 1);
+			ASSERT(texture_exists(atlas.texture));
+			ASSERT_EQUAL(texture_isTiled(atlas.texture), tiled == 1);
+			ASSERT_EQUAL(texture_getMipLevelCount(atlas.texture), 3);
+			ASSERT_EQUAL(atlas.regions.length(), images.length());
+			ASSERT(!atlas.regions[12].hasArea());
+			auto readPixel = [&atlas](uint32_t x, uint32_t y, uint32_t mipLevel) -> uint32_t {
+				return texture_isTiled(atlas.texture) ? texture_readPixel<false, false, false, false, false, true>(atlas.texture, x, y, mipLevel) : texture_readPixel(atlas.texture, x, y, mipLevel);
+			};
+			for (int32_t i = 0; i < images.length(); i++) {
+				IRect region = atlas.regions[i];
+				if (image_exists(images[i])) {
+					ASSERT_EQUAL(region.width(), image_getWidth(images[i]));
+					ASSERT_EQUAL(region.height(), image_getHeight(images[i]));
+					// Aligned to whole pixels in the lowest resolution, after one pixel of padding in the lowest resolution.
+					ASSERT_EQUAL(region.left() % 4, 0);
+					ASSERT_EQUAL(region.top() % 4, 0);
+					ASSERT_GREATER(region.left(), 3);
+					ASSERT_GREATER(region.top(), 3);
+					ASSERT(region.right() <= texture_getMaxWidth(atlas.texture) - 4);
+					ASSERT(region.bottom() <= texture_getMaxHeight(atlas.texture) - 4);
+					// Padded regions do not overlap.
+					IRect padded = IRect(region.left() - 4, region.top() - 4, region.width() + 8, region.height() + 8);
+					for (int32_t j = 0; j < i; j++) {
+						if (image_exists(images[j])) {
+							ASSERT(!IRect::overlaps(padded, atlas.regions[j]));
+						}
+					}
+					// Each image is copied with the same pixels in the highest resolution.
+					for (int32_t y = 0; y < region.height(); y++) {
+						for (int32_t x = 0; x < region.width(); x++) {
+							ASSERT_EQUAL(readPixel(uint32_t(region.left() + x), uint32_t(region.top() + y), 0u), image_readPixel_border_packed(images[i], x, y));
+						}
+					}
+					if (i < 12) {
+						// Solid images keep their color in the lowest resolution, including the neighbor pixels reached by bi-linear sampling.
+						uint32_t expected = image_readPixel_border_packed(images[i], 0, 0);
+						for (int32_t y = region.top() / 4 - 1; y <= (region.bottom() - 1) / 4 + 1; y++) {
+							for (int32_t x = region.left() / 4 - 1; x <= (region.right() - 1) / 4 + 1; x++) {
+								ASSERT_EQUAL(readPixel(uint32_t(x), uint32_t(y), 2u), expected);
+							}
+						}
+					}
+				}
+			}
+		}
+		// No images give no texture.
+		TextureAtlas emptyAtlas = texture_createAtlas(List<ImageRgbaU8>(), 1);
+		ASSERT(!texture_exists(emptyAtlas.texture));
+		ASSERT_CRASH(texture_createAtlas(images, 9), U"Tried to create a texture atlas with 9 resolutions");
 	}
 		// TODO: Test reading pixels from SafePointer with and without a specified row index.
 	{